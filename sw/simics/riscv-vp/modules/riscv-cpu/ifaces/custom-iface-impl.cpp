@@ -0,0 +1,123 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-custom.hpp"
+#include "riscv-cpu-custom-iface.h"
+
+namespace kz::riscv::core {
+
+    template<unsigned XLEN>
+    static int bind_c(
+        conf_object_t *obj,
+        const char *name,
+        uint8 opcode,
+        int func3,
+        int func7,
+        unsigned latency,
+        riscv_custom_instr_handler_t handler,
+        lang_void *user_data) {
+        auto *cpu = simics::from_obj<RiscvCpu<XLEN>>(obj);
+        return cpu->bind_custom_instr(name, opcode, func3, func7, latency, handler, user_data);
+    }
+
+    template<unsigned XLEN>
+    static int unbind_c(conf_object_t *obj, uint8 opcode, int func3, int func7) {
+        auto *cpu = simics::from_obj<RiscvCpu<XLEN>>(obj);
+        return cpu->unbind_custom_instr(opcode, func3, func7);
+    }
+
+    template<unsigned XLEN>
+    const riscv_custom_instr_interface_t RiscvCpu<XLEN>::custom_instr_funcs = {
+        bind_c<XLEN>,
+        unbind_c<XLEN>,
+    };
+
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::bind_custom_instr(
+        const char *name,
+        uint8 opcode,
+        int func3,
+        int func7,
+        unsigned latency,
+        riscv_custom_instr_handler_t handler,
+        lang_void *user_data) {
+        custom_instr_t instr;
+        instr.name = (name != nullptr) ? name : "custom";
+        instr.opcode = opcode;
+        instr.func3 = func3;
+        instr.func7 = func7;
+        instr.latency = latency;
+        instr.handler = handler;
+        instr.user_data = user_data;
+        if (!custom_instrs_.bind(instr)) {
+            SIM_LOG_ERROR(
+                cobj_, 0,
+                "Can not bind custom instruction '%s': opcode='0x%02x', func3='%d', func7='%d'",
+                instr.name.c_str(), static_cast<unsigned int>(opcode), func3, func7
+            );
+            return -1;
+        }
+        // bindings are resolved at predecode time, drop the decoded instructions
+        predecode_cache_.flush();
+        SIM_LOG_INFO(
+            2, cobj_, 0,
+            "Bound custom instruction '%s': opcode='0x%02x', func3='%d', func7='%d', latency='%u'",
+            instr.name.c_str(), static_cast<unsigned int>(opcode), func3, func7, latency
+        );
+        return 0;
+    }
+
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::unbind_custom_instr(uint8 opcode, int func3, int func7) {
+        if (!custom_instrs_.unbind(opcode, func3, func7)) {
+            SIM_LOG_ERROR(
+                cobj_, 0,
+                "Can not unbind custom instruction: opcode='0x%02x', func3='%d', func7='%d'",
+                static_cast<unsigned int>(opcode), func3, func7
+            );
+            return -1;
+        }
+        predecode_cache_.flush();
+        return 0;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::custom_instrs_as_attr() const {
+        const auto &instrs = custom_instrs_.get_instrs();
+        attr_value_t result = SIM_alloc_attr_list(static_cast<unsigned>(instrs.size()));
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            SIM_attr_list_set_item(
+                &result, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    5,
+                    SIM_make_attr_string(instrs[i].name.c_str()),
+                    SIM_make_attr_uint64(instrs[i].opcode),
+                    SIM_make_attr_int64(instrs[i].func3),
+                    SIM_make_attr_int64(instrs[i].func7),
+                    SIM_make_attr_uint64(instrs[i].latency)
+                )
+            );
+        }
+        return result;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
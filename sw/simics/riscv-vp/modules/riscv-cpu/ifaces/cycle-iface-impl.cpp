@@ -25,12 +25,14 @@
 
 namespace kz::riscv::core {
 
+    template<unsigned XLEN>
     static attr_value_t cycle_events_c(conf_object_t *obj) {
-        auto *cpu = static_cast<RiscvCpu *>(SIM_object_data(obj));
+        auto *cpu = static_cast<RiscvCpu<XLEN> *>(SIM_object_data(obj));
         return cpu->cycle_events();
     }
 
-    const simics::iface::CycleInterface::ctype RiscvCpu::cycle_funcs = {
+    template<unsigned XLEN>
+    const simics::iface::CycleInterface::ctype RiscvCpu<XLEN>::cycle_funcs = {
         simics::iface::CycleInterface::FromC::get_cycle_count,
         simics::iface::CycleInterface::FromC::get_time,
         simics::iface::CycleInterface::FromC::cycles_delta,
@@ -40,7 +42,7 @@ namespace kz::riscv::core {
         simics::iface::CycleInterface::FromC::cancel,
         simics::iface::CycleInterface::FromC::find_next_cycle,
         simics::iface::CycleInterface::FromC::find_next_time,
-        cycle_events_c,
+        cycle_events_c<XLEN>,
         simics::iface::CycleInterface::FromC::get_time_in_ps,
         simics::iface::CycleInterface::FromC::cycles_delta_from_ps,
         simics::iface::CycleInterface::FromC::post_time_in_ps,
@@ -51,27 +53,28 @@ namespace kz::riscv::core {
             return 1;
     }
 
-    static void cycle_event_posted_() {
-        // An event has been posted. We only single step, so we don't need to bother.
-    }
-
-    cycles_t RiscvCpu::get_cycle_count() {
+    template<unsigned XLEN>
+    cycles_t RiscvCpu<XLEN>::get_cycle_count() {
         return current_cycle_;
     }
 
-    double RiscvCpu::get_time() {
+    template<unsigned XLEN>
+    double RiscvCpu<XLEN>::get_time() {
         return local_time_as_sec(get_time_in_ps());
     }
 
-    cycles_t RiscvCpu::cycles_delta(double when) {
+    template<unsigned XLEN>
+    cycles_t RiscvCpu<XLEN>::cycles_delta(double when) {
         return cycles_delta_from_ps(local_time_from_sec(cobj_, when));
     }
 
-    uint64_t RiscvCpu::get_frequency() {
+    template<unsigned XLEN>
+    uint64_t RiscvCpu<XLEN>::get_frequency() {
         return freq_hz_;
     }
 
-    void RiscvCpu::post_cycle(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::post_cycle(
         event_class_t *evclass,
         conf_object_t *obj,
         cycles_t cycles,
@@ -83,10 +86,12 @@ namespace kz::riscv::core {
             return;
         }
         cycle_queue_.post(cycles, evclass, obj, user_data);
-        cycle_event_posted_();
+        // the new event may be due within the current batch of instructions
+        batch_exit_ = true;
     }
 
-    void RiscvCpu::post_time(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::post_time(
         event_class_t *evclass,
         conf_object_t *obj,
         double seconds,
@@ -101,10 +106,12 @@ namespace kz::riscv::core {
         if (err) {
             SIM_LOG_ERROR(cobj_, 0, "%s", err);
         }
-        cycle_event_posted_();
+        // the new event may be due within the current batch of instructions
+        batch_exit_ = true;
     }
 
-    void RiscvCpu::cancel(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::cancel(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data), lang_void *match_data) {
@@ -112,7 +119,8 @@ namespace kz::riscv::core {
         cycle_queue_.remove(evclass, obj, pred == NULL ? match_all_ : pred, match_data);
     }
 
-    cycles_t RiscvCpu::find_next_cycle(
+    template<unsigned XLEN>
+    cycles_t RiscvCpu<XLEN>::find_next_cycle(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data),
@@ -121,7 +129,8 @@ namespace kz::riscv::core {
         return cycle_queue_.next(evclass, obj, pred == NULL ? match_all_ : pred, match_data);
     }
 
-    double RiscvCpu::find_next_time(
+    template<unsigned XLEN>
+    double RiscvCpu<XLEN>::find_next_time(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data),
@@ -134,7 +143,8 @@ namespace kz::riscv::core {
             }, freq_hz_);
     }
 
-    attr_value_t RiscvCpu::cycle_events() {
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::cycle_events() {
         // Return the list of pending cycle events
         attr_value_t evs = SIM_alloc_attr_list(static_cast<int>(cycle_queue_.get_events().size()));
         cycles_t t = 0;
@@ -163,11 +173,13 @@ namespace kz::riscv::core {
         return evs;
     }
 
-    local_time_t RiscvCpu::get_time_in_ps() {
+    template<unsigned XLEN>
+    local_time_t RiscvCpu<XLEN>::get_time_in_ps() {
         return RiscvCpuCycle::generic_get_time_in_ps(cobj_, time_offset_, current_cycle_, freq_hz_);
     }
 
-    cycles_t RiscvCpu::cycles_delta_from_ps(local_time_t when) {
+    template<unsigned XLEN>
+    cycles_t RiscvCpu<XLEN>::cycles_delta_from_ps(local_time_t when) {
         cycles_t delta;
         if (!RiscvCpuCycle::generic_delta_from_ps(when, time_offset_, current_cycle_, freq_hz_, &delta)) {
                 char r[LOCAL_TIME_STR_MAX_SIZE];
@@ -182,7 +194,8 @@ namespace kz::riscv::core {
         }
     }
 
-    void RiscvCpu::post_time_in_ps(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::post_time_in_ps(
         event_class_t *evclass,
         conf_object_t *obj,
         duration_t ps,
@@ -196,10 +209,12 @@ namespace kz::riscv::core {
         if (err) {
             SIM_LOG_ERROR(cobj_, 0, "%s", err);
         }
-        cycle_event_posted_();
+        // the new event may be due within the current batch of instructions
+        batch_exit_ = true;
     }
 
-    duration_t RiscvCpu::find_next_time_in_ps(
+    template<unsigned XLEN>
+    duration_t RiscvCpu<XLEN>::find_next_time_in_ps(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data),
@@ -214,4 +229,7 @@ namespace kz::riscv::core {
                 return this->find_next_cycle(evclass, obj, pred, match_data);
             }, freq_hz_);
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 }; /* ! kz::riscv::core ! */
\ No newline at end of file
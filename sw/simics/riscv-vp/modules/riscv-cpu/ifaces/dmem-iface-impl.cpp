@@ -21,28 +21,38 @@
 #include "riscv-cpu.hpp"
 
 namespace kz::riscv::core {
-    void RiscvCpu::release(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::release(
         conf_object_t *target,
         direct_memory_handle_t handle,
         direct_memory_ack_id_t id) {
-        SIM_LOG_UNIMPLEMENTED(3, cobj_, 0, "RiscvCpu::release() not implemented yet");
+        // memory behind the mapping may change, so instructions decoded from it and cached
+        // host pointers are stale
+        flush_caches_();
     }
 
-    void RiscvCpu::update_permission(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::update_permission(
         conf_object_t *target,
         direct_memory_handle_t handle,
         access_t lost_access,
         access_t lost_permission,
         access_t lost_inhibit,
         direct_memory_ack_id_t id) {
-        SIM_LOG_UNIMPLEMENTED(3, cobj_, 0, "RiscvCpu::update_permission() not implemented yet");
+        // somebody else is going to modify the memory, instructions decoded from it and cached
+        // host pointers (write ones at least) are stale
+        flush_caches_();
     }
 
-    void RiscvCpu::conflicting_access(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::conflicting_access(
         conf_object_t *target,
         direct_memory_handle_t handle,
         access_t conflicting_permission,
         direct_memory_ack_id_t id) {
         SIM_LOG_UNIMPLEMENTED(3, cobj_, 0, "RiscvCpu::conflicting_access() not implemented yet");
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
@@ -23,7 +23,8 @@
 
 namespace kz::riscv::core {
 
-    void RiscvCpu::run() {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::run() {
         // Called by Simics to start execution.
         state_ = execute_state_t::Running;
         // Check event queue for pending events, timers, etc. on current step and cycle
@@ -31,17 +32,41 @@ namespace kz::riscv::core {
         if (is_enabled_) {
             handle_events_(&step_queue_);
         }
+        check_interrupts_();
+        apply_mode_schedule_();
+        // the counters count the calling thread, which is the simulation one only here
+        bool host_profiling = host_profiling_ && host_profile_.open();
         // Main execution loop
         while (state_ == execute_state_t::Running) {
             if (is_enabled_ && stall_cycles_ == 0) {
                 SIM_LOG_INFO(4, cobj_, 0, "Start execution");
-                // Fetch instruction at PC
-                // Assuming 4-byte instructions (RV32I, without C extension, for compressed instructions)
-                instr_t instr = fetch_(pc_);
-                // Decode and execute instruction
-                dec_instr_t dec_instr = decode_(instr);
-                // Execute one instruction
-                execute_(dec_instr);
+                // Instructions are executed in batches up to the next event, nothing can
+                // raise an interrupt or require event handling in the meantime, unless an
+                // instruction posts an event, accesses a device, or writes a CSR (batch_exit_
+                // is set then), so the per-instruction path has no queue or interrupt checks.
+                batch_exit_ = false;
+                // the callbacks of single instructions are released by the predecode flushes,
+                // the plain batches are back once the last ones are gone
+                if (instrumentation_.is_active() != instrumentation_active_) {
+                    update_instrumentation_();
+                    batch_exit_ = false;
+                }
+                // the instrumentation is selected once per batch, so the plain variant has
+                // no per-instruction checks for it
+                // the tier is taken before the batch, which can change the instrumentation
+                uint8_t tier = instrumented_ ? host_tier_t::INSTRUMENTED : host_tier_t::PLAIN;
+                pc_step_t steps = current_step_;
+                if (host_profiling) {
+                    host_profile_.account(host_tier_t::EVENTS, 0);
+                }
+                if (instrumented_) {
+                    run_batch_<true>(get_batch_size_());
+                } else {
+                    run_batch_<false>(get_batch_size_());
+                }
+                if (host_profiling) {
+                    host_profile_.account(tier, current_step_ - steps);
+                }
                 SIM_LOG_INFO(4, cobj_, 0, "Stop execution");
             } else {
                 // If the processor is disabled, we can either halt or just wait
@@ -62,28 +87,145 @@ namespace kz::riscv::core {
                 break;
             }
             // Check for interrupts, events, etc.
+            VT_check_async_events();
             handle_events_(&cycle_queue_);
             if (is_enabled_) {
                 handle_events_(&step_queue_);
             }
+            check_interrupts_();
+            apply_mode_schedule_();
         }
+        if (host_profiling) {
+            host_profile_.account(host_tier_t::EVENTS, 0);
+            host_profile_.close();
+        }
+        // the trace and BBV files are complete whenever the simulation is stopped
+        if (tracing_) {
+            tracer_.flush();
+        }
+        bbv_.flush();
     }
 
-    void RiscvCpu::stop() {
+    template<unsigned XLEN>
+    template<bool INSTRUMENTED>
+    void RiscvCpu<XLEN>::run_batch_(uint64_t batch) {
+        batch_left_ = batch;
+        // a change of the callbacks ends the batch, the hooks released meanwhile leave it stale
+        // but harmless (nothing to dispatch)
+        [[maybe_unused]] bool instrumentation_active = INSTRUMENTED && instrumentation_.is_active();
+        do {
+            [[maybe_unused]] reg_t pc = pc_;
+            [[maybe_unused]] uint8_t priv = priv_;
+            [[maybe_unused]] uint64_t traps = trap_count_;
+            // Fetch and decode instruction at PC, it's done only on predecode cache miss
+            // Assuming 4-byte instructions (RV32I, without C extension, for compressed instructions)
+            const predecoded_instr_t *entry = predecode_(pc_);
+            // only the instructions of the pages with an execution breakpoint pay for the check
+            if (entry != nullptr && entry->breakpoint && break_exec_(pc, *entry)) {
+                break;
+            }
+            // the trace and the data cache need the operands of loads and stores before they
+            // are overwritten
+            [[maybe_unused]] reg_t addr = 0;
+            [[maybe_unused]] reg_t store_val = 0;
+            if constexpr (INSTRUMENTED) {
+                if ((tracing_ || mode_ != sim_mode_t::Functional || instrumentation_active) && entry != nullptr) {
+                    addr = regs_[entry->dec_instr.rs1] + static_cast<sreg_t>(entry->dec_instr.imm);
+                    store_val = regs_[entry->dec_instr.rs2];
+                }
+                if (instrumentation_active && entry != nullptr) {
+                    instrument_before_(pc, *entry, addr, store_val);
+                }
+            }
+            // Execute one instruction, custom instructions were bound at predecode time,
+            // nothing to execute if the fetch raised an exception (pc_ is at the handler)
+            if (entry != nullptr) {
+                if (entry->custom != nullptr) {
+                    execute_custom_(*entry);
+                } else {
+                    execute_(entry->dec_instr, entry->instr);
+                }
+            }
+            if constexpr (INSTRUMENTED) {
+                if (tracking_blocks_) {
+                    track_block_(pc, entry);
+                }
+                if (callgraph_tracking_ && entry != nullptr && entry->ends_block && trap_count_ == traps) {
+                    track_call_(pc, entry->dec_instr);
+                }
+                if (mix_counting_ && entry != nullptr) {
+                    instr_mix_.count(entry->mix_id);
+                }
+                // trapped instructions aren't retired
+                if (tracing_ && entry != nullptr && trap_count_ == traps) {
+                    trace_instr_(pc, priv, *entry, addr, store_val);
+                }
+                if (mode_ != sim_mode_t::Functional) {
+                    timing_instr_(pc, entry, trap_count_ == traps, addr);
+                }
+                if (instrumentation_active && entry != nullptr && trap_count_ == traps) {
+                    instrument_after_(*entry);
+                }
+            }
+        } while (--batch_left_ != 0 && !batch_exit_);
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::limit_batch_() {
+        // every following instruction takes at least one cycle, the event is due after the
+        // delta of them at the latest
+        simtime_t delta = cycle_queue_.get_delta();
+        if (delta >= 0 && static_cast<uint64_t>(delta) < batch_left_) {
+            batch_left_ = delta + 1;
+        }
+    }
+
+    template<unsigned XLEN>
+    uint64_t RiscvCpu<XLEN>::get_batch_size_() const {
+        // every instruction takes one step and at least one cycle, so the batch never runs
+        // past the next step or cycle event (delta is negative for an empty queue), the
+        // instructions taking more cycles shorten the rest of the batch (limit_batch_)
+        uint64_t batch = MAX_BATCH_SIZE;
+        simtime_t cycles = cycle_queue_.get_delta();
+        simtime_t steps = is_enabled_ ? step_queue_.get_delta() : -1;
+        if (cycles >= 0 && static_cast<uint64_t>(cycles) < batch) {
+            batch = cycles;
+        }
+        if (steps >= 0 && static_cast<uint64_t>(steps) < batch) {
+            batch = steps;
+        }
+        // the mode is switched between batches
+        uint64_t next_switch = timing_.get_next_switch();
+        if (next_switch != RiscvCpuTiming::NO_SWITCH && next_switch > static_cast<uint64_t>(current_step_) &&
+            next_switch - current_step_ < batch) {
+            batch = next_switch - current_step_;
+        }
+        // the due events have been handled, unless the CPU has been stopped meanwhile
+        return batch > 0 ? batch : 1;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::stop() {
         // Called by Simics to stop execution.
         state_ = execute_state_t::Stopped;
+        batch_exit_ = true;
         VT_stop_event_processing(cobj_);
     }
 
-    void RiscvCpu::switch_in() {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::switch_in() {
         // Called when this CPU becomes the active one in the simulation.
         // Set up state or resources here if needed.
         //SIM_LOG_UNIMPLEMENTED(3, cobj_, 0, "RiscvCpu::switch_in() not implemented yet");
     }
 
-    void RiscvCpu::switch_out() {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::switch_out() {
         // Called when this CPU is no longer the active one.
         // Clean up or save state if needed.
         //SIM_LOG_UNIMPLEMENTED(3, cobj_, 0, "RiscvCpu::switch_out() not implemented yet");
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
@@ -21,7 +21,8 @@
 #include "riscv-cpu-cycle.hpp"
 
 namespace kz::riscv::core {
-    void RiscvCpu::set(uint64 numerator, uint64 denominator) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set(uint64 numerator, uint64 denominator) {
         uint64_t old_freq = freq_hz_;
         uint64_t new_freq = 1;
         if (numerator == 0 || denominator == 0) {
@@ -50,4 +51,7 @@ namespace kz::riscv::core {
         freq_hz_ = new_freq;
         VT_clock_frequency_change(cobj_, freq_hz_);
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } // namespace kz::riscv::core
\ No newline at end of file
@@ -0,0 +1,280 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-instrumentation.hpp"
+
+namespace kz::riscv::core {
+    using kind_t = instrumentation_kind_t;
+
+    // ! cpu_instrumentation_subscribe !
+
+    template<unsigned XLEN>
+    static void remove_callback_c(conf_object_t *obj, cpu_cb_handle_t *handle) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->remove_instrumentation(handle);
+    }
+
+    template<unsigned XLEN>
+    static void enable_callback_c(conf_object_t *obj, cpu_cb_handle_t *handle) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->enable_instrumentation(handle, true);
+    }
+
+    template<unsigned XLEN>
+    static void disable_callback_c(conf_object_t *obj, cpu_cb_handle_t *handle) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->enable_instrumentation(handle, false);
+    }
+
+    template<unsigned XLEN>
+    static void remove_connection_callbacks_c(conf_object_t *obj, conf_object_t *connection) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->remove_connection_instrumentation(connection);
+    }
+
+    template<unsigned XLEN>
+    static void enable_connection_callbacks_c(conf_object_t *obj, conf_object_t *connection) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->enable_connection_instrumentation(connection, true);
+    }
+
+    template<unsigned XLEN>
+    static void disable_connection_callbacks_c(conf_object_t *obj, conf_object_t *connection) {
+        simics::from_obj<RiscvCpu<XLEN>>(obj)->enable_connection_instrumentation(connection, false);
+    }
+
+    template<unsigned XLEN, uint8_t KIND>
+    static cpu_cb_handle_t *register_instruction_cb_c(
+        conf_object_t *obj, conf_object_t *connection, cpu_instruction_cb_t cb, lang_void *data) {
+        instrumentation_callback_t callback = {};
+        callback.kind = KIND;
+        callback.func.instruction = cb;
+        callback.data = data;
+        return simics::from_obj<RiscvCpu<XLEN>>(obj)->register_instrumentation(connection, callback);
+    }
+
+    // all accesses of the model are explicit (there are no page table walks), the scope is ignored
+    template<unsigned XLEN, uint8_t KIND>
+    static cpu_cb_handle_t *register_memory_cb_c(
+        conf_object_t *obj, conf_object_t *connection, cpu_access_scope_t scope, cpu_memory_cb_t cb, lang_void *data) {
+        instrumentation_callback_t callback = {};
+        callback.kind = KIND;
+        callback.func.memory = cb;
+        callback.data = data;
+        return simics::from_obj<RiscvCpu<XLEN>>(obj)->register_instrumentation(connection, callback);
+    }
+
+    template<unsigned XLEN>
+    static cpu_cb_handle_t *register_cached_instruction_cb_c(
+        conf_object_t *obj, conf_object_t *connection, cpu_cached_instruction_cb_t cb, lang_void *data) {
+        instrumentation_callback_t callback = {};
+        callback.kind = kind_t::CACHED_INSTRUCTION;
+        callback.func.cached = cb;
+        callback.data = data;
+        return simics::from_obj<RiscvCpu<XLEN>>(obj)->register_instrumentation(connection, callback);
+    }
+
+    template<unsigned XLEN>
+    static cpu_cb_handle_t *register_exception_before_cb_c(
+        conf_object_t *obj, conf_object_t *connection, int exception_number, cpu_exception_cb_t cb, lang_void *data) {
+        instrumentation_callback_t callback = {};
+        callback.kind = kind_t::EXCEPTION_BEFORE;
+        callback.exception = exception_number;
+        callback.func.exception = cb;
+        callback.data = data;
+        return simics::from_obj<RiscvCpu<XLEN>>(obj)->register_instrumentation(connection, callback);
+    }
+
+    // the functions are set by name, the address, decoder, mode and control register
+    // callbacks aren't provided (NULL)
+    template<unsigned XLEN>
+    static cpu_instrumentation_subscribe_interface_t make_instrumentation_subscribe_funcs() {
+        cpu_instrumentation_subscribe_interface_t funcs = {};
+        funcs.remove_callback = remove_callback_c<XLEN>;
+        funcs.enable_callback = enable_callback_c<XLEN>;
+        funcs.disable_callback = disable_callback_c<XLEN>;
+        funcs.remove_connection_callbacks = remove_connection_callbacks_c<XLEN>;
+        funcs.enable_connection_callbacks = enable_connection_callbacks_c<XLEN>;
+        funcs.disable_connection_callbacks = disable_connection_callbacks_c<XLEN>;
+        funcs.register_instruction_before_cb = register_instruction_cb_c<XLEN, kind_t::INSTRUCTION_BEFORE>;
+        funcs.register_instruction_after_cb = register_instruction_cb_c<XLEN, kind_t::INSTRUCTION_AFTER>;
+        funcs.register_read_before_cb = register_memory_cb_c<XLEN, kind_t::READ_BEFORE>;
+        funcs.register_read_after_cb = register_memory_cb_c<XLEN, kind_t::READ_AFTER>;
+        funcs.register_write_before_cb = register_memory_cb_c<XLEN, kind_t::WRITE_BEFORE>;
+        funcs.register_write_after_cb = register_memory_cb_c<XLEN, kind_t::WRITE_AFTER>;
+        funcs.register_cached_instruction_cb = register_cached_instruction_cb_c<XLEN>;
+        funcs.register_exception_before_cb = register_exception_before_cb_c<XLEN>;
+        return funcs;
+    }
+
+    template<unsigned XLEN>
+    const cpu_instrumentation_subscribe_interface_t RiscvCpu<XLEN>::instrumentation_subscribe_funcs =
+        make_instrumentation_subscribe_funcs<XLEN>();
+
+    // ! cpu_cached_instruction !
+
+    template<uint8_t KIND, typename CB>
+    static void register_hook_c(
+        conf_object_t *obj, cached_instruction_handle_t *ci_handle, CB cb, lang_void *data,
+        cpu_callback_free_user_data_cb_t free_cb) {
+        // the handle is the hooks object being filled by RiscvCpuInstrumentation::cache_instruction
+        auto *hooks = reinterpret_cast<instrumentation_hooks_t *>(ci_handle);
+        instrumentation_hooks_t::Hook hook = {};
+        hook.connection = hooks->connection;
+        if constexpr (std::is_same_v<CB, cpu_instruction_cb_t>) {
+            hook.func.instruction = cb;
+        } else {
+            hook.func.memory = cb;
+        }
+        hook.data = data;
+        hook.free_cb = free_cb;
+        hooks->hooks[KIND].push_back(hook);
+    }
+
+    static void add_counter_c(
+        conf_object_t *obj, cached_instruction_handle_t *ci_handle, uint64 *counter, bool use_atomic_increment) {
+        auto *hooks = reinterpret_cast<instrumentation_hooks_t *>(ci_handle);
+        // the counter belongs to the connection, it's dropped with its callbacks
+        hooks->counters.push_back(instrumentation_hooks_t::Counter{hooks->connection, counter, use_atomic_increment});
+    }
+
+    static cpu_cached_instruction_interface_t make_cached_instruction_funcs() {
+        cpu_cached_instruction_interface_t funcs = {};
+        funcs.register_instruction_before_cb = register_hook_c<kind_t::INSTRUCTION_BEFORE, cpu_instruction_cb_t>;
+        funcs.register_instruction_after_cb = register_hook_c<kind_t::INSTRUCTION_AFTER, cpu_instruction_cb_t>;
+        funcs.register_read_before_cb = register_hook_c<kind_t::READ_BEFORE, cpu_memory_cb_t>;
+        funcs.register_read_after_cb = register_hook_c<kind_t::READ_AFTER, cpu_memory_cb_t>;
+        funcs.register_write_before_cb = register_hook_c<kind_t::WRITE_BEFORE, cpu_memory_cb_t>;
+        funcs.register_write_after_cb = register_hook_c<kind_t::WRITE_AFTER, cpu_memory_cb_t>;
+        funcs.add_counter = add_counter_c;
+        return funcs;
+    }
+
+    template<unsigned XLEN>
+    const cpu_cached_instruction_interface_t RiscvCpu<XLEN>::cached_instruction_funcs = make_cached_instruction_funcs();
+
+    // ! cpu_instruction_query, cpu_memory_query, cpu_exception_query !
+    // there is no MMU, the logical addresses are the physical ones
+
+    static logical_address_t instruction_address_c(conf_object_t *obj, instruction_handle_t *handle) {
+        return reinterpret_cast<instrumentation_instr_t *>(handle)->pc;
+    }
+
+    static cpu_bytes_t instruction_bytes_c(conf_object_t *obj, instruction_handle_t *handle) {
+        auto *instr = reinterpret_cast<instrumentation_instr_t *>(handle);
+        return cpu_bytes_t{INSTR_SIZE, reinterpret_cast<const uint8 *>(&instr->instr)};
+    }
+
+    static cpu_instruction_query_interface_t make_instruction_query_funcs() {
+        cpu_instruction_query_interface_t funcs = {};
+        funcs.logical_address = instruction_address_c;
+        funcs.physical_address = instruction_address_c;
+        funcs.get_instruction_bytes = instruction_bytes_c;
+        return funcs;
+    }
+
+    template<unsigned XLEN>
+    const cpu_instruction_query_interface_t RiscvCpu<XLEN>::instruction_query_funcs = make_instruction_query_funcs();
+
+    static logical_address_t access_address_c(conf_object_t *obj, memory_handle_t *handle) {
+        return reinterpret_cast<instrumentation_access_t *>(handle)->addr;
+    }
+
+    static cpu_bytes_t access_bytes_c(conf_object_t *obj, memory_handle_t *handle) {
+        auto *access = reinterpret_cast<instrumentation_access_t *>(handle);
+        return cpu_bytes_t{access->bytes_size, access->bytes};
+    }
+
+    static bool access_atomic_c(conf_object_t *obj, memory_handle_t *handle) {
+        return false;
+    }
+
+    static cpu_memory_query_interface_t make_memory_query_funcs() {
+        cpu_memory_query_interface_t funcs = {};
+        funcs.logical_address = access_address_c;
+        funcs.physical_address = access_address_c;
+        funcs.get_bytes = access_bytes_c;
+        funcs.atomic = access_atomic_c;
+        return funcs;
+    }
+
+    template<unsigned XLEN>
+    const cpu_memory_query_interface_t RiscvCpu<XLEN>::memory_query_funcs = make_memory_query_funcs();
+
+    static int exception_number_c(conf_object_t *obj, exception_handle_t *handle) {
+        return reinterpret_cast<instrumentation_exception_t *>(handle)->number;
+    }
+
+    static logical_address_t exception_pc_c(conf_object_t *obj, exception_handle_t *handle) {
+        return reinterpret_cast<instrumentation_exception_t *>(handle)->fault_pc;
+    }
+
+    static cpu_exception_query_interface_t make_exception_query_funcs() {
+        cpu_exception_query_interface_t funcs = {};
+        funcs.exception_number = exception_number_c;
+        funcs.fault_pc = exception_pc_c;
+        funcs.fault_pa = exception_pc_c;
+        return funcs;
+    }
+
+    template<unsigned XLEN>
+    const cpu_exception_query_interface_t RiscvCpu<XLEN>::exception_query_funcs = make_exception_query_funcs();
+
+    template<unsigned XLEN>
+    cpu_cb_handle_t *RiscvCpu<XLEN>::register_instrumentation(
+        conf_object_t *connection, const instrumentation_callback_t &callback) {
+        cpu_cb_handle_t *handle = instrumentation_.add(connection, callback);
+        if (callback.kind == kind_t::CACHED_INSTRUCTION) {
+            // the already predecoded instructions have to be offered to the new callback
+            predecode_cache_.flush();
+        }
+        update_instrumentation_();
+        return handle;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::remove_instrumentation(cpu_cb_handle_t *handle) {
+        if (!instrumentation_.remove(handle)) {
+            SIM_LOG_ERROR(cobj_, 0, "Unknown instrumentation callback handle");
+        }
+        update_instrumentation_();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::enable_instrumentation(cpu_cb_handle_t *handle, bool enabled) {
+        if (!instrumentation_.enable(handle, enabled)) {
+            SIM_LOG_ERROR(cobj_, 0, "Unknown instrumentation callback handle");
+        }
+        update_instrumentation_();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::remove_connection_instrumentation(conf_object_t *connection) {
+        instrumentation_.remove_connection(connection);
+        // the callbacks of single instructions are released with the predecoded instructions,
+        // the remaining connections register theirs again
+        predecode_cache_.flush();
+        update_instrumentation_();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::enable_connection_instrumentation(conf_object_t *connection, bool enabled) {
+        instrumentation_.enable_connection(connection, enabled);
+        update_instrumentation_();
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -23,7 +23,8 @@
 #include "riscv-cpu-disasm.hpp"
 
 namespace kz::riscv::core {
-    tuple_int_string_t RiscvCpu::get_disassembly(
+    template<unsigned XLEN>
+    tuple_int_string_t RiscvCpu<XLEN>::get_disassembly(
         const char *addr_prefix,
         generic_address_t address,
         bool print_cpu,
@@ -46,8 +47,14 @@ namespace kz::riscv::core {
             return { 0, nullptr };
         }
         // read instruction data from memory
-        addr_t addr = static_cast<addr_t>(address);
-        uint8* data = read_mem_(addr, INSTR_SIZE);
+        uint8* data = read_mem_(static_cast<physical_address_t>(address), INSTR_SIZE);
+        if (data == nullptr) {
+            SIM_LOG_INFO(
+                4, cobj_, 0,
+                "No memory at address: 0x%08llx", static_cast<unsigned long long>(address)
+            );
+            return { 0, nullptr };
+        }
         SIM_LOG_INFO(
             4, cobj_, 0,
             "Direct memory: data[0]='0x%02x', data[1]='0x%02x', data[2]='0x%02x', data[3]='0x%02x'",
@@ -66,27 +73,31 @@ namespace kz::riscv::core {
         }
     }
 
-    char *RiscvCpu::get_pregs(bool all) {
+    template<unsigned XLEN>
+    char *RiscvCpu<XLEN>::get_pregs(bool all) {
         strbuf_t pregs_sb = sb_new("");
+        // registers are printed with XLEN / 4 hex digits
+        constexpr int digits = XLEN / 4;
         for (int i = 0; i < RV32I_GP_REG_NUM; ++i) {
             sb_addfmt(
-                &pregs_sb, "%s (%s) = 0x%08X\n",
+                &pregs_sb, "%s (%s) = 0x%0*llX\n",
                 RiscvCpuDisasm::get_reg_name(i, false).c_str(),
                 RiscvCpuDisasm::get_reg_name(i, true).c_str(),
-                regs_[i]
+                digits, static_cast<unsigned long long>(regs_[i])
             );
         }
         if (all) {
-            sb_addfmt(&pregs_sb, "%s = 0x%08X\n", get_name(32), pc_);
-            sb_addfmt(&pregs_sb, "%s = 0x%08X\n", get_name(33), mstatus_);
-            sb_addfmt(&pregs_sb, "%s = 0x%08X\n", get_name(34), mepc_);
-            sb_addfmt(&pregs_sb, "%s = 0x%08X\n", get_name(35), mtvec_);
+            // pc, CSRs and the privilege level
+            for (int i = RV32I_GP_REG_NUM; i < ALL_REGS_NUM; ++i) {
+                sb_addfmt(&pregs_sb, "%s = 0x%0*llX\n", get_name(i), digits, static_cast<unsigned long long>(read(i)));
+            }
         }
         // detach the string so Simics owns the memory now
         return sb_detach(&pregs_sb);
     }
 
-    attr_value_t RiscvCpu::get_diff_regs() {
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::get_diff_regs() {
         attr_value_t result = SIM_alloc_attr_list(ALL_REGS_NUM);
         // general purpose registers x0..x31
         for (int i = 0; i < RV32I_GP_REG_NUM; ++i) {
@@ -102,24 +113,30 @@ namespace kz::riscv::core {
         return result;
     }
 
-    char *RiscvCpu::get_pending_exception_string() {
+    template<unsigned XLEN>
+    char *RiscvCpu<XLEN>::get_pending_exception_string() {
         // Check for pending exception or interrupt
         if (mcause_ != 0) {
             // Format a message describing the exception
             strbuf_t exc_sb = sb_new("");
-            sb_addfmt(&exc_sb, "Pending exception: mcause=0x%08X", mcause_);
+            sb_addfmt(
+                &exc_sb, "Pending exception: mcause=0x%0*llX",
+                XLEN / 4, static_cast<unsigned long long>(mcause_)
+            );
             return sb_detach(&exc_sb);
         }
         // No pending exception
         return nullptr;
     }
 
-    char *RiscvCpu::get_address_prefix() {
+    template<unsigned XLEN>
+    char *RiscvCpu<XLEN>::get_address_prefix() {
         strbuf_t addr_prefix_sb = sb_new("p");
         return sb_detach(&addr_prefix_sb);
     }
 
-    physical_block_t RiscvCpu::translate_to_physical(const char *prefix, generic_address_t address) {
+    template<unsigned XLEN>
+    physical_block_t RiscvCpu<XLEN>::translate_to_physical(const char *prefix, generic_address_t address) {
         physical_block_t block = {};
         // Accept "p" (physical) and "v" (virtual) prefixes and "l" (linear) (no MMU)
         if (prefix && (prefix[0] == 'p' || prefix[0] == 'v' || prefix[0] == 'l')) {
@@ -136,4 +153,7 @@ namespace kz::riscv::core {
         }
         return block;
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
@@ -24,21 +24,23 @@
 #include "riscv-cpu-disasm.hpp"
 
 namespace kz::riscv::core {
-    void RiscvCpu::set_program_counter(logical_address_t pc) {
-        pc_ = static_cast<uint32_t>(pc);
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set_program_counter(logical_address_t pc) {
+        pc_ = static_cast<reg_t>(pc);
     }
 
-    logical_address_t RiscvCpu::get_program_counter() {
+    template<unsigned XLEN>
+    logical_address_t RiscvCpu<XLEN>::get_program_counter() {
         return static_cast<logical_address_t>(pc_);
     }
 
-    tuple_int_string_t RiscvCpu::disassemble(
+    template<unsigned XLEN>
+    tuple_int_string_t RiscvCpu<XLEN>::disassemble(
         generic_address_t address,
         attr_value_t instruction_data,
         int sub_operation) {
         strbuf_t result_sb = sb_new("");
         // set type aliases
-        using addr_t = kz::riscv::types::addr_t;
         using instr_t = kz::riscv::types::instr_t;
         using dec_instr_t = kz::riscv::types::dec_instr_t;
         using operation_code_t = kz::riscv::types::operation_code_t;
@@ -92,18 +94,18 @@ namespace kz::riscv::core {
             static_cast<unsigned int>(dec_instr.type)
         );
         // disassemble instruction
-        addr_t addr = static_cast<addr_t>(address);
-        std::string disasm_instr = RiscvCpuDisasm::disasm(addr, dec_instr);
+        std::string disasm_instr = RiscvCpuDisasm::disasm(static_cast<uint64_t>(address), dec_instr);
         SIM_LOG_INFO(
             4, cobj_, 0,
-            "addr: 0x%08x disassembled: %s",
-            static_cast<unsigned int>(addr), disasm_instr.c_str()
+            "addr: 0x%08llx disassembled: %s",
+            static_cast<unsigned long long>(address), disasm_instr.c_str()
         );
         sb_addstr(&result_sb, disasm_instr.c_str());
         return {INSTR_SIZE, sb_detach(&result_sb)};
     }
 
-    physical_block_t RiscvCpu::logical_to_physical(logical_address_t address, access_t access_type) {
+    template<unsigned XLEN>
+    physical_block_t RiscvCpu<XLEN>::logical_to_physical(logical_address_t address, access_t access_type) {
         // So far no MMu no paging, direct mapping. The logical and physical address are the same.
         // The block is a single address, no range. This is standard for simple CPUs or when running
         // in machine mode without virtual memory.
@@ -115,11 +117,18 @@ namespace kz::riscv::core {
         return block;
     }
 
-    processor_mode_t RiscvCpu::get_processor_mode() {
-        return Sim_CPU_Mode_User;
+    template<unsigned XLEN>
+    processor_mode_t RiscvCpu<XLEN>::get_processor_mode() {
+        // Simics knows three modes only, M-mode is reported as the most privileged one
+        switch (priv_) {
+            case privilege_t::U: return Sim_CPU_Mode_User;
+            case privilege_t::S: return Sim_CPU_Mode_Supervisor;
+            default: return Sim_CPU_Mode_Hypervisor;
+        }
     }
 
-    int RiscvCpu::enable_processor() {
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::enable_processor() {
         SIM_LOG_INFO(4, cobj_, 0, "Enabling processor (no-op)");
         if (is_enabled_) {
             SIM_LOG_INFO(4, cobj_, 0, "Processor already enabled");
@@ -129,7 +138,8 @@ namespace kz::riscv::core {
         return 0;
     }
 
-    int RiscvCpu::disable_processor() {
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::disable_processor() {
         SIM_LOG_INFO(4, cobj_, 0, "Disabling processor (no-op)");
         if (!is_enabled_) {
             SIM_LOG_INFO(4, cobj_, 0, "Processor already disabled");
@@ -139,27 +149,36 @@ namespace kz::riscv::core {
         return 0;
     }
 
-    int RiscvCpu::get_enabled() {
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::get_enabled() {
         return is_enabled_ ? 1 : 0;
     }
 
-    cpu_endian_t RiscvCpu::get_endian() {
+    template<unsigned XLEN>
+    cpu_endian_t RiscvCpu<XLEN>::get_endian() {
         return Sim_Endian_Little;
     }
 
-    conf_object_t * RiscvCpu::get_physical_memory() {
+    template<unsigned XLEN>
+    conf_object_t * RiscvCpu<XLEN>::get_physical_memory() {
         return phys_mem_;
     }
 
-    int RiscvCpu::get_logical_address_width() {
-        return RAM_ADDR_WIDTH;
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::get_logical_address_width() {
+        return XLEN;
     }
 
-    int RiscvCpu::get_physical_address_width() {
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::get_physical_address_width() {
         return RAM_ADDR_WIDTH;
     }
 
-    const char *RiscvCpu::architecture() {
+    template<unsigned XLEN>
+    const char *RiscvCpu<XLEN>::architecture() {
         return "riscv";
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
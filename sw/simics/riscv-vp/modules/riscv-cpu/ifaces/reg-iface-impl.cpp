@@ -20,14 +20,47 @@
 #include "riscv-cpu.hpp"
 #include "riscv-cpu-disasm.hpp"
 #include "riscv-cpu-conf.hpp"
+#include "riscv-cpu-priv.hpp"
 
 namespace kz::riscv::core {
-    int RiscvCpu::get_number(const char *name) {
-        if (strcmp(name, "pc") == 0) return 32;
-        if (strcmp(name, "mstatus") == 0) return 33;
-        if (strcmp(name, "mepc") == 0) return 34;
-        if (strcmp(name, "mcause") == 0) return 35;
-        if (strcmp(name, "mtvec") == 0) return 36;
+    // registers numbered after x0..x31 and pc (32), accessed through the CSR logic, the
+    // privilege level is the last one
+    class CsrRegInfo {
+    public:
+        const char *name;
+        uint16_t csr;
+    };
+    static constexpr int PC_REG = RV32I_GP_REG_NUM;
+    static constexpr int FIRST_CSR_REG = PC_REG + 1;
+    static constexpr CsrRegInfo CSR_REGS[] = {
+        {"mstatus", CsrAddr::MSTATUS},
+        {"mepc", CsrAddr::MEPC},
+        {"mcause", CsrAddr::MCAUSE},
+        {"mtvec", CsrAddr::MTVEC},
+        {"medeleg", CsrAddr::MEDELEG},
+        {"mideleg", CsrAddr::MIDELEG},
+        {"mie", CsrAddr::MIE},
+        {"mip", CsrAddr::MIP},
+        {"mtval", CsrAddr::MTVAL},
+        {"mscratch", CsrAddr::MSCRATCH},
+        {"stvec", CsrAddr::STVEC},
+        {"sepc", CsrAddr::SEPC},
+        {"scause", CsrAddr::SCAUSE},
+        {"stval", CsrAddr::STVAL},
+        {"sscratch", CsrAddr::SSCRATCH},
+        {"satp", CsrAddr::SATP},
+    };
+    static constexpr int CSR_REGS_NUM = sizeof(CSR_REGS) / sizeof(CSR_REGS[0]);
+    static constexpr int PRIV_REG = FIRST_CSR_REG + CSR_REGS_NUM;
+    static_assert(PRIV_REG + 1 == ALL_REGS_NUM, "ALL_REGS_NUM doesn't match the register list");
+
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::get_number(const char *name) {
+        if (strcmp(name, "pc") == 0) return PC_REG;
+        if (strcmp(name, "priv") == 0) return PRIV_REG;
+        for (int i = 0; i < CSR_REGS_NUM; ++i) {
+            if (strcmp(name, CSR_REGS[i].name) == 0) return FIRST_CSR_REG + i;
+        }
         if (name[0] == 'x') {
             char *endptr;
             long idx = strtol(name + 1, &endptr, 10);
@@ -38,12 +71,11 @@ namespace kz::riscv::core {
         return -1;
     }
 
-    const char *RiscvCpu::get_name(int reg) {
-        if (reg == 32) return "pc";
-        if (reg == 33) return "mstatus";
-        if (reg == 34) return "mepc";
-        if (reg == 35) return "mcause";
-        if (reg == 36) return "mtvec";
+    template<unsigned XLEN>
+    const char *RiscvCpu<XLEN>::get_name(int reg) {
+        if (reg == PC_REG) return "pc";
+        if (reg == PRIV_REG) return "priv";
+        if (reg >= FIRST_CSR_REG && reg < PRIV_REG) return CSR_REGS[reg - FIRST_CSR_REG].name;
         if (reg >= 0 && reg < RV32I_GP_REG_NUM) {
             strbuf_t regs_sb = sb_new("");
             sb_addstr(&regs_sb, RiscvCpuDisasm::get_reg_name(reg, false).c_str());
@@ -52,40 +84,45 @@ namespace kz::riscv::core {
         return nullptr;
     }
 
-    uint64 RiscvCpu::read(int reg) {
+    template<unsigned XLEN>
+    uint64 RiscvCpu<XLEN>::read(int reg) {
         if (reg >= 0 && reg < RV32I_GP_REG_NUM) {
             return regs_[reg];
         }
-        switch (reg) {
-            case 32: return pc_;
-            case 33: return mstatus_;
-            case 34: return mepc_;
-            case 35: return mcause_;
-            case 36: return mtvec_;
-            default:
-                throw std::out_of_range("Invalid register number");
+        if (reg == PC_REG) return pc_;
+        if (reg == PRIV_REG) return priv_;
+        if (reg >= FIRST_CSR_REG && reg < PRIV_REG) {
+            reg_t value = 0;
+            csr_read_(CSR_REGS[reg - FIRST_CSR_REG].csr, &value, true);
+            return value;
         }
+        throw std::out_of_range("Invalid register number");
     }
 
-    void RiscvCpu::write(int reg, uint64 val) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::write(int reg, uint64 val) {
         if (reg >= 0 && reg < RV32I_GP_REG_NUM) {
             if (reg != 0) { // x0 is hardwired to zero
-                regs_[reg] = static_cast<uint32_t>(val);
+                regs_[reg] = static_cast<reg_t>(val);
             }
             return;
         }
-        switch (reg) {
-            case 32: pc_ = static_cast<uint32_t>(val); break;
-            case 33: mstatus_ = static_cast<uint32_t>(val); break;
-            case 34: mepc_ = static_cast<uint32_t>(val); break;
-            case 35: mcause_ = static_cast<uint32_t>(val); break;
-            case 36: mtvec_ = static_cast<uint32_t>(val); break;
-            default:
-                throw std::out_of_range("Invalid register number");
+        if (reg == PC_REG) {
+            pc_ = static_cast<reg_t>(val);
+        } else if (reg == PRIV_REG) {
+            if (val != privilege_t::U && val != privilege_t::S && val != privilege_t::M) {
+                throw std::out_of_range("Invalid privilege level");
+            }
+            set_priv_(static_cast<uint8_t>(val));
+        } else if (reg >= FIRST_CSR_REG && reg < PRIV_REG) {
+            csr_write_(CSR_REGS[reg - FIRST_CSR_REG].csr, static_cast<reg_t>(val), true);
+        } else {
+            throw std::out_of_range("Invalid register number");
         }
     }
 
-    attr_value_t RiscvCpu::all_registers() {
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::all_registers() {
         attr_value_t result = SIM_alloc_attr_list(ALL_REGS_NUM);
         for (int i = 0; i < ALL_REGS_NUM; ++i) {
             SIM_attr_list_set_item(&result, i,  SIM_make_attr_uint64(i));
@@ -93,15 +130,19 @@ namespace kz::riscv::core {
         return result;
     }
 
-    int RiscvCpu::register_info(int reg, ireg_info_t info) {
+    template<unsigned XLEN>
+    int RiscvCpu<XLEN>::register_info(int reg, ireg_info_t info) {
         constexpr int UNSUPPORTED = -1;
         switch (info) {
             case Sim_RegInfo_Catchable:
-                if (reg >= 0 && reg < RV32I_GP_REG_NUM) return 0; // x0..x31 are 32-bit
-                if (reg >= RV32I_GP_REG_NUM && reg <= ALL_REGS_NUM) return 0; // pc, mstatus, mepc, mcause, mtvec are 32-bit
+                if (reg >= 0 && reg < RV32I_GP_REG_NUM) return 0; // x0..x31 are XLEN-bit
+                if (reg >= RV32I_GP_REG_NUM && reg < ALL_REGS_NUM) return 0; // pc, CSRs and the privilege level
                 return UNSUPPORTED;
             default:
                 return UNSUPPORTED;
         }
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
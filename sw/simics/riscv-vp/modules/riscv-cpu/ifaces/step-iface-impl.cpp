@@ -23,17 +23,19 @@
 
 namespace kz::riscv::core {
 
+    template<unsigned XLEN>
     static attr_value_t step_events_c(conf_object_t *obj) {
-        auto *cpu = static_cast<RiscvCpu *>(SIM_object_data(obj));
+        auto *cpu = static_cast<RiscvCpu<XLEN> *>(SIM_object_data(obj));
         return cpu->step_events();
     }
 
-    const simics::iface::StepInterface::ctype RiscvCpu::step_funcs = {
+    template<unsigned XLEN>
+    const simics::iface::StepInterface::ctype RiscvCpu<XLEN>::step_funcs = {
         simics::iface::StepInterface::FromC::get_step_count,
         simics::iface::StepInterface::FromC::post_step,
         simics::iface::StepInterface::FromC::cancel_step,
         simics::iface::StepInterface::FromC::find_next_step,
-        step_events_c,
+        step_events_c<XLEN>,
         simics::iface::StepInterface::FromC::advance,
     };
 
@@ -41,15 +43,13 @@ namespace kz::riscv::core {
             return 1;
     }
 
-    static void step_event_posted_() {
-        // An event has been posted. We only single step, so we don't need to bother.
-    }
-
-    pc_step_t RiscvCpu::get_step_count() {
+    template<unsigned XLEN>
+    pc_step_t RiscvCpu<XLEN>::get_step_count() {
         return current_step_;
     }
 
-    void RiscvCpu::post_step(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::post_step(
         event_class_t *evclass,
         conf_object_t *obj,
         pc_step_t steps,
@@ -61,10 +61,12 @@ namespace kz::riscv::core {
             return;
         }
         step_queue_.post(steps, evclass, obj, user_data);
-        step_event_posted_();
+        // the new event may be due within the current batch of instructions
+        batch_exit_ = true;
     }
 
-    void RiscvCpu::cancel_step(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::cancel_step(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data),
@@ -74,7 +76,8 @@ namespace kz::riscv::core {
         step_queue_.remove(evclass, obj, pred == NULL ? match_all_ : pred, match_data);
     }
 
-    pc_step_t RiscvCpu::find_next_step(
+    template<unsigned XLEN>
+    pc_step_t RiscvCpu<XLEN>::find_next_step(
         event_class_t *evclass,
         conf_object_t *obj,
         int (*pred)(lang_void *data, lang_void *match_data),
@@ -84,7 +87,8 @@ namespace kz::riscv::core {
         return step_queue_.next(evclass, obj, pred == NULL ? match_all_ : pred, match_data);
     }
 
-    attr_value_t RiscvCpu::step_events() {
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::step_events() {
         // Return the list of pending step events
         const auto &events = step_queue_.get_events();
         std::vector<attr_value_t> attr_events;
@@ -117,10 +121,14 @@ namespace kz::riscv::core {
         return ret;
     }
 
-    pc_step_t RiscvCpu::advance(pc_step_t steps) {
+    template<unsigned XLEN>
+    pc_step_t RiscvCpu<XLEN>::advance(pc_step_t steps) {
         // Advance the CPU by 'steps' instructions
         SIM_LOG_INFO(1, cobj_, 0, "Advancing CPU by %llu steps", steps);
         // do nothing
         return steps;
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
@@ -0,0 +1,91 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <simics/cc-api.h>
+#include <simics/c++/devs/signal.h>
+#include <simics/c++/model-iface/transaction.h>
+
+namespace kz::riscv::devices {
+    /**
+     * Core-local interruptor (CLINT) of a single hart, SiFive compatible register layout:
+     * msip at 0x0000, mtimecmp at 0x4000 and mtime at 0xBFF8. The registers may be accessed
+     * with 4-byte (halves of the 64-bit ones) or 8-byte aligned accesses.
+     *
+     * The mtime is not stored, it's derived from the cycle counter of the clock the device
+     * is bound to (queue attribute), so it doesn't cost anything while the CPU executes. The
+     * device is never polled, a single cycle event is posted for the next mtimecmp match
+     * and reposted whenever mtime, mtimecmp or the tick length changes. MTIP and MSIP are
+     * driven through the signal interface of the connected targets (CPU interrupt ports).
+     */
+    class RiscvClint : public simics::ConfObject, public simics::iface::TransactionInterface {
+    public:
+        static constexpr uint64_t MSIP_OFFSET = 0x0000;
+        static constexpr uint64_t MTIMECMP_OFFSET = 0x4000;
+        static constexpr uint64_t MTIME_OFFSET = 0xBFF8;
+        static constexpr uint64_t REGS_SIZE = 0x10000;
+
+        explicit RiscvClint(simics::ConfObjectRef conf_obj);
+        virtual ~RiscvClint();
+
+        void objects_finalized() override;
+
+        // ! TransactionInterface (riscv-clint) !
+        exception_type_t issue(transaction_t *t, uint64 addr) override;
+
+        static void init_class(simics::ConfClass *cls);
+    private:
+        conf_object_t *cobj_;
+        uint32_t msip_;
+        uint64_t mtimecmp_;
+        // mtime = clock cycles / cycles_per_tick_ + mtime_offset_ (modulo 2^64)
+        uint64_t mtime_offset_;
+        uint64_t cycles_per_tick_;
+        bool mtip_;
+        simics::Connect<simics::iface::SignalInterface> mtip_target_;
+        simics::Connect<simics::iface::SignalInterface> msip_target_;
+        static event_class_t *timer_event_;
+
+        cycles_t get_cycles_() const;
+        uint64_t get_mtime_() const;
+        void set_mtime_(uint64_t mtime);
+        void set_mtimecmp_(uint64_t mtimecmp);
+        void set_msip_(uint32_t msip);
+        void set_cycles_per_tick_(uint64_t cycles_per_tick);
+        void set_mtip_(bool level);
+        /**
+         * Update MTIP and (re)post the timer event for the next mtimecmp match, nothing is
+         * posted if the match has already happened.
+         */
+        void update_timer_();
+        /**
+         * Read or write a part of the register, size and offset are in bytes.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param offs [M][In] Offset of the access from the beginning of the register bank.
+         * @param size [M][In] Size of the access (4 or 8 bytes).
+         * @param value [M][In/Out] The read/written value.
+         * @return false if the access doesn't hit any register.
+         */
+        bool read_reg_(uint64_t offs, unsigned size, uint64_t *value) const;
+        bool write_reg_(uint64_t offs, unsigned size, uint64_t value);
+        static void timer_event_c(conf_object_t *obj, lang_void *data);
+    };
+} /* ! kz::riscv::devices ! */
@@ -0,0 +1,89 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace kz::riscv::core {
+    /**
+     * Basic block vectors for SimPoint. The executed instructions are split into intervals,
+     * for every interval the entries of each basic block weighted by the block length are
+     * written as a line of the SimPoint .bb file: "T:<id>:<count> :<id>:<count> ...", the
+     * block ids start at 1, in the order of the first execution. An interval ends with the
+     * first block which reaches its length, the blocks aren't split.
+     */
+    class RiscvCpuBbv {
+    public:
+        RiscvCpuBbv();
+        ~RiscvCpuBbv();
+        /**
+         * Create the .bb file and start the first interval.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param path [M][In] The output file, truncated if it exists.
+         * @param interval [M][In] Length of the intervals in instructions.
+         * @return false if the file can't be created.
+         */
+        bool open(const std::string &path, uint64_t interval);
+        /**
+         * Write the last, incomplete interval and close the file.
+         */
+        void close();
+        /**
+         * Write the complete intervals to the file.
+         */
+        void flush();
+        bool is_open() const { return file_ != nullptr; }
+        uint64_t get_intervals() const { return intervals_; }
+        /**
+         * Count a single execution of the block.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the first instruction of the block.
+         * @param length [M][In] Number of instructions executed in the block.
+         */
+        void add(uint64_t pc, uint32_t length) {
+            auto [it, inserted] = ids_.try_emplace(pc, static_cast<uint32_t>(counts_.size()));
+            if (inserted) {
+                counts_.push_back(0);
+            }
+            uint64_t &count = counts_[it->second];
+            if (count == 0) {
+                touched_.push_back(it->second);
+            }
+            count += length;
+            executed_ += length;
+            if (executed_ >= interval_) {
+                write_interval_();
+            }
+        }
+    private:
+        void write_interval_();
+        FILE *file_;
+        uint64_t interval_;
+        uint64_t executed_;                         // instructions of the current interval
+        uint64_t intervals_;                        // written intervals
+        std::unordered_map<uint64_t, uint32_t> ids_;// block address -> index of counts_ (id - 1)
+        std::vector<uint64_t> counts_;              // weighted entries in the current interval
+        std::vector<uint32_t> touched_;             // blocks executed in the current interval
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,135 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kz::riscv::core {
+    class BranchPredictorKind {
+    public:
+        static const uint8_t BTFN = 0;      // static: backward taken, forward not taken
+        static const uint8_t BIMODAL = 1;   // 2-bit counters indexed with the branch address
+        static const uint8_t GSHARE = 2;    // 2-bit counters indexed with the address ^ global history
+        static const uint8_t NUM = 3;
+    };
+    using branch_predictor_kind_t = BranchPredictorKind;
+
+    /**
+     * Branch prediction model of the fetch stage: the direction predictor of the conditional
+     * branches, the branch target buffer (direct-mapped, tagged) which provides the targets of
+     * the taken branches and jumps, and the return address stack. JAL/JALR with rd = ra push
+     * the return address, JALR with rs1 = ra and rd = x0 pops it. Without the BTB (0 entries)
+     * the targets of the direct branches and jumps are known at decode, the indirect jumps
+     * are always mispredicted.
+     */
+    class RiscvCpuBranchPredictor {
+    public:
+        RiscvCpuBranchPredictor();
+        static const char *get_kind_name(uint8_t kind);
+        /**
+         * Find the direction predictor with the given name.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param name [M][In] "btfn", "bimodal" or "gshare".
+         * @param kind [M][Out] The direction predictor.
+         * @return false if there is no predictor with the name.
+         */
+        static bool get_kind(const std::string &name, uint8_t *kind);
+        /**
+         * Attach the predictor with the given configuration, all tables are reset.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param kind [M][In] The direction predictor.
+         * @param pht_entries [M][In] Counters of bimodal/gshare, a power of two.
+         * @param history_bits [M][In] Length of the gshare global history, up to 32.
+         * @param btb_entries [M][In] Entries of the BTB, a power of two or 0 (no BTB).
+         * @param ras_depth [M][In] Entries of the return address stack, 0 - no RAS.
+         * @return false if the configuration is invalid, the predictor is left unchanged then.
+         */
+        bool attach(uint8_t kind, unsigned pht_entries, unsigned history_bits, unsigned btb_entries,
+            unsigned ras_depth);
+        void detach();
+        bool is_attached() const { return attached_; }
+        /**
+         * Resolve the conditional branch, the tables are trained with the outcome.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the branch.
+         * @param target [M][In] Target address of the branch.
+         * @param taken [M][In] The branch has been taken.
+         * @return true if the branch was mispredicted.
+         */
+        bool branch(uint64_t pc, uint64_t target, bool taken);
+        /**
+         * Resolve the jump (JAL/JALR), the tables are trained with the outcome.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the jump.
+         * @param target [M][In] Target address of the jump.
+         * @param indirect [M][In] JALR (true) or JAL (false).
+         * @param call [M][In] The link register is ra, the return address is pushed.
+         * @param ret [M][In] JALR through ra not linking, the return address is popped.
+         * @return true if the target was mispredicted.
+         */
+        bool jump(uint64_t pc, uint64_t target, bool indirect, bool call, bool ret);
+        uint8_t get_kind() const { return kind_; }
+        unsigned get_pht_entries() const { return static_cast<unsigned>(pht_.size()); }
+        unsigned get_history_bits() const { return history_bits_; }
+        unsigned get_btb_entries() const { return static_cast<unsigned>(btb_.size()); }
+        unsigned get_ras_depth() const { return static_cast<unsigned>(ras_.size()); }
+        uint64_t get_branches() const { return branches_; }
+        uint64_t get_branch_misses() const { return branch_misses_; }
+        uint64_t get_jumps() const { return jumps_; }
+        uint64_t get_jump_misses() const { return jump_misses_; }
+        uint64_t get_returns() const { return returns_; }
+        uint64_t get_return_misses() const { return return_misses_; }
+        void clear_stats();
+    private:
+        class BtbEntry {
+        public:
+            uint64_t pc;
+            uint64_t target;
+        };
+        size_t pht_index_(uint64_t pc) const {
+            uint64_t index = pc >> 2;
+            if (kind_ == branch_predictor_kind_t::GSHARE) {
+                index ^= history_;
+            }
+            return index & (pht_.size() - 1);
+        }
+        /**
+         * Check the BTB prediction of the taken control transfer and store its target.
+         * @return true if the BTB didn't provide the target.
+         */
+        bool btb_update_(uint64_t pc, uint64_t target);
+        bool attached_;
+        uint8_t kind_;
+        unsigned history_bits_;
+        uint64_t history_;                  // global history, the last outcome is bit 0
+        std::vector<uint8_t> pht_;          // 2-bit saturating counters, taken if >= 2
+        std::vector<BtbEntry> btb_;
+        std::vector<uint64_t> ras_;         // circular, overflow overwrites the oldest entry
+        unsigned ras_top_;
+        uint64_t branches_;
+        uint64_t branch_misses_;
+        uint64_t jumps_;
+        uint64_t jump_misses_;
+        uint64_t returns_;
+        uint64_t return_misses_;
+    };
+} /* ! kz::riscv::core ! */
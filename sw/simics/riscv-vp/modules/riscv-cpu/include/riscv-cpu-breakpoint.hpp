@@ -0,0 +1,108 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <simics/device-api.h>
+#include <simics/model-iface/breakpoints.h>
+
+namespace kz::riscv::core {
+    class BreakpointRange {
+    public:
+        breakpoint_handle_t handle;
+        uint8_t access;     // bitmask of (1 << access kind), see RiscvCpuTlb
+        uint64_t start;     // first and last byte of the range
+        uint64_t end;
+    };
+    using breakpoint_range_t = BreakpointRange;
+
+    class WatchpointHit {
+    public:
+        static constexpr breakpoint_handle_t NO_HIT = -1;
+        breakpoint_handle_t handle; // index of the watchpoint, NO_HIT if none was hit yet
+        uint64_t pc;                // address of the accessing instruction
+        uint64_t addr;
+        uint32_t size;
+        uint8_t access;             // access kind, READ or WRITE (see RiscvCpuTlb)
+        uint64_t step;              // instruction count at the hit
+    };
+    using watchpoint_hit_t = WatchpointHit;
+
+    /**
+     * Address ranges checked by the CPU: the copy of the breakpoints of the physical memory
+     * space and the watchpoints. The pages the ranges are set on are flagged per access kind,
+     * so the CPU checks the ranges only for the accesses to the flagged pages, the rest of
+     * the memory runs without any check. The ranges spanning more than MAX_RANGE_PAGES pages
+     * flag all pages of the access kind.
+     */
+    class RiscvCpuBreakpoints {
+    public:
+        static constexpr unsigned PAGE_WIDTH = 12;
+        static constexpr uint64_t MAX_RANGE_PAGES = 1024;
+        RiscvCpuBreakpoints();
+        /**
+         * Replace the breakpoints with the ones of the set.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param set [M][In] Breakpoints returned by the breakpoint_query_v2 interface.
+         */
+        void set(const breakpoint_set_t &set);
+        /**
+         * Add the range.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param handle [M][In] Handle reported when the range is hit.
+         * @param access [M][In] Access kinds, bitmask of (1 << access kind).
+         * @param start [M][In] First byte of the range.
+         * @param end [M][In] Last byte of the range.
+         */
+        void add(breakpoint_handle_t handle, uint8_t access, uint64_t start, uint64_t end);
+        void clear();
+        bool empty() const { return ranges_.empty(); }
+        /**
+         * Get the access kinds with a breakpoint on the page, bitmask of (1 << access kind).
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param addr [M][In] Any address of the page.
+         */
+        uint8_t get_page_mask(uint64_t addr) const {
+            if (pages_.empty()) {
+                return global_;
+            }
+            auto it = pages_.find(addr >> PAGE_WIDTH);
+            return (it != pages_.end()) ? (global_ | it->second) : global_;
+        }
+        /**
+         * Find the breakpoints hit by the access.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ, WRITE or EXEC (see RiscvCpuTlb).
+         * @param addr [M][In] Address of the access.
+         * @param size [M][In] Size of the access in bytes.
+         * @param hits [M][Out] Handles of the breakpoints hit, appended.
+         * @return true if any breakpoint is hit.
+         */
+        bool match(unsigned access, uint64_t addr, uint64_t size, std::vector<breakpoint_handle_t> *hits) const;
+        const std::vector<breakpoint_range_t> &get_ranges() const { return ranges_; }
+    private:
+        std::vector<breakpoint_range_t> ranges_;
+        std::unordered_map<uint64_t, uint8_t> pages_; // page number -> access kinds
+        uint8_t global_;                              // access kinds flagged on all pages
+    };
+} /* ! kz::riscv::core ! */
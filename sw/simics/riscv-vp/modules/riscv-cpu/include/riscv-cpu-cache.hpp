@@ -0,0 +1,168 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kz::riscv::core {
+    class CacheReplacement {
+    public:
+        static const uint8_t LRU = 0;
+        static const uint8_t PLRU = 1;   // tree pseudo-LRU
+        static const uint8_t RANDOM = 2;
+        static const uint8_t NUM = 3;
+    };
+    using cache_replacement_t = CacheReplacement;
+
+    /**
+     * Set-associative cache model, only the tags are simulated. The tags of a set are stored
+     * next to each other, so a lookup touches a single host cache line for up to 8 ways, the
+     * replacement state is kept in separate arrays touched on a hit only by LRU and PLRU.
+     * A write-back cache allocates lines on write misses, a write-through one doesn't and its
+     * writes are assumed to be absorbed by a write buffer, so they never stall.
+     */
+    class RiscvCpuCache {
+    public:
+        static constexpr unsigned MAX_WAYS = 64;
+        RiscvCpuCache();
+        static const char *get_replacement_name(uint8_t replacement);
+        /**
+         * Find the replacement policy with the given name.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param name [M][In] "lru", "plru" or "random".
+         * @param replacement [M][Out] The replacement policy.
+         * @return false if there is no policy with the name.
+         */
+        static bool get_replacement(const std::string &name, uint8_t *replacement);
+        /**
+         * Attach the cache with the given geometry, all lines are invalid.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param size [M][In] Capacity in bytes, a power of two.
+         * @param ways [M][In] Associativity, a power of two up to MAX_WAYS.
+         * @param line_size [M][In] Line size in bytes, a power of two.
+         * @param replacement [M][In] The replacement policy.
+         * @param write_back [M][In] Write-back (true) or write-through (false).
+         * @return false if the geometry is invalid, the cache is left unchanged then.
+         */
+        bool attach(uint64_t size, unsigned ways, unsigned line_size, uint8_t replacement, bool write_back);
+        void detach();
+        bool is_attached() const { return attached_; }
+        /**
+         * Invalidate all lines, the dirty ones are counted as written back.
+         */
+        void invalidate();
+        /**
+         * Simulate the access of the byte at addr.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param addr [M][In] The accessed address.
+         * @param is_write [M][In] Store (true) or load/fetch (false).
+         * @return number of line transfers from/to memory: 0 - hit, 1 - miss, 2 - miss which
+         *     evicted a dirty line.
+         */
+        unsigned access(uint64_t addr, bool is_write) {
+            uint64_t line = addr >> line_shift_;
+            if (is_write) {
+                writes_++;
+            } else {
+                reads_++;
+            }
+            // consecutive accesses of the same line (e.g. sequential fetches) skip the lookup,
+            // the line can only be evicted by a miss, which changes last_line_
+            if (line == last_line_) {
+                if (is_write && write_back_) {
+                    dirty_[last_set_] |= 1ULL << last_way_;
+                }
+                return 0;
+            }
+            size_t set = line & set_mask_;
+            const uint64_t *tags = &tags_[set * ways_];
+            // the ways are compared without branches, a hit way is found with a single bit scan
+            uint64_t hits = 0;
+            for (unsigned way = 0; way < ways_; ++way) {
+                hits |= static_cast<uint64_t>(tags[way] == line) << way;
+            }
+            if (hits == 0) {
+                return miss_(set, line, is_write);
+            }
+            unsigned way = static_cast<unsigned>(__builtin_ctzll(hits));
+            touch_(set, way);
+            if (is_write && write_back_) {
+                dirty_[set] |= 1ULL << way;
+            }
+            remember_(line, set, way);
+            return 0;
+        }
+        uint64_t get_size() const { return static_cast<uint64_t>(sets_) * ways_ << line_shift_; }
+        unsigned get_ways() const { return ways_; }
+        unsigned get_line_size() const { return 1U << line_shift_; }
+        uint8_t get_replacement() const { return replacement_; }
+        bool is_write_back() const { return write_back_; }
+        uint64_t get_reads() const { return reads_; }
+        uint64_t get_read_misses() const { return read_misses_; }
+        uint64_t get_writes() const { return writes_; }
+        uint64_t get_write_misses() const { return write_misses_; }
+        uint64_t get_writebacks() const { return writebacks_; }
+        void clear_stats();
+    private:
+        static constexpr uint64_t INVALID = ~0ULL;
+        unsigned miss_(size_t set, uint64_t line, bool is_write);
+        unsigned victim_(size_t set);
+        void touch_(size_t set, unsigned way) {
+            if (replacement_ == cache_replacement_t::LRU) {
+                stamps_[set * ways_ + way] = ++clock_;
+            } else if (replacement_ == cache_replacement_t::PLRU) {
+                // every node on the path from the root points away from the touched way
+                plru_[set] = (plru_[set] & plru_path_[way]) | plru_away_[way];
+            }
+        }
+        void remember_(uint64_t line, size_t set, unsigned way) {
+            last_line_ = line;
+            last_set_ = set;
+            last_way_ = way;
+        }
+        bool attached_;
+        unsigned ways_;
+        unsigned ways_shift_;
+        unsigned sets_;
+        unsigned line_shift_;
+        uint64_t set_mask_;
+        uint8_t replacement_;
+        bool write_back_;
+        std::vector<uint64_t> tags_;    // line address (addr >> line_shift_) of every way, set by set
+        std::vector<uint64_t> stamps_;  // LRU: time of the last access of every way
+        std::vector<uint64_t> plru_;    // PLRU: tree bits of every set, node n is bit n (1..ways-1)
+        std::array<uint64_t, MAX_WAYS> plru_path_; // PLRU: ~nodes on the path to the way
+        std::array<uint64_t, MAX_WAYS> plru_away_; // PLRU: node bits pointing away from the way
+        std::vector<uint64_t> dirty_;   // dirty ways of every set
+        uint64_t clock_;
+        uint64_t random_;               // xorshift state of the random replacement
+        uint64_t last_line_;
+        size_t last_set_;
+        unsigned last_way_;
+        uint64_t reads_;
+        uint64_t read_misses_;
+        uint64_t writes_;
+        uint64_t write_misses_;
+        uint64_t writebacks_;
+    };
+} /* ! kz::riscv::core ! */
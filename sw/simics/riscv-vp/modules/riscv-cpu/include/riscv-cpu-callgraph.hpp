@@ -0,0 +1,118 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace kz::riscv::core {
+    class CallGraphFunction {
+    public:
+        uint64_t pc;            // entry address
+        uint64_t instructions;  // exclusive cost
+        uint64_t cycles;
+    };
+    using callgraph_function_t = CallGraphFunction;
+
+    class CallGraphCall {
+    public:
+        uint64_t caller;        // entry address of the calling function
+        uint64_t site;          // address of the call instruction
+        uint64_t callee;        // entry address of the called function
+        uint64_t calls;
+        uint64_t instructions;  // inclusive cost of the calls
+        uint64_t cycles;
+    };
+    using callgraph_call_t = CallGraphCall;
+
+    /**
+     * Shadow call stack of the executed program. The CPU reports the calls (JAL/JALR writing
+     * ra) and the returns (jalr x0, 0(ra)) together with its instruction and cycle counters,
+     * the costs are computed from the counter differences, so nothing has to be done for the
+     * other instructions. The exclusive cost of a function is its inclusive cost without the
+     * inclusive costs of its callees. A return to an address which isn't on the stack
+     * (e.g. longjmp) replaces the root function.
+     */
+    class RiscvCpuCallGraph {
+    public:
+        static constexpr size_t MAX_DEPTH = 4096;
+        RiscvCpuCallGraph();
+        /**
+         * Start tracking with an empty stack, the collected costs are kept.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] The current pc, it is taken as the entry of the root function.
+         * @param instructions [M][In] The current instruction counter.
+         * @param cycles [M][In] The current cycle counter.
+         */
+        void start(uint64_t pc, uint64_t instructions, uint64_t cycles);
+        /**
+         * Account the open frames up to the given counters and empty the stack.
+         */
+        void stop(uint64_t instructions, uint64_t cycles);
+        /**
+         * Enter the function called by the instruction at site, the counters include the call.
+         */
+        void call(uint64_t site, uint64_t target, uint64_t instructions, uint64_t cycles);
+        /**
+         * Leave the function returning to target, the counters include the return.
+         */
+        void ret(uint64_t target, uint64_t instructions, uint64_t cycles);
+        /**
+         * Drop the collected costs, the open frames continue from the given counters.
+         */
+        void clear(uint64_t instructions, uint64_t cycles);
+        /**
+         * Get the collected costs, including the open frames accounted up to the counters.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param instructions [M][In] The current instruction counter.
+         * @param cycles [M][In] The current cycle counter.
+         * @param functions [M][Out] Exclusive costs of the functions, sorted by address.
+         * @param calls [M][Out] Inclusive costs of the calls, sorted by caller, site and callee.
+         */
+        void get(uint64_t instructions, uint64_t cycles, std::vector<callgraph_function_t> *functions,
+            std::vector<callgraph_call_t> *calls) const;
+    private:
+        class Frame {
+        public:
+            uint64_t function;
+            uint64_t site;              // the call instruction, unused for the root
+            uint64_t return_pc;
+            uint64_t instructions;      // counters at the entry
+            uint64_t cycles;
+            uint64_t child_instructions;// inclusive costs of the finished callees
+            uint64_t child_cycles;
+        };
+        class Cost {
+        public:
+            uint64_t calls;
+            uint64_t instructions;
+            uint64_t cycles;
+        };
+        using call_key_t = std::tuple<uint64_t, uint64_t, uint64_t>; // caller, site, callee
+        void pop_(uint64_t instructions, uint64_t cycles);
+        std::vector<Frame> stack_;
+        std::unordered_map<uint64_t, Cost> functions_;
+        std::map<call_key_t, Cost> calls_;
+    };
+} /* ! kz::riscv::core ! */
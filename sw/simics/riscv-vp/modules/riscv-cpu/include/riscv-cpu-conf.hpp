@@ -23,13 +23,65 @@
 
 namespace kz::riscv::core {
     static constexpr const char* MODULE_NAME = "riscv-cpu";
-    static constexpr uint8_t ALL_REGS_NUM = 37;
+    static constexpr uint8_t ALL_REGS_NUM = 50; // x0..x31, pc, CSRs and privilege level
     static constexpr uint8_t RV32I_GP_REG_NUM = 32;
     static constexpr uint8_t RAM_ADDR_WIDTH = 16;
     static constexpr uint32_t RAM_SIZE = (1 << RAM_ADDR_WIDTH); /* 64KB */
-    static constexpr uint8_t XLEN = 4;
-    static constexpr uint8_t DATA_SIZE = XLEN;
-    static constexpr uint8_t ADDR_SIZE = XLEN;
-    static constexpr uint8_t INSTR_SIZE = XLEN;
+    static constexpr uint8_t INSTR_SIZE = 4;
     static constexpr uint32_t RESET_ADDR = 0x10000000;
+    // max number of instructions executed between checks for asynchronous events
+    static constexpr uint64_t MAX_BATCH_SIZE = 4096;
+    // default length of the basic block vector (SimPoint) intervals in instructions
+    static constexpr uint64_t BBV_INTERVAL = 10000000;
+    // default length of the working set intervals of the memory profile in instructions
+    static constexpr uint64_t MEM_PROFILE_INTERVAL = 1000000;
+    // default number of cycles charged for a line transfer of the simulated caches
+    static constexpr uint64_t CACHE_MISS_PENALTY = 20;
+    // default number of cycles charged for a mispredicted branch or jump
+    static constexpr uint64_t BRANCH_MISPREDICT_PENALTY = 3;
+    // number of the CPU interrupt ports (bits of the mip register)
+    static constexpr int IRQ_PORTS_NUM = 12;
+    // supported register widths (XLEN) in bits
+    static constexpr unsigned RV32 = 32;
+    static constexpr unsigned RV64 = 64;
+
+    /**
+     * Width dependent types and constants of the base integer ISA. The CPU model is templated
+     * on XLEN and takes everything what depends on the register width from here, so every
+     * instantiation is resolved at compile time without any runtime width checks.
+     */
+    template<unsigned XLEN>
+    class XlenTraits;
+
+    template<>
+    class XlenTraits<RV32> {
+    public:
+        using reg_t = uint32_t;
+        using sreg_t = int32_t;
+        static constexpr uint8_t DATA_SIZE = 4;
+        static constexpr uint8_t ADDR_SIZE = 4;
+        static constexpr uint8_t SHAMT_MASK = 0b11111;
+        // shamt[5] is not a part of func7 for RV32I, so all func7 bits are checked
+        static constexpr uint8_t SHIFT_FUNC7_MASK = 0b1111111;
+        // misa.MXL = 1, the base ISA is 32-bit
+        static constexpr reg_t MISA_MXL = (1U << 30);
+        // pmpaddr holds bits [33:2] of the 34-bit physical address
+        static constexpr uint64_t PMPADDR_MASK = 0xFFFFFFFFULL;
+    };
+
+    template<>
+    class XlenTraits<RV64> {
+    public:
+        using reg_t = uint64_t;
+        using sreg_t = int64_t;
+        static constexpr uint8_t DATA_SIZE = 8;
+        static constexpr uint8_t ADDR_SIZE = 8;
+        static constexpr uint8_t SHAMT_MASK = 0b111111;
+        // the lowest func7 bit of the immediate shift instructions is shamt[5] for RV64I
+        static constexpr uint8_t SHIFT_FUNC7_MASK = 0b1111110;
+        // misa.MXL = 2, the base ISA is 64-bit
+        static constexpr reg_t MISA_MXL = (2ULL << 62);
+        // pmpaddr holds bits [55:2] of the 56-bit physical address
+        static constexpr uint64_t PMPADDR_MASK = 0x003FFFFFFFFFFFFFULL;
+    };
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-custom.hpp"
+
+namespace kz::riscv::core {
+    class CostClass {
+    public:
+        static const uint8_t ALU = 0;               // OP, OP_IMM, LUI, AUIPC, MISC_MEM
+        static const uint8_t BRANCH_TAKEN = 1;      // taken branches, JAL and JALR
+        static const uint8_t BRANCH_NOT_TAKEN = 2;
+        static const uint8_t LOAD = 3;
+        static const uint8_t STORE = 4;
+        static const uint8_t MUL_DIV = 5;           // OP/OP_32 with func7 = 1 (M extension encodings)
+        static const uint8_t CSR = 6;               // SYSTEM: CSR access, ECALL, EBREAK, xRET, WFI
+        static const uint8_t NUM = 7;
+    };
+    using cost_class_t = CostClass;
+
+    /**
+     * Latency table of the timing mode: number of cycles of every operation class, one cycle
+     * is the cost of every instruction in the functional mode. The latencies are resolved into
+     * the predecode cache entries, so the owner must flush the cache when the table changes.
+     * Custom instructions keep the latency they were bound with.
+     */
+    class RiscvCpuCostModel {
+    public:
+        using latencies_t = std::array<uint16_t, cost_class_t::NUM>;
+        RiscvCpuCostModel();
+        static const char *get_class_name(uint8_t cls);
+        /**
+         * Find the operation class with the given name.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param name [M][In] Name of the class, see get_class_name.
+         * @param cls [M][Out] The operation class.
+         * @return false if there is no class with the name.
+         */
+        static bool get_class(const std::string &name, uint8_t *cls);
+        static uint8_t classify(const kz::riscv::types::dec_instr_t &dec_instr);
+        /**
+         * Load the latency table of the preset: "default" (one cycle per instruction) or
+         * "fde_ip" (the HLS fde_ip core, pipelined with II=6, six cycles per instruction).
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param name [M][In] Name of the preset.
+         * @return false if there is no preset with the name.
+         */
+        bool set_preset(const std::string &name);
+        /**
+         * Get the name of the preset the table matches.
+         * @return "custom" if the table doesn't match any preset.
+         */
+        const char *get_preset() const;
+        void set_latency(uint8_t cls, uint16_t cycles) { latencies_[cls] = cycles; }
+        uint16_t get_latency(uint8_t cls) const { return latencies_[cls]; }
+        /**
+         * Resolve the latencies of the predecoded instruction.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         * @param custom [O][In] The custom instruction binding, nullptr if there is none.
+         * @param cycles [M][Out] Cycles of the instruction, of a not taken branch for branches.
+         * @param taken_cycles [M][Out] Cycles of the instruction when the control is transferred.
+         */
+        void resolve(const kz::riscv::types::dec_instr_t &dec_instr, const custom_instr_t *custom,
+            uint16_t *cycles, uint16_t *taken_cycles) const;
+    private:
+        latencies_t latencies_;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,72 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace kz::riscv::core {
+    class CoveragePage {
+    public:
+        static constexpr unsigned WORDS = 16; // one bit per 4-byte slot of a 4 KiB page
+        uint64_t addr;
+        std::array<uint64_t, WORDS> bits;
+    };
+    using coverage_page_t = CoveragePage;
+
+    /**
+     * Code coverage, one bit per 4-byte instruction slot of every executed code page. The
+     * bits are set when an instruction is predecoded, which happens before its first
+     * execution, so the run loop doesn't pay anything for the already covered code. The
+     * owner flushes the predecode cache when the coverage is enabled or cleared, so the
+     * instructions held by the cache are marked again.
+     */
+    class RiscvCpuCoverage {
+    public:
+        static constexpr unsigned PAGE_WIDTH = 12;
+        static constexpr uint64_t PAGE_SIZE = 1ULL << PAGE_WIDTH;
+        /**
+         * Mark the instruction at the given address as executed.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] The address of the instruction.
+         */
+        void mark(uint64_t pc) {
+            uint64_t slot = (pc & (PAGE_SIZE - 1)) >> 2;
+            pages_[pc >> PAGE_WIDTH][slot >> 6] |= 1ULL << (slot & 63);
+        }
+        /**
+         * Set the bits of the given page, the ones already set are kept (used to merge maps).
+         */
+        void merge(const coverage_page_t &page);
+        void clear() { pages_.clear(); }
+        /**
+         * Get the covered pages sorted by the address.
+         */
+        std::vector<coverage_page_t> get() const;
+        /**
+         * Get the number of covered instruction slots.
+         */
+        uint64_t get_covered() const;
+    private:
+        std::unordered_map<uint64_t, std::array<uint64_t, CoveragePage::WORDS>> pages_;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,86 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RISCV_CPU_CUSTOM_IFACE_H
+#define RISCV_CPU_CUSTOM_IFACE_H
+
+#include <simics/device-api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wildcard value for the func3/func7 fields of a custom instruction pattern.
+ */
+#define RISCV_CUSTOM_ANY_FUNC (-1)
+
+/**
+ * Host-native implementation of a custom instruction. The handler is called every time
+ * the bound instruction is executed, the returned value is written back to rd (unless
+ * rd is x0). The raw instruction word is passed to let the handler decode any custom
+ * immediate fields.
+ * M/O - Mandatory/Optional, In/Out - Input/Output.
+ * @param user_data [O][In] Pointer passed to "bind" together with the handler.
+ * @param cpu [M][In] The CPU object executing the instruction.
+ * @param instr [M][In] The raw instruction word.
+ * @param rs1_val [M][In] Value of the rs1 register.
+ * @param rs2_val [M][In] Value of the rs2 register.
+ * @return value to be written to the rd register.
+ */
+typedef uint64 (*riscv_custom_instr_handler_t)(
+    lang_void *user_data,
+    conf_object_t *cpu,
+    uint32 instr,
+    uint64 rs1_val,
+    uint64 rs2_val);
+
+/**
+ * The riscv_custom_instr interface is used by companion modules to bind host-native
+ * implementations to the instruction patterns placed in the CUSTOM_0, CUSTOM_1,
+ * CUSTOM_2_RV128 and CUSTOM_3_RV128 major opcodes. Bindings are resolved when an
+ * instruction is predecoded, so the execution of a bound instruction costs a single
+ * indirect call. Every change of the bindings flushes the predecode cache.
+ *
+ * "bind" returns 0 on success and -1 if the opcode is not a custom one or the pattern
+ * is already bound. "opcode" is the 5-bit major opcode (instr[6:2]), func3 and func7
+ * accept RISCV_CUSTOM_ANY_FUNC to match any value. "latency" is the number of cycles
+ * charged for a single execution of the instruction.
+ *
+ * "unbind" returns 0 on success and -1 if the pattern is not bound.
+ */
+SIM_INTERFACE(riscv_custom_instr) {
+    int (*bind)(
+        conf_object_t *NOTNULL obj,
+        const char *name,
+        uint8 opcode,
+        int func3,
+        int func7,
+        unsigned latency,
+        riscv_custom_instr_handler_t handler,
+        lang_void *user_data);
+    int (*unbind)(conf_object_t *NOTNULL obj, uint8 opcode, int func3, int func7);
+};
+#define RISCV_CUSTOM_INSTR_INTERFACE "riscv_custom_instr"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !RISCV_CPU_CUSTOM_IFACE_H! */
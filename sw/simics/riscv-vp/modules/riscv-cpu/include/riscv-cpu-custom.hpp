@@ -0,0 +1,84 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-custom-iface.h"
+
+namespace kz::riscv::core {
+    class CustomInstr {
+    public:
+        std::string name;
+        uint8_t opcode;
+        int func3;                              // RISCV_CUSTOM_ANY_FUNC matches any value
+        int func7;                              // RISCV_CUSTOM_ANY_FUNC matches any value
+        unsigned latency;                       // cycles charged per execution
+        riscv_custom_instr_handler_t handler;   // host-native implementation
+        lang_void *user_data;                   // passed back to the handler
+    };
+    using custom_instr_t = CustomInstr;
+
+    class RiscvCpuCustom {
+    private:
+        using opcode_t = kz::riscv::types::opcode_t;
+        using dec_instr_t = kz::riscv::types::dec_instr_t;
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        // The bindings are kept in a plain vector, every modification invalidates pointers
+        // handed out by resolve(), so the owner must flush all cached resolutions on change.
+        std::vector<custom_instr_t> instrs_;
+        static bool matches_(int pattern, unsigned value);
+    public:
+        /**
+         * Check if the given major opcode belongs to the custom opcode space.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param opcode [M][In] The 5-bit major opcode.
+         * @return true for CUSTOM_0, CUSTOM_1, CUSTOM_2_RV128 and CUSTOM_3_RV128.
+         */
+        static bool is_custom_opcode(opcode_t opcode);
+        /**
+         * Bind a host-native handler to the (opcode, func3, func7) pattern.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param instr [M][In] The binding description.
+         * @return true on success, false if the opcode isn't a custom one or the pattern
+         *     is already bound.
+         */
+        bool bind(const custom_instr_t &instr);
+        /**
+         * Remove the binding of the (opcode, func3, func7) pattern.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @return true on success, false if the pattern is not bound.
+         */
+        bool unbind(uint8_t opcode, int func3, int func7);
+        /**
+         * Find the binding matching the decoded instruction. Exact func3/func7 matches take
+         * precedence over wildcard ones. It is intended to be called only when an instruction
+         * is predecoded, never on the execution path.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         * @return pointer to the matching binding, nullptr if there is none.
+         */
+        const custom_instr_t *resolve(const dec_instr_t &dec_instr) const;
+        const std::vector<custom_instr_t> &get_instrs() const { return instrs_; }
+    };
+} /* ! kz::riscv::core ! */
@@ -28,6 +28,7 @@ namespace kz::riscv::core {
         using dec_instr_t = kz::riscv::types::dec_instr_t;
         using dec_imm_t = kz::riscv::types::dec_imm_t;
         using operation_type_t = kz::riscv::types::operation_type_t;
+        using operation_code_t = kz::riscv::types::operation_code_t;
         static void dec_instr_(instr_t instr, dec_instr_t *p_dec_instr);
         static void dec_imm_(instr_t instr, dec_instr_t *p_dec_instr);
     public:
@@ -42,5 +43,34 @@ namespace kz::riscv::core {
          * @return pointer to the decoded instruction components.
          */
         static void decode(instr_t instr, dec_instr_t *p_dec_instr);
+        /**
+         * Get the key of the operation of the decoded instruction, built from the opcode and
+         * those func3/func7 (imm[11:0] for the system instructions) bits, which select the
+         * operation, so the register operands and immediates don't change it:
+         * [19:15] opcode, [14:12] func3, [11:0] func7/imm[11:0].
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         * @return the operation key.
+         */
+        static uint32_t get_op_key(const dec_instr_t &dec_instr);
+        /**
+         * Check if the decoded instruction is a call: JAL or JALR writing ra.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         */
+        static bool is_call(const dec_instr_t &dec_instr) {
+            return (dec_instr.opcode == operation_code_t::JAL || dec_instr.opcode == operation_code_t::JALR)
+                && dec_instr.rd == operation_code_t::RA;
+        }
+        /**
+         * Check if the decoded instruction is a return: "jalr x0, 0(ra)", an indirect jump
+         * through ra with an offset is not one (it doesn't go back to the call site).
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         */
+        static bool is_return(const dec_instr_t &dec_instr) {
+            return dec_instr.opcode == operation_code_t::JALR && dec_instr.rd == 0
+                && dec_instr.rs1 == operation_code_t::RA && dec_instr.imm == 0;
+        }
     };
 } /* ! kz::riscv::core ! */
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include "riscv-cpu-types.hpp"
 
 namespace kz::riscv::core {
@@ -31,7 +32,6 @@ namespace kz::riscv::core {
         using dec_instr_t = kz::riscv::types::dec_instr_t;
         using operation_type_t = kz::riscv::types::operation_type_t;
         using operation_code_t = kz::riscv::types::operation_code_t;
-        using addr_t = kz::riscv::types::addr_t;
     public:
         /**
          * Get a string representation of the operation type.
@@ -65,14 +65,29 @@ namespace kz::riscv::core {
          * @return The mnemonic of the instruction as a string.
          */
         static std::string get_mnemonic(opcode_t opcode, dec_instr_t dec_instr);
+        /**
+         * Get the name of the operation of the decoded instruction (see
+         * RiscvCpuDecoder::get_op_key), the pseudo-instructions like li, j or ret are
+         * reported as the base ones, unknown operations as OPCODE/func3/func7.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction structure.
+         * @return The name of the operation.
+         */
+        static std::string get_op_name(dec_instr_t dec_instr);
         /**
          * Disassemble the given decoded instruction into a human-readable assembly
          * instruction string.
          * M/O - Mandatory/Optional, In/Out - Input/Output.
-         * @param pc [M][In] The program counter (address) of the instruction.
+         * @param pc [M][In] The program counter (address) of the instruction, the targets
+         *     of the branches and jumps are printed as absolute addresses.
          * @param dec_instr [M][In] The decoded instruction structure.
          * @return A string representing the disassembled instruction.
          */
-        static std::string disasm(addr_t pc, dec_instr_t dec_instr);
+        static std::string disasm(uint64_t pc, dec_instr_t dec_instr);
+    private:
+        /**
+         * Get the target address of the B-type or J-type instruction at the given address.
+         */
+        static uint64_t get_target_(uint64_t pc, dec_instr_t dec_instr);
     };
 } /* ! kz::riscv::core ! */
@@ -0,0 +1,92 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kz::riscv::core {
+    /**
+     * Connection part of the GDB remote serial protocol stub: the listening socket on the
+     * local host, a single client, the packet framing and the acknowledgements. The sockets
+     * are watched by Simics (SIM_notify_on_socket), so the packets are handled in the global
+     * context, by the CPU. The packets are big (PACKET_SIZE), so the memory of an image is
+     * transferred in a few round trips.
+     */
+    class RiscvCpuGdb {
+    public:
+        static constexpr size_t PACKET_SIZE = 0x20000;
+        static constexpr char INTERRUPT = 0x03;
+        RiscvCpuGdb();
+        ~RiscvCpuGdb();
+        /**
+         * Listen on the port of the local host, the previous connection is closed.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param port [M][In] TCP port.
+         * @return true on success.
+         */
+        bool listen(uint16_t port);
+        /**
+         * Close the client connection and the listening socket.
+         */
+        void close();
+        /**
+         * Accept the pending client, it replaces the connected one.
+         * @return true on success.
+         */
+        bool accept();
+        /**
+         * Close the client connection.
+         */
+        void disconnect();
+        int get_port() const { return port_; }
+        int get_listen_socket() const { return listen_fd_; }
+        int get_client_socket() const { return client_fd_; }
+        bool is_connected() const { return client_fd_ >= 0; }
+        /**
+         * Read the data available on the client socket and extract the complete packets,
+         * the packets are acknowledged (unless in the no-ack mode), the corrupted ones are
+         * rejected, so the client sends them again.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param packets [M][Out] Payloads of the received packets, appended.
+         * @param interrupt [M][Out] Set if the client sent the interrupt request (Ctrl-C).
+         * @return false if the client has disconnected.
+         */
+        bool receive(std::vector<std::string> *packets, bool *interrupt);
+        /**
+         * Send the packet, the special characters of the payload are escaped.
+         */
+        void send(const std::string &payload);
+        /**
+         * Stop sending and expecting the acknowledgements (QStartNoAckMode).
+         */
+        void set_no_ack() { no_ack_ = true; }
+    private:
+        void write_(const char *data, size_t size);
+        int listen_fd_;
+        int client_fd_;
+        int port_;
+        bool no_ack_;
+        std::string input_;     // received data which doesn't form a complete packet yet
+        std::string last_sent_; // the last packet, sent again if the client rejects it
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,104 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace kz::riscv::core {
+    /**
+     * Parts of the run loop the host costs are attributed to.
+     */
+    class HostTier {
+    public:
+        static const uint8_t PLAIN = 0;         // batches without instrumentation
+        static const uint8_t INSTRUMENTED = 1;  // batches feeding profilers, traces or timing models
+        static const uint8_t EVENTS = 2;        // event queues, interrupts and the rest of the loop
+        static const uint8_t NUM = 3;
+        static const char *get_name(uint8_t tier);
+    };
+    using host_tier_t = HostTier;
+
+    /**
+     * Host counters read through perf_event_open.
+     */
+    class HostCounter {
+    public:
+        static const uint8_t TASK_CLOCK = 0;    // nanoseconds, a software counter available everywhere
+        static const uint8_t CYCLES = 1;
+        static const uint8_t INSTRUCTIONS = 2;
+        static const uint8_t BRANCH_MISSES = 3;
+        static const uint8_t L1I_MISSES = 4;
+        static const uint8_t NUM = 5;
+        static const char *get_name(uint8_t counter);
+    };
+    using host_counter_t = HostCounter;
+
+    class HostTierStats {
+    public:
+        uint64_t guest_instructions;
+        std::array<uint64_t, HostCounter::NUM> counters;
+    };
+    using host_tier_stats_t = HostTierStats;
+
+    /**
+     * Self-profiling of the simulator, the counters of the simulation thread are read as one
+     * perf_event_open group at the borders of the run loop parts and the differences are
+     * added to the part just finished. The hardware counters are optional (e.g. virtual
+     * machines often don't expose them), the ones which can't be opened stay at zero.
+     */
+    class RiscvCpuHostProfile {
+    public:
+        RiscvCpuHostProfile();
+        ~RiscvCpuHostProfile();
+        /**
+         * Open the counters of the calling thread.
+         * @return false if perf_event_open isn't available, true otherwise.
+         */
+        bool open();
+        void close();
+        bool is_open() const { return fds_[0] >= 0; }
+        /**
+         * Check if the counter was opened, the result of the last open() is kept after close().
+         */
+        bool is_available(uint8_t counter) const { return index_[counter] >= 0; }
+        /**
+         * Take the current counter values as the start of the next part.
+         */
+        void mark();
+        /**
+         * Add the counter differences since the previous mark to the given tier.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param tier [M][In] The finished part of the run loop, see HostTier.
+         * @param guest_instructions [M][In] Number of the guest instructions executed in it.
+         */
+        void account(uint8_t tier, uint64_t guest_instructions);
+        void clear();
+        const host_tier_stats_t &get_stats(uint8_t tier) const { return stats_[tier]; }
+    private:
+        bool read_(std::array<uint64_t, HostCounter::NUM> *values) const;
+        std::array<int, HostCounter::NUM> fds_;
+        std::array<int, HostCounter::NUM> index_;   // position of the counter in the group read, -1 if not open
+        unsigned opened_;
+        std::array<uint64_t, HostCounter::NUM> last_;
+        std::array<host_tier_stats_t, HostTier::NUM> stats_;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace kz::riscv::core {
+    /**
+     * Host-target interface (HTIF) used by Spike binaries (riscv-tests, benchmarks linked with
+     * spike.lds): the target writes a command to the 64-bit tohost location, the host clears it
+     * and posts the response to fromhost. Command layout: device [63:56], cmd [55:48],
+     * payload [47:0].
+     */
+    class Htif {
+    public:
+        static constexpr unsigned DEVICE_SHIFT = 56;
+        static constexpr unsigned CMD_SHIFT = 48;
+        static constexpr uint64_t PAYLOAD_MASK = (1ULL << CMD_SHIFT) - 1;
+        // device 0: payload bit 0 set - exit with the code payload >> 1, otherwise the payload
+        // is the address of the "magic memory" (8 x 64-bit, syscall number and arguments)
+        static constexpr uint8_t DEV_SYSCALL = 0;
+        // device 1: blocking console, cmd 1 writes the character from payload [7:0]
+        static constexpr uint8_t DEV_CONSOLE = 1;
+        static constexpr uint8_t CMD_PUTCHAR = 1;
+        static constexpr unsigned MAGIC_MEM_SIZE = 8;
+        static constexpr uint64_t SYS_WRITE = 64;
+        static constexpr uint64_t SYS_EXIT = 93;
+        // SYS_WRITE file descriptors, both are written to the Simics console
+        static constexpr uint64_t STDOUT_FD = 1;
+        static constexpr uint64_t STDERR_FD = 2;
+    };
+    using htif_t = Htif;
+
+    /**
+     * RISC-V semihosting: EBREAK surrounded by the "slli x0, x0, 0x1f" and "srai x0, x0, 7"
+     * markers is a host call, a0 holds the operation number, a1 the argument (usually the
+     * address of a block of XLEN-wide arguments), the result is returned in a0. Operation
+     * numbers follow the Arm semihosting specification.
+     */
+    class Semihosting {
+    public:
+        static constexpr uint32_t ENTRY_INSTR = 0x01F01013; // slli x0, x0, 0x1f
+        static constexpr uint32_t EXIT_INSTR = 0x40705013;  // srai x0, x0, 7
+        static constexpr uint8_t SYS_OPEN = 0x01;
+        static constexpr uint8_t SYS_WRITEC = 0x03;
+        static constexpr uint8_t SYS_WRITE0 = 0x04;
+        static constexpr uint8_t SYS_WRITE = 0x05;
+        static constexpr uint8_t SYS_CLOCK = 0x10;
+        static constexpr uint8_t SYS_EXIT = 0x18;
+        static constexpr uint8_t SYS_EXIT_EXTENDED = 0x20;
+        // SYS_OPEN(":tt") handles of stdout and stderr, both are written to the Simics console
+        static constexpr uint64_t STDOUT_HANDLE = 2;
+        static constexpr uint64_t STDERR_HANDLE = 3;
+        // SYS_EXIT reason of the normal program termination
+        static constexpr uint64_t ADP_STOPPED_APPLICATION_EXIT = 0x20026;
+    };
+    using semihosting_t = Semihosting;
+} /* ! kz::riscv::core ! */
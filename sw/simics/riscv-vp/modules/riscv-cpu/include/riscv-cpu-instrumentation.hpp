@@ -0,0 +1,217 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <simics/device-api.h>
+#include <simics/model-iface/cpu-instrumentation.h>
+
+namespace kz::riscv::core {
+    /**
+     * Kinds of the instrumentation callbacks, the first six ones can be registered for
+     * a single instruction too (cpu_cached_instruction interface).
+     */
+    class InstrumentationKind {
+    public:
+        static const uint8_t INSTRUCTION_BEFORE = 0;
+        static const uint8_t INSTRUCTION_AFTER = 1;
+        static const uint8_t READ_BEFORE = 2;
+        static const uint8_t READ_AFTER = 3;
+        static const uint8_t WRITE_BEFORE = 4;
+        static const uint8_t WRITE_AFTER = 5;
+        static const uint8_t HOOK_NUM = 6;
+        static const uint8_t EXCEPTION_BEFORE = 6;
+        static const uint8_t CACHED_INSTRUCTION = 7;
+        static const uint8_t NUM = 8;
+    };
+    using instrumentation_kind_t = InstrumentationKind;
+
+    union InstrumentationFunc {
+        cpu_instruction_cb_t instruction;
+        cpu_memory_cb_t memory;
+        cpu_exception_cb_t exception;
+        cpu_cached_instruction_cb_t cached;
+    };
+    using instrumentation_func_t = InstrumentationFunc;
+
+    class InstrumentationConnection {
+    public:
+        conf_object_t *obj;
+        bool enabled;
+        bool removed;           // dropped once no callback is running
+    };
+    using instrumentation_connection_t = InstrumentationConnection;
+
+    class InstrumentationCallback {
+    public:
+        instrumentation_connection_t *connection;
+        uint8_t kind;
+        int exception;          // EXCEPTION_BEFORE: exception number or CPU_Exception_All
+        instrumentation_func_t func;
+        lang_void *data;
+        bool enabled;
+        bool removed;           // dropped once no callback is running
+    };
+    using instrumentation_callback_t = InstrumentationCallback;
+
+    /**
+     * Callbacks registered for a single predecoded instruction.
+     */
+    class InstrumentationHooks {
+    public:
+        class Hook {
+        public:
+            instrumentation_connection_t *connection;
+            instrumentation_func_t func;
+            lang_void *data;
+            cpu_callback_free_user_data_cb_t free_cb;
+        };
+        class Counter {
+        public:
+            instrumentation_connection_t *connection;
+            uint64 *value;
+            bool atomic;
+        };
+        std::array<std::vector<Hook>, InstrumentationKind::HOOK_NUM> hooks;
+        std::vector<Counter> counters;
+        conf_object_t *cpu;
+        instrumentation_connection_t *connection; // of the cached instruction callback registering hooks
+        bool empty() const {
+            return counters.empty() &&
+                std::all_of(hooks.begin(), hooks.end(), [](const auto &kind) { return kind.empty(); });
+        }
+    };
+    using instrumentation_hooks_t = InstrumentationHooks;
+
+    // the objects behind the query handles passed to the callbacks
+    class InstrumentationInstr {
+    public:
+        uint64_t pc;
+        uint32_t instr;
+    };
+    using instrumentation_instr_t = InstrumentationInstr;
+
+    class InstrumentationAccess {
+    public:
+        uint64_t addr;
+        unsigned size;
+        size_t bytes_size;      // 0 if the bytes aren't known (a load before it's done, a device)
+        uint8_t bytes[8];
+    };
+    using instrumentation_access_t = InstrumentationAccess;
+
+    class InstrumentationException {
+    public:
+        int number;
+        uint64_t fault_pc;
+    };
+    using instrumentation_exception_t = InstrumentationException;
+
+    /**
+     * Subscriptions of the cpu_instrumentation_subscribe interface. Every change rebuilds
+     * the per-kind tables of the enabled callbacks, so the dispatch is a loop over a table,
+     * and the CPU runs the plain batches (see RiscvCpu::update_instrumentation_) when all
+     * the tables are empty. The callbacks of single instructions are collected when an
+     * instruction is predecoded and kept with the predecoded instruction, so only the
+     * instrumented instructions pay for them. Callbacks can subscribe and unsubscribe from
+     * within a callback, the tables are rebuilt and the released callbacks of single
+     * instructions are freed when the dispatch is over then.
+     */
+    class RiscvCpuInstrumentation {
+    public:
+        // the exception numbers are the trap causes, interrupts are numbered from here
+        static const int INTERRUPT_BASE = 64;
+        RiscvCpuInstrumentation() : active_(false), dispatching_(0), dirty_(false) {}
+        ~RiscvCpuInstrumentation();
+        /**
+         * Register the callback, the connection is enabled if it's seen for the first time.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param connection [O][In] The connection object of the tool, may be NULL.
+         * @param callback [M][In] The callback, its connection field is filled here.
+         * @return handle of the callback.
+         */
+        cpu_cb_handle_t *add(conf_object_t *connection, instrumentation_callback_t callback);
+        /**
+         * Remove or enable/disable the callback, @return false if the handle is unknown.
+         */
+        bool remove(cpu_cb_handle_t *handle);
+        bool enable(cpu_cb_handle_t *handle, bool enabled);
+        /**
+         * Remove or enable/disable all callbacks of the connection, including the ones of
+         * single instructions.
+         */
+        void remove_connection(conf_object_t *connection);
+        void enable_connection(conf_object_t *connection, bool enabled);
+        bool is_active() const { return active_; }
+        bool has(uint8_t kind) const { return !tables_[kind].empty(); }
+        void instruction(uint8_t kind, conf_object_t *cpu, instrumentation_instr_t *instr);
+        void memory(uint8_t kind, conf_object_t *cpu, instrumentation_access_t *access);
+        void exception(conf_object_t *cpu, instrumentation_exception_t *exception);
+        /**
+         * Let the cached instruction callbacks register the callbacks of the predecoded
+         * instruction.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param cpu [M][In] The CPU object.
+         * @param instr [M][In] The predecoded instruction.
+         * @return the callbacks of the instruction, nullptr if there are none.
+         */
+        instrumentation_hooks_t *cache_instruction(conf_object_t *cpu, instrumentation_instr_t *instr);
+        /**
+         * Drop the callbacks of an instruction leaving the predecode cache, the caller
+         * forgets the pointer.
+         */
+        void release(instrumentation_hooks_t *hooks);
+        void run_instruction_hooks(const instrumentation_hooks_t &hooks, uint8_t kind,
+            instrumentation_instr_t *instr);
+        void run_memory_hooks(const instrumentation_hooks_t &hooks, uint8_t kind,
+            instrumentation_access_t *access);
+    private:
+        void update_();
+        void update_active_();
+        void free_(instrumentation_hooks_t *hooks);
+        void begin_dispatch_() { dispatching_++; }
+        void end_dispatch_() {
+            if (--dispatching_ == 0) {
+                for (instrumentation_hooks_t *hooks : released_) {
+                    free_(hooks);
+                }
+                released_.clear();
+                if (dirty_) {
+                    update_();
+                }
+            }
+        }
+        std::unordered_map<conf_object_t *, instrumentation_connection_t> connections_;
+        std::list<instrumentation_callback_t> callbacks_;
+        std::array<std::vector<const instrumentation_callback_t *>, InstrumentationKind::NUM> tables_;
+        std::unordered_set<instrumentation_hooks_t *> hooks_;
+        std::vector<instrumentation_hooks_t *> released_; // freed when the dispatch is over
+        bool active_;
+        unsigned dispatching_;  // nesting level of the running callbacks
+        bool dirty_;            // the tables are rebuilt when the dispatch is over
+    };
+} /* ! kz::riscv::core ! */
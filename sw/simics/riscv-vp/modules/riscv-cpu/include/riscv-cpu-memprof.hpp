@@ -0,0 +1,91 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace kz::riscv::core {
+    class MemPage {
+    public:
+        uint64_t addr;
+        uint64_t reads;         // sampled accesses
+        uint64_t writes;
+        uint64_t first_touch;   // instruction count of the first and the last sampled access
+        uint64_t last_touch;
+    };
+    using mem_page_t = MemPage;
+
+    /**
+     * Page-granular profile of the data accesses. Every Nth load or store is sampled, the
+     * sampled accesses are counted per page together with the instruction counts of the
+     * first and the last touch, and the distinct pages touched in every interval of
+     * instructions give the working set. The countdown is owned by the CPU, so an access
+     * which is not sampled costs a decrement and a branch.
+     */
+    class RiscvCpuMemProfile {
+    public:
+        static constexpr unsigned PAGE_WIDTH = 12;
+        static constexpr uint64_t NO_SAMPLING = ~0ULL;
+        RiscvCpuMemProfile();
+        /**
+         * Set the sampling period (0 disables the sampling) and the length of the working
+         * set intervals (0 disables the working set), the collected data is cleared.
+         */
+        void configure(uint64_t period, uint64_t interval);
+        uint64_t get_period() const { return period_; }
+        uint64_t get_interval() const { return interval_; }
+        /**
+         * Get the countdown to the next sampled access, NO_SAMPLING if the sampling is disabled.
+         */
+        uint64_t get_countdown() const { return period_ != 0 ? period_ : NO_SAMPLING; }
+        /**
+         * Count the sampled access.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param write [M][In] True for a store, false for a load.
+         * @param addr [M][In] Address of the access.
+         * @param step [M][In] Number of the instructions executed so far.
+         */
+        void sample(bool write, uint64_t addr, uint64_t step);
+        void clear();
+        /**
+         * Get the touched pages sorted by the address.
+         */
+        std::vector<mem_page_t> get_pages() const;
+        /**
+         * Get the number of the distinct pages touched in every interval.
+         */
+        const std::vector<uint64_t> &get_working_set() const { return working_set_; }
+    private:
+        class PageStats {
+        public:
+            uint64_t reads;
+            uint64_t writes;
+            uint64_t first_touch;
+            uint64_t last_touch;
+            uint64_t last_interval; // the interval the page was last counted in the working set
+        };
+        uint64_t period_;
+        uint64_t interval_;
+        std::unordered_map<uint64_t, PageStats> pages_;
+        std::vector<uint64_t> working_set_;
+    };
+} /* ! kz::riscv::core ! */
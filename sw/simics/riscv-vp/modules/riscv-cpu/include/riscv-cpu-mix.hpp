@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-custom.hpp"
+
+namespace kz::riscv::core {
+    class MixCounter {
+    public:
+        std::string mnemonic;
+        kz::riscv::types::op_type_t type;   // instruction format
+        uint64_t executions;
+    };
+    using mix_counter_t = MixCounter;
+
+    /**
+     * Dynamic instruction mix. Every operation (see RiscvCpuDecoder::get_op_key) gets an id
+     * on the first predecode, the id is kept in the predecode cache entry, counting an
+     * executed instruction is then a single increment with no lookup.
+     */
+    class RiscvCpuInstrMix {
+    private:
+        using dec_instr_t = kz::riscv::types::dec_instr_t;
+        using op_type_t = kz::riscv::types::op_type_t;
+        using operation_type_t = kz::riscv::types::operation_type_t;
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        // the ids are indices of counters_, entries are never removed, so the ids held by
+        // the predecode cache stay valid when the counters are cleared
+        std::vector<mix_counter_t> counters_;
+        std::unordered_map<uint32_t, uint32_t> ids_;
+        static uint32_t get_key_(const dec_instr_t &dec_instr, const custom_instr_t *custom);
+    public:
+        /**
+         * Get the id of the operation of the decoded instruction, a new counter is created
+         * for an operation seen for the first time.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param dec_instr [M][In] The decoded instruction.
+         * @param custom [O][In] The custom instruction binding, nullptr if there is none.
+         * @return id of the operation, to be passed to count().
+         */
+        uint32_t resolve(const dec_instr_t &dec_instr, const custom_instr_t *custom);
+        void count(uint32_t id) { counters_[id].executions++; }
+        /**
+         * Reset all execution counts, the ids remain valid.
+         */
+        void clear();
+        /**
+         * Get the executed operations sorted by the number of executions, the most frequent first.
+         */
+        std::vector<mix_counter_t> get_sorted() const;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,95 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace kz::riscv::core {
+    /**
+     * Physical Memory Protection unit, 16 entries. The unit only keeps the pmpcfg/pmpaddr state
+     * and answers which permissions apply to the given physical range for the given privilege
+     * level. It is not consulted on every access, the CPU folds the answer into its page cache
+     * (RiscvCpuTlb) entries and flushes them whenever the PMP configuration changes.
+     */
+    class RiscvCpuPmp {
+    public:
+        static constexpr unsigned ENTRIES_NUM = 16;
+        // pmpcfg fields
+        static constexpr uint8_t R = 0x01;
+        static constexpr uint8_t W = 0x02;
+        static constexpr uint8_t X = 0x04;
+        static constexpr uint8_t RWX = R | W | X;
+        static constexpr unsigned A_SHIFT = 3;
+        static constexpr uint8_t A_MASK = (0b11 << A_SHIFT);
+        static constexpr uint8_t L = 0x80;
+        // address matching modes (pmpcfg.A)
+        static constexpr uint8_t A_OFF = 0;
+        static constexpr uint8_t A_TOR = 1;
+        static constexpr uint8_t A_NA4 = 2;
+        static constexpr uint8_t A_NAPOT = 3;
+
+        RiscvCpuPmp();
+        /**
+         * Turn off and unlock all entries.
+         */
+        void reset();
+        uint8_t get_cfg(unsigned idx) const { return cfg_[idx]; }
+        uint64_t get_addr(unsigned idx) const { return addr_[idx]; }
+        /**
+         * Write pmpcfg of the entry, writes to locked entries are ignored.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param idx [M][In] Entry number.
+         * @param cfg [M][In] New configuration.
+         * @return true if the configuration has changed.
+         */
+        bool set_cfg(unsigned idx, uint8_t cfg);
+        /**
+         * Write pmpaddr of the entry (physical address bits [55:2]), writes are ignored if the
+         * entry is locked, or the next entry is a locked TOR entry using it as a bottom bound.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param idx [M][In] Entry number.
+         * @param addr [M][In] New address.
+         * @return true if the address has changed.
+         */
+        bool set_addr(unsigned idx, uint64_t addr);
+        /**
+         * Find permissions of the privilege level to all bytes of the physical range.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param start [M][In] The first address of the range.
+         * @param size [M][In] Size of the range in bytes.
+         * @param priv [M][In] Privilege level of the access.
+         * @param uniform [M][Out] Set to false if the highest priority entry matching the range
+         *     doesn't cover all of its bytes, such range is not accessible as a whole, however
+         *     its smaller parts may be.
+         * @return the R/W/X mask.
+         */
+        uint8_t get_perms(uint64_t start, uint64_t size, uint8_t priv, bool *uniform) const;
+    private:
+        std::array<uint8_t, ENTRIES_NUM> cfg_;
+        std::array<uint64_t, ENTRIES_NUM> addr_;
+        /**
+         * Compute the [lo, hi) range of the entry.
+         * @return false if the entry is turned off.
+         */
+        bool get_range_(unsigned idx, uint64_t *lo, uint64_t *hi) const;
+    };
+    using pmp_t = RiscvCpuPmp;
+} /* ! kz::riscv::core ! */
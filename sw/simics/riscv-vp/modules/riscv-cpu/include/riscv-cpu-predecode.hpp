@@ -0,0 +1,99 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-custom.hpp"
+
+namespace kz::riscv::core {
+    class InstrumentationHooks;
+    class RiscvCpuInstrumentation;
+
+    class PredecodedInstr {
+    public:
+        uint64_t pc;                            // address of the instruction | privilege level (cache tag)
+        bool valid;
+        kz::riscv::types::instr_t instr;        // raw instruction word
+        kz::riscv::types::dec_instr_t dec_instr;
+        const custom_instr_t *custom;           // custom instruction binding, resolved on fill
+        bool ends_block;                        // control transfer or system instruction, resolved on fill
+        uint32_t mix_id;                        // operation id in the instruction mix, resolved on fill
+        uint16_t cycles;                        // timing mode latency (not taken branch), resolved on fill
+        uint16_t taken_cycles;                  // timing mode latency of a control transfer, resolved on fill
+        bool breakpoint;                        // the page has an execution breakpoint, resolved on fill
+        InstrumentationHooks *hooks;            // instrumentation callbacks of the instruction, released on eviction
+    };
+    using predecoded_instr_t = PredecodedInstr;
+
+    /**
+     * Direct-mapped cache of decoded instructions indexed by the program counter. The cache
+     * removes fetch and decode from the execution path of already visited code, everything
+     * what can be derived from the instruction word alone is resolved once, when the entry
+     * is filled. The owner is responsible for flushing entries when the memory they were
+     * fetched from changes. The instrumentation callbacks of an entry are released when it's
+     * evicted or flushed.
+     */
+    class RiscvCpuPredecode {
+    public:
+        static constexpr unsigned ENTRIES_WIDTH = 12;
+        static constexpr unsigned ENTRIES_NUM = (1 << ENTRIES_WIDTH); /* 4096 instructions */
+
+        /**
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param instrumentation [M][In] Owner of the instrumentation callbacks of the entries.
+         */
+        explicit RiscvCpuPredecode(RiscvCpuInstrumentation *instrumentation);
+        /**
+         * Find the predecoded instruction at the given address.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] The address of the instruction.
+         * @return pointer to the entry, nullptr on cache miss.
+         */
+        predecoded_instr_t *lookup(uint64_t pc) {
+            predecoded_instr_t *entry = &entries_[index_(pc)];
+            return (entry->valid && entry->pc == pc) ? entry : nullptr;
+        }
+        /**
+         * Claim the entry for the given address, the previous content is evicted.
+         * The caller has to fill the instruction related fields.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] The address of the instruction.
+         * @return pointer to the claimed entry.
+         */
+        predecoded_instr_t *fill(uint64_t pc);
+        /**
+         * Invalidate all entries.
+         */
+        void flush();
+        /**
+         * Invalidate entries of instructions placed in the [start, start + size) range.
+         */
+        void flush_range(uint64_t start, uint64_t size);
+    private:
+        // instructions are 4-byte aligned (no C extension), so the two lowest bits are skipped
+        static size_t index_(uint64_t pc) { return (pc >> 2) & (ENTRIES_NUM - 1); }
+        void release_hooks_(predecoded_instr_t *entry);
+        RiscvCpuInstrumentation *instrumentation_;
+        std::array<predecoded_instr_t, ENTRIES_NUM> entries_;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,139 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace kz::riscv::core {
+    class Privilege {
+    public:
+        static const uint8_t U = 0b00; // user/application
+        static const uint8_t S = 0b01; // supervisor
+        static const uint8_t M = 0b11; // machine
+        static const uint8_t NUM = 4;  // number of encodings, 0b10 is reserved
+    };
+    using privilege_t = Privilege;
+
+    class CsrAddr {
+    public:
+        // unprivileged counters/timers
+        static const uint16_t CYCLE = 0xC00;
+        static const uint16_t TIME = 0xC01;
+        static const uint16_t INSTRET = 0xC02;
+        static const uint16_t CYCLEH = 0xC80;
+        static const uint16_t TIMEH = 0xC81;
+        static const uint16_t INSTRETH = 0xC82;
+        // supervisor level
+        static const uint16_t SSTATUS = 0x100;
+        static const uint16_t SIE = 0x104;
+        static const uint16_t STVEC = 0x105;
+        static const uint16_t SCOUNTEREN = 0x106;
+        static const uint16_t SSCRATCH = 0x140;
+        static const uint16_t SEPC = 0x141;
+        static const uint16_t SCAUSE = 0x142;
+        static const uint16_t STVAL = 0x143;
+        static const uint16_t SIP = 0x144;
+        static const uint16_t SATP = 0x180;
+        // machine level
+        static const uint16_t MVENDORID = 0xF11;
+        static const uint16_t MARCHID = 0xF12;
+        static const uint16_t MIMPID = 0xF13;
+        static const uint16_t MHARTID = 0xF14;
+        static const uint16_t MSTATUS = 0x300;
+        static const uint16_t MISA = 0x301;
+        static const uint16_t MEDELEG = 0x302;
+        static const uint16_t MIDELEG = 0x303;
+        static const uint16_t MIE = 0x304;
+        static const uint16_t MTVEC = 0x305;
+        static const uint16_t MCOUNTEREN = 0x306;
+        static const uint16_t MSTATUSH = 0x310;
+        static const uint16_t MSCRATCH = 0x340;
+        static const uint16_t MEPC = 0x341;
+        static const uint16_t MCAUSE = 0x342;
+        static const uint16_t MTVAL = 0x343;
+        static const uint16_t MIP = 0x344;
+        static const uint16_t PMPCFG0 = 0x3A0;
+        static const uint16_t PMPCFG15 = 0x3AF;
+        static const uint16_t PMPADDR0 = 0x3B0;
+        static const uint16_t PMPADDR15 = 0x3BF;
+        static const uint16_t MCYCLE = 0xB00;
+        static const uint16_t MINSTRET = 0xB02;
+        static const uint16_t MCYCLEH = 0xB80;
+        static const uint16_t MINSTRETH = 0xB82;
+    };
+    using csr_addr_t = CsrAddr;
+
+    class Mstatus {
+    public:
+        static const uint64_t SIE = (1ULL << 1);
+        static const uint64_t MIE = (1ULL << 3);
+        static const uint64_t SPIE = (1ULL << 5);
+        static const uint64_t MPIE = (1ULL << 7);
+        static const uint64_t SPP = (1ULL << 8);
+        static const unsigned MPP_SHIFT = 11;
+        static const uint64_t MPP = (0b11ULL << MPP_SHIFT);
+        static const uint64_t MPRV = (1ULL << 17);
+        static const uint64_t SUM = (1ULL << 18);
+        static const uint64_t MXR = (1ULL << 19);
+        static const uint64_t TVM = (1ULL << 20);
+        static const uint64_t TW = (1ULL << 21);
+        static const uint64_t TSR = (1ULL << 22);
+        // RV64 only, U-mode and S-mode XLEN, hardwired to 64-bit
+        static const uint64_t UXL_SXL_64 = (0b10ULL << 32) | (0b10ULL << 34);
+        // writable fields of the mstatus and its sstatus restricted view
+        static const uint64_t MSTATUS_MASK = SIE | MIE | SPIE | MPIE | SPP | MPP | MPRV | SUM | MXR | TVM | TW | TSR;
+        static const uint64_t SSTATUS_MASK = SIE | SPIE | SPP | SUM | MXR;
+    };
+    using mstatus_t = Mstatus;
+
+    class Interrupt {
+    public:
+        // bits of the mip/mie (sip/sie) registers
+        static const uint64_t SSIP = (1ULL << 1);
+        static const uint64_t MSIP = (1ULL << 3);
+        static const uint64_t STIP = (1ULL << 5);
+        static const uint64_t MTIP = (1ULL << 7);
+        static const uint64_t SEIP = (1ULL << 9);
+        static const uint64_t MEIP = (1ULL << 11);
+        static const uint64_t S_MASK = SSIP | STIP | SEIP;
+        static const uint64_t M_MASK = MSIP | MTIP | MEIP;
+        static const uint64_t ALL_MASK = S_MASK | M_MASK;
+    };
+    using interrupt_t = Interrupt;
+
+    class TrapCause {
+    public:
+        // synchronous exceptions, interrupts have the most significant (XLEN - 1) bit set
+        static const uint8_t INSTR_MISALIGNED = 0;
+        static const uint8_t INSTR_ACCESS_FAULT = 1;
+        static const uint8_t ILLEGAL_INSTR = 2;
+        static const uint8_t BREAKPOINT = 3;
+        static const uint8_t LOAD_MISALIGNED = 4;
+        static const uint8_t LOAD_ACCESS_FAULT = 5;
+        static const uint8_t STORE_MISALIGNED = 6;
+        static const uint8_t STORE_ACCESS_FAULT = 7;
+        static const uint8_t ECALL_U = 8;
+        static const uint8_t ECALL_S = 9;
+        static const uint8_t ECALL_M = 11;
+        // exceptions which can be delegated to S-mode with medeleg (all up to ECALL_S)
+        static const uint64_t DELEG_MASK = ((1ULL << (ECALL_S + 1)) - 1);
+    };
+    using trap_cause_t = TrapCause;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,94 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kz::riscv::core {
+    class ProfileEntry {
+    public:
+        uint64_t pc;            // address of the first instruction of the block, EMPTY_PC if free
+        uint64_t executions;    // number of times the block was entered
+        uint64_t instructions;  // number of instructions executed in the block
+        uint32_t length;        // the longest observed length of the block in instructions
+    };
+    using profile_entry_t = ProfileEntry;
+
+    /**
+     * Execution counts of the basic blocks, kept in an open-addressing hash table (linear
+     * probing) keyed by the address of the first instruction of the block. A block ends with
+     * a control transfer instruction (see PredecodedInstr::ends_block) or when the execution
+     * doesn't continue at the next instruction (trap, interrupt).
+     */
+    class RiscvCpuProfiler {
+    public:
+        static constexpr uint64_t EMPTY_PC = ~0ULL; // never a valid, 4-byte aligned pc
+        static constexpr size_t INITIAL_WIDTH = 10;  // 1024 blocks
+
+        RiscvCpuProfiler();
+        /**
+         * Count a single execution of the block.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the first instruction of the block.
+         * @param length [M][In] Number of instructions executed in the block.
+         */
+        void add(uint64_t pc, uint32_t length) {
+            profile_entry_t *entry = find_(pc);
+            if (entry->pc == EMPTY_PC) {
+                entry = insert_(pc);
+            }
+            entry->executions++;
+            entry->instructions += length;
+            if (length > entry->length) {
+                entry->length = length;
+            }
+        }
+        /**
+         * Add the counters of the block, used to restore the profile from the attribute.
+         */
+        void merge(const profile_entry_t &block);
+        /**
+         * Remove all blocks.
+         */
+        void clear();
+        /**
+         * Get all blocks sorted by the number of executed instructions, the hottest first.
+         */
+        std::vector<profile_entry_t> get_sorted() const;
+    private:
+        profile_entry_t *find_(uint64_t pc) {
+            size_t mask = entries_.size() - 1;
+            size_t index = hash_(pc) & mask;
+            while (entries_[index].pc != pc && entries_[index].pc != EMPTY_PC) {
+                index = (index + 1) & mask;
+            }
+            return &entries_[index];
+        }
+        static size_t hash_(uint64_t pc) {
+            // Fibonacci hashing, the upper bits of the product are the best mixed ones
+            return static_cast<size_t>(((pc >> 2) * 0x9E3779B97F4A7C15ULL) >> 32);
+        }
+        profile_entry_t *insert_(uint64_t pc);
+        std::vector<profile_entry_t> entries_;
+        size_t used_;
+    };
+} /* ! kz::riscv::core ! */
@@ -65,6 +65,7 @@ namespace kz::riscv::core {
         bool add(attr_value_t *ev);
         int is_empty() const;
         void decrement(simtime_t delta);
+        // clocks until the next event (the queue is ordered by delta), -1 if it's empty
         simtime_t get_delta() const;
         void handle_next();
         attr_value_t to_attr_list(simtime_t start) const;
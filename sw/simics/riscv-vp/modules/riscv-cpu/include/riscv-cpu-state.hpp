@@ -17,6 +17,8 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#pragma once
+
 namespace kz::riscv::core {
     enum class ExecuteState {
         Idle,
@@ -24,4 +26,16 @@ namespace kz::riscv::core {
         Stopped
     };
     using execute_state_t = ExecuteState;
+
+    /**
+     * Simulation mode of the CPU: Functional runs every instruction in one cycle without any
+     * timing model, Warmup trains the timing models (caches, branch predictors) without
+     * charging their latencies and Timing charges them.
+     */
+    enum class SimMode {
+        Functional,
+        Warmup,
+        Timing
+    };
+    using sim_mode_t = SimMode;
 } /* ! kz::riscv::core ! */
\ No newline at end of file
@@ -0,0 +1,111 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "riscv-cpu-state.hpp"
+
+namespace kz::riscv::core {
+    /**
+     * Schedule of the simulation mode switches and the statistics of the measurement windows
+     * (the periods spent in the timing mode). The switches are kept ordered by the step they
+     * are due at, so the run loop only checks the first one.
+     */
+    class RiscvCpuTiming {
+    public:
+        static constexpr uint64_t NO_SWITCH = ~0ULL;
+        RiscvCpuTiming();
+        /**
+         * Get the name of the mode used by the attributes and the CLI.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param mode [M][In] The simulation mode.
+         * @return "functional", "warmup" or "timing".
+         */
+        static const char *get_mode_name(sim_mode_t mode);
+        /**
+         * Find the mode with the given name.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param name [M][In] Name of the mode, see get_mode_name.
+         * @param mode [M][Out] The simulation mode.
+         * @return false if there is no mode with the name.
+         */
+        static bool get_mode(const std::string &name, sim_mode_t *mode);
+        /**
+         * Schedule the switch to the mode, it replaces the switch scheduled at the same step.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param step [M][In] Step count the switch is due at.
+         * @param mode [M][In] The new simulation mode.
+         */
+        void schedule(uint64_t step, sim_mode_t mode) { schedule_[step] = mode; }
+        void clear_schedule() { schedule_.clear(); }
+        const std::map<uint64_t, sim_mode_t> &get_schedule() const { return schedule_; }
+        /**
+         * Get the step of the first scheduled switch.
+         * @return NO_SWITCH if nothing is scheduled.
+         */
+        uint64_t get_next_switch() const {
+            return schedule_.empty() ? NO_SWITCH : schedule_.begin()->first;
+        }
+        /**
+         * Remove the first scheduled switch if it is due.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param step [M][In] The current step count.
+         * @param mode [M][Out] Mode of the removed switch.
+         * @return false if no switch is due.
+         */
+        bool pop_due(uint64_t step, sim_mode_t *mode);
+        /**
+         * Open the measurement window, the counters passed here and to end_window are the
+         * totals of the CPU, the window accounts the difference.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param steps [M][In] The current step count.
+         * @param cycles [M][In] The current cycle count, including the pending stall cycles.
+         */
+        void begin_window(uint64_t steps, uint64_t cycles);
+        void end_window(uint64_t steps, uint64_t cycles);
+        bool is_window_open() const { return window_open_; }
+        /**
+         * Get the statistics of the measurement windows, including the open one.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param steps [M][In] The current step count.
+         * @param cycles [M][In] The current cycle count, including the pending stall cycles.
+         * @param windows [M][Out] Number of the windows.
+         * @param instructions [M][Out] Instructions executed in the windows.
+         * @param window_cycles [M][Out] Cycles spent in the windows.
+         */
+        void get_stats(uint64_t steps, uint64_t cycles, uint64_t *windows, uint64_t *instructions,
+            uint64_t *window_cycles) const;
+        /**
+         * Replace the statistics of the closed windows, e.g. from a checkpoint.
+         */
+        void set_stats(uint64_t windows, uint64_t instructions, uint64_t cycles);
+    private:
+        std::map<uint64_t, sim_mode_t> schedule_;   // step -> mode
+        bool window_open_;
+        uint64_t window_steps_;                     // counters at the beginning of the open window
+        uint64_t window_cycles_;
+        uint64_t windows_;                          // closed windows
+        uint64_t instructions_;
+        uint64_t cycles_;
+    };
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,94 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace kz::riscv::core {
+    class TlbEntry {
+    public:
+        uint64_t tag;   // physical address of the page, INVALID_TAG if empty
+        uint8_t *host;  // host address of the first byte of the page
+    };
+    using tlb_entry_t = TlbEntry;
+
+    /**
+     * Direct-mapped cache of host pointers to 4KB physical pages, separate for read, write and
+     * instruction fetch accesses. An entry is filled only if the access of that kind is permitted
+     * to the whole page, so a hit needs neither the PMP nor the direct memory lookup. There is no
+     * permission field in the entry, the CPU keeps one cache per privilege level instead, so a
+     * privilege change just selects another cache, and any change of the permissions (PMP) or of
+     * the memory mapping flushes all of them.
+     */
+    class RiscvCpuTlb {
+    public:
+        static constexpr unsigned PAGE_WIDTH = 12;
+        static constexpr uint64_t PAGE_SIZE = (1ULL << PAGE_WIDTH); /* 4KB */
+        static constexpr uint64_t PAGE_MASK = ~(PAGE_SIZE - 1);
+        static constexpr unsigned ENTRIES_WIDTH = 8;
+        static constexpr unsigned ENTRIES_NUM = (1 << ENTRIES_WIDTH); /* 256 pages, 1MB */
+        // the tag has bits set below the page boundary, so it never matches any address
+        static constexpr uint64_t INVALID_TAG = ~0ULL;
+        // access kinds
+        static constexpr unsigned READ = 0;
+        static constexpr unsigned WRITE = 1;
+        static constexpr unsigned EXEC = 2;
+        static constexpr unsigned ACCESS_NUM = 3;
+
+        RiscvCpuTlb();
+        /**
+         * Translate the physical address to the host address. The alignment check is a part of
+         * the tag comparison, a misaligned access always misses.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ, WRITE or EXEC.
+         * @param addr [M][In] Physical address of the access.
+         * @param size [M][In] Size of the access in bytes (1, 2, 4 or 8).
+         * @return host address, nullptr on cache miss.
+         */
+        uint8_t *lookup(unsigned access, uint64_t addr, unsigned size) const {
+            const tlb_entry_t &entry = entries_[access][index_(addr)];
+            if ((addr & (PAGE_MASK | (size - 1))) != entry.tag) {
+                return nullptr;
+            }
+            return entry.host + (addr & ~PAGE_MASK);
+        }
+        /**
+         * Store translation of the page, the previous content of the entry is evicted.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ, WRITE or EXEC.
+         * @param page [M][In] Physical address of the page (aligned).
+         * @param host [M][In] Host address of the page.
+         */
+        void fill(unsigned access, uint64_t page, uint8_t *host);
+        /**
+         * Invalidate all entries.
+         */
+        void flush();
+        /**
+         * Invalidate translations of the page for the given access kind.
+         */
+        void flush_page(unsigned access, uint64_t page);
+    private:
+        static size_t index_(uint64_t addr) { return (addr >> PAGE_WIDTH) & (ENTRIES_NUM - 1); }
+        std::array<std::array<tlb_entry_t, ENTRIES_NUM>, ACCESS_NUM> entries_;
+    };
+} /* ! kz::riscv::core ! */
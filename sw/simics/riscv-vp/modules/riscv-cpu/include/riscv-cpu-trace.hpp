@@ -0,0 +1,168 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kz::riscv::core {
+    class TraceRecord {
+    public:
+        uint64_t pc;
+        uint32_t instr;         // raw instruction word
+        uint8_t priv;           // privilege level the instruction was executed at
+        uint8_t flags;          // RiscvCpuTracer::REC_* bits of the optional fields
+        uint8_t rd;             // REC_RD: destination register (never x0)
+        uint64_t rd_val;        // REC_RD: value written to rd
+        uint64_t addr;          // REC_MEM: accessed memory address
+        uint64_t store_val;     // REC_STORE: stored value
+    };
+    using trace_record_t = TraceRecord;
+
+    /**
+     * Binary instruction trace, one record per retired instruction. The file starts with
+     * a 16-byte header ("RVTRACE\0", u16 version, u16 xlen, u32 flags) followed by chunks,
+     * every chunk has a 16-byte header (u32 "RVTC", u32 stored size, u32 raw size, u32 number
+     * of records) and can be decoded on its own, the delta encoding restarts in every chunk.
+     * A chunk is zlib compressed if the file flags have FLAG_COMPRESSED set. A record is:
+     *   u8 header: REC_* flags, privilege level in bits [5:4]
+     *   REC_PC: zigzag varint of (pc - expected pc), the next instruction is expected
+     *   u32 instruction word
+     *   REC_RD: u8 register number, varint value
+     *   REC_MEM: zigzag varint of (address - previous address)
+     *   REC_STORE: varint value
+     * Records are encoded by the simulation thread into the chunks of a single-producer,
+     * single-consumer ring, a host thread compresses and writes the full chunks to the file.
+     */
+    class RiscvCpuTracer {
+    public:
+        static constexpr uint16_t VERSION = 1;
+        static constexpr uint32_t FLAG_COMPRESSED = 1;
+        static constexpr uint32_t CHUNK_MAGIC = 0x43545652; // "RVTC"
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+        static constexpr size_t RING_SLOTS = 64;            // up to 4MB waiting for the writer
+        static constexpr size_t MAX_RECORD_SIZE = 1 + 10 + 4 + 1 + 10 + 10 + 10;
+        static constexpr uint8_t REC_PC = 0x01;
+        static constexpr uint8_t REC_RD = 0x02;
+        static constexpr uint8_t REC_MEM = 0x04;
+        static constexpr uint8_t REC_STORE = 0x08;
+        static constexpr unsigned REC_PRIV_SHIFT = 4;
+
+        RiscvCpuTracer();
+        ~RiscvCpuTracer();
+        /**
+         * Create the trace file and start the writer thread.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param path [M][In] The trace file, truncated if it exists.
+         * @param xlen [M][In] Register width of the traced CPU.
+         * @param compress [M][In] Compress the chunks with zlib.
+         * @return false if the file can't be created or compression isn't supported.
+         */
+        bool open(const std::string &path, unsigned xlen, bool compress);
+        /**
+         * Write the pending records, stop the writer thread and close the file.
+         * @return false if any write to the file failed.
+         */
+        bool close();
+        bool is_open() const { return file_ != nullptr; }
+        /**
+         * Hand the records encoded so far over to the writer thread.
+         */
+        void flush();
+        uint64_t get_records() const { return records_; }
+        /**
+         * Encode the record of a retired instruction.
+         */
+        void record(const trace_record_t &rec) {
+            Chunk &chunk = ring_[head_.load(std::memory_order_relaxed) % RING_SLOTS];
+            uint8_t *p = chunk.data.data() + chunk.size;
+            uint8_t header = rec.flags | static_cast<uint8_t>(rec.priv << REC_PRIV_SHIFT);
+            if (rec.pc != next_pc_) {
+                header |= REC_PC;
+            }
+            *p++ = header;
+            if (header & REC_PC) {
+                p = put_varint_(p, zigzag_(rec.pc - next_pc_));
+            }
+            for (unsigned i = 0; i < sizeof(rec.instr); ++i) {
+                *p++ = static_cast<uint8_t>(rec.instr >> (8 * i));
+            }
+            if (rec.flags & REC_RD) {
+                *p++ = rec.rd;
+                p = put_varint_(p, rec.rd_val);
+            }
+            if (rec.flags & REC_MEM) {
+                p = put_varint_(p, zigzag_(rec.addr - last_addr_));
+                last_addr_ = rec.addr;
+            }
+            if (rec.flags & REC_STORE) {
+                p = put_varint_(p, rec.store_val);
+            }
+            next_pc_ = rec.pc + 4;
+            chunk.size = p - chunk.data.data();
+            chunk.records++;
+            records_++;
+            if (chunk.size > CHUNK_SIZE - MAX_RECORD_SIZE) {
+                flush();
+            }
+        }
+    private:
+        class Chunk {
+        public:
+            std::vector<uint8_t> data;
+            size_t size;
+            uint32_t records;
+        };
+        static uint64_t zigzag_(uint64_t delta) {
+            return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+        }
+        static uint8_t *put_varint_(uint8_t *p, uint64_t value) {
+            while (value >= 0x80) {
+                *p++ = static_cast<uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            *p++ = static_cast<uint8_t>(value);
+            return p;
+        }
+        void start_chunk_();
+        void write_chunks_();
+        bool write_chunk_(const Chunk &chunk);
+        // the producer (simulation thread) fills ring_[head_], the consumer (writer thread)
+        // writes ring_[tail_] out, a slot is owned by one side at a time
+        std::array<Chunk, RING_SLOTS> ring_;
+        std::atomic<size_t> head_;
+        std::atomic<size_t> tail_;
+        std::atomic<bool> stop_;
+        std::atomic<bool> write_error_;
+        std::thread writer_;
+        FILE *file_;
+        bool compress_;
+        std::vector<uint8_t> compressed_; // writer thread buffer
+        // delta encoding state of the current chunk
+        uint64_t next_pc_;
+        uint64_t last_addr_;
+        uint64_t records_;
+    };
+} /* ! kz::riscv::core ! */
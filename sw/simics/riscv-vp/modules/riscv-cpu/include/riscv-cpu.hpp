@@ -21,6 +21,11 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <simics/cc-api.h>
 
 #include <simics/c++/model-iface/execute.h>
@@ -30,14 +35,46 @@
 #include <simics/c++/model-iface/step.h>
 #include <simics/c++/model-iface/cycle.h>
 #include <simics/c++/model-iface/cycle-event.h>
+#include <simics/c++/devs/signal.h>
 #include <simics/c++/devs/frequency.h>
 
 #include "riscv-cpu-types.hpp"
 #include "riscv-cpu-conf.hpp"
 #include "riscv-cpu-state.hpp"
+#include "riscv-cpu-decode.hpp"
 #include "riscv-cpu-queue.hpp"
+#include "riscv-cpu-predecode.hpp"
+#include "riscv-cpu-custom.hpp"
+#include "riscv-cpu-custom-iface.h"
+#include "riscv-cpu-priv.hpp"
+#include "riscv-cpu-pmp.hpp"
+#include "riscv-cpu-tlb.hpp"
+#include "riscv-cpu-htif.hpp"
+#include "riscv-cpu-profile.hpp"
+#include "riscv-cpu-mix.hpp"
+#include "riscv-cpu-trace.hpp"
+#include "riscv-cpu-bbv.hpp"
+#include "riscv-cpu-timing.hpp"
+#include "riscv-cpu-cost.hpp"
+#include "riscv-cpu-cache.hpp"
+#include "riscv-cpu-bpred.hpp"
+#include "riscv-cpu-callgraph.hpp"
+#include "riscv-cpu-coverage.hpp"
+#include "riscv-cpu-memprof.hpp"
+#include "riscv-cpu-hostprof.hpp"
+#include "riscv-cpu-instrumentation.hpp"
+#include "riscv-cpu-breakpoint.hpp"
+#include "riscv-cpu-gdb.hpp"
 
 namespace kz::riscv::core {
+    /**
+     * RISC-V CPU model templated on the register width (XLEN in bits, RV32 or RV64). Both
+     * variants are built from the same sources, everything what depends on the width is taken
+     * from XlenTraits or selected with "if constexpr", so there are no runtime width checks.
+     * The class is explicitly instantiated for RV32 and RV64 at the end of every source file
+     * that implements its methods.
+     */
+    template<unsigned XLEN>
     class RiscvCpu:
         public simics::ConfObject,
         public simics::iface::IntRegisterInterface,
@@ -54,12 +91,20 @@ namespace kz::riscv::core {
         using addr_t = kz::riscv::types::addr_t;
         using instr_t = kz::riscv::types::instr_t;
         using dec_instr_t = kz::riscv::types::dec_instr_t;
+        using traits_t = XlenTraits<XLEN>;
+        using reg_t = typename traits_t::reg_t;
+        using sreg_t = typename traits_t::sreg_t;
         // attributes
         conf_object_t *cobj_;
-        std::array<uint32_t, RV32I_GP_REG_NUM> regs_; // x0..x31
-        uint32_t pc_;
-        uint32_t mstatus_, mepc_, mcause_, mtvec_;
-        direct_memory_lookup_t mem_handler_;
+        std::array<reg_t, RV32I_GP_REG_NUM> regs_; // x0..x31
+        reg_t pc_;
+        // privilege level and control and status registers, sstatus/sie/sip are views of the
+        // machine level registers
+        uint8_t priv_;
+        reg_t mstatus_, medeleg_, mideleg_, mie_, mip_, mtvec_, mcounteren_;
+        reg_t mscratch_, mepc_, mcause_, mtval_;
+        reg_t stvec_, scounteren_, sscratch_, sepc_, scause_, stval_, satp_;
+        RiscvCpuPmp pmp_;
         simics::Connect<simics::iface::DirectMemoryLookupInterface> phys_mem_;
         // state
         uint64_t subsystem_;
@@ -73,17 +118,470 @@ namespace kz::riscv::core {
         bigtime_t time_offset_;
         event_queue_t step_queue_;
         event_queue_t cycle_queue_;
+        // set when the current batch of instructions has to be ended before the next event,
+        // because the event queues or the interrupt state have changed, or the CPU is stopped
+        bool batch_exit_;
+        // instructions left in the current batch, including the one being executed
+        uint64_t batch_left_;
+        // instruction processing
+        RiscvCpuPredecode predecode_cache_;
+        RiscvCpuCustom custom_instrs_;
+        // memory access, one page cache per privilege level (the index), the data accesses use
+        // the one of the effective privilege level (mstatus.MPRV), instruction fetches of priv_
+        std::array<RiscvCpuTlb, privilege_t::NUM> tlb_;
+        RiscvCpuTlb *data_tlb_;
+        uint8_t data_priv_;
+        std::unordered_set<uint64_t> code_pages_; // pages instructions were predecoded from
+        // pages with accesses reported to watch_hit_(), bitmask of (1 << access kind), these
+        // accesses are never cached, so the fast path needs no extra check
+        std::unordered_map<uint64_t, uint8_t> watched_pages_;
+        // breakpoints of the physical memory space, the execution ones are flagged in the
+        // predecoded instructions, the pages with read or write ones are never cached
+        RiscvCpuBreakpoints breakpoints_;
+        pc_step_t break_step_; // step and address of the last execution breakpoint hit
+        reg_t break_pc_;
+        hap_handle_t breakpoint_hap_; // Core_Breakpoint_Change callback, deleted with the CPU
+        // watchpoints, the handle of a range is its index in the watchpoints attribute, the
+        // pages with a watchpoint are never cached either
+        RiscvCpuBreakpoints watchpoints_;
+        watchpoint_hit_t last_watch_hit_;
+        // GDB remote stub, the breakpoints and watchpoints of the session are removed when
+        // the client disconnects
+        RiscvCpuGdb gdb_;
+        bool gdb_running_; // the simulation was continued by the client, the stop is replied
+        std::deque<std::string> gdb_pending_; // received while the target runs, handled after the stop
+        uint64_t gdb_watch_step_; // last watchpoint hit before the continue
+        breakpoint_handle_t gdb_watch_handle_;
+        hap_handle_t gdb_stopped_hap_; // Core_Simulation_Stopped callback, added while listening
+        static event_class_t *gdb_step_event_;
+        std::unordered_map<uint64_t, breakpoint_id_t> gdb_breakpoints_;
+        std::vector<bool> gdb_watchpoints_; // set for the watchpoints of the session, by index
+        // host interface, HTIF (tohost_addr_ 0 - disabled) and semihosting
+        uint64_t tohost_addr_;
+        uint64_t fromhost_addr_;
+        bool semihosting_;
+        bool quit_on_exit_;
+        bool exited_;
+        int64_t exit_code_;
+        // instrumentation, the run loop checks instrumented_ once per batch and runs the
+        // plain variant of the batch if nothing is enabled
+        RiscvCpuProfiler profiler_;
+        bool profiling_;
+        RiscvCpuBbv bbv_;
+        std::string bbv_file_;
+        uint64_t bbv_interval_;
+        bool bbv_collecting_;
+        bool tracking_blocks_; // profiling_ or bbv_collecting_
+        uint64_t block_pc_;  // address of the first instruction of the current basic block
+        uint32_t block_len_; // number of instructions executed in the current basic block
+        RiscvCpuCoverage coverage_;
+        bool coverage_enabled_;
+        RiscvCpuInstrumentation instrumentation_;
+        instrumentation_instr_t instr_handle_;      // query handles of the instruction being executed
+        instrumentation_access_t access_handle_;
+        RiscvCpuHostProfile host_profile_;
+        bool host_profiling_; // the counters are opened by run(), in the simulation thread
+        RiscvCpuMemProfile mem_profile_;
+        uint64_t mem_countdown_; // accesses left to the next sampled one
+        RiscvCpuCallGraph callgraph_;
+        bool callgraph_tracking_;
+        RiscvCpuInstrMix instr_mix_;
+        bool mix_counting_;
+        RiscvCpuTracer tracer_;
+        bool tracing_;
+        std::string trace_file_;
+        bool trace_compression_;
+        uint64_t trap_count_; // taken traps, tells the retired instructions from the trapped ones
+        // simulation mode, the warm-up and timing modes run the instrumented batches
+        sim_mode_t mode_;
+        RiscvCpuTiming timing_;
+        bool mode_magic_;
+        custom_instr_t mode_magic_instr_; // bound to the marker instructions at predecode time
+        RiscvCpuCostModel cost_model_;
+        RiscvCpuCache icache_;
+        RiscvCpuCache dcache_;
+        uint64_t icache_miss_penalty_; // cycles per line transfer
+        uint64_t dcache_miss_penalty_;
+        RiscvCpuBranchPredictor bpred_;
+        uint64_t bpred_penalty_; // cycles per misprediction
+        bool instrumented_;
+        bool instrumentation_active_; // instrumentation_.is_active() when instrumented_ was computed
         // methods
         // -- methods: memory access
-        direct_memory_lookup_t get_mem_handler_(physical_address_t addr, unsigned size);
-        uint8 *read_mem_(addr_t addr, unsigned size);
+        direct_memory_lookup_t get_mem_handler_(physical_address_t addr, unsigned size, access_t access);
+        uint8 *read_mem_(physical_address_t addr, unsigned size);
+        uint8_t *get_page_host_(uint64_t page, unsigned access);
+        bool access_slow_(unsigned access, reg_t addr, unsigned size, uint8_t *data);
+        void flush_caches_();
+        /**
+         * Rebuild the watched pages from the host interface configuration, the cached
+         * translations of the pages are dropped.
+         */
+        void update_watched_pages_();
+        /**
+         * Called after an access to a watched page completed (see access_slow_).
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ, WRITE or EXEC.
+         * @param addr [M][In] Physical address of the access.
+         * @param size [M][In] Size of the access in bytes.
+         */
+        void watch_hit_(unsigned access, reg_t addr, unsigned size);
+        /**
+         * Core_Breakpoint_Change hap callback, the breakpoints are copied again when the ones
+         * of the physical memory space change.
+         */
+        static void breakpoint_change_c(lang_void *data, conf_object_t *obj);
+        /**
+         * Copy the breakpoints of the physical memory space, the caches are flushed.
+         */
+        void update_breakpoints_();
+        /**
+         * Trigger the breakpoints hit by the access through the breakpoint_trigger interface
+         * of the physical memory space.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ, WRITE or EXEC.
+         * @param addr [M][In] Physical address of the access.
+         * @param size [M][In] Size of the access in bytes.
+         * @param data [M][In] Data of the access.
+         * @return true if any breakpoint was hit.
+         */
+        bool trigger_breakpoints_(unsigned access, reg_t addr, unsigned size, uint8_t *data);
+        /**
+         * Check the execution breakpoints of the instruction, called only for the
+         * instructions of the pages with a breakpoint.
+         * @return true if a breakpoint was hit, the instruction mustn't be executed then.
+         */
+        bool break_exec_(reg_t pc, const predecoded_instr_t &entry);
+        /**
+         * Check the read or write breakpoints after an access to a page with a breakpoint.
+         */
+        void break_access_(unsigned access, reg_t addr, unsigned size, uint8_t *data);
+        /**
+         * Check the watchpoints after an access to a page with a watchpoint, a hit stops
+         * the simulation after the instruction.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param access [M][In] Access kind: READ or WRITE.
+         * @param addr [M][In] Physical address of the access.
+         * @param size [M][In] Size of the access in bytes.
+         */
+        void watch_access_(unsigned access, reg_t addr, unsigned size);
+        /**
+         * Replace the watchpoints, the handles are the positions in the list.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param ranges [M][In] Watched ranges.
+         * @param gdb_owned [M][In] Set for the ranges inserted by the GDB client, same size.
+         */
+        void set_watchpoints_(const std::vector<breakpoint_range_t> &ranges, const std::vector<bool> &gdb_owned);
+        /**
+         * SIM_notify_on_socket callbacks of the GDB stub, a new client on the listening
+         * socket and data of the connected client.
+         */
+        static void gdb_accept_c(lang_void *data);
+        static void gdb_receive_c(lang_void *data);
+        /**
+         * Start listening for GDB on the port of the local host, 0 stops it.
+         * @return false if the port can't be opened.
+         */
+        bool open_gdb_(uint16_t port);
+        void close_gdb_();
+        /**
+         * End the GDB session, its breakpoints and watchpoints are removed.
+         */
+        void gdb_disconnect_();
+        /**
+         * Handle the pending packets of the client in order, until the target is resumed or
+         * the session ends.
+         */
+        void gdb_process_();
+        /**
+         * Handle the packet of the GDB remote serial protocol.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param packet [M][In] Payload of the packet.
+         * @param close [M][Out] Set if the session ends after the reply.
+         * @return the reply payload, none if the target was resumed (gdb_running_).
+         */
+        std::string gdb_handle_(const std::string &packet, bool *close);
+        /**
+         * Continue the simulation or step this CPU once, the run is started after the packet
+         * is handled and the stop is replied by gdb_stopped_c.
+         */
+        void gdb_resume_(bool step);
+        /**
+         * SIM_register_work callback starting the run of gdb_resume_.
+         */
+        static void gdb_continue_c(lang_void *data);
+        /**
+         * Step event of gdb_resume_, the simulation stops after one step of this CPU.
+         */
+        static void gdb_step_event_c(conf_object_t *obj, lang_void *data);
+        /**
+         * Core_Simulation_Stopped hap callback, the stop reply is sent to the client that
+         * continued the simulation, then the packets received meanwhile are handled.
+         */
+        static void gdb_stopped_c(lang_void *data, conf_object_t *obj, int64 exception, char *error);
+        /**
+         * Get the stop reply: the exit, the new watchpoint hit or the trap.
+         */
+        std::string gdb_stop_reply_() const;
+        /**
+         * Handle the Z (insert) and z (remove) packets.
+         */
+        std::string gdb_breakpoint_(bool insert, const std::string &packet);
+        /**
+         * Copy the memory of the GDB packets, the RAM is accessed through the direct memory
+         * pointers, the devices with the inquiry transactions.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param addr [M][In] Physical address.
+         * @param size [M][In] Number of bytes.
+         * @param data [M][In/Out] Data to write or buffer for the read ones.
+         * @param is_write [M][In] True for writing to the memory.
+         * @return false if any part of the memory isn't accessible.
+         */
+        bool gdb_memory_(uint64_t addr, size_t size, uint8_t *data, bool is_write);
+        /**
+         * Get the target description of the registers (qXfer:features:read).
+         */
+        std::string gdb_target_xml_() const;
+        /**
+         * Count the sampled load or store in the memory profile and restart the countdown.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param write [M][In] True for a store, false for a load.
+         * @param addr [M][In] Address of the access.
+         */
+        void sample_access_(bool write, reg_t addr);
+        /**
+         * Load the value from memory, the fast path is a single page cache lookup.
+         * Assumes a little-endian host.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param addr [M][In] Physical address.
+         * @param value [M][Out] Loaded value.
+         * @return false if the access raised an exception, pc_ points to the trap handler then.
+         */
+        template<typename T>
+        bool load_(reg_t addr, T *value) {
+            if (--mem_countdown_ == 0) {
+                sample_access_(false, addr);
+            }
+            const uint8_t *host = data_tlb_->lookup(RiscvCpuTlb::READ, addr, sizeof(T));
+            if (host == nullptr) {
+                return access_slow_(RiscvCpuTlb::READ, addr, sizeof(T), reinterpret_cast<uint8_t *>(value));
+            }
+            std::memcpy(value, host, sizeof(T));
+            return true;
+        }
+        /**
+         * Store the value to memory, the fast path is a single page cache lookup.
+         * Assumes a little-endian host.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param addr [M][In] Physical address.
+         * @param value [M][In] Value to store.
+         * @return false if the access raised an exception, pc_ points to the trap handler then.
+         */
+        template<typename T>
+        bool store_(reg_t addr, T value) {
+            if (--mem_countdown_ == 0) {
+                sample_access_(true, addr);
+            }
+            uint8_t *host = data_tlb_->lookup(RiscvCpuTlb::WRITE, addr, sizeof(T));
+            if (host == nullptr) {
+                return access_slow_(RiscvCpuTlb::WRITE, addr, sizeof(T), reinterpret_cast<uint8_t *>(&value));
+            }
+            std::memcpy(host, &value, sizeof(T));
+            return true;
+        }
+        // -- methods: privilege levels and traps (riscv-cpu-priv)
+        void set_priv_(uint8_t priv);
+        void update_data_priv_();
+        // the CSRs of the checkpointed state (csrs attribute) and their registers
+        class CsrState {
+        public:
+            uint16_t csr;
+            reg_t RiscvCpu::*value;
+        };
+        static const std::vector<CsrState> &get_csr_state_();
+        void take_trap_(reg_t cause, reg_t tval, bool to_s_mode);
+        void raise_exception_(uint8_t cause, reg_t tval);
+        /**
+         * Take the highest priority pending and enabled interrupt, if any. Interrupts are
+         * only checked between batches of instructions (see run()).
+         */
+        void check_interrupts_();
+        /**
+         * Set the level of the interrupt pending bit driven by a device.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param irq [M][In] Interrupt number (bit of the mip register).
+         * @param level [M][In] New level of the interrupt line.
+         */
+        void set_irq_(int irq, bool level);
+        bool csr_read_(uint16_t csr, reg_t *value, bool inquiry = false);
+        bool csr_write_(uint16_t csr, reg_t value, bool inquiry = false);
+        void execute_system_(const dec_instr_t &dec_instr);
+        void execute_misc_mem_(const dec_instr_t &dec_instr);
+        // -- methods: host interface (riscv-cpu-htif)
+        /**
+         * Access the physical memory on behalf of the host, without the PMP checks, side
+         * effects and exceptions, the access may cross page boundaries.
+         * @return false if any part of the range is not mapped.
+         */
+        bool host_access_(uint64_t addr, size_t size, uint8_t *data, bool is_write);
+        void host_write_(const char *data, size_t size);
+        /**
+         * Write the target buffer to the console, the buffer is copied in page sized chunks
+         * since the size comes from the target.
+         * @return the number of bytes written, less than size if the buffer is not mapped.
+         */
+        uint64_t host_write_mem_(uint64_t addr, uint64_t size);
+        void host_exit_(int64_t code);
+        void htif_tohost_();
+        /**
+         * Execute the semihosting call if the EBREAK at pc_ is surrounded by the semihosting
+         * markers, pc_ is moved to the exit marker then.
+         * @return false if EBREAK is a regular breakpoint.
+         */
+        bool semihosting_call_();
         // -- methods: register access
-        inline uint32_t read_reg_(int reg);
-        inline void write_reg_(int reg, uint32_t value);
+        inline reg_t read_reg_(int reg);
+        inline void write_reg_(int reg, reg_t value);
         // -- methods: instruction processing
-        instr_t fetch_(addr_t addr);
+        bool fetch_(reg_t addr, instr_t *instr);
         dec_instr_t decode_(instr_t instr);
-        void execute_(dec_instr_t dec_instr);
+        void execute_(dec_instr_t dec_instr, instr_t instr);
+        predecoded_instr_t *predecode_(uint64_t pc);
+        uint64_t get_batch_size_() const;
+        void execute_custom_(const predecoded_instr_t &entry);
+        /**
+         * Execute up to batch instructions, the INSTRUMENTED variant additionally feeds the
+         * enabled instrumentation (profiler, BBV, instruction mix, trace) after every instruction.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param batch [M][In] Maximum number of instructions to execute, at least 1.
+         */
+        template<bool INSTRUMENTED>
+        void run_batch_(uint64_t batch);
+        /**
+         * Shorten the rest of the batch, so it doesn't run past the next cycle event. The batch
+         * size assumes one cycle per instruction, it has to be called whenever an instruction
+         * takes more (custom instruction latencies, timing mode).
+         */
+        void limit_batch_();
+        // -- methods: instrumentation
+        void update_instrumentation_();
+        /**
+         * Run the instrumentation callbacks of the instruction about to be executed (see
+         * RiscvCpuInstrumentation).
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the instruction.
+         * @param entry [M][In] The predecoded instruction.
+         * @param addr [M][In] Address of the load or store, computed before the execution.
+         * @param store_val [M][In] Value of the store.
+         */
+        void instrument_before_(reg_t pc, const predecoded_instr_t &entry, reg_t addr, reg_t store_val);
+        /**
+         * Run the instrumentation callbacks of the retired instruction, the handles of
+         * instrument_before_ are reused.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param entry [M][In] The predecoded instruction.
+         */
+        void instrument_after_(const predecoded_instr_t &entry);
+        /**
+         * Write the trace record of the retired instruction.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the instruction.
+         * @param priv [M][In] Privilege level the instruction was executed at.
+         * @param entry [M][In] The predecoded instruction.
+         * @param addr [M][In] Effective address of a load or store (rs1 + imm before execution).
+         * @param store_val [M][In] Value of rs2 before execution, stored by a store.
+         */
+        void trace_instr_(reg_t pc, uint8_t priv, const predecoded_instr_t &entry, reg_t addr, reg_t store_val);
+        /**
+         * Account the instruction executed at pc to the current basic block, the completed
+         * blocks are passed to the profiler and the BBV collector.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the executed instruction.
+         * @param entry [O][In] The predecoded instruction, nullptr if the fetch failed.
+         */
+        void track_block_(reg_t pc, const predecoded_instr_t *entry) {
+            if (pc != block_pc_ + static_cast<uint64_t>(block_len_) * INSTR_SIZE) {
+                // a trap or an interrupt has left the previous block
+                if (block_len_ != 0) {
+                    end_block_();
+                }
+                block_pc_ = pc;
+                block_len_ = 0;
+            }
+            if (entry == nullptr) {
+                return;
+            }
+            block_len_++;
+            if (entry->ends_block) {
+                end_block_();
+                block_pc_ = pc_;
+                block_len_ = 0;
+            }
+        }
+        /**
+         * Feed the timing models with the executed instruction, the extra cycles are charged
+         * in the timing mode only.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the instruction.
+         * @param entry [O][In] The predecoded instruction, nullptr if the fetch failed.
+         * @param retired [M][In] false if the instruction has trapped.
+         * @param addr [M][In] Effective address of a load or store (rs1 + imm before execution).
+         */
+        void timing_instr_(reg_t pc, const predecoded_instr_t *entry, bool retired, reg_t addr);
+        /**
+         * Charge the cycles on top of the one the instruction took, if a cycle event falls
+         * within them, they are turned into stall cycles consumed by the run loop.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param extra [M][In] Number of the extra cycles.
+         */
+        void charge_cycles_(cycles_t extra);
+        // -- methods: simulation mode (riscv-cpu-timing)
+        void set_mode_(sim_mode_t mode);
+        /**
+         * Switch to the modes of the scheduled switches which are due at the current step.
+         */
+        void apply_mode_schedule_();
+        /**
+         * Check if the instruction is the mode switch marker: "srai zero, zero, N", a HINT
+         * with no architectural effect, N is 1 (functional), 2 (warmup) or 3 (timing).
+         */
+        static bool is_mode_magic_(instr_t instr) {
+            uint32_t mode = (instr >> 20) & 0x1F;
+            return (instr & ~(0x1FU << 20)) == 0x40005013U && mode >= 1 && mode <= 3;
+        }
+        static uint64 mode_magic_handler_(
+            lang_void *user_data,
+            conf_object_t *cpu,
+            uint32 instr,
+            uint64 rs1_val,
+            uint64 rs2_val);
+        /**
+         * Report the executed call or return to the call graph, JAL/JALR writing ra is a call,
+         * "jalr x0, 0(ra)" is a return.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param pc [M][In] Address of the executed control transfer.
+         * @param dec_instr [M][In] The decoded instruction.
+         */
+        void track_call_(reg_t pc, const dec_instr_t &dec_instr) {
+            using operation_code_t = kz::riscv::types::operation_code_t;
+            if (dec_instr.opcode != operation_code_t::JAL && dec_instr.opcode != operation_code_t::JALR) {
+                return;
+            }
+            uint64_t cycles = current_cycle_ + stall_cycles_;
+            if (RiscvCpuDecoder::is_call(dec_instr)) {
+                callgraph_.call(pc, pc_, current_step_, cycles);
+            } else if (RiscvCpuDecoder::is_return(dec_instr)) {
+                callgraph_.ret(pc_, current_step_, cycles);
+            }
+        }
+        void end_block_() {
+            if (profiling_) {
+                profiler_.add(block_pc_, block_len_);
+            }
+            if (bbv_collecting_) {
+                bbv_.add(block_pc_, block_len_);
+            }
+        }
         // -- methods: cycle / step processing
         void handle_events_(event_queue_t *queue);
         void inc_cycles_(int cycles);
@@ -108,6 +606,185 @@ namespace kz::riscv::core {
          */
         void objects_finalized() override;
 
+        // ! cpu_instrumentation_subscribe interface (instrumentation-iface-impl) !
+        /**
+         * Register the instrumentation callback of the connection.
+         * @return handle of the callback.
+         */
+        cpu_cb_handle_t *register_instrumentation(conf_object_t *connection, const instrumentation_callback_t &callback);
+        void remove_instrumentation(cpu_cb_handle_t *handle);
+        void enable_instrumentation(cpu_cb_handle_t *handle, bool enabled);
+        void remove_connection_instrumentation(conf_object_t *connection);
+        void enable_connection_instrumentation(conf_object_t *connection, bool enabled);
+
+        // ! riscv_custom_instr interface (custom-iface-impl) !
+        /**
+         * Bind a host-native implementation to the custom instruction pattern, see
+         * riscv-cpu-custom-iface.h for the parameters description.
+         * @return 0 on success, -1 otherwise.
+         */
+        int bind_custom_instr(
+            const char *name,
+            uint8 opcode,
+            int func3,
+            int func7,
+            unsigned latency,
+            riscv_custom_instr_handler_t handler,
+            lang_void *user_data);
+        /**
+         * Remove the binding of the custom instruction pattern.
+         * @return 0 on success, -1 otherwise.
+         */
+        int unbind_custom_instr(uint8 opcode, int func3, int func7);
+        /**
+         * Method returns the list of bound custom instructions:
+         * ((<i>name</i>, <i>opcode</i>, <i>func3</i>, <i>func7</i>, <i>latency</i>)*).
+         */
+        attr_value_t custom_instrs_as_attr() const;
+        /**
+         * Method returns the machine and supervisor CSRs: ((<i>address</i>, <i>value</i>)*),
+         * the counters are derived from the steps and cycles, so they aren't in the list.
+         */
+        attr_value_t csrs_as_attr() const;
+        /**
+         * Restore the CSRs (see csrs_as_attr), the values are set as they are, without the
+         * side effects of the CSR instructions.
+         */
+        set_error_t set_csrs_from_attr(attr_value_t *val);
+        /**
+         * Method returns the PMP entries: ((<i>pmpcfg</i>, <i>pmpaddr</i>)*).
+         */
+        attr_value_t pmp_as_attr() const;
+        /**
+         * Restore the PMP entries (see pmp_as_attr), the locked ones included.
+         */
+        set_error_t set_pmp_from_attr(attr_value_t *val);
+        /**
+         * Method returns the executed basic blocks, the hottest first:
+         * ((<i>pc</i>, <i>executions</i>, <i>instructions</i>, <i>length</i>)*).
+         */
+        attr_value_t profile_as_attr() const;
+        /**
+         * Replace the profile with the given list of basic blocks (see profile_as_attr),
+         * an empty list clears the profile.
+         */
+        set_error_t set_profile_from_attr(attr_value_t *val);
+        /**
+         * Method returns the executed operations, the most frequent first:
+         * ((<i>mnemonic</i>, <i>format</i>, <i>executions</i>)*).
+         */
+        attr_value_t instr_mix_as_attr() const;
+        /**
+         * Method returns the call graph: (((<i>function</i>, <i>instructions</i>,
+         * <i>cycles</i>)*), ((<i>caller</i>, <i>call site</i>, <i>callee</i>, <i>calls</i>,
+         * <i>instructions</i>, <i>cycles</i>)*)), the costs of the functions are exclusive,
+         * the ones of the calls inclusive.
+         */
+        attr_value_t callgraph_as_attr() const;
+        /**
+         * Method returns the executed code: ((<i>page</i>, <i>bitmap</i>)*), bit n of the
+         * bitmap (little-endian bit order) is set if the instruction at page + 4 * n was executed.
+         */
+        attr_value_t coverage_as_attr() const;
+        /**
+         * Method returns the touched pages: ((<i>page</i>, <i>reads</i>, <i>writes</i>,
+         * <i>first touch</i>, <i>last touch</i>)*), the accesses are the sampled ones.
+         */
+        attr_value_t mem_heatmap_as_attr() const;
+        /**
+         * Method returns the host costs of the run loop parts: ((<i>tier</i>,
+         * <i>guest instructions</i>, <i>task-clock</i>, <i>cycles</i>, <i>instructions</i>,
+         * <i>branch-misses</i>, <i>L1-icache-misses</i>)*).
+         */
+        attr_value_t host_profile_as_attr() const;
+        /**
+         * Method returns the names of the host counters opened by the last run.
+         */
+        attr_value_t host_counters_as_attr() const;
+        /**
+         * Method returns the breakpoints copied from the physical memory space:
+         * ((<i>handle</i>, <i>access</i>, <i>start</i>, <i>end</i>)*).
+         */
+        attr_value_t breakpoints_as_attr() const;
+        /**
+         * Method returns the watchpoints: ((<i>start</i>, <i>length</i>, <i>access</i>)*).
+         */
+        attr_value_t watchpoints_as_attr() const;
+        /**
+         * Replace the watchpoints (see watchpoints_as_attr).
+         */
+        set_error_t set_watchpoints_from_attr(attr_value_t *val);
+        /**
+         * Method returns the last watchpoint hit: (<i>index</i>, <i>pc</i>, <i>address</i>,
+         * <i>size</i>, <i>access</i>), NIL if there was none.
+         */
+        attr_value_t watchpoint_hit_as_attr() const;
+        /**
+         * Method returns the number of the distinct pages touched in every interval.
+         */
+        attr_value_t mem_working_set_as_attr() const;
+        /**
+         * Replace the executed code with the given one (see coverage_as_attr).
+         */
+        set_error_t set_coverage_from_attr(attr_value_t *val);
+        /**
+         * Method returns the scheduled mode switches: ((<i>step</i>, <i>mode</i>)*).
+         */
+        attr_value_t mode_schedule_as_attr() const;
+        /**
+         * Replace the scheduled mode switches (see mode_schedule_as_attr).
+         */
+        set_error_t set_mode_schedule_from_attr(attr_value_t *val);
+        /**
+         * Method returns the statistics of the timing mode windows:
+         * (<i>windows</i>, <i>instructions</i>, <i>cycles</i>).
+         */
+        attr_value_t timing_stats_as_attr() const;
+        /**
+         * Restore the statistics of the timing mode windows (see timing_stats_as_attr), an
+         * empty list clears them.
+         */
+        set_error_t set_timing_stats_from_attr(attr_value_t *val);
+        /**
+         * Method returns the latency table of the timing mode: ((<i>class</i>, <i>cycles</i>)*).
+         */
+        attr_value_t cost_model_as_attr() const;
+        /**
+         * Update the latencies of the listed operation classes (see cost_model_as_attr).
+         */
+        set_error_t set_cost_model_from_attr(attr_value_t *val);
+        /**
+         * Method returns the geometry of the cache: (<i>size</i>, <i>ways</i>,
+         * <i>line size</i>, <i>replacement</i>, <i>write-back</i>), NIL if it isn't attached.
+         */
+        attr_value_t cache_config_as_attr(const RiscvCpuCache &cache) const;
+        /**
+         * Attach the cache with the given geometry (see cache_config_as_attr), NIL detaches it.
+         */
+        set_error_t set_cache_config_from_attr(RiscvCpuCache *cache, attr_value_t *val);
+        /**
+         * Method returns the statistics of the cache: (<i>reads</i>, <i>read misses</i>,
+         * <i>writes</i>, <i>write misses</i>, <i>writebacks</i>).
+         */
+        attr_value_t cache_stats_as_attr(const RiscvCpuCache &cache) const;
+        /**
+         * Method returns the configuration of the branch predictor: (<i>predictor</i>,
+         * <i>PHT entries</i>, <i>history bits</i>, <i>BTB entries</i>, <i>RAS depth</i>), NIL if
+         * it isn't attached.
+         */
+        attr_value_t bpred_config_as_attr() const;
+        /**
+         * Attach the branch predictor with the given configuration (see bpred_config_as_attr),
+         * NIL detaches it.
+         */
+        set_error_t set_bpred_config_from_attr(attr_value_t *val);
+        /**
+         * Method returns the statistics of the branch predictor: (<i>branches</i>,
+         * <i>mispredicted</i>, <i>jumps</i>, <i>mispredicted</i>, <i>returns</i>,
+         * <i>mispredicted</i>), the returns are included in the jumps.
+         */
+        attr_value_t bpred_stats_as_attr() const;
+
         class frequency_port:
             public simics::Port<RiscvCpu>,
             public simics::iface::SimpleDispatcherInterface {
@@ -124,6 +801,26 @@ namespace kz::riscv::core {
             }
         };
 
+        /**
+         * Interrupt lines of the CPU, a port array indexed with the bit number of the mip
+         * register (e.g. port.irq[7] is MTIP), driven by devices through the signal interface.
+         */
+        class irq_port:
+            public simics::Port<RiscvCpu>,
+            public simics::iface::SignalInterface {
+        public:
+            explicit irq_port(simics::ConfObjectRef obj) : simics::Port<RiscvCpu>(obj) {}
+            virtual ~irq_port() = default;
+
+            // ! SignalInterface (signal-iface-impl) !
+            void signal_raise() override;
+            void signal_lower() override;
+
+            static void init_class(simics::ConfClass *cls) {
+                cls->add(simics::iface::SignalInterface::Info());
+            }
+        };
+
         /**
          * Implement a custom Info class for the Step interface to prevent naming conflicts with
          * the Cycle interface.
@@ -146,6 +843,38 @@ namespace kz::riscv::core {
             const interface_t *cstruct() const override { return &cycle_funcs; }
         };
 
+        /**
+         * Implement a custom Info class for the riscv_custom_instr interface, it's a C interface
+         * declared in riscv-cpu-custom-iface.h without the generated C++ wrapper.
+         */
+        static const riscv_custom_instr_interface_t custom_instr_funcs;
+        class CustomInstrInfo : public simics::iface::InterfaceInfo {
+        public:
+            std::string name() const override { return RISCV_CUSTOM_INSTR_INTERFACE; }
+            const interface_t *cstruct() const override {
+                return reinterpret_cast<const interface_t *>(&custom_instr_funcs);
+            }
+        };
+
+        /**
+         * Info class of the C instrumentation interfaces (simics/model-iface/cpu-instrumentation.h),
+         * they have no generated C++ wrappers.
+         */
+        static const cpu_instrumentation_subscribe_interface_t instrumentation_subscribe_funcs;
+        static const cpu_cached_instruction_interface_t cached_instruction_funcs;
+        static const cpu_instruction_query_interface_t instruction_query_funcs;
+        static const cpu_memory_query_interface_t memory_query_funcs;
+        static const cpu_exception_query_interface_t exception_query_funcs;
+        class CInterfaceInfo : public simics::iface::InterfaceInfo {
+        public:
+            CInterfaceInfo(const char *name, const void *funcs) : name_(name), funcs_(funcs) {}
+            std::string name() const override { return name_; }
+            const interface_t *cstruct() const override { return reinterpret_cast<const interface_t *>(funcs_); }
+        private:
+            const char *name_;
+            const void *funcs_;
+        };
+
         // ! FrequencyListenerInterface (frequency-listener-iface-impl) !
         /**
          * Method is called to set the frequency of the listener.
@@ -692,11 +1421,25 @@ namespace kz::riscv::core {
             cls->add(simics::iface::DirectMemoryUpdateInterface::Info());
             // Step interface is used to support stepping through instructions
             cls->add(CustomStepInfo());
+            // the GDB single step is an event of the stepped CPU
+            gdb_step_event_ = SIM_register_event(
+                "gdb_step", *cls, Sim_EC_Notsaved, gdb_step_event_c, nullptr, nullptr, nullptr, nullptr
+            );
             // Cycle interface is used to support cycle-accurate simulation
             cls->add(CustomCycleInfo());
             SIM_register_clock(
                 *cls, static_cast<const cycle_interface_t*>(CustomCycleInfo().cstruct())
             );
+            // Custom instruction interface is used by companion modules to bind host-native
+            // implementations of instructions placed in CUSTOM_0..CUSTOM_3 opcodes
+            cls->add(CustomInstrInfo());
+            // Instrumentation interfaces are used by the Simics tools (coverage, traces,
+            // cache models) to observe the executed instructions, memory accesses and exceptions
+            cls->add(CInterfaceInfo(CPU_INSTRUMENTATION_SUBSCRIBE_INTERFACE, &instrumentation_subscribe_funcs));
+            cls->add(CInterfaceInfo(CPU_CACHED_INSTRUCTION_INTERFACE, &cached_instruction_funcs));
+            cls->add(CInterfaceInfo(CPU_INSTRUCTION_QUERY_INTERFACE, &instruction_query_funcs));
+            cls->add(CInterfaceInfo(CPU_MEMORY_QUERY_INTERFACE, &memory_query_funcs));
+            cls->add(CInterfaceInfo(CPU_EXCEPTION_QUERY_INTERFACE, &exception_query_funcs));
             // Attributes
             cls->add(
                 simics::Attribute(
@@ -758,6 +1501,857 @@ namespace kz::riscv::core {
                     ATTR_CLS_VAR(RiscvCpu, pc_)
                 )
             );
-        }
-    };
+            cls->add(
+                simics::Attribute(
+                    "priv", "i", "Current privilege level (0 - U, 1 - S, 3 - M).",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->priv_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        uint64 priv = SIM_attr_integer(*val);
+                        if (priv != privilege_t::U && priv != privilege_t::S && priv != privilege_t::M) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->set_priv_(static_cast<uint8_t>(priv));
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            // the architectural state, so a checkpoint resumes the same execution
+            cls->add(
+                simics::Attribute(
+                    "gprs", "[i{32}]", "General purpose registers x0..x31.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        attr_value_t regs = SIM_alloc_attr_list(RV32I_GP_REG_NUM);
+                        for (int i = 0; i < RV32I_GP_REG_NUM; ++i) {
+                            SIM_attr_list_set_item(&regs, i, SIM_make_attr_uint64(cpu->regs_[i]));
+                        }
+                        return regs;
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        // x0 is hardwired to zero
+                        for (int i = 1; i < RV32I_GP_REG_NUM; ++i) {
+                            cpu->regs_[i] = static_cast<reg_t>(SIM_attr_integer(SIM_attr_list_item(*val, i)));
+                        }
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "csrs", "[[ii]*]",
+                    "Machine and supervisor CSRs: ((<i>address</i>, <i>value</i>)*).",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        return simics::from_obj<RiscvCpu>(obj)->csrs_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        return simics::from_obj<RiscvCpu>(obj)->set_csrs_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "pmp", "[[ii]{16}]",
+                    "PMP entries: ((<i>pmpcfg</i>, <i>pmpaddr</i>)*).",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        return simics::from_obj<RiscvCpu>(obj)->pmp_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        return simics::from_obj<RiscvCpu>(obj)->set_pmp_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "xlen", "i", "Register width in bits.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        return SIM_make_attr_uint64(XLEN);
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "tohost", "i",
+                    "Physical address of the HTIF tohost location, 0 disables HTIF. Stores to it"
+                    " are detected through the watched page, the rest of the memory is not"
+                    " affected.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->tohost_addr_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        uint64 addr = SIM_attr_integer(*val);
+                        if (addr & (sizeof(uint64_t) - 1)) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->tohost_addr_ = addr;
+                        cpu->update_watched_pages_();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "fromhost", "i",
+                    "Physical address of the HTIF fromhost location, 0 if there is none.",
+                    ATTR_CLS_VAR(RiscvCpu, fromhost_addr_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "semihosting", "b", "Handle the RISC-V semihosting calls (EBREAK sequence).",
+                    ATTR_CLS_VAR(RiscvCpu, semihosting_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "quit_on_exit", "b",
+                    "Quit Simics with the program exit code when the program exits through HTIF"
+                    " or semihosting, otherwise the simulation is stopped.",
+                    ATTR_CLS_VAR(RiscvCpu, quit_on_exit_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "exit_code", "i|n", "Exit code of the program, NIL if it hasn't exited yet.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->exited_ ? SIM_make_attr_int64(cpu->exit_code_) : SIM_make_attr_nil();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "profiling", "b",
+                    "Count executions of the basic blocks, see the profile attribute.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->profiling_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        cpu->profiling_ = SIM_attr_boolean(*val);
+                        cpu->block_len_ = 0;
+                        cpu->update_instrumentation_();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "profile", "[[iiii]*]",
+                    "Executed basic blocks sorted by the number of executed instructions:"
+                    " ((<i>pc</i>, <i>executions</i>, <i>instructions</i>, <i>length</i>)*),"
+                    " <i>length</i> is the longest observed one. Setting an empty list clears"
+                    " the profile.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->profile_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_profile_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "bbv_file", "s|n",
+                    "Basic block vectors are written to the file in the SimPoint .bb format, one"
+                    " line per bbv_interval instructions, NIL closes the file.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->bbv_collecting_ ? SIM_make_attr_string(cpu->bbv_file_.c_str()) : SIM_make_attr_nil();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        cpu->bbv_.close();
+                        cpu->bbv_collecting_ = false;
+                        if (SIM_attr_is_string(*val)) {
+                            cpu->bbv_file_ = SIM_attr_string(*val);
+                            cpu->bbv_collecting_ = cpu->bbv_.open(cpu->bbv_file_, cpu->bbv_interval_);
+                        }
+                        cpu->block_len_ = 0;
+                        cpu->update_instrumentation_();
+                        return cpu->bbv_collecting_ || SIM_attr_is_nil(*val) ? Sim_Set_Ok : Sim_Set_Illegal_Value;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "bbv_interval", "i",
+                    "Length of the BBV intervals in instructions, applies to the next bbv_file.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->bbv_interval_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_integer(*val) <= 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->bbv_interval_ = SIM_attr_integer(*val);
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "bbv_intervals", "i", "Number of the intervals written to bbv_file.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->bbv_.get_intervals());
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "host_profiling", "b",
+                    "Profile the simulator itself with the perf_event_open counters of the"
+                    " simulation thread, see the host_profile attribute. Fails if the host"
+                    " doesn't allow perf_event_open (see /proc/sys/kernel/perf_event_paranoid).",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->host_profiling_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        bool profiling = SIM_attr_boolean(*val);
+                        // the counters are reopened by every run, check they can be opened at all
+                        if (profiling && !cpu->host_profiling_) {
+                            if (!cpu->host_profile_.open()) {
+                                SIM_LOG_ERROR(cpu->cobj_, 0, "perf_event_open is not available");
+                                return Sim_Set_Illegal_Value;
+                            }
+                            cpu->host_profile_.close();
+                        }
+                        cpu->host_profiling_ = profiling;
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "host_profile", "[[siiiiii]*]",
+                    "Host costs of the run loop parts: ((<i>tier</i>, <i>guest instructions</i>,"
+                    " <i>task-clock</i>, <i>cycles</i>, <i>instructions</i>, <i>branch-misses</i>,"
+                    " <i>L1-icache-misses</i>)*), <i>tier</i> is plain (batches without"
+                    " instrumentation), instrumented or events (event queues, interrupts and the"
+                    " rest of the loop), the task clock is in nanoseconds. The counters the host"
+                    " doesn't provide stay at zero, see host_counters. Setting an empty list"
+                    " clears the profile.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->host_profile_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->host_profile_.clear();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "host_counters", "[s*]",
+                    "Names of the host counters opened by the last run with host_profiling set.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->host_counters_as_attr();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "breakpoints", "[[iiii]*]",
+                    "Breakpoints of the physical memory space the CPU checks itself:"
+                    " ((<i>handle</i>, <i>access</i>, <i>start</i>, <i>end</i>)*), <i>access</i>"
+                    " is the bitmask of read (1), write (2) and execute (4). Only the accesses to"
+                    " the pages with a breakpoint are checked.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->breakpoints_as_attr();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "watchpoints", "[[iii]*]",
+                    "Data watchpoints: ((<i>start</i>, <i>length</i>, <i>access</i>)*),"
+                    " <i>access</i> is the bitmask of read (1) and write (2). A load or store"
+                    " touching any byte of the range stops the simulation after the instruction,"
+                    " see watchpoint_hit. Only the pages with a watchpoint lose the direct memory"
+                    " access, the rest of the memory runs at full speed.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->watchpoints_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_watchpoints_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "watchpoint_hit", "[iiiii]|n",
+                    "The last watchpoint hit: (<i>index</i>, <i>pc</i>, <i>address</i>,"
+                    " <i>size</i>, <i>access</i>), <i>index</i> is the position of the watchpoint"
+                    " in the watchpoints attribute, <i>access</i> is read (1) or write (2)."
+                    " NIL if no watchpoint was hit.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->watchpoint_hit_as_attr();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "gdb_port", "i",
+                    "TCP port of the local host the GDB remote stub listens on, 0 (default)"
+                    " disables the stub. Connect with \"target remote :<i>port</i>\".",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_int64(cpu->gdb_.get_port());
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        int64 port = SIM_attr_integer(*val);
+                        if (port < 0 || port > 0xffff || !cpu->open_gdb_(static_cast<uint16_t>(port))) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mem_sampling", "i",
+                    "Sample every Nth load and store into the memory profile, see the mem_heatmap"
+                    " and mem_working_set attributes. 0 (default) disables the sampling, setting"
+                    " the period clears the profile.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->mem_profile_.get_period());
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_integer(*val) < 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->mem_profile_.configure(SIM_attr_integer(*val), cpu->mem_profile_.get_interval());
+                        cpu->mem_countdown_ = cpu->mem_profile_.get_countdown();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mem_interval", "i",
+                    "Length of the working set intervals of the memory profile in instructions,"
+                    " 0 disables the working set. Setting the length clears the profile.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->mem_profile_.get_interval());
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_integer(*val) < 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->mem_profile_.configure(cpu->mem_profile_.get_period(), SIM_attr_integer(*val));
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mem_heatmap", "[[iiiii]*]",
+                    "Pages touched by the sampled loads and stores: ((<i>page</i>, <i>reads</i>,"
+                    " <i>writes</i>, <i>first touch</i>, <i>last touch</i>)*), the touches are"
+                    " instruction counts, the accesses have to be multiplied by mem_sampling to"
+                    " get the estimated totals. Setting an empty list clears the profile.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->mem_heatmap_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->mem_profile_.clear();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mem_working_set", "[i*]",
+                    "Number of the distinct pages touched by the sampled accesses in every"
+                    " mem_interval instructions, the first interval starts at the instruction 0.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->mem_working_set_as_attr();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "coverage", "b",
+                    "Collect the code coverage, see the coverage_map attribute.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->coverage_enabled_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        bool enabled = SIM_attr_boolean(*val);
+                        if (enabled && !cpu->coverage_enabled_) {
+                            // the instructions are marked when they are predecoded
+                            cpu->predecode_cache_.flush();
+                        }
+                        cpu->coverage_enabled_ = enabled;
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "coverage_map", "[[id]*]",
+                    "Executed code: ((<i>page</i>, <i>bitmap</i>)*), one 128-byte bitmap per 4 KiB"
+                    " page, bit n (little-endian bit order) is set if the instruction at"
+                    " <i>page</i> + 4 * n was executed. The addresses are the virtual ones."
+                    " Setting an empty list clears the map. Use save-coverage to write it as"
+                    " a drcov file.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->coverage_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_coverage_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "callgraph_tracking", "b",
+                    "Track the calls and returns of the program, see the callgraph attribute."
+                    " The function executed when the tracking starts is the root of the graph.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->callgraph_tracking_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        bool tracking = SIM_attr_boolean(*val);
+                        uint64_t cycles = cpu->current_cycle_ + cpu->stall_cycles_;
+                        if (tracking && !cpu->callgraph_tracking_) {
+                            cpu->callgraph_.start(cpu->pc_, cpu->current_step_, cycles);
+                        } else if (!tracking && cpu->callgraph_tracking_) {
+                            cpu->callgraph_.stop(cpu->current_step_, cycles);
+                        }
+                        cpu->callgraph_tracking_ = tracking;
+                        cpu->update_instrumentation_();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "callgraph", "[[[iii]*][[iiiiii]*]]|[]",
+                    "Call graph: (((<i>function</i>, <i>instructions</i>, <i>cycles</i>)*),"
+                    " ((<i>caller</i>, <i>call site</i>, <i>callee</i>, <i>calls</i>,"
+                    " <i>instructions</i>, <i>cycles</i>)*)), the functions are identified by"
+                    " their entry addresses, their costs are exclusive, the costs of the calls"
+                    " are inclusive. Setting an empty list clears the graph. Use save-callgraph"
+                    " to write it in the callgrind format.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->callgraph_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->callgraph_.clear(cpu->current_step_, cpu->current_cycle_ + cpu->stall_cycles_);
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mix_counting", "b",
+                    "Count executions of every operation, see the instruction_mix attribute.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->mix_counting_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        cpu->mix_counting_ = SIM_attr_boolean(*val);
+                        cpu->update_instrumentation_();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "instruction_mix", "[[ssi]*]",
+                    "Executed operations sorted by the number of executions:"
+                    " ((<i>mnemonic</i>, <i>format</i>, <i>executions</i>)*), <i>format</i> is"
+                    " one of R, I, S, B, U, J or other. Setting an empty list clears the counters.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->instr_mix_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->instr_mix_.clear();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "trace_file", "s|n",
+                    "Binary trace of the retired instructions is written to the file, NIL stops"
+                    " the trace. Use riscv-trace.py to decode it.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->tracing_ ? SIM_make_attr_string(cpu->trace_file_.c_str()) : SIM_make_attr_nil();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (cpu->tracing_ && !cpu->tracer_.close()) {
+                            SIM_LOG_ERROR(cpu->cobj_, 0, "Failed to write trace file '%s'", cpu->trace_file_.c_str());
+                        }
+                        cpu->tracing_ = false;
+                        if (SIM_attr_is_string(*val)) {
+                            cpu->trace_file_ = SIM_attr_string(*val);
+                            if (!cpu->tracer_.open(cpu->trace_file_, XLEN, cpu->trace_compression_)) {
+                                cpu->update_instrumentation_();
+                                return Sim_Set_Illegal_Value;
+                            }
+                            cpu->tracing_ = true;
+                        }
+                        cpu->update_instrumentation_();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "trace_compression", "b",
+                    "Compress the trace with zlib, applies to the next trace_file.",
+                    ATTR_CLS_VAR(RiscvCpu, trace_compression_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "trace_records", "i", "Number of records written to the current trace.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_uint64(cpu->tracer_.get_records());
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mode", "s",
+                    "Simulation mode: \"functional\" (one cycle per instruction, no timing"
+                    " model), \"warmup\" (the timing models are trained, but their latencies"
+                    " aren't charged) or \"timing\".",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_string(RiscvCpuTiming::get_mode_name(cpu->mode_));
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        sim_mode_t mode;
+                        if (!RiscvCpuTiming::get_mode(SIM_attr_string(*val), &mode)) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->set_mode_(mode);
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mode_schedule", "[[is]*]",
+                    "Scheduled mode switches: ((<i>step</i>, <i>mode</i>)*), the mode is"
+                    " switched when the step count reaches <i>step</i>.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->mode_schedule_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_mode_schedule_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "mode_magic", "b",
+                    "Switch the mode on the marker instruction \"srai zero, zero, N\", N is 1"
+                    " (functional), 2 (warmup) or 3 (timing).",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_boolean(cpu->mode_magic_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        cpu->mode_magic_ = SIM_attr_boolean(*val);
+                        // the markers are bound when the instructions are predecoded
+                        cpu->predecode_cache_.flush();
+                        return Sim_Set_Ok;
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "timing_stats", "[iii]|[]",
+                    "Statistics of the timing mode windows: (<i>windows</i>, <i>instructions</i>,"
+                    " <i>cycles</i>), including the open window. Setting an empty list clears"
+                    " them.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->timing_stats_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_timing_stats_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "cost_model", "[[si]*]",
+                    "Latencies of the operation classes in the timing mode:"
+                    " ((<i>class</i>, <i>cycles</i>)*), <i>class</i> is one of alu,"
+                    " branch_taken, branch_not_taken, load, store, mul_div or csr. Setting a list"
+                    " updates the listed classes only.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->cost_model_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_cost_model_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "cost_preset", "s",
+                    "Latency table preset: \"default\" (one cycle per instruction) or \"fde_ip\""
+                    " (the HLS fde_ip core, six cycles per instruction), \"custom\" if cost_model"
+                    " doesn't match any preset.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return SIM_make_attr_string(cpu->cost_model_.get_preset());
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (!cpu->cost_model_.set_preset(SIM_attr_string(*val))) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        // the latencies are resolved when the instructions are predecoded
+                        cpu->predecode_cache_.flush();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "icache", "[iiisb]|n",
+                    "L1 cache of the instruction fetches simulated in the warm-up and timing modes:"
+                    " (<i>size</i>, <i>ways</i>, <i>line size</i>, <i>replacement</i>,"
+                    " <i>write-back</i>), <i>replacement</i> is lru, plru or random, the sizes are"
+                    " powers of two. NIL detaches the cache, setting a geometry invalidates it.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->cache_config_as_attr(cpu->icache_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_cache_config_from_attr(&cpu->icache_, val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "icache_miss_penalty", "i",
+                    "Cycles charged in the timing mode for every line transferred by icache.",
+                    ATTR_CLS_VAR(RiscvCpu, icache_miss_penalty_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "icache_stats", "[iiiii]|[]",
+                    "Statistics of icache: (<i>reads</i>, <i>read misses</i>, <i>writes</i>,"
+                    " <i>write misses</i>, <i>writebacks</i>). Setting an empty list clears them.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->cache_stats_as_attr(cpu->icache_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->icache_.clear_stats();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "dcache", "[iiisb]|n",
+                    "L1 cache of the loads and stores simulated in the warm-up and timing modes:"
+                    " (<i>size</i>, <i>ways</i>, <i>line size</i>, <i>replacement</i>,"
+                    " <i>write-back</i>), <i>replacement</i> is lru, plru or random, the sizes are"
+                    " powers of two. NIL detaches the cache, setting a geometry invalidates it.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->cache_config_as_attr(cpu->dcache_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_cache_config_from_attr(&cpu->dcache_, val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "dcache_miss_penalty", "i",
+                    "Cycles charged in the timing mode for every line transferred by dcache.",
+                    ATTR_CLS_VAR(RiscvCpu, dcache_miss_penalty_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "dcache_stats", "[iiiii]|[]",
+                    "Statistics of dcache: (<i>reads</i>, <i>read misses</i>, <i>writes</i>,"
+                    " <i>write misses</i>, <i>writebacks</i>). Setting an empty list clears them.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->cache_stats_as_attr(cpu->dcache_);
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->dcache_.clear_stats();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "branch_predictor", "[siiii]|n",
+                    "Branch predictor simulated in the warm-up and timing modes: (<i>predictor</i>,"
+                    " <i>PHT entries</i>, <i>history bits</i>, <i>BTB entries</i>, <i>RAS depth</i>),"
+                    " <i>predictor</i> is btfn, bimodal or gshare, the table sizes are powers of"
+                    " two, 0 BTB entries or RAS depth leave the BTB or RAS out. NIL detaches the"
+                    " predictor, setting a configuration resets it.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->bpred_config_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->set_bpred_config_from_attr(val);
+                    }
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "branch_mispredict_penalty", "i",
+                    "Cycles charged in the timing mode for every mispredicted branch or jump.",
+                    ATTR_CLS_VAR(RiscvCpu, bpred_penalty_)
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "branch_stats", "[iiiiii]|[]",
+                    "Statistics of the branch predictor: (<i>branches</i>, <i>mispredicted</i>,"
+                    " <i>jumps</i>, <i>mispredicted</i>, <i>returns</i>, <i>mispredicted</i>), the"
+                    " returns are included in the jumps. Setting an empty list clears them.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->bpred_stats_as_attr();
+                    },
+                    [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        if (SIM_attr_list_size(*val) != 0) {
+                            return Sim_Set_Illegal_Value;
+                        }
+                        cpu->bpred_.clear_stats();
+                        return Sim_Set_Ok;
+                    },
+                    Sim_Attr_Pseudo
+                )
+            );
+            cls->add(
+                simics::Attribute(
+                    "custom_instructions", "[[siiii]*]",
+                    "Bound custom instructions: ((<i>name</i>, <i>opcode</i>, <i>func3</i>,"
+                    " <i>func7</i>, <i>latency</i>)*), func3/func7 equal to -1 match any value.",
+                    [](conf_object_t *obj) -> attr_value_t {
+                        auto *cpu = simics::from_obj<RiscvCpu>(obj);
+                        return cpu->custom_instrs_as_attr();
+                    },
+                    nullptr,
+                    Sim_Attr_Pseudo
+                )
+            );
+        }
+    };
+
+    using riscv32_cpu_t = RiscvCpu<RV32>;
+    using riscv64_cpu_t = RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
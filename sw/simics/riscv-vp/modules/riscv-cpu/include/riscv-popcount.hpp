@@ -0,0 +1,62 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <simics/cc-api.h>
+
+#include "riscv-cpu-custom-iface.h"
+
+namespace kz::riscv::devices {
+    /**
+     * Example accelerator bound through the riscv_custom_instr interface of the CPU, it's the
+     * reference for companion modules. "popc rd, rs1" is placed in the CUSTOM_0 opcode with
+     * func3 and func7 equal to 0 (R-type, rs2 ignored) and writes the number of set bits of
+     * rs1 to rd. The instruction is bound when the configuration is finalized and rebound when
+     * the latency changes.
+     */
+    class RiscvPopcount : public simics::ConfObject {
+    public:
+        static constexpr uint8_t OPCODE = 0b00010; // CUSTOM_0
+        static constexpr int FUNC3 = 0;
+        static constexpr int FUNC7 = 0;
+
+        explicit RiscvPopcount(simics::ConfObjectRef conf_obj);
+        virtual ~RiscvPopcount();
+
+        void objects_finalized() override;
+
+        static void init_class(simics::ConfClass *cls);
+    private:
+        conf_object_t *cobj_;
+        conf_object_t *cpu_;
+        unsigned latency_;
+        uint64_t executions_;
+        bool bound_;
+
+        /**
+         * Bind the instruction to the CPU, the previous binding is removed first.
+         * @return false if the CPU doesn't implement the interface or refused the binding.
+         */
+        bool bind_();
+        void unbind_();
+        static uint64 execute_c(lang_void *user_data, conf_object_t *cpu, uint32 instr, uint64 rs1_val, uint64 rs2_val);
+    };
+} /* ! kz::riscv::devices ! */
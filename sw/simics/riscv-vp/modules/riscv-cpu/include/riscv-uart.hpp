@@ -0,0 +1,119 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <simics/cc-api.h>
+#include <simics/c++/devs/signal.h>
+#include <simics/c++/model-iface/transaction.h>
+
+namespace kz::riscv::devices {
+    /**
+     * SiFive compatible UART with the host side buffering. Registers (4-byte accesses only):
+     * txdata (0x00), rxdata (0x04), txctrl (0x08), rxctrl (0x0C), ie (0x10), ip (0x14) and
+     * div (0x18).
+     *
+     * The transmitted characters are collected in a host buffer flushed on newline, when the
+     * buffer is full or when the simulation stops, so the transmit FIFO is never full and the
+     * guest never waits for it. Writes to txdata neither post events nor change the interrupt
+     * line, so printing doesn't end the batch of instructions executed by the CPU. The received
+     * characters are injected with the rx_input attribute or read from a file (or stdin) when
+     * rxdata is read with an empty receive FIFO and every rx_poll_interval cycles, so the RX
+     * watermark interrupt is raised also for a guest that doesn't poll rxdata.
+     */
+    class RiscvUart : public simics::ConfObject, public simics::iface::TransactionInterface {
+    public:
+        static constexpr uint64_t TXDATA_OFFSET = 0x00;
+        static constexpr uint64_t RXDATA_OFFSET = 0x04;
+        static constexpr uint64_t TXCTRL_OFFSET = 0x08;
+        static constexpr uint64_t RXCTRL_OFFSET = 0x0C;
+        static constexpr uint64_t IE_OFFSET = 0x10;
+        static constexpr uint64_t IP_OFFSET = 0x14;
+        static constexpr uint64_t DIV_OFFSET = 0x18;
+        static constexpr uint64_t REGS_SIZE = 0x1000;
+        // txdata.full / rxdata.empty
+        static constexpr uint32_t FIFO_FLAG = (1U << 31);
+        // txctrl/rxctrl fields
+        static constexpr uint32_t CTRL_EN = 0x1;
+        static constexpr unsigned CTRL_CNT_SHIFT = 16;
+        static constexpr uint32_t CTRL_CNT_MASK = (0x7 << CTRL_CNT_SHIFT);
+        // ie/ip bits
+        static constexpr uint32_t TXWM = 0x1;
+        static constexpr uint32_t RXWM = 0x2;
+        static constexpr size_t RX_FIFO_SIZE = 8;
+        static constexpr size_t TX_BUFFER_SIZE = 256;
+        static constexpr uint64_t RX_POLL_CYCLES = 10000;
+
+        explicit RiscvUart(simics::ConfObjectRef conf_obj);
+        virtual ~RiscvUart();
+
+        void objects_finalized() override;
+
+        // ! TransactionInterface (riscv-uart) !
+        exception_type_t issue(transaction_t *t, uint64 addr) override;
+
+        static void init_class(simics::ConfClass *cls);
+    private:
+        conf_object_t *cobj_;
+        uint32_t txctrl_;
+        uint32_t rxctrl_;
+        uint32_t ie_;
+        uint32_t div_;
+        bool irq_;
+        std::string tx_buffer_;
+        std::deque<uint8_t> rx_fifo_;
+        std::string tx_file_name_;
+        std::string rx_file_name_;
+        std::FILE *tx_file_;
+        std::FILE *rx_file_;
+        uint64_t tx_count_;
+        uint64_t rx_count_;
+        uint64_t rx_poll_cycles_;
+        hap_handle_t stopped_hap_;
+        static event_class_t *rx_poll_event_;
+        simics::Connect<simics::iface::SignalInterface> irq_target_;
+
+        void transmit_(uint8_t c);
+        /**
+         * Write the buffered characters to the console or the output file.
+         */
+        void flush_tx_();
+        /**
+         * Refill the receive FIFO from the input file (or stdin), never blocks.
+         */
+        void fill_rx_();
+        /**
+         * (Re)post the poll event of the input file, nothing is posted without an input file.
+         */
+        void post_rx_poll_();
+        static void rx_poll_event_c(conf_object_t *obj, lang_void *data);
+        uint32_t get_ip_() const;
+        /**
+         * Update the interrupt line, the signal is sent on level changes only.
+         */
+        void update_irq_();
+        bool open_tx_file_(const std::string &name);
+        bool open_rx_file_(const std::string &name);
+        static void simulation_stopped_c(lang_void *data, conf_object_t *obj, int64 exception, char *error);
+    };
+} /* ! kz::riscv::devices ! */
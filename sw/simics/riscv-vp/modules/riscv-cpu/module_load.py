@@ -15,29 +15,436 @@
 # OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 # DEALINGS IN THE SOFTWARE.
 
+import bisect
+import json
+import struct
 import cli
+from . import riscv_elf
 
-class_name = "riscv_cpu"
+class_names = ["riscv_cpu", "riscv64_cpu"]
 
 def pregs(obj, all: bool = False):
     return cli.command_return(f"{obj.iface.processor_cli.get_pregs(all)}")
 
+# hot basic blocks with disassembly, the profile is sorted by executed instructions
+def print_profile(obj, count: int):
+    blocks = obj.profile
+    total = sum(instructions for (_, _, instructions, _) in blocks)
+    lines = []
+    for (rank, (pc, executions, instructions, length)) in enumerate(blocks[:count], 1):
+        share = 100.0 * instructions / total if total else 0.0
+        lines.append(f"#{rank} {pc:#010x} executions={executions}"
+                     f" instructions={instructions} ({share:.2f}%)")
+        for addr in range(pc, pc + 4 * length, 4):
+            (_, disasm) = obj.iface.processor_cli.get_disassembly("p", addr, False, None)
+            lines.append(f"    {addr:#010x}  {disasm}")
+    if not obj.profiling and not blocks:
+        lines.append("Profiling is disabled, enable it with the profiling attribute")
+    return cli.command_return("\n".join(lines), blocks[:count])
+
+# executed operations and the breakdown by instruction format
+def instruction_mix(obj, count: int):
+    ops = obj.instruction_mix
+    total = sum(executions for (_, _, executions) in ops)
+    def share(executions):
+        return 100.0 * executions / total if total else 0.0
+    lines = [f"{'Operation':<16}{'Format':<8}{'Executions':>16}{'%':>9}"]
+    for (mnemonic, fmt, executions) in ops[:count]:
+        lines.append(f"{mnemonic:<16}{fmt:<8}{executions:>16}{share(executions):>8.2f}%")
+    if len(ops) > count:
+        rest = sum(executions for (_, _, executions) in ops[count:])
+        lines.append(f"{f'({len(ops) - count} more)':<24}{rest:>16}{share(rest):>8.2f}%")
+    formats = {}
+    for (_, fmt, executions) in ops:
+        formats[fmt] = formats.get(fmt, 0) + executions
+    lines.append("")
+    lines.append(f"{'Format':<24}{'Executions':>16}{'%':>9}")
+    for fmt in ("R", "I", "S", "B", "U", "J", "other"):
+        if fmt in formats:
+            lines.append(f"{fmt:<24}{formats[fmt]:>16}{share(formats[fmt]):>8.2f}%")
+    lines.append(f"{'Total':<24}{total:>16}")
+    if not obj.mix_counting and not ops:
+        lines.append("Counting is disabled, enable it with the mix_counting attribute")
+    return cli.command_return("\n".join(lines), ops)
+
+# function symbols (STT_FUNC) of an ELF file as a sorted list of (address, size, name)
+def elf_functions(filename: str, offset: int = 0):
+    try:
+        return riscv_elf.Elf(filename).functions(offset)
+    except riscv_elf.ElfError as e:
+        raise cli.CliError(str(e))
+
+# call graph in the callgrind format, the functions are named after the ELF symbols
+def save_callgraph(obj, filename: str, elf: str, offset: int):
+    (functions, calls) = obj.callgraph
+    symbols = elf_functions(elf, offset) if elf else []
+    starts = [address for (address, _, _) in symbols]
+    def name(pc):
+        i = bisect.bisect_right(starts, pc) - 1
+        if i >= 0:
+            (address, size, symbol) = symbols[i]
+            if pc == address:
+                return symbol
+            if pc < address + size:
+                return f"{symbol}+{pc - address:#x}"
+        return f"{pc:#x}"
+    out = {}
+    for (caller, site, callee, count, instructions, cycles) in calls:
+        out.setdefault(caller, []).append((site, callee, count, instructions, cycles))
+    lines = ["version: 1", "creator: riscv-cpu", "positions: instr",
+             "events: Instructions Cycles", ""]
+    for (pc, instructions, cycles) in functions:
+        lines.append(f"fn={name(pc)}")
+        lines.append(f"{pc:#x} {instructions} {cycles}")
+        for (site, callee, count, incl_instructions, incl_cycles) in out.get(pc, []):
+            lines.append(f"cfn={name(callee)}")
+            lines.append(f"calls={count} {callee:#x}")
+            lines.append(f"{site:#x} {incl_instructions} {incl_cycles}")
+        lines.append("")
+    with open(filename, "w") as f:
+        f.write("\n".join(lines))
+    if not obj.callgraph_tracking and not functions:
+        return cli.command_return("Tracking is disabled, enable it with the callgraph_tracking"
+                                  " attribute")
+    return cli.command_return(f"Saved {len(functions)} functions and {len(calls)} call arcs"
+                              f" to {filename}")
+
+# [start, end) range of the executable segments of an ELF file
+def elf_code_range(filename: str, offset: int = 0):
+    try:
+        segments = riscv_elf.Elf(filename).code_segments(offset)
+    except riscv_elf.ElfError as e:
+        raise cli.CliError(str(e))
+    if not segments:
+        raise cli.CliError(f"{filename} has no executable segment")
+    return (min(start for (start, _) in segments), max(end for (_, end) in segments))
+
+# executed code as a drcov file, the blocks are the runs of executed instructions
+def save_coverage(obj, filename: str, elf: str, offset: int):
+    pages = obj.coverage_map
+    runs = []
+    for (page, bitmap) in pages:
+        bits = int.from_bytes(bytes(bitmap), "little")
+        slot = 0
+        while bits >> slot:
+            while not (bits >> slot) & 1:
+                slot += 1
+            length = 0
+            while (bits >> (slot + length)) & 1:
+                length += 1
+            start = page + 4 * slot
+            if runs and runs[-1][1] == start:
+                runs[-1][1] = start + 4 * length
+            else:
+                runs.append([start, start + 4 * length])
+            slot += length
+    modules = [(*elf_code_range(elf, offset), elf)] if elf else []
+    outside = [(start, end) for (start, end) in runs
+               if not any(base <= start and end <= top for (base, top, _) in modules)]
+    # the offsets of the blocks are 32-bit, the code far apart goes to separate modules
+    for (start, end) in outside:
+        if modules and modules[-1][2] == "[unknown]" and end - modules[-1][0] <= 0xffffffff:
+            modules[-1] = (modules[-1][0], end, "[unknown]")
+        else:
+            modules.append((start, end, "[unknown]"))
+    blocks = []
+    for (start, end) in runs:
+        module = next(i for (i, (base, top, _)) in enumerate(modules)
+                      if base <= start and end <= top)
+        # the size of a drcov block is a 16-bit field
+        for chunk in range(start, end, 0xfffc):
+            size = min(end - chunk, 0xfffc)
+            blocks.append(struct.pack("<IHH", chunk - modules[module][0], size, module))
+    header = ["DRCOV VERSION: 2", "DRCOV FLAVOR: riscv-cpu",
+              f"Module Table: version 2, count {len(modules)}",
+              "Columns: id, base, end, entry, checksum, timestamp, path"]
+    for (i, (base, top, path)) in enumerate(modules):
+        header.append(f"{i}, {base:#x}, {top:#x}, 0x0, 0x0, 0x0, {path}")
+    header.append(f"BB Table: {len(blocks)} bbs")
+    with open(filename, "wb") as f:
+        f.write(("\n".join(header) + "\n").encode())
+        f.write(b"".join(blocks))
+    if not obj.coverage and not pages:
+        return cli.command_return("Coverage is disabled, enable it with the coverage attribute")
+    covered = sum(end - start for (start, end) in runs) // 4
+    return cli.command_return(f"Saved {covered} executed instructions in {len(blocks)} blocks"
+                              f" to {filename}")
+
+# hottest pages of the memory profile and the working set summary
+def mem_heatmap(obj, count: int):
+    period = obj.mem_sampling
+    pages = sorted(obj.mem_heatmap, key = lambda page: page[1] + page[2], reverse = True)
+    hottest = pages[0][1] + pages[0][2] if pages else 0
+    lines = [f"{'Page':<20}{'Reads':>14}{'Writes':>14}{'First':>16}{'Last':>16}"]
+    for (page, reads, writes, first, last) in pages[:count]:
+        bar = "#" * ((20 * (reads + writes) + hottest - 1) // hottest)
+        lines.append(f"{page:#018x}  {reads * period:>14}{writes * period:>14}"
+                     f"{first:>16}{last:>16}  {bar}")
+    working_set = obj.mem_working_set
+    if working_set:
+        peak = max(working_set)
+        mean = sum(working_set) / len(working_set)
+        lines.append("")
+        lines.append(f"Working set of {len(working_set)} intervals of {obj.mem_interval}"
+                     f" instructions: peak {peak} pages ({peak * 4} KiB),"
+                     f" mean {mean:.1f} pages ({mean * 4:.1f} KiB)")
+    if not period and not pages:
+        lines.append("Sampling is disabled, enable it with the mem_sampling attribute")
+    return cli.command_return("\n".join(lines), pages[:count])
+
+# memory profile as JSON, the accesses are the estimated totals
+def save_mem_profile(obj, filename: str):
+    period = obj.mem_sampling
+    profile = {
+        "sampling": period,
+        "interval": obj.mem_interval,
+        "page_size": 4096,
+        "pages": [{"page": page, "reads": reads * period, "writes": writes * period,
+                   "first_touch": first, "last_touch": last}
+                  for (page, reads, writes, first, last) in obj.mem_heatmap],
+        "working_set": obj.mem_working_set
+    }
+    with open(filename, "w") as f:
+        json.dump(profile, f, indent = 1)
+    return cli.command_return(f"Saved {len(profile['pages'])} pages and"
+                              f" {len(profile['working_set'])} intervals to {filename}")
+
+# host costs per guest instruction of the run loop parts
+def host_profile(obj):
+    available = set(obj.host_counters)
+    tiers = obj.host_profile
+    total = ["total"] + [sum(column) for column in list(zip(*tiers))[1:]]
+    lines = [f"{'Tier':<14}{'Guest instrs':>16}{'ns/instr':>10}{'cycles/instr':>14}"
+             f"{'instrs/instr':>14}{'br-miss/1k':>12}{'L1i-miss/1k':>13}"]
+    for (tier, guest, clock, cycles, instructions, branch_misses, icache_misses) in tiers + [total]:
+        # the events tier has no guest instructions, its costs are shown per all of them
+        executed = total[1] if tier == "events" else guest
+        def per(value, counter, scale = 1):
+            if counter not in available:
+                return "n/a"
+            return f"{scale * value / executed:.2f}" if executed else "-"
+        lines.append(f"{tier:<14}{guest:>16}{per(clock, 'task-clock'):>10}"
+                     f"{per(cycles, 'cycles'):>14}{per(instructions, 'instructions'):>14}"
+                     f"{per(branch_misses, 'branch-misses', 1000):>12}"
+                     f"{per(icache_misses, 'L1-icache-misses', 1000):>13}")
+    if not obj.host_profiling and not total[1]:
+        lines.append("Profiling is disabled, enable it with the host_profiling attribute")
+    return cli.command_return("\n".join(lines), tiers)
+
+# data watchpoints, a watchpoint is identified by its position in the watchpoints attribute
+def watch(obj, address: int, length: int, read: bool, write: bool):
+    access = (1 if read else 0) | (2 if write else 0)
+    obj.watchpoints = obj.watchpoints + [[address, length, access or 3]]
+    return cli.command_return(f"Watchpoint {len(obj.watchpoints) - 1} set", len(obj.watchpoints) - 1)
+
+def unwatch(obj, index: int):
+    watchpoints = obj.watchpoints
+    if index < 0:
+        obj.watchpoints = []
+        return cli.command_return(f"Removed {len(watchpoints)} watchpoints")
+    if index >= len(watchpoints):
+        raise cli.CliError(f"No watchpoint {index}")
+    obj.watchpoints = watchpoints[:index] + watchpoints[index + 1:]
+    return cli.command_return(f"Watchpoint {index} removed")
+
+def list_watchpoints(obj):
+    names = {1: "r", 2: "w", 3: "rw"}
+    lines = [f"{'Id':<4}{'Start':<20}{'Length':>10}  Access"]
+    for (i, (start, length, access)) in enumerate(obj.watchpoints):
+        lines.append(f"{i:<4}{start:#018x}  {length:>10}  {names[access]}")
+    hit = obj.watchpoint_hit
+    if hit is not None:
+        (i, pc, address, size, access) = hit
+        lines.append("")
+        lines.append(f"Last hit: watchpoint {i}, {'write' if access == 2 else 'read'} of {size}"
+                     f" bytes at {address:#x} by the instruction at {pc:#x}")
+    return cli.command_return("\n".join(lines), obj.watchpoints)
+
 # info command prints static information
 def get_info(obj):
-    return []
+    return [("Architecture",
+             [("XLEN", obj.xlen)]),
+            ("Custom instructions",
+             [(name, f"opcode={opcode:#04x} func3={func3} func7={func7} latency={latency}")
+              for (name, opcode, func3, func7, latency) in obj.custom_instructions])]
 
 # status command prints dynamic information
 def get_status(obj):
     return [("Registers",
              [("Value", obj.value)])]
 
-cli.new_info_command(class_name, get_info)
-cli.new_status_command(class_name, get_status)
-cli.new_command(
-    "pregs", pregs,
-    args = [cli.arg(cli.flag_t, "-all")],
-    cls = class_name,
-    alias = "print-registers",
-    short = "Print general purpose registers",
-    doc = "Print general purpose registers"
-)
+# info/status commands of the CLINT device
+def get_clint_info(obj):
+    return [("Connections",
+             [("MTIP target", obj.mtip_target),
+              ("MSIP target", obj.msip_target)]),
+            ("Timer",
+             [("Cycles per tick", obj.cycles_per_tick)])]
+
+def get_clint_status(obj):
+    return [("Registers",
+             [("msip", obj.msip),
+              ("mtimecmp", f"{obj.mtimecmp:#018x}"),
+              ("mtime", f"{obj.mtime:#018x}")])]
+
+cli.new_info_command("riscv_clint", get_clint_info)
+cli.new_status_command("riscv_clint", get_clint_status)
+
+# info/status commands of the UART device
+def get_uart_info(obj):
+    return [("Connections",
+             [("IRQ target", obj.irq_target)]),
+            ("Host files",
+             [("Output", obj.tx_file or "console"),
+              ("Input", obj.rx_file)])]
+
+def get_uart_status(obj):
+    return [("Registers",
+             [("txctrl", f"{obj.txctrl:#010x}"),
+              ("rxctrl", f"{obj.rxctrl:#010x}"),
+              ("ie", obj.ie),
+              ("div", obj.div)]),
+            ("Statistics",
+             [("Transmitted", obj.tx_count),
+              ("Received", obj.rx_count)])]
+
+cli.new_info_command("riscv_uart", get_uart_info)
+cli.new_status_command("riscv_uart", get_uart_status)
+
+# info/status commands of the example custom instruction
+def get_popcount_info(obj):
+    return [("Connections",
+             [("CPU", obj.cpu)]),
+            ("Instruction",
+             [("Latency", obj.latency)])]
+
+def get_popcount_status(obj):
+    return [("Statistics",
+             [("Executions", obj.executions)])]
+
+cli.new_info_command("riscv_popcount", get_popcount_info)
+cli.new_status_command("riscv_popcount", get_popcount_status)
+
+for class_name in class_names:
+    cli.new_info_command(class_name, get_info)
+    cli.new_status_command(class_name, get_status)
+    cli.new_command(
+        "pregs", pregs,
+        args = [cli.arg(cli.flag_t, "-all")],
+        cls = class_name,
+        alias = "print-registers",
+        short = "Print general purpose registers",
+        doc = "Print general purpose registers"
+    )
+    cli.new_command(
+        "print-profile", print_profile,
+        args = [cli.arg(cli.uint_t, "count", "?", 10)],
+        cls = class_name,
+        short = "Print the hottest basic blocks",
+        doc = ("Print the <arg>count</arg> (default 10) basic blocks with the most executed"
+               " instructions, together with their disassembly. The blocks are collected"
+               " when the <attr>profiling</attr> attribute is set, the raw data is available"
+               " in the <attr>profile</attr> attribute.")
+    )
+    cli.new_command(
+        "instruction-mix", instruction_mix,
+        args = [cli.arg(cli.uint_t, "count", "?", 20)],
+        cls = class_name,
+        short = "Print the dynamic instruction mix",
+        doc = ("Print the <arg>count</arg> (default 20) most frequently executed operations"
+               " with their share of all executed instructions, followed by the breakdown by"
+               " instruction format (R/I/S/B/U/J). The operations are counted when the"
+               " <attr>mix_counting</attr> attribute is set, the raw data is available in the"
+               " <attr>instruction_mix</attr> attribute, setting it to an empty list clears"
+               " the counters.")
+    )
+    cli.new_command(
+        "save-callgraph", save_callgraph,
+        args = [cli.arg(cli.filename_t(), "filename"),
+                cli.arg(cli.filename_t(exist = True), "elf", "?", ""),
+                cli.arg(cli.uint_t, "offset", "?", 0)],
+        cls = class_name,
+        short = "Save the call graph in the callgrind format",
+        doc = ("Save the call graph collected when the <attr>callgraph_tracking</attr>"
+               " attribute is set to <arg>filename</arg> in the callgrind format, readable by"
+               " callgrind_annotate and KCachegrind. The functions are named after the symbols"
+               " of the <arg>elf</arg> file, moved by <arg>offset</arg> if the program is not"
+               " loaded at its link address. The exclusive costs are attributed to the entry"
+               " of a function, the inclusive costs of a call to its call site.")
+    )
+    cli.new_command(
+        "save-coverage", save_coverage,
+        args = [cli.arg(cli.filename_t(), "filename"),
+                cli.arg(cli.filename_t(exist = True), "elf", "?", ""),
+                cli.arg(cli.uint_t, "offset", "?", 0)],
+        cls = class_name,
+        short = "Save the code coverage as a drcov file",
+        doc = ("Save the code executed while the <attr>coverage</attr> attribute is set to"
+               " <arg>filename</arg> in the drcov format. The blocks are described relative to"
+               " the executable segments of the <arg>elf</arg> file, moved by"
+               " <arg>offset</arg> if the program is not loaded at its link address, the code"
+               " outside of them is put in an \"[unknown]\" module. The files of many runs are"
+               " merged, or converted to lcov, with tools/riscv-coverage.py.")
+    )
+    cli.new_command(
+        "mem-heatmap", mem_heatmap,
+        args = [cli.arg(cli.uint_t, "count", "?", 20)],
+        cls = class_name,
+        short = "Print the most accessed memory pages",
+        doc = ("Print the <arg>count</arg> (default 20) pages with the most loads and stores,"
+               " estimated from the accesses sampled when the <attr>mem_sampling</attr>"
+               " attribute is set, with the instruction counts of their first and last touch,"
+               " followed by the summary of the working set (<attr>mem_working_set</attr>).")
+    )
+    cli.new_command(
+        "save-mem-profile", save_mem_profile,
+        args = [cli.arg(cli.filename_t(), "filename")],
+        cls = class_name,
+        short = "Save the memory profile as JSON",
+        doc = ("Save the page heatmap and the working set of every interval to"
+               " <arg>filename</arg> as JSON, the loads and stores are the estimated totals"
+               " (the sampled accesses multiplied by <attr>mem_sampling</attr>).")
+    )
+    cli.new_command(
+        "host-profile", host_profile,
+        args = [],
+        cls = class_name,
+        short = "Print the host costs of the simulation",
+        doc = ("Print the host costs per guest instruction of the run loop parts, measured"
+               " with the perf_event_open counters when the <attr>host_profiling</attr>"
+               " attribute is set: the plain and the instrumented batches of instructions and"
+               " the handling of events and interrupts in between. The counters the host"
+               " doesn't provide are shown as n/a, the raw data is in the"
+               " <attr>host_profile</attr> attribute.")
+    )
+    cli.new_command(
+        "watch", watch,
+        args = [cli.arg(cli.uint64_t, "address"),
+                cli.arg(cli.uint64_t, "length", "?", 1),
+                cli.arg(cli.flag_t, "-r"),
+                cli.arg(cli.flag_t, "-w")],
+        cls = class_name,
+        short = "Set a data watchpoint",
+        doc = ("Stop the simulation when a load (<tt>-r</tt>) or a store (<tt>-w</tt>), both"
+               " if none is given, touches any of the <arg>length</arg> (default 1) bytes at"
+               " the physical <arg>address</arg>. The simulation stops after the accessing"
+               " instruction, which is reported together with the access, see"
+               " <attr>watchpoint_hit</attr>. Only the accesses to the pages with a"
+               " watchpoint are checked.")
+    )
+    cli.new_command(
+        "unwatch", unwatch,
+        args = [cli.arg(cli.int_t, "id", "?", -1)],
+        cls = class_name,
+        short = "Remove a data watchpoint",
+        doc = ("Remove the watchpoint <arg>id</arg> (see list-watchpoints), all of them if"
+               " no id is given. The following watchpoints are renumbered.")
+    )
+    cli.new_command(
+        "list-watchpoints", list_watchpoints,
+        args = [],
+        cls = class_name,
+        short = "List the data watchpoints",
+        doc = ("List the data watchpoints and the last hit, the raw data is in the"
+               " <attr>watchpoints</attr> attribute.")
+    )
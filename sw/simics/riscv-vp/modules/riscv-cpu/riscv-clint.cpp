@@ -0,0 +1,305 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <limits>
+
+#include <simics/cc-api.h>
+#include <simics/base/clock.h>
+
+#include "riscv-clint.hpp"
+
+namespace kz::riscv::devices {
+    event_class_t *RiscvClint::timer_event_ = nullptr;
+
+    RiscvClint::RiscvClint(simics::ConfObjectRef conf_obj) : simics::ConfObject(conf_obj) {
+        cobj_ = obj().object();
+        msip_ = 0;
+        mtimecmp_ = std::numeric_limits<uint64_t>::max(); // no timer interrupt after reset
+        mtime_offset_ = 0;
+        cycles_per_tick_ = 1;
+        mtip_ = false;
+    }
+
+    RiscvClint::~RiscvClint() {}
+
+    void RiscvClint::objects_finalized() {
+        // the event is not checkpointed, post it again for the restored state
+        update_timer_();
+        if (msip_target_.obj() && msip_) {
+            msip_target_.iface().signal_raise();
+        }
+    }
+
+    cycles_t RiscvClint::get_cycles_() const {
+        conf_object_t *clock = SIM_object_clock(cobj_);
+        return clock != nullptr ? SIM_cycle_count(clock) : 0;
+    }
+
+    uint64_t RiscvClint::get_mtime_() const {
+        return static_cast<uint64_t>(get_cycles_()) / cycles_per_tick_ + mtime_offset_;
+    }
+
+    void RiscvClint::set_mtime_(uint64_t mtime) {
+        mtime_offset_ = mtime - static_cast<uint64_t>(get_cycles_()) / cycles_per_tick_;
+        update_timer_();
+    }
+
+    void RiscvClint::set_mtimecmp_(uint64_t mtimecmp) {
+        mtimecmp_ = mtimecmp;
+        update_timer_();
+    }
+
+    void RiscvClint::set_msip_(uint32_t msip) {
+        // only the lowest bit is implemented
+        msip &= 1;
+        if (msip == msip_) {
+            return;
+        }
+        msip_ = msip;
+        SIM_LOG_INFO(3, cobj_, 0, "MSIP %s", msip_ ? "raised" : "lowered");
+        if (msip_target_.obj()) {
+            if (msip_) {
+                msip_target_.iface().signal_raise();
+            } else {
+                msip_target_.iface().signal_lower();
+            }
+        }
+    }
+
+    void RiscvClint::set_cycles_per_tick_(uint64_t cycles_per_tick) {
+        if (!SIM_object_is_configured(cobj_)) {
+            // restored from a checkpoint, mtime_offset is the one of the saved divider
+            cycles_per_tick_ = cycles_per_tick;
+            return;
+        }
+        // keep mtime continuous across the change
+        uint64_t mtime = get_mtime_();
+        cycles_per_tick_ = cycles_per_tick;
+        set_mtime_(mtime);
+    }
+
+    void RiscvClint::set_mtip_(bool level) {
+        if (level == mtip_) {
+            return;
+        }
+        mtip_ = level;
+        SIM_LOG_INFO(3, cobj_, 0, "MTIP %s", mtip_ ? "raised" : "lowered");
+        if (mtip_target_.obj()) {
+            if (mtip_) {
+                mtip_target_.iface().signal_raise();
+            } else {
+                mtip_target_.iface().signal_lower();
+            }
+        }
+    }
+
+    void RiscvClint::update_timer_() {
+        conf_object_t *clock = SIM_object_clock(cobj_);
+        if (clock == nullptr || !SIM_object_is_configured(cobj_)) {
+            // objects_finalized() will do it
+            return;
+        }
+        SIM_event_cancel_time(clock, timer_event_, cobj_, nullptr, nullptr);
+        uint64_t mtime = get_mtime_();
+        if (mtime >= mtimecmp_) {
+            set_mtip_(true);
+            return;
+        }
+        set_mtip_(false);
+        // the match happens on the first cycle of the mtimecmp tick
+        uint64_t ticks = mtimecmp_ - mtime;
+        uint64_t cycles = static_cast<uint64_t>(get_cycles_());
+        uint64_t max_ticks = static_cast<uint64_t>(std::numeric_limits<cycles_t>::max()) / cycles_per_tick_ - 1;
+        if (ticks > max_ticks) {
+            // out of the simulated time range, never happens
+            return;
+        }
+        cycles_t delta = static_cast<cycles_t>((cycles / cycles_per_tick_ + ticks) * cycles_per_tick_ - cycles);
+        SIM_LOG_INFO(4, cobj_, 0, "Timer event posted in %lld cycles", static_cast<long long>(delta));
+        SIM_event_post_cycle(clock, timer_event_, cobj_, delta, nullptr);
+    }
+
+    bool RiscvClint::read_reg_(uint64_t offs, unsigned size, uint64_t *value) const {
+        uint64_t reg;
+        uint64_t base;
+        if (offs >= MSIP_OFFSET && offs < MSIP_OFFSET + 4) {
+            reg = msip_;
+            base = MSIP_OFFSET;
+        } else if (offs >= MTIMECMP_OFFSET && offs < MTIMECMP_OFFSET + 8) {
+            reg = mtimecmp_;
+            base = MTIMECMP_OFFSET;
+        } else if (offs >= MTIME_OFFSET && offs < MTIME_OFFSET + 8) {
+            reg = get_mtime_();
+            base = MTIME_OFFSET;
+        } else {
+            return false;
+        }
+        if (base == MSIP_OFFSET && size != 4) {
+            return false;
+        }
+        reg >>= (offs - base) * 8;
+        *value = (size == 8) ? reg : (reg & 0xFFFFFFFFULL);
+        return true;
+    }
+
+    bool RiscvClint::write_reg_(uint64_t offs, unsigned size, uint64_t value) {
+        if (offs >= MSIP_OFFSET && offs < MSIP_OFFSET + 4) {
+            if (size != 4) {
+                return false;
+            }
+            set_msip_(static_cast<uint32_t>(value));
+            return true;
+        }
+        bool is_mtimecmp = (offs >= MTIMECMP_OFFSET && offs < MTIMECMP_OFFSET + 8);
+        bool is_mtime = (offs >= MTIME_OFFSET && offs < MTIME_OFFSET + 8);
+        if (!is_mtimecmp && !is_mtime) {
+            return false;
+        }
+        uint64_t reg = is_mtimecmp ? mtimecmp_ : get_mtime_();
+        if (size == 8) {
+            reg = value;
+        } else {
+            // 32-bit harts update the 64-bit registers in halves
+            unsigned shift = (offs & 4) * 8;
+            reg = (reg & ~(0xFFFFFFFFULL << shift)) | ((value & 0xFFFFFFFFULL) << shift);
+        }
+        if (is_mtimecmp) {
+            set_mtimecmp_(reg);
+        } else {
+            set_mtime_(reg);
+        }
+        return true;
+    }
+
+    exception_type_t RiscvClint::issue(transaction_t *t, uint64 addr) {
+        unsigned size = SIM_transaction_size(t);
+        if ((size != 4 && size != 8) || (addr & (size - 1)) != 0) {
+            SIM_LOG_SPEC_VIOLATION(
+                1, cobj_, 0,
+                "Unsupported access: offset='0x%llx', size='%u'",
+                static_cast<unsigned long long>(addr), size
+            );
+            return Sim_PE_IO_Not_Taken;
+        }
+        bool ok;
+        if (SIM_transaction_is_write(t)) {
+            ok = write_reg_(addr, size, SIM_get_transaction_value_le(t));
+        } else {
+            uint64_t value = 0;
+            ok = read_reg_(addr, size, &value);
+            SIM_set_transaction_value_le(t, value);
+        }
+        if (!ok) {
+            SIM_LOG_SPEC_VIOLATION(
+                1, cobj_, 0,
+                "Access to unmapped register: offset='0x%llx', size='%u'",
+                static_cast<unsigned long long>(addr), size
+            );
+            return Sim_PE_IO_Not_Taken;
+        }
+        return Sim_PE_No_Exception;
+    }
+
+    void RiscvClint::timer_event_c(conf_object_t *obj, lang_void *data) {
+        RiscvClint *clint = simics::from_obj<RiscvClint>(obj);
+        // mtime has reached mtimecmp, MTIP is raised
+        clint->update_timer_();
+    }
+
+    void RiscvClint::init_class(simics::ConfClass *cls) {
+        cls->add(simics::iface::TransactionInterface::Info());
+        // the event is reposted from the registers, so it's not saved in checkpoints
+        timer_event_ = SIM_register_event(
+            "mtimecmp_match", *cls, Sim_EC_Notsaved, timer_event_c, nullptr, nullptr, nullptr, nullptr
+        );
+        cls->add(
+            simics::Attribute(
+                "msip", "i", "Machine software interrupt pending register.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvClint>(obj)->msip_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    simics::from_obj<RiscvClint>(obj)->set_msip_(static_cast<uint32_t>(SIM_attr_integer(*val)));
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "mtimecmp", "i", "Machine timer compare register.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvClint>(obj)->mtimecmp_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    simics::from_obj<RiscvClint>(obj)->set_mtimecmp_(SIM_attr_integer(*val));
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "mtime_offset", "i",
+                "Difference between mtime and the number of ticks of the clock (cycles divided"
+                " by cycles_per_tick).",
+                ATTR_CLS_VAR(RiscvClint, mtime_offset_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "mtime", "i", "Machine timer register.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvClint>(obj)->get_mtime_());
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    simics::from_obj<RiscvClint>(obj)->set_mtime_(SIM_attr_integer(*val));
+                    return Sim_Set_Ok;
+                },
+                Sim_Attr_Pseudo
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "cycles_per_tick", "i", "Number of clock cycles per mtime tick (default 1).",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvClint>(obj)->cycles_per_tick_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    uint64 cycles_per_tick = SIM_attr_integer(*val);
+                    if (cycles_per_tick == 0) {
+                        return Sim_Set_Illegal_Value;
+                    }
+                    simics::from_obj<RiscvClint>(obj)->set_cycles_per_tick_(cycles_per_tick);
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "mtip_target", "o|n", "Target of the machine timer interrupt (e.g. cpu.port.irq[7]).",
+                ATTR_CLS_VAR(RiscvClint, mtip_target_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "msip_target", "o|n", "Target of the machine software interrupt (e.g. cpu.port.irq[3]).",
+                ATTR_CLS_VAR(RiscvClint, msip_target_)
+            )
+        );
+    }
+} /* ! kz::riscv::devices ! */
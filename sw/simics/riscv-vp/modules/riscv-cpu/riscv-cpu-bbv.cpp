@@ -0,0 +1,76 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu-bbv.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuBbv::RiscvCpuBbv(): file_(nullptr), interval_(0), executed_(0), intervals_(0) {}
+
+    RiscvCpuBbv::~RiscvCpuBbv() {
+        close();
+    }
+
+    bool RiscvCpuBbv::open(const std::string &path, uint64_t interval) {
+        close();
+        file_ = fopen(path.c_str(), "w");
+        if (file_ == nullptr) {
+            return false;
+        }
+        interval_ = interval;
+        executed_ = 0;
+        intervals_ = 0;
+        ids_.clear();
+        counts_.clear();
+        touched_.clear();
+        return true;
+    }
+
+    void RiscvCpuBbv::close() {
+        if (file_ == nullptr) {
+            return;
+        }
+        if (executed_ != 0) {
+            write_interval_();
+        }
+        fclose(file_);
+        file_ = nullptr;
+    }
+
+    void RiscvCpuBbv::flush() {
+        if (file_ != nullptr) {
+            fflush(file_);
+        }
+    }
+
+    void RiscvCpuBbv::write_interval_() {
+        // SimPoint doesn't need the ids sorted, it's just easier to compare the files
+        std::sort(touched_.begin(), touched_.end());
+        fputc('T', file_);
+        for (uint32_t index : touched_) {
+            fprintf(file_, ":%u:%llu ", index + 1, static_cast<unsigned long long>(counts_[index]));
+            counts_[index] = 0;
+        }
+        fputc('\n', file_);
+        touched_.clear();
+        executed_ = 0;
+        intervals_++;
+    }
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,206 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-bpred.hpp"
+
+namespace kz::riscv::core {
+    namespace {
+        const char *KIND_NAMES[branch_predictor_kind_t::NUM] = {"btfn", "bimodal", "gshare"};
+        const uint64_t NO_PC = ~0ULL;
+
+        bool is_power_of_2(uint64_t value) {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+    }
+
+    RiscvCpuBranchPredictor::RiscvCpuBranchPredictor() {
+        clear_stats();
+        detach();
+    }
+
+    const char *RiscvCpuBranchPredictor::get_kind_name(uint8_t kind) {
+        return kind < branch_predictor_kind_t::NUM ? KIND_NAMES[kind] : "unknown";
+    }
+
+    bool RiscvCpuBranchPredictor::get_kind(const std::string &name, uint8_t *kind) {
+        for (uint8_t i = 0; i < branch_predictor_kind_t::NUM; ++i) {
+            if (name == KIND_NAMES[i]) {
+                *kind = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RiscvCpuBranchPredictor::attach(uint8_t kind, unsigned pht_entries, unsigned history_bits,
+        unsigned btb_entries, unsigned ras_depth) {
+        // validate first, a rejected configuration keeps the attached predictor
+        if (kind >= branch_predictor_kind_t::NUM || !is_power_of_2(pht_entries) || history_bits > 32 ||
+            (btb_entries != 0 && !is_power_of_2(btb_entries))) {
+            return false;
+        }
+        detach();
+        kind_ = kind;
+        history_bits_ = kind == branch_predictor_kind_t::GSHARE ? history_bits : 0;
+        // weakly not taken
+        pht_.assign(kind == branch_predictor_kind_t::BTFN ? 1 : pht_entries, 1);
+        btb_.assign(btb_entries, BtbEntry{NO_PC, 0});
+        ras_.assign(ras_depth, 0);
+        attached_ = true;
+        clear_stats();
+        return true;
+    }
+
+    void RiscvCpuBranchPredictor::detach() {
+        attached_ = false;
+        kind_ = branch_predictor_kind_t::BTFN;
+        history_bits_ = 0;
+        history_ = 0;
+        pht_.assign(1, 1);
+        btb_.clear();
+        ras_.clear();
+        ras_top_ = 0;
+    }
+
+    void RiscvCpuBranchPredictor::clear_stats() {
+        branches_ = 0;
+        branch_misses_ = 0;
+        jumps_ = 0;
+        jump_misses_ = 0;
+        returns_ = 0;
+        return_misses_ = 0;
+    }
+
+    bool RiscvCpuBranchPredictor::btb_update_(uint64_t pc, uint64_t target) {
+        if (btb_.empty()) {
+            return false;
+        }
+        BtbEntry &entry = btb_[(pc >> 2) & (btb_.size() - 1)];
+        bool miss = entry.pc != pc || entry.target != target;
+        entry.pc = pc;
+        entry.target = target;
+        return miss;
+    }
+
+    bool RiscvCpuBranchPredictor::branch(uint64_t pc, uint64_t target, bool taken) {
+        bool predicted;
+        if (kind_ == branch_predictor_kind_t::BTFN) {
+            predicted = target < pc;
+        } else {
+            uint8_t &counter = pht_[pht_index_(pc)];
+            predicted = counter >= 2;
+            if (taken && counter < 3) {
+                counter++;
+            } else if (!taken && counter > 0) {
+                counter--;
+            }
+            if (history_bits_ != 0) {
+                history_ = ((history_ << 1) | (taken ? 1 : 0)) & ((1ULL << history_bits_) - 1);
+            }
+        }
+        // a taken branch needs its target from the BTB to redirect the fetch in time
+        bool miss = predicted != taken;
+        if (taken) {
+            miss = btb_update_(pc, target) || miss;
+        }
+        branches_++;
+        if (miss) {
+            branch_misses_++;
+        }
+        return miss;
+    }
+
+    bool RiscvCpuBranchPredictor::jump(uint64_t pc, uint64_t target, bool indirect, bool call, bool ret) {
+        bool miss;
+        if (ret && !ras_.empty()) {
+            ras_top_ = (ras_top_ + static_cast<unsigned>(ras_.size()) - 1) % ras_.size();
+            miss = ras_[ras_top_] != target;
+            returns_++;
+            if (miss) {
+                return_misses_++;
+            }
+        } else if (btb_.empty()) {
+            // the direct targets are computed at decode, the indirect ones aren't known
+            miss = indirect;
+        } else {
+            miss = btb_update_(pc, target);
+        }
+        if (call && !ras_.empty()) {
+            ras_[ras_top_] = pc + 4;
+            ras_top_ = (ras_top_ + 1) % ras_.size();
+        }
+        jumps_++;
+        if (miss) {
+            jump_misses_++;
+        }
+        return miss;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::bpred_config_as_attr() const {
+        if (!bpred_.is_attached()) {
+            return SIM_make_attr_nil();
+        }
+        return SIM_make_attr_list(
+            5,
+            SIM_make_attr_string(RiscvCpuBranchPredictor::get_kind_name(bpred_.get_kind())),
+            SIM_make_attr_uint64(bpred_.get_pht_entries()),
+            SIM_make_attr_uint64(bpred_.get_history_bits()),
+            SIM_make_attr_uint64(bpred_.get_btb_entries()),
+            SIM_make_attr_uint64(bpred_.get_ras_depth())
+        );
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_bpred_config_from_attr(attr_value_t *val) {
+        if (SIM_attr_is_nil(*val)) {
+            bpred_.detach();
+            return Sim_Set_Ok;
+        }
+        uint8_t kind;
+        if (!RiscvCpuBranchPredictor::get_kind(SIM_attr_string(SIM_attr_list_item(*val, 0)), &kind)) {
+            return Sim_Set_Illegal_Value;
+        }
+        bool attached = bpred_.attach(
+            kind,
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 1))),
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 2))),
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 3))),
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 4)))
+        );
+        return attached ? Sim_Set_Ok : Sim_Set_Illegal_Value;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::bpred_stats_as_attr() const {
+        return SIM_make_attr_list(
+            6,
+            SIM_make_attr_uint64(bpred_.get_branches()),
+            SIM_make_attr_uint64(bpred_.get_branch_misses()),
+            SIM_make_attr_uint64(bpred_.get_jumps()),
+            SIM_make_attr_uint64(bpred_.get_jump_misses()),
+            SIM_make_attr_uint64(bpred_.get_returns()),
+            SIM_make_attr_uint64(bpred_.get_return_misses())
+        );
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,270 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-breakpoint.hpp"
+#include "riscv-cpu-tlb.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuBreakpoints::RiscvCpuBreakpoints() : global_(0) {}
+
+    void RiscvCpuBreakpoints::set(const breakpoint_set_t &set) {
+        clear();
+        for (int i = 0; i < set.num_breakpoints; ++i) {
+            const breakpoint_info_t &info = set.breakpoints[i];
+            uint8_t access = 0;
+            if (info.read_write_execute & Sim_Access_Read) {
+                access |= 1U << RiscvCpuTlb::READ;
+            }
+            if (info.read_write_execute & Sim_Access_Write) {
+                access |= 1U << RiscvCpuTlb::WRITE;
+            }
+            if (info.read_write_execute & Sim_Access_Execute) {
+                access |= 1U << RiscvCpuTlb::EXEC;
+            }
+            add(info.handle, access, info.start, info.end);
+        }
+    }
+
+    void RiscvCpuBreakpoints::add(breakpoint_handle_t handle, uint8_t access, uint64_t start, uint64_t end) {
+        if (access == 0 || end < start) {
+            return;
+        }
+        ranges_.push_back(breakpoint_range_t{handle, access, start, end});
+        uint64_t first = start >> PAGE_WIDTH;
+        uint64_t last = end >> PAGE_WIDTH;
+        if (last - first >= MAX_RANGE_PAGES) {
+            global_ |= access;
+            return;
+        }
+        for (uint64_t page = first; page <= last; ++page) {
+            pages_[page] |= access;
+        }
+    }
+
+    void RiscvCpuBreakpoints::clear() {
+        ranges_.clear();
+        pages_.clear();
+        global_ = 0;
+    }
+
+    bool RiscvCpuBreakpoints::match(
+        unsigned access, uint64_t addr, uint64_t size, std::vector<breakpoint_handle_t> *hits) const {
+        bool hit = false;
+        uint64_t last = addr + size - 1;
+        for (const breakpoint_range_t &range : ranges_) {
+            if ((range.access & (1U << access)) && range.start <= last && addr <= range.end) {
+                hits->push_back(range.handle);
+                hit = true;
+            }
+        }
+        return hit;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::breakpoint_change_c(lang_void *data, conf_object_t *obj) {
+        auto *cpu = static_cast<RiscvCpu *>(data);
+        if (obj == cpu->phys_mem_.obj().object()) {
+            cpu->update_breakpoints_();
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::update_breakpoints_() {
+        breakpoints_.clear();
+        conf_object_t *mem = phys_mem_.obj().object();
+        const breakpoint_query_v2_interface_t *query = (mem != nullptr)
+            ? SIM_C_GET_INTERFACE(mem, breakpoint_query_v2)
+            : nullptr;
+        if (query != nullptr) {
+            breakpoint_set_t set = query->get_breakpoints(
+                mem, static_cast<access_t>(Sim_Access_Read | Sim_Access_Write | Sim_Access_Execute), 0, ~0ULL
+            );
+            breakpoints_.set(set);
+            query->free_breakpoint_set(mem, &set);
+        }
+        // the breakpoint flags of the predecoded instructions are stale and the pages with
+        // read or write breakpoints mustn't stay cached
+        flush_caches_();
+        SIM_LOG_INFO(
+            3, cobj_, 0, "Breakpoints updated: ranges='%zu'", breakpoints_.get_ranges().size()
+        );
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::trigger_breakpoints_(unsigned access, reg_t addr, unsigned size, uint8_t *data) {
+        // the handles are collected first, a breakpoint callback may change the breakpoints
+        std::vector<breakpoint_handle_t> hits;
+        if (!breakpoints_.match(access, addr, size, &hits)) {
+            return false;
+        }
+        static constexpr access_t kind_access[RiscvCpuTlb::ACCESS_NUM] = {
+            Sim_Access_Read, Sim_Access_Write, Sim_Access_Execute
+        };
+        conf_object_t *mem = phys_mem_.obj().object();
+        const breakpoint_trigger_interface_t *trigger = SIM_C_GET_INTERFACE(mem, breakpoint_trigger);
+        if (trigger == nullptr) {
+            return false;
+        }
+        for (breakpoint_handle_t handle : hits) {
+            trigger->trigger_breakpoint(mem, cobj_, handle, addr, size, kind_access[access], data);
+        }
+        return true;
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::break_exec_(reg_t pc, const predecoded_instr_t &entry) {
+        // the breakpoint which ended the previous batch doesn't fire again, when the
+        // simulation is resumed the instruction is executed
+        if (current_step_ == break_step_ && pc == break_pc_) {
+            return false;
+        }
+        uint32_t instr = entry.instr;
+        if (!trigger_breakpoints_(RiscvCpuTlb::EXEC, pc, INSTR_SIZE, reinterpret_cast<uint8_t *>(&instr))) {
+            return false;
+        }
+        // the instruction isn't executed, a stop requested by the breakpoint takes effect
+        // before it
+        break_step_ = current_step_;
+        break_pc_ = pc;
+        batch_exit_ = true;
+        return true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::break_access_(unsigned access, reg_t addr, unsigned size, uint8_t *data) {
+        // the access is done, the simulation stops after the instruction
+        if (trigger_breakpoints_(access, addr, size, data)) {
+            batch_exit_ = true;
+        }
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::breakpoints_as_attr() const {
+        const std::vector<breakpoint_range_t> &ranges = breakpoints_.get_ranges();
+        attr_value_t ranges_attr = SIM_alloc_attr_list(static_cast<unsigned>(ranges.size()));
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            SIM_attr_list_set_item(
+                &ranges_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    4,
+                    SIM_make_attr_int64(ranges[i].handle),
+                    SIM_make_attr_uint64(ranges[i].access),
+                    SIM_make_attr_uint64(ranges[i].start),
+                    SIM_make_attr_uint64(ranges[i].end)
+                )
+            );
+        }
+        return ranges_attr;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::watch_access_(unsigned access, reg_t addr, unsigned size) {
+        std::vector<breakpoint_handle_t> hits;
+        if (!watchpoints_.match(access, addr, size, &hits)) {
+            // another part of the page
+            return;
+        }
+        // pc_ is advanced after the access, so it's the address of the accessing instruction
+        last_watch_hit_ = watchpoint_hit_t{
+            hits.front(), pc_, addr, size, static_cast<uint8_t>(access), static_cast<uint64_t>(current_step_)
+        };
+        char msg[128];
+        std::snprintf(
+            msg, sizeof(msg), "Watchpoint %d: %s of %u bytes at 0x%llx by the instruction at 0x%llx",
+            hits.front(), (access == RiscvCpuTlb::WRITE) ? "write" : "read", size,
+            static_cast<unsigned long long>(addr), static_cast<unsigned long long>(pc_)
+        );
+        SIM_LOG_INFO(1, cobj_, 0, "%s", msg);
+        batch_exit_ = true;
+        SIM_break_simulation(msg);
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::watchpoints_as_attr() const {
+        const std::vector<breakpoint_range_t> &ranges = watchpoints_.get_ranges();
+        attr_value_t ranges_attr = SIM_alloc_attr_list(static_cast<unsigned>(ranges.size()));
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            SIM_attr_list_set_item(
+                &ranges_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    3,
+                    SIM_make_attr_uint64(ranges[i].start),
+                    SIM_make_attr_uint64(ranges[i].end - ranges[i].start + 1),
+                    SIM_make_attr_uint64(ranges[i].access)
+                )
+            );
+        }
+        return ranges_attr;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_watchpoints_from_attr(attr_value_t *val) {
+        static constexpr uint64_t ACCESS_MASK = (1U << RiscvCpuTlb::READ) | (1U << RiscvCpuTlb::WRITE);
+        std::vector<breakpoint_range_t> ranges;
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t item = SIM_attr_list_item(*val, i);
+            uint64_t start = SIM_attr_integer(SIM_attr_list_item(item, 0));
+            uint64_t length = SIM_attr_integer(SIM_attr_list_item(item, 1));
+            uint64_t access = SIM_attr_integer(SIM_attr_list_item(item, 2));
+            if (length == 0 || start + (length - 1) < start || access == 0 || (access & ~ACCESS_MASK) != 0) {
+                return Sim_Set_Illegal_Value;
+            }
+            ranges.push_back(breakpoint_range_t{0, static_cast<uint8_t>(access), start, start + (length - 1)});
+        }
+        // the ranges set by the attribute aren't removed with the GDB session
+        set_watchpoints_(ranges, std::vector<bool>(ranges.size(), false));
+        return Sim_Set_Ok;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set_watchpoints_(
+        const std::vector<breakpoint_range_t> &ranges, const std::vector<bool> &gdb_owned
+    ) {
+        watchpoints_.clear();
+        gdb_watchpoints_ = gdb_owned;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            watchpoints_.add(static_cast<breakpoint_handle_t>(i), ranges[i].access, ranges[i].start, ranges[i].end);
+        }
+        // the pages with a watchpoint mustn't stay cached, the rest is cached again on a miss
+        for (auto &tlb : tlb_) {
+            tlb.flush();
+        }
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::watchpoint_hit_as_attr() const {
+        if (last_watch_hit_.handle == watchpoint_hit_t::NO_HIT) {
+            return SIM_make_attr_nil();
+        }
+        return SIM_make_attr_list(
+            5,
+            SIM_make_attr_int64(last_watch_hit_.handle),
+            SIM_make_attr_uint64(last_watch_hit_.pc),
+            SIM_make_attr_uint64(last_watch_hit_.addr),
+            SIM_make_attr_uint64(last_watch_hit_.size),
+            SIM_make_attr_uint64(1U << last_watch_hit_.access)
+        );
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,242 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-cache.hpp"
+
+namespace kz::riscv::core {
+    namespace {
+        const char *REPLACEMENT_NAMES[cache_replacement_t::NUM] = {"lru", "plru", "random"};
+
+        bool is_power_of_2(uint64_t value) {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+
+        unsigned log2(uint64_t value) {
+            unsigned shift = 0;
+            while ((1ULL << shift) < value) {
+                shift++;
+            }
+            return shift;
+        }
+    }
+
+    RiscvCpuCache::RiscvCpuCache() {
+        random_ = 0x9E3779B97F4A7C15ULL;
+        clear_stats();
+        detach();
+    }
+
+    const char *RiscvCpuCache::get_replacement_name(uint8_t replacement) {
+        return replacement < cache_replacement_t::NUM ? REPLACEMENT_NAMES[replacement] : "unknown";
+    }
+
+    bool RiscvCpuCache::get_replacement(const std::string &name, uint8_t *replacement) {
+        for (uint8_t i = 0; i < cache_replacement_t::NUM; ++i) {
+            if (name == REPLACEMENT_NAMES[i]) {
+                *replacement = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RiscvCpuCache::attach(uint64_t size, unsigned ways, unsigned line_size, uint8_t replacement,
+        bool write_back) {
+        // validate first, a rejected geometry keeps the attached cache
+        if (!is_power_of_2(size) || !is_power_of_2(ways) || !is_power_of_2(line_size) ||
+            ways > MAX_WAYS || size < static_cast<uint64_t>(ways) * line_size ||
+            replacement >= cache_replacement_t::NUM) {
+            return false;
+        }
+        detach();
+        ways_ = ways;
+        ways_shift_ = log2(ways);
+        line_shift_ = log2(line_size);
+        sets_ = static_cast<unsigned>(size / ways / line_size);
+        set_mask_ = sets_ - 1;
+        replacement_ = replacement;
+        write_back_ = write_back;
+        for (unsigned way = 0; way < ways_; ++way) {
+            uint64_t path = 0;
+            uint64_t away = 0;
+            unsigned node = 1;
+            for (unsigned level = ways_shift_; level != 0; --level) {
+                unsigned bit = (way >> (level - 1)) & 1;
+                path |= 1ULL << node;
+                away |= static_cast<uint64_t>(bit ^ 1) << node;
+                node = node * 2 + bit;
+            }
+            plru_path_[way] = ~path;
+            plru_away_[way] = away;
+        }
+        attached_ = true;
+        invalidate();
+        clear_stats();
+        return true;
+    }
+
+    void RiscvCpuCache::detach() {
+        attached_ = false;
+        ways_ = 1;
+        ways_shift_ = 0;
+        sets_ = 1;
+        line_shift_ = 6;
+        set_mask_ = 0;
+        replacement_ = cache_replacement_t::LRU;
+        write_back_ = true;
+        tags_.clear();
+        stamps_.clear();
+        plru_.clear();
+        dirty_.clear();
+        clock_ = 0;
+        last_line_ = INVALID;
+        last_set_ = 0;
+        last_way_ = 0;
+    }
+
+    void RiscvCpuCache::invalidate() {
+        for (uint64_t dirty : dirty_) {
+            writebacks_ += __builtin_popcountll(dirty);
+        }
+        tags_.assign(static_cast<size_t>(sets_) * ways_, INVALID);
+        stamps_.assign(replacement_ == cache_replacement_t::LRU ? tags_.size() : 0, 0);
+        plru_.assign(replacement_ == cache_replacement_t::PLRU ? sets_ : 0, 0);
+        dirty_.assign(sets_, 0);
+        clock_ = 0;
+        last_line_ = INVALID;
+    }
+
+    void RiscvCpuCache::clear_stats() {
+        reads_ = 0;
+        read_misses_ = 0;
+        writes_ = 0;
+        write_misses_ = 0;
+        writebacks_ = 0;
+    }
+
+    unsigned RiscvCpuCache::victim_(size_t set) {
+        const uint64_t *tags = &tags_[set * ways_];
+        for (unsigned way = 0; way < ways_; ++way) {
+            if (tags[way] == INVALID) {
+                return way;
+            }
+        }
+        switch (replacement_) {
+            case cache_replacement_t::LRU: {
+                const uint64_t *stamps = &stamps_[set * ways_];
+                unsigned victim = 0;
+                for (unsigned way = 1; way < ways_; ++way) {
+                    if (stamps[way] < stamps[victim]) {
+                        victim = way;
+                    }
+                }
+                return victim;
+            }
+            case cache_replacement_t::PLRU: {
+                // follow the bits from the root, they point to the less recently used half
+                uint64_t bits = plru_[set];
+                unsigned node = 1;
+                for (unsigned level = 0; level < ways_shift_; ++level) {
+                    node = node * 2 + static_cast<unsigned>((bits >> node) & 1);
+                }
+                return node - ways_;
+            }
+            default:
+                random_ ^= random_ << 13;
+                random_ ^= random_ >> 7;
+                random_ ^= random_ << 17;
+                return static_cast<unsigned>(random_ & (ways_ - 1));
+        }
+    }
+
+    unsigned RiscvCpuCache::miss_(size_t set, uint64_t line, bool is_write) {
+        if (is_write) {
+            write_misses_++;
+            if (!write_back_) {
+                // no write allocation, the write buffer takes the store
+                return 0;
+            }
+        } else {
+            read_misses_++;
+        }
+        unsigned way = victim_(set);
+        unsigned transfers = 1;
+        uint64_t bit = 1ULL << way;
+        if (dirty_[set] & bit) {
+            writebacks_++;
+            transfers++;
+        }
+        tags_[set * ways_ + way] = line;
+        dirty_[set] = (is_write && write_back_) ? (dirty_[set] | bit) : (dirty_[set] & ~bit);
+        touch_(set, way);
+        remember_(line, set, way);
+        return transfers;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::cache_config_as_attr(const RiscvCpuCache &cache) const {
+        if (!cache.is_attached()) {
+            return SIM_make_attr_nil();
+        }
+        return SIM_make_attr_list(
+            5,
+            SIM_make_attr_uint64(cache.get_size()),
+            SIM_make_attr_uint64(cache.get_ways()),
+            SIM_make_attr_uint64(cache.get_line_size()),
+            SIM_make_attr_string(RiscvCpuCache::get_replacement_name(cache.get_replacement())),
+            SIM_make_attr_boolean(cache.is_write_back())
+        );
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_cache_config_from_attr(RiscvCpuCache *cache, attr_value_t *val) {
+        if (SIM_attr_is_nil(*val)) {
+            cache->detach();
+            return Sim_Set_Ok;
+        }
+        uint8_t replacement;
+        if (!RiscvCpuCache::get_replacement(SIM_attr_string(SIM_attr_list_item(*val, 3)), &replacement)) {
+            return Sim_Set_Illegal_Value;
+        }
+        bool attached = cache->attach(
+            SIM_attr_integer(SIM_attr_list_item(*val, 0)),
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 1))),
+            static_cast<unsigned>(SIM_attr_integer(SIM_attr_list_item(*val, 2))),
+            replacement,
+            SIM_attr_boolean(SIM_attr_list_item(*val, 4))
+        );
+        return attached ? Sim_Set_Ok : Sim_Set_Illegal_Value;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::cache_stats_as_attr(const RiscvCpuCache &cache) const {
+        return SIM_make_attr_list(
+            5,
+            SIM_make_attr_uint64(cache.get_reads()),
+            SIM_make_attr_uint64(cache.get_read_misses()),
+            SIM_make_attr_uint64(cache.get_writes()),
+            SIM_make_attr_uint64(cache.get_write_misses()),
+            SIM_make_attr_uint64(cache.get_writebacks())
+        );
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,152 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-callgraph.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuCallGraph::RiscvCpuCallGraph() {
+        stack_.reserve(MAX_DEPTH);
+    }
+
+    void RiscvCpuCallGraph::start(uint64_t pc, uint64_t instructions, uint64_t cycles) {
+        stack_.clear();
+        stack_.push_back(Frame{pc, 0, 0, instructions, cycles, 0, 0});
+    }
+
+    void RiscvCpuCallGraph::stop(uint64_t instructions, uint64_t cycles) {
+        while (!stack_.empty()) {
+            pop_(instructions, cycles);
+        }
+    }
+
+    void RiscvCpuCallGraph::pop_(uint64_t instructions, uint64_t cycles) {
+        const Frame &frame = stack_.back();
+        uint64_t inclusive_instructions = instructions - frame.instructions;
+        uint64_t inclusive_cycles = cycles - frame.cycles;
+        Cost &function = functions_[frame.function];
+        function.calls++;
+        function.instructions += inclusive_instructions - frame.child_instructions;
+        function.cycles += inclusive_cycles - frame.child_cycles;
+        if (stack_.size() > 1) {
+            Frame &caller = stack_[stack_.size() - 2];
+            Cost &call = calls_[call_key_t{caller.function, frame.site, frame.function}];
+            call.calls++;
+            call.instructions += inclusive_instructions;
+            call.cycles += inclusive_cycles;
+            caller.child_instructions += inclusive_instructions;
+            caller.child_cycles += inclusive_cycles;
+        }
+        stack_.pop_back();
+    }
+
+    void RiscvCpuCallGraph::call(uint64_t site, uint64_t target, uint64_t instructions, uint64_t cycles) {
+        if (stack_.size() == MAX_DEPTH) {
+            // runaway recursion, the deepest frame is merged into its caller
+            pop_(instructions, cycles);
+        }
+        stack_.push_back(Frame{target, site, site + 4, instructions, cycles, 0, 0});
+    }
+
+    void RiscvCpuCallGraph::ret(uint64_t target, uint64_t instructions, uint64_t cycles) {
+        // frames skipped by the return (e.g. tail calls through the ra) are left as well
+        size_t depth = stack_.size();
+        while (depth > 1 && stack_[depth - 1].return_pc != target) {
+            depth--;
+        }
+        if (depth > 1) {
+            while (stack_.size() >= depth) {
+                pop_(instructions, cycles);
+            }
+            return;
+        }
+        // returned from the root, the function it returned to becomes the new root
+        stop(instructions, cycles);
+        start(target, instructions, cycles);
+    }
+
+    void RiscvCpuCallGraph::clear(uint64_t instructions, uint64_t cycles) {
+        functions_.clear();
+        calls_.clear();
+        for (Frame &frame : stack_) {
+            frame.instructions = instructions;
+            frame.cycles = cycles;
+            frame.child_instructions = 0;
+            frame.child_cycles = 0;
+        }
+    }
+
+    void RiscvCpuCallGraph::get(uint64_t instructions, uint64_t cycles,
+        std::vector<callgraph_function_t> *functions, std::vector<callgraph_call_t> *calls) const {
+        // the open frames are accounted on a copy
+        RiscvCpuCallGraph graph = *this;
+        graph.stop(instructions, cycles);
+        functions->clear();
+        for (const auto &[pc, cost] : graph.functions_) {
+            functions->push_back(callgraph_function_t{pc, cost.instructions, cost.cycles});
+        }
+        std::sort(functions->begin(), functions->end(),
+            [](const callgraph_function_t &a, const callgraph_function_t &b) { return a.pc < b.pc; });
+        calls->clear();
+        for (const auto &[key, cost] : graph.calls_) {
+            const auto &[caller, site, callee] = key;
+            calls->push_back(callgraph_call_t{caller, site, callee, cost.calls, cost.instructions, cost.cycles});
+        }
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::callgraph_as_attr() const {
+        std::vector<callgraph_function_t> functions;
+        std::vector<callgraph_call_t> calls;
+        callgraph_.get(current_step_, current_cycle_ + stall_cycles_, &functions, &calls);
+        attr_value_t functions_attr = SIM_alloc_attr_list(static_cast<unsigned>(functions.size()));
+        for (size_t i = 0; i < functions.size(); ++i) {
+            SIM_attr_list_set_item(
+                &functions_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    3,
+                    SIM_make_attr_uint64(functions[i].pc),
+                    SIM_make_attr_uint64(functions[i].instructions),
+                    SIM_make_attr_uint64(functions[i].cycles)
+                )
+            );
+        }
+        attr_value_t calls_attr = SIM_alloc_attr_list(static_cast<unsigned>(calls.size()));
+        for (size_t i = 0; i < calls.size(); ++i) {
+            SIM_attr_list_set_item(
+                &calls_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    6,
+                    SIM_make_attr_uint64(calls[i].caller),
+                    SIM_make_attr_uint64(calls[i].site),
+                    SIM_make_attr_uint64(calls[i].callee),
+                    SIM_make_attr_uint64(calls[i].calls),
+                    SIM_make_attr_uint64(calls[i].instructions),
+                    SIM_make_attr_uint64(calls[i].cycles)
+                )
+            );
+        }
+        return SIM_make_attr_list(2, functions_attr, calls_attr);
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
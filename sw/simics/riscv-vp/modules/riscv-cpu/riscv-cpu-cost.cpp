@@ -0,0 +1,115 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu-cost.hpp"
+
+namespace kz::riscv::core {
+    namespace {
+        class CostPreset {
+        public:
+            const char *name;
+            RiscvCpuCostModel::latencies_t latencies;
+        };
+
+        // ALU, BRANCH_TAKEN, BRANCH_NOT_TAKEN, LOAD, STORE, MUL_DIV, CSR
+        const CostPreset PRESETS[] = {
+            {"default", {1, 1, 1, 1, 1, 1, 1}},
+            // fde_ip starts a new fetch-decode-execute iteration every 6 cycles (II=6)
+            // regardless of the instruction
+            {"fde_ip", {6, 6, 6, 6, 6, 6, 6}},
+        };
+
+        const char *CLASS_NAMES[cost_class_t::NUM] = {
+            "alu", "branch_taken", "branch_not_taken", "load", "store", "mul_div", "csr"
+        };
+    }
+
+    RiscvCpuCostModel::RiscvCpuCostModel() {
+        set_preset("default");
+    }
+
+    const char *RiscvCpuCostModel::get_class_name(uint8_t cls) {
+        return cls < cost_class_t::NUM ? CLASS_NAMES[cls] : "unknown";
+    }
+
+    bool RiscvCpuCostModel::get_class(const std::string &name, uint8_t *cls) {
+        for (uint8_t i = 0; i < cost_class_t::NUM; ++i) {
+            if (name == CLASS_NAMES[i]) {
+                *cls = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint8_t RiscvCpuCostModel::classify(const kz::riscv::types::dec_instr_t &dec_instr) {
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        switch (dec_instr.opcode) {
+            case operation_code_t::LOAD:
+                return cost_class_t::LOAD;
+            case operation_code_t::STORE:
+                return cost_class_t::STORE;
+            case operation_code_t::BRANCH:
+                return cost_class_t::BRANCH_NOT_TAKEN;
+            case operation_code_t::JAL:
+            case operation_code_t::JALR:
+                return cost_class_t::BRANCH_TAKEN;
+            case operation_code_t::SYSTEM:
+                return cost_class_t::CSR;
+            case operation_code_t::OP:
+            case operation_code_t::OP_32:
+                return dec_instr.func7 == 0b0000001 ? cost_class_t::MUL_DIV : cost_class_t::ALU;
+            default:
+                return cost_class_t::ALU;
+        }
+    }
+
+    bool RiscvCpuCostModel::set_preset(const std::string &name) {
+        for (const auto &preset : PRESETS) {
+            if (name == preset.name) {
+                latencies_ = preset.latencies;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *RiscvCpuCostModel::get_preset() const {
+        for (const auto &preset : PRESETS) {
+            if (latencies_ == preset.latencies) {
+                return preset.name;
+            }
+        }
+        return "custom";
+    }
+
+    void RiscvCpuCostModel::resolve(const kz::riscv::types::dec_instr_t &dec_instr,
+        const custom_instr_t *custom, uint16_t *cycles, uint16_t *taken_cycles) const {
+        if (custom != nullptr) {
+            // the bound latency is charged by the execution itself
+            *cycles = 1;
+            *taken_cycles = 1;
+            return;
+        }
+        uint8_t cls = classify(dec_instr);
+        *cycles = latencies_[cls];
+        // a conditional branch is taken when it leaves the fall-through path
+        *taken_cycles = cls == cost_class_t::BRANCH_NOT_TAKEN ? latencies_[cost_class_t::BRANCH_TAKEN] : *cycles;
+    }
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,105 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-coverage.hpp"
+
+namespace kz::riscv::core {
+    void RiscvCpuCoverage::merge(const coverage_page_t &page) {
+        auto &bits = pages_[page.addr >> PAGE_WIDTH];
+        for (unsigned i = 0; i < CoveragePage::WORDS; ++i) {
+            bits[i] |= page.bits[i];
+        }
+    }
+
+    std::vector<coverage_page_t> RiscvCpuCoverage::get() const {
+        std::vector<coverage_page_t> pages;
+        pages.reserve(pages_.size());
+        for (const auto &[page, bits] : pages_) {
+            pages.push_back(coverage_page_t{page << PAGE_WIDTH, bits});
+        }
+        std::sort(pages.begin(), pages.end(),
+            [](const coverage_page_t &a, const coverage_page_t &b) { return a.addr < b.addr; });
+        return pages;
+    }
+
+    uint64_t RiscvCpuCoverage::get_covered() const {
+        uint64_t covered = 0;
+        for (const auto &[page, bits] : pages_) {
+            for (uint64_t word : bits) {
+                covered += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+        }
+        return covered;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::coverage_as_attr() const {
+        std::vector<coverage_page_t> pages = coverage_.get();
+        attr_value_t pages_attr = SIM_alloc_attr_list(static_cast<unsigned>(pages.size()));
+        for (size_t i = 0; i < pages.size(); ++i) {
+            uint8_t data[sizeof(coverage_page_t::bits)];
+            // little-endian bit order, bit n of the data is the slot n of the page
+            for (unsigned j = 0; j < sizeof(data); ++j) {
+                data[j] = static_cast<uint8_t>(pages[i].bits[j / 8] >> (8 * (j % 8)));
+            }
+            SIM_attr_list_set_item(
+                &pages_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    2,
+                    SIM_make_attr_uint64(pages[i].addr),
+                    SIM_make_attr_data(sizeof(data), data)
+                )
+            );
+        }
+        return pages_attr;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_coverage_from_attr(attr_value_t *val) {
+        std::vector<coverage_page_t> pages;
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t item = SIM_attr_list_item(*val, i);
+            uint64_t addr = SIM_attr_integer(SIM_attr_list_item(item, 0));
+            attr_value_t data = SIM_attr_list_item(item, 1);
+            if ((addr & (RiscvCpuCoverage::PAGE_SIZE - 1)) != 0 ||
+                SIM_attr_data_size(data) != sizeof(coverage_page_t::bits)) {
+                return Sim_Set_Illegal_Value;
+            }
+            coverage_page_t page{addr, {}};
+            const uint8 *bytes = SIM_attr_data(data);
+            for (unsigned j = 0; j < sizeof(coverage_page_t::bits); ++j) {
+                page.bits[j / 8] |= static_cast<uint64_t>(bytes[j]) << (8 * (j % 8));
+            }
+            pages.push_back(page);
+        }
+        coverage_.clear();
+        for (const coverage_page_t &page : pages) {
+            coverage_.merge(page);
+        }
+        // the cached instructions are marked again when they are predecoded
+        predecode_cache_.flush();
+        return Sim_Set_Ok;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
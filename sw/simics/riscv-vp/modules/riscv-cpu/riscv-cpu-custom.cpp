@@ -0,0 +1,85 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-custom.hpp"
+
+namespace kz::riscv::core {
+    bool RiscvCpuCustom::matches_(int pattern, unsigned value) {
+        return pattern == RISCV_CUSTOM_ANY_FUNC || static_cast<unsigned>(pattern) == value;
+    }
+
+    bool RiscvCpuCustom::is_custom_opcode(opcode_t opcode) {
+        switch (opcode) {
+            case operation_code_t::CUSTOM_0:
+            case operation_code_t::CUSTOM_1:
+            case operation_code_t::CUSTOM_2_RV128:
+            case operation_code_t::CUSTOM_3_RV128:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool RiscvCpuCustom::bind(const custom_instr_t &instr) {
+        if (!is_custom_opcode(instr.opcode) || instr.handler == nullptr) {
+            return false;
+        }
+        for (const auto &i : instrs_) {
+            if (i.opcode == instr.opcode && i.func3 == instr.func3 && i.func7 == instr.func7) {
+                return false;
+            }
+        }
+        instrs_.push_back(instr);
+        return true;
+    }
+
+    bool RiscvCpuCustom::unbind(uint8_t opcode, int func3, int func7) {
+        for (auto it = instrs_.begin(); it != instrs_.end(); ++it) {
+            if (it->opcode == opcode && it->func3 == func3 && it->func7 == func7) {
+                instrs_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const custom_instr_t *RiscvCpuCustom::resolve(const dec_instr_t &dec_instr) const {
+        if (!is_custom_opcode(dec_instr.opcode)) {
+            return nullptr;
+        }
+        const custom_instr_t *best = nullptr;
+        int best_score = -1;
+        for (const auto &i : instrs_) {
+            if (i.opcode != dec_instr.opcode
+                || !matches_(i.func3, dec_instr.func3)
+                || !matches_(i.func7, dec_instr.func7)) {
+                continue;
+            }
+            // the more specific pattern wins: func3 exact match weights more than func7 one
+            int score = (i.func3 != RISCV_CUSTOM_ANY_FUNC ? 2 : 0)
+                + (i.func7 != RISCV_CUSTOM_ANY_FUNC ? 1 : 0);
+            if (score > best_score) {
+                best = &i;
+                best_score = score;
+            }
+        }
+        return best;
+    }
+} /* ! kz::riscv::core ! */
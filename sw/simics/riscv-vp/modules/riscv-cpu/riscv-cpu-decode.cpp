@@ -57,4 +57,35 @@ namespace kz::riscv::core {
         dec_instr_(instr, p_dec_instr);
         dec_imm_(instr, p_dec_instr);
     }
+
+    uint32_t RiscvCpuDecoder::get_op_key(const dec_instr_t &dec_instr) {
+        uint32_t key = static_cast<uint32_t>(dec_instr.opcode) << 15;
+        if (dec_instr.type == operation_type_t::U_TYPE || dec_instr.type == operation_type_t::J_TYPE) {
+            return key;
+        }
+        key |= static_cast<uint32_t>(dec_instr.func3) << 12;
+        switch (dec_instr.opcode) {
+            case operation_code_t::OP:
+            case operation_code_t::OP_32:
+                return key | static_cast<uint32_t>(dec_instr.func7);
+            case operation_code_t::OP_IMM:
+            case operation_code_t::OP_IMM_32:
+                // shifts, func7 bit 0 is shamt[5] on RV64
+                if (dec_instr.func3 == 0b001 || dec_instr.func3 == 0b101) {
+                    return key | (static_cast<uint32_t>(dec_instr.func7) & 0x7e);
+                }
+                return key;
+            case operation_code_t::SYSTEM:
+                if (dec_instr.func3 != 0b000) {
+                    return key;
+                }
+                if (dec_instr.func7 == 0b0001001) { // sfence.vma rs1, rs2
+                    return key | (static_cast<uint32_t>(dec_instr.func7) << 5);
+                }
+                return key | (static_cast<uint32_t>(dec_instr.func7) << 5)
+                    | static_cast<uint32_t>(dec_instr.rs2);
+            default:
+                return key;
+        }
+    }
 } /* ! kz::riscv::core ! */
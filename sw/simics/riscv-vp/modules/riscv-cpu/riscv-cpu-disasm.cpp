@@ -161,11 +161,75 @@ namespace kz::riscv::core {
                 return "jalr";
             case operation_code_t::LUI: return "lui";
             case operation_code_t::AUIPC: return "auipc";
+            case operation_code_t::OP_IMM_32: {
+                switch (dec_instr.func3) {
+                    case 0b000: return "addiw";
+                    case 0b001: return dec_instr.func7 == 0b0000000 ? "slliw" : "unknown";
+                    case 0b101:
+                        if (dec_instr.func7 == 0b0000000) return "srliw";
+                        if (dec_instr.func7 == 0b0100000) return "sraiw";
+                        return "unknown";
+                    default: return "unknown";
+                }
+            }
+            case operation_code_t::OP_32: {
+                switch (dec_instr.func3) {
+                    case 0b000:
+                        if (dec_instr.func7 == 0b0000000) return "addw";
+                        if (dec_instr.func7 == 0b0100000) return "subw";
+                        return "unknown";
+                    case 0b001: return dec_instr.func7 == 0b0000000 ? "sllw" : "unknown";
+                    case 0b101:
+                        if (dec_instr.func7 == 0b0000000) return "srlw";
+                        if (dec_instr.func7 == 0b0100000) return "sraw";
+                        return "unknown";
+                    default: return "unknown";
+                }
+            }
+            case operation_code_t::MISC_MEM:
+                if (dec_instr.func3 == 0b000) return "fence";
+                if (dec_instr.func3 == 0b001) return "fence.i";
+                return "unknown";
+            case operation_code_t::SYSTEM: {
+                static constexpr std::array<const char*, 8> csr_table = {
+                    "unknown", "csrrw", "csrrs", "csrrc", "unknown", "csrrwi", "csrrsi", "csrrci"
+                };
+                if (dec_instr.func3 != 0b000)
+                    return csr_table[dec_instr.func3];
+                if (dec_instr.func7 == 0b0001001) return "sfence.vma";
+                // the remaining ones are told apart by the whole imm[11:0] field
+                switch ((dec_instr.func7 << 5) | dec_instr.rs2) {
+                    case 0x000: return "ecall";
+                    case 0x001: return "ebreak";
+                    case 0x102: return "sret";
+                    case 0x105: return "wfi";
+                    case 0x302: return "mret";
+                    default: return "unknown";
+                }
+            }
             default: return "unknown";
         }
     }
 
-    std::string RiscvCpuDisasm::disasm(addr_t pc, dec_instr_t dec_instr) {
+    std::string RiscvCpuDisasm::get_op_name(dec_instr_t dec_instr) {
+        // non-zero registers, so the pseudo-instructions aren't reported
+        dec_instr.rd = 1;
+        dec_instr.rs1 = 1;
+        std::string mnemonic = get_mnemonic(dec_instr.opcode, dec_instr);
+        if (mnemonic == "unknown") {
+            mnemonic = get_opcode(dec_instr.opcode) + "/"
+                + std::to_string(static_cast<unsigned>(dec_instr.func3)) + "/"
+                + std::to_string(static_cast<unsigned>(dec_instr.func7));
+        }
+        return mnemonic;
+    }
+
+    uint64_t RiscvCpuDisasm::get_target_(uint64_t pc, dec_instr_t dec_instr) {
+        // the decoder keeps the B-type and J-type offsets in halfwords (imm[12:1], imm[20:1])
+        return pc + (static_cast<uint64_t>(static_cast<int64_t>(dec_instr.imm)) << 1);
+    }
+
+    std::string RiscvCpuDisasm::disasm(uint64_t pc, dec_instr_t dec_instr) {
         std::ostringstream ss;
         std::string mnemonic = get_mnemonic(dec_instr.opcode, dec_instr);
         switch (dec_instr.type) {
@@ -219,7 +283,7 @@ namespace kz::riscv::core {
                 ss << mnemonic << " "
                 << get_reg_name(dec_instr.rs1) << ", "
                 << get_reg_name(dec_instr.rs2) << ", "
-                << ((int)pc + (int)(dec_instr.imm >> 1)) * sizeof(kz::riscv::types::instr_t);
+                << "0x" << std::hex << get_target_(pc, dec_instr);
                 break;
             }
             case operation_type_t::U_TYPE: {
@@ -231,7 +295,7 @@ namespace kz::riscv::core {
             case operation_type_t::J_TYPE: {
                 ss << mnemonic << " "
                 << get_reg_name(dec_instr.rd) << ", "
-                << ((int)pc + (int)(dec_instr.imm >> 1)) * sizeof(kz::riscv::types::instr_t);
+                << "0x" << std::hex << get_target_(pc, dec_instr);
                 break;
             }
         }
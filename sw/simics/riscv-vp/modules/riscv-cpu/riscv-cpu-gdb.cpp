@@ -0,0 +1,742 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-gdb.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuGdb::RiscvCpuGdb() : listen_fd_(-1), client_fd_(-1), port_(0), no_ack_(false) {}
+
+    RiscvCpuGdb::~RiscvCpuGdb() {
+        close();
+    }
+
+    bool RiscvCpuGdb::listen(uint16_t port) {
+        close();
+#ifndef _WIN32
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        // the stub can change the memory and the registers, it's reachable from the local host only
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 1) != 0) {
+            ::close(fd);
+            return false;
+        }
+        listen_fd_ = fd;
+        port_ = port;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void RiscvCpuGdb::close() {
+        disconnect();
+#ifndef _WIN32
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+        }
+#endif
+        listen_fd_ = -1;
+        port_ = 0;
+    }
+
+    bool RiscvCpuGdb::accept() {
+#ifndef _WIN32
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            return false;
+        }
+        disconnect();
+        // the replies are complete packets, they shouldn't wait for the acknowledgements
+        int nodelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        client_fd_ = fd;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void RiscvCpuGdb::disconnect() {
+#ifndef _WIN32
+        if (client_fd_ >= 0) {
+            ::close(client_fd_);
+        }
+#endif
+        client_fd_ = -1;
+        no_ack_ = false;
+        input_.clear();
+        last_sent_.clear();
+    }
+
+    bool RiscvCpuGdb::receive(std::vector<std::string> *packets, bool *interrupt) {
+#ifndef _WIN32
+        char buffer[0x10000];
+        for (;;) {
+            ssize_t size = ::recv(client_fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (size == 0) {
+                return false;
+            }
+            if (size < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            input_.append(buffer, static_cast<size_t>(size));
+        }
+#endif
+        size_t pos = 0;
+        while (pos < input_.size()) {
+            char c = input_[pos];
+            if (c == '$') {
+                size_t end = input_.find('#', pos + 1);
+                if (end == std::string::npos || end + 2 >= input_.size()) {
+                    // incomplete, the rest comes with the next data
+                    break;
+                }
+                uint8_t sum = 0;
+                for (size_t i = pos + 1; i < end; ++i) {
+                    sum += static_cast<uint8_t>(input_[i]);
+                }
+                bool valid = std::strtoul(input_.substr(end + 1, 2).c_str(), nullptr, 16) == sum;
+                if (!no_ack_) {
+                    write_(valid ? "+" : "-", 1);
+                }
+                if (valid || no_ack_) {
+                    packets->push_back(input_.substr(pos + 1, end - pos - 1));
+                }
+                pos = end + 3;
+                continue;
+            }
+            if (c == INTERRUPT) {
+                *interrupt = true;
+            } else if (c == '-' && !last_sent_.empty()) {
+                write_(last_sent_.data(), last_sent_.size());
+            }
+            // acknowledgements and noise between the packets
+            ++pos;
+        }
+        input_.erase(0, pos);
+        return true;
+    }
+
+    void RiscvCpuGdb::send(const std::string &payload) {
+        std::string packet;
+        packet.reserve(payload.size() + 4);
+        packet.push_back('$');
+        uint8_t sum = 0;
+        for (char c : payload) {
+            if (c == '$' || c == '#' || c == '}' || c == '*') {
+                packet.push_back('}');
+                sum += static_cast<uint8_t>('}');
+                c ^= 0x20;
+            }
+            packet.push_back(c);
+            sum += static_cast<uint8_t>(c);
+        }
+        char checksum[4];
+        std::snprintf(checksum, sizeof(checksum), "#%02x", sum);
+        packet.append(checksum);
+        write_(packet.data(), packet.size());
+        if (!no_ack_) {
+            last_sent_ = std::move(packet);
+        }
+    }
+
+    void RiscvCpuGdb::write_(const char *data, size_t size) {
+#ifndef _WIN32
+        while (size > 0 && client_fd_ >= 0) {
+            ssize_t written = ::send(client_fd_, data, size, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#endif
+    }
+
+    static const char *const GDB_REG_NAMES[RV32I_GP_REG_NUM] = {
+        "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2", "fp", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+        "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+    };
+
+    static void append_hex(std::string *out, const uint8_t *data, size_t size) {
+        static const char digits[] = "0123456789abcdef";
+        for (size_t i = 0; i < size; ++i) {
+            out->push_back(digits[data[i] >> 4]);
+            out->push_back(digits[data[i] & 0xf]);
+        }
+    }
+
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static bool parse_hex(const char *text, size_t size, uint8_t *data) {
+        for (size_t i = 0; i < size; ++i) {
+            int high = hex_value(text[2 * i]);
+            int low = (high < 0) ? -1 : hex_value(text[2 * i + 1]);
+            if (low < 0) {
+                return false;
+            }
+            data[i] = static_cast<uint8_t>((high << 4) | low);
+        }
+        return true;
+    }
+
+    // the hexadecimal number at pos, pos is moved behind it and the separator following it
+    static uint64_t parse_number(const std::string &text, size_t *pos) {
+        uint64_t value = 0;
+        int digit;
+        while (*pos < text.size() && (digit = hex_value(text[*pos])) >= 0) {
+            value = (value << 4) | static_cast<uint64_t>(digit);
+            ++*pos;
+        }
+        if (*pos < text.size()) {
+            ++*pos;
+        }
+        return value;
+    }
+
+    template<unsigned XLEN>
+    event_class_t *RiscvCpu<XLEN>::gdb_step_event_ = nullptr;
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_accept_c(lang_void *data) {
+        auto *cpu = static_cast<RiscvCpu *>(data);
+        if (cpu->gdb_.is_connected()) {
+            // a new client replaces the connected one
+            cpu->gdb_disconnect_();
+        }
+        if (!cpu->gdb_.accept()) {
+            return;
+        }
+        SIM_notify_on_socket(cpu->gdb_.get_client_socket(), Sim_NM_Read, 0, gdb_receive_c, cpu);
+        SIM_LOG_INFO(1, cpu->cobj_, 0, "GDB connected on port %d", cpu->gdb_.get_port());
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_receive_c(lang_void *data) {
+        auto *cpu = static_cast<RiscvCpu *>(data);
+        std::vector<std::string> packets;
+        bool interrupt = false;
+        if (!cpu->gdb_.receive(&packets, &interrupt)) {
+            cpu->gdb_disconnect_();
+            return;
+        }
+        // all-stop mode, the packets received while the target runs wait for its stop reply
+        cpu->gdb_pending_.insert(cpu->gdb_pending_.end(), packets.begin(), packets.end());
+        cpu->gdb_process_();
+        if (interrupt && cpu->gdb_running_) {
+            if (SIM_simics_is_running()) {
+                SIM_break_simulation("Interrupted by GDB");
+            } else {
+                // received with the resume packet, the run scheduled by it isn't started
+                gdb_stopped_c(cpu, cpu->cobj_, 0, nullptr);
+            }
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_process_() {
+        while (!gdb_pending_.empty() && !gdb_running_) {
+            std::string packet = std::move(gdb_pending_.front());
+            gdb_pending_.pop_front();
+            bool close = false;
+            std::string reply = gdb_handle_(packet, &close);
+            // the target runs, the stop reply is sent when it stops and the rest waits for it
+            if (gdb_running_) {
+                return;
+            }
+            // kill has no reply
+            if (packet != "k") {
+                gdb_.send(reply);
+            }
+            if (packet == "QStartNoAckMode") {
+                gdb_.set_no_ack();
+            }
+            if (close) {
+                gdb_disconnect_();
+                return;
+            }
+        }
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::open_gdb_(uint16_t port) {
+        close_gdb_();
+        if (port == 0) {
+            return true;
+        }
+        if (!gdb_.listen(port)) {
+            SIM_LOG_ERROR(cobj_, 0, "Can not listen for GDB on port %u", static_cast<unsigned>(port));
+            return false;
+        }
+        SIM_notify_on_socket(gdb_.get_listen_socket(), Sim_NM_Read, 0, gdb_accept_c, this);
+        gdb_stopped_hap_ = SIM_hap_add_callback(
+            "Core_Simulation_Stopped", reinterpret_cast<obj_hap_func_t>(gdb_stopped_c), this
+        );
+        SIM_LOG_INFO(1, cobj_, 0, "Waiting for GDB on port %u", static_cast<unsigned>(port));
+        return true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::close_gdb_() {
+        if (gdb_.is_connected()) {
+            gdb_disconnect_();
+        }
+        if (gdb_.get_listen_socket() >= 0) {
+            SIM_notify_on_socket(gdb_.get_listen_socket(), Sim_NM_Read, 0, nullptr, nullptr);
+        }
+        if (gdb_stopped_hap_ >= 0) {
+            SIM_hap_delete_callback_id("Core_Simulation_Stopped", gdb_stopped_hap_);
+            gdb_stopped_hap_ = -1;
+        }
+        gdb_.close();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_disconnect_() {
+        SIM_notify_on_socket(gdb_.get_client_socket(), Sim_NM_Read, 0, nullptr, nullptr);
+        gdb_.disconnect();
+        gdb_pending_.clear();
+        // a continued simulation keeps running without the stop reply
+        if (gdb_running_) {
+            gdb_running_ = false;
+            SIM_event_cancel_step(cobj_, gdb_step_event_, cobj_, nullptr, nullptr);
+        }
+        // the breakpoints and watchpoints of the session aren't left behind
+        for (const auto &[addr, id] : gdb_breakpoints_) {
+            SIM_delete_breakpoint(id);
+        }
+        gdb_breakpoints_.clear();
+        if (std::find(gdb_watchpoints_.begin(), gdb_watchpoints_.end(), true) != gdb_watchpoints_.end()) {
+            const std::vector<breakpoint_range_t> &ranges = watchpoints_.get_ranges();
+            std::vector<breakpoint_range_t> kept;
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                if (i >= gdb_watchpoints_.size() || !gdb_watchpoints_[i]) {
+                    kept.push_back(ranges[i]);
+                }
+            }
+            set_watchpoints_(kept, std::vector<bool>(kept.size(), false));
+        }
+        SIM_LOG_INFO(1, cobj_, 0, "GDB disconnected");
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::gdb_memory_(uint64_t addr, size_t size, uint8_t *data, bool is_write) {
+        while (size > 0) {
+            uint64_t page = addr & RiscvCpuTlb::PAGE_MASK;
+            size_t chunk = std::min<uint64_t>(size, RiscvCpuTlb::PAGE_SIZE - (addr - page));
+            // the memory is copied through the direct memory pointer, page by page, only the
+            // devices get a transaction
+            uint8_t *host = get_page_host_(page, is_write ? RiscvCpuTlb::WRITE : RiscvCpuTlb::READ);
+            if (host != nullptr) {
+                if (is_write) {
+                    std::memcpy(host + (addr - page), data, chunk);
+                } else {
+                    std::memcpy(data, host + (addr - page), chunk);
+                }
+            } else if (!host_access_(addr, chunk, data, is_write)) {
+                return false;
+            }
+            if (is_write) {
+                predecode_cache_.flush_range(page, RiscvCpuTlb::PAGE_SIZE);
+            }
+            addr += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_resume_(bool step) {
+        gdb_watch_step_ = last_watch_hit_.step;
+        gdb_watch_handle_ = last_watch_hit_.handle;
+        gdb_running_ = true;
+        if (step) {
+            SIM_event_post_step(cobj_, gdb_step_event_, cobj_, 1, nullptr);
+        }
+        // the socket callback returns before the simulation runs, so the interrupt is received
+        SIM_register_work(gdb_continue_c, this);
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_continue_c(lang_void *data) {
+        auto *cpu = static_cast<RiscvCpu *>(data);
+        // the client may be gone, or the simulation started by the command line meanwhile
+        if (cpu->gdb_running_ && !SIM_simics_is_running()) {
+            SIM_continue(0);
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_step_event_c(conf_object_t *obj, lang_void *data) {
+        SIM_break_simulation("Stepped by GDB");
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::gdb_stopped_c(lang_void *data, conf_object_t *obj, int64 exception, char *error) {
+        auto *cpu = static_cast<RiscvCpu *>(data);
+        if (!cpu->gdb_running_) {
+            return;
+        }
+        cpu->gdb_running_ = false;
+        // a breakpoint may stop the simulation before the step
+        SIM_event_cancel_step(cpu->cobj_, gdb_step_event_, cpu->cobj_, nullptr, nullptr);
+        cpu->gdb_.send(cpu->gdb_stop_reply_());
+        cpu->gdb_process_();
+    }
+
+    template<unsigned XLEN>
+    std::string RiscvCpu<XLEN>::gdb_stop_reply_() const {
+        if (exited_) {
+            char reply[8];
+            std::snprintf(reply, sizeof(reply), "W%02x", static_cast<unsigned>(exit_code_ & 0xff));
+            return reply;
+        }
+        const std::vector<breakpoint_range_t> &ranges = watchpoints_.get_ranges();
+        if (last_watch_hit_.handle != watchpoint_hit_t::NO_HIT &&
+            (last_watch_hit_.step != gdb_watch_step_ || last_watch_hit_.handle != gdb_watch_handle_) &&
+            static_cast<size_t>(last_watch_hit_.handle) < ranges.size()) {
+            uint8_t access = ranges[last_watch_hit_.handle].access;
+            const char *kind = (access == ((1U << RiscvCpuTlb::READ) | (1U << RiscvCpuTlb::WRITE)))
+                ? "awatch"
+                : (access & (1U << RiscvCpuTlb::WRITE)) ? "watch" : "rwatch";
+            char reply[64];
+            std::snprintf(
+                reply, sizeof(reply), "T05%s:%llx;", kind, static_cast<unsigned long long>(last_watch_hit_.addr)
+            );
+            return reply;
+        }
+        return "S05";
+    }
+
+    template<unsigned XLEN>
+    std::string RiscvCpu<XLEN>::gdb_breakpoint_(bool insert, const std::string &packet) {
+        // Ztype,addr,kind: 0 and 1 execution, 2 write, 3 read and 4 access watchpoints
+        size_t pos = 3;
+        if (packet.size() < pos) {
+            return "E01";
+        }
+        char type = packet[1];
+        uint64_t addr = parse_number(packet, &pos);
+        uint64_t kind = parse_number(packet, &pos);
+        if (type == '0' || type == '1') {
+            // both kinds are the breakpoints of the memory space, checked by the CPU on the
+            // pages they are set on (see update_breakpoints_), the code isn't patched
+            auto it = gdb_breakpoints_.find(addr);
+            if (!insert) {
+                if (it != gdb_breakpoints_.end()) {
+                    SIM_delete_breakpoint(it->second);
+                    gdb_breakpoints_.erase(it);
+                }
+                return "OK";
+            }
+            if (it != gdb_breakpoints_.end()) {
+                return "OK";
+            }
+            conf_object_t *mem = phys_mem_.obj().object();
+            if (mem == nullptr) {
+                return "E01";
+            }
+            breakpoint_id_t id = SIM_breakpoint(
+                mem, Sim_Break_Physical, Sim_Access_Execute, addr, std::max<uint64_t>(kind, 1), Sim_Breakpoint_Simulation
+            );
+            if (id < 0) {
+                SIM_clear_exception();
+                return "E01";
+            }
+            gdb_breakpoints_[addr] = id;
+            return "OK";
+        }
+        if (type < '2' || type > '4' || kind == 0) {
+            return "";
+        }
+        uint8_t access = (type == '2') ? (1U << RiscvCpuTlb::WRITE)
+            : (type == '3') ? (1U << RiscvCpuTlb::READ)
+            : ((1U << RiscvCpuTlb::READ) | (1U << RiscvCpuTlb::WRITE));
+        std::vector<breakpoint_range_t> ranges = watchpoints_.get_ranges();
+        std::vector<bool> gdb_owned = gdb_watchpoints_;
+        gdb_owned.resize(ranges.size(), false);
+        if (insert) {
+            ranges.push_back(breakpoint_range_t{0, access, addr, addr + kind - 1});
+            gdb_owned.push_back(true);
+        } else {
+            // only a watchpoint of the session is removed, not the same range of the attribute
+            size_t i = 0;
+            while (i < ranges.size() &&
+                   !(gdb_owned[i] && ranges[i].access == access && ranges[i].start == addr &&
+                     ranges[i].end == addr + kind - 1)) {
+                ++i;
+            }
+            if (i == ranges.size()) {
+                return "E01";
+            }
+            ranges.erase(ranges.begin() + i);
+            gdb_owned.erase(gdb_owned.begin() + i);
+        }
+        set_watchpoints_(ranges, gdb_owned);
+        return "OK";
+    }
+
+    template<unsigned XLEN>
+    std::string RiscvCpu<XLEN>::gdb_target_xml_() const {
+        std::string bits = std::to_string(XLEN);
+        std::string xml =
+            "<?xml version=\"1.0\"?><!DOCTYPE target SYSTEM \"gdb-target.dtd\"><target version=\"1.0\">"
+            "<architecture>riscv:rv" + bits + "</architecture><feature name=\"org.gnu.gdb.riscv.cpu\">";
+        for (int i = 0; i < RV32I_GP_REG_NUM; ++i) {
+            const char *type = (i == 1) ? "code_ptr" : (i == 2) ? "data_ptr" : "int";
+            xml += std::string("<reg name=\"") + GDB_REG_NAMES[i] + "\" bitsize=\"" + bits + "\" type=\"" + type + "\"/>";
+        }
+        xml += "<reg name=\"pc\" bitsize=\"" + bits + "\" type=\"code_ptr\"/></feature></target>";
+        return xml;
+    }
+
+    template<unsigned XLEN>
+    std::string RiscvCpu<XLEN>::gdb_handle_(const std::string &packet, bool *close) {
+        static constexpr size_t REG_SIZE = XLEN / 8;
+        static constexpr int PC_NUM = RV32I_GP_REG_NUM;
+        auto reg_hex = [](std::string *out, reg_t value) {
+            uint8_t bytes[REG_SIZE];
+            for (size_t i = 0; i < REG_SIZE; ++i) {
+                bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+            append_hex(out, bytes, REG_SIZE);
+        };
+        auto parse_reg = [](const char *text, reg_t *value) {
+            uint8_t bytes[REG_SIZE];
+            if (!parse_hex(text, REG_SIZE, bytes)) {
+                return false;
+            }
+            *value = 0;
+            for (size_t i = 0; i < REG_SIZE; ++i) {
+                *value |= static_cast<reg_t>(bytes[i]) << (8 * i);
+            }
+            return true;
+        };
+        if (packet.empty()) {
+            return "";
+        }
+        size_t pos = 1;
+        switch (packet[0]) {
+            case '?':
+                return "S05";
+            case 'g': {
+                // all registers in a single packet, x0..x31 and pc
+                std::string reply;
+                reply.reserve((PC_NUM + 1) * REG_SIZE * 2);
+                for (int i = 0; i < PC_NUM; ++i) {
+                    reg_hex(&reply, regs_[i]);
+                }
+                reg_hex(&reply, pc_);
+                return reply;
+            }
+            case 'G': {
+                reg_t values[PC_NUM + 1];
+                if (packet.size() < 1 + (PC_NUM + 1) * REG_SIZE * 2) {
+                    return "E01";
+                }
+                for (int i = 0; i <= PC_NUM; ++i) {
+                    if (!parse_reg(packet.c_str() + 1 + i * REG_SIZE * 2, &values[i])) {
+                        return "E01";
+                    }
+                }
+                for (int i = 1; i < PC_NUM; ++i) {
+                    regs_[i] = values[i];
+                }
+                pc_ = values[PC_NUM];
+                return "OK";
+            }
+            case 'p': {
+                uint64_t reg = parse_number(packet, &pos);
+                if (reg > PC_NUM) {
+                    return "E01";
+                }
+                std::string reply;
+                reg_hex(&reply, (reg == PC_NUM) ? pc_ : regs_[reg]);
+                return reply;
+            }
+            case 'P': {
+                uint64_t reg = parse_number(packet, &pos);
+                reg_t value;
+                if (reg > PC_NUM || packet.size() < pos + REG_SIZE * 2 || !parse_reg(packet.c_str() + pos, &value)) {
+                    return "E01";
+                }
+                if (reg == PC_NUM) {
+                    pc_ = value;
+                } else if (reg != 0) {
+                    regs_[reg] = value;
+                }
+                return "OK";
+            }
+            case 'm': {
+                uint64_t addr = parse_number(packet, &pos);
+                size_t size = std::min<uint64_t>(parse_number(packet, &pos), RiscvCpuGdb::PACKET_SIZE / 2);
+                std::vector<uint8_t> data(size);
+                if (!gdb_memory_(addr, size, data.data(), false)) {
+                    return "E01";
+                }
+                std::string reply;
+                reply.reserve(size * 2);
+                append_hex(&reply, data.data(), size);
+                return reply;
+            }
+            case 'M':
+            case 'X': {
+                uint64_t addr = parse_number(packet, &pos);
+                uint64_t size = parse_number(packet, &pos);
+                // the size comes from the client, the data has to be in the payload
+                size_t payload = (pos < packet.size()) ? packet.size() - pos : 0;
+                if (size > RiscvCpuGdb::PACKET_SIZE || size > ((packet[0] == 'M') ? payload / 2 : payload)) {
+                    return "E01";
+                }
+                std::vector<uint8_t> data(size);
+                if (packet[0] == 'M') {
+                    if (!parse_hex(packet.c_str() + pos, size, data.data())) {
+                        return "E01";
+                    }
+                } else {
+                    // binary data, 0x7d escapes the next byte (xor 0x20)
+                    size_t i = 0;
+                    while (i < size && pos < packet.size()) {
+                        char c = packet[pos++];
+                        if (c == '}' && pos < packet.size()) {
+                            c = static_cast<char>(packet[pos++] ^ 0x20);
+                        }
+                        data[i++] = static_cast<uint8_t>(c);
+                    }
+                    if (i < size) {
+                        return "E01";
+                    }
+                }
+                return gdb_memory_(addr, size, data.data(), true) ? "OK" : "E01";
+            }
+            case 'Z':
+            case 'z':
+                return gdb_breakpoint_(packet[0] == 'Z', packet);
+            case 'c':
+            case 's':
+                if (packet.size() > 1) {
+                    pc_ = static_cast<reg_t>(parse_number(packet, &pos));
+                }
+                gdb_resume_(packet[0] == 's');
+                return "";
+            case 'C':
+            case 'S':
+                // the signal is ignored
+                gdb_resume_(packet[0] == 'S');
+                return "";
+            case 'v':
+                if (packet == "vCont?") {
+                    return "vCont;c;C;s;S";
+                }
+                if (packet.compare(0, 6, "vCont;") == 0) {
+                    // a single thread, the first action applies to it
+                    gdb_resume_(packet[6] == 's' || packet[6] == 'S');
+                    return "";
+                }
+                return "";
+            case 'q':
+                if (packet.compare(0, 10, "qSupported") == 0) {
+                    char reply[128];
+                    std::snprintf(
+                        reply, sizeof(reply), "PacketSize=%zx;qXfer:features:read+;QStartNoAckMode+;vContSupported+",
+                        RiscvCpuGdb::PACKET_SIZE
+                    );
+                    return reply;
+                }
+                if (packet.compare(0, 31, "qXfer:features:read:target.xml:") == 0) {
+                    std::string xml = gdb_target_xml_();
+                    pos = 31;
+                    uint64_t offset = parse_number(packet, &pos);
+                    uint64_t length = parse_number(packet, &pos);
+                    if (offset >= xml.size()) {
+                        return "l";
+                    }
+                    std::string chunk = xml.substr(offset, length);
+                    return ((offset + chunk.size() < xml.size()) ? "m" : "l") + chunk;
+                }
+                if (packet == "qAttached") {
+                    return "1";
+                }
+                if (packet == "qC") {
+                    return "QC1";
+                }
+                if (packet == "qfThreadInfo") {
+                    return "m1";
+                }
+                if (packet == "qsThreadInfo") {
+                    return "l";
+                }
+                return "";
+            case 'Q':
+                return (packet == "QStartNoAckMode") ? "OK" : "";
+            case 'H':
+            case 'T':
+                return "OK";
+            case 'D':
+                *close = true;
+                return "OK";
+            case 'k':
+                // the simulation keeps running, only the session ends
+                *close = true;
+                return "";
+            default:
+                return "";
+        }
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,182 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-hostprof.hpp"
+
+namespace kz::riscv::core {
+    const char *HostTier::get_name(uint8_t tier) {
+        static const char *names[NUM] = {"plain", "instrumented", "events"};
+        return names[tier];
+    }
+
+    const char *HostCounter::get_name(uint8_t counter) {
+        static const char *names[NUM] = {"task-clock", "cycles", "instructions", "branch-misses", "L1-icache-misses"};
+        return names[counter];
+    }
+
+    RiscvCpuHostProfile::RiscvCpuHostProfile() : opened_(0) {
+        fds_.fill(-1);
+        index_.fill(-1);
+        last_.fill(0);
+        clear();
+    }
+
+    RiscvCpuHostProfile::~RiscvCpuHostProfile() {
+        close();
+    }
+
+    bool RiscvCpuHostProfile::open() {
+        close();
+        index_.fill(-1);
+        opened_ = 0;
+#ifdef __linux__
+        static const std::array<std::pair<uint32_t, uint64_t>, HostCounter::NUM> events = {{
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1I | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}
+        }};
+        for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[counter].first;
+            attr.config = events[counter].second;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = (counter == HostCounter::TASK_CLOCK);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // the task clock leads the group, the hardware counters join it if the host has them
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, fds_[0], 0));
+            if (fd < 0) {
+                if (counter == HostCounter::TASK_CLOCK) {
+                    return false;
+                }
+                continue;
+            }
+            fds_[counter] = fd;
+            index_[counter] = static_cast<int>(opened_++);
+        }
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        mark();
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void RiscvCpuHostProfile::close() {
+#ifdef __linux__
+        for (int &fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            fd = -1;
+        }
+#endif
+    }
+
+    bool RiscvCpuHostProfile::read_(std::array<uint64_t, HostCounter::NUM> *values) const {
+#ifdef __linux__
+        // PERF_FORMAT_GROUP: the number of the counters followed by their values
+        uint64_t data[1 + HostCounter::NUM];
+        if (::read(fds_[0], data, sizeof(data)) < static_cast<ssize_t>((1 + opened_) * sizeof(uint64_t))) {
+            return false;
+        }
+        for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+            (*values)[counter] = index_[counter] >= 0 ? data[1 + index_[counter]] : 0;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void RiscvCpuHostProfile::mark() {
+        if (is_open()) {
+            read_(&last_);
+        }
+    }
+
+    void RiscvCpuHostProfile::account(uint8_t tier, uint64_t guest_instructions) {
+        std::array<uint64_t, HostCounter::NUM> values;
+        if (!is_open() || !read_(&values)) {
+            return;
+        }
+        host_tier_stats_t &stats = stats_[tier];
+        stats.guest_instructions += guest_instructions;
+        for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+            stats.counters[counter] += values[counter] - last_[counter];
+        }
+        last_ = values;
+    }
+
+    void RiscvCpuHostProfile::clear() {
+        for (auto &stats : stats_) {
+            stats.guest_instructions = 0;
+            stats.counters.fill(0);
+        }
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::host_profile_as_attr() const {
+        attr_value_t tiers = SIM_alloc_attr_list(HostTier::NUM);
+        for (uint8_t tier = 0; tier < HostTier::NUM; ++tier) {
+            const host_tier_stats_t &stats = host_profile_.get_stats(tier);
+            attr_value_t item = SIM_alloc_attr_list(2 + HostCounter::NUM);
+            SIM_attr_list_set_item(&item, 0, SIM_make_attr_string(HostTier::get_name(tier)));
+            SIM_attr_list_set_item(&item, 1, SIM_make_attr_uint64(stats.guest_instructions));
+            for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+                SIM_attr_list_set_item(&item, 2 + counter, SIM_make_attr_uint64(stats.counters[counter]));
+            }
+            SIM_attr_list_set_item(&tiers, tier, item);
+        }
+        return tiers;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::host_counters_as_attr() const {
+        unsigned num = 0;
+        for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+            num += host_profile_.is_available(counter) ? 1 : 0;
+        }
+        attr_value_t counters = SIM_alloc_attr_list(num);
+        unsigned i = 0;
+        for (uint8_t counter = 0; counter < HostCounter::NUM; ++counter) {
+            if (host_profile_.is_available(counter)) {
+                SIM_attr_list_set_item(&counters, i++, SIM_make_attr_string(HostCounter::get_name(counter)));
+            }
+        }
+        return counters;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,289 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <string>
+#include <simics/cc-api.h>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-conf.hpp"
+#include "riscv-cpu-htif.hpp"
+
+namespace kz::riscv::core {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::update_watched_pages_() {
+        watched_pages_.clear();
+        if (tohost_addr_ != 0) {
+            watched_pages_[tohost_addr_ & RiscvCpuTlb::PAGE_MASK] |= (1U << RiscvCpuTlb::WRITE);
+        }
+        // the pages may be cached already, a page which is not watched anymore is simply
+        // cached again on the next miss
+        for (const auto &[page, mask] : watched_pages_) {
+            for (auto &tlb : tlb_) {
+                for (unsigned access = 0; access < RiscvCpuTlb::ACCESS_NUM; ++access) {
+                    if (mask & (1U << access)) {
+                        tlb.flush_page(access, page);
+                    }
+                }
+            }
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::watch_hit_(unsigned access, reg_t addr, unsigned size) {
+        // the HTIF command is taken when its last byte is written, RV32 programs store the
+        // lower word first
+        if (access == RiscvCpuTlb::WRITE && tohost_addr_ != 0
+            && static_cast<uint64_t>(addr) + size == tohost_addr_ + sizeof(uint64_t)) {
+            htif_tohost_();
+        }
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::host_access_(uint64_t addr, size_t size, uint8_t *data, bool is_write) {
+        transaction_flags_t flags = static_cast<transaction_flags_t>(
+            is_write ? (Sim_Transaction_Write | Sim_Transaction_Inquiry) : Sim_Transaction_Inquiry
+        );
+        while (size > 0) {
+            // a single transaction must not cross a mapping boundary
+            size_t chunk = std::min<uint64_t>(size, RiscvCpuTlb::PAGE_SIZE - (addr & ~RiscvCpuTlb::PAGE_MASK));
+            atom_t atoms[] = {
+                ATOM_data(data),
+                ATOM_size(static_cast<uint32>(chunk)),
+                ATOM_flags(flags),
+                ATOM_initiator(cobj_),
+                ATOM_LIST_END
+            };
+            transaction_t t = {};
+            t.atoms = atoms;
+            if (SIM_issue_transaction(phys_mem_.obj().object(), &t, addr) != Sim_PE_No_Exception) {
+                SIM_LOG_INFO(
+                    2, cobj_, 0, "Host access failed: addr='0x%llx', size='%zu'",
+                    static_cast<unsigned long long>(addr), chunk
+                );
+                return false;
+            }
+            addr += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::host_write_(const char *data, size_t size) {
+        SIM_write(data, static_cast<int>(size));
+    }
+
+    template<unsigned XLEN>
+    uint64_t RiscvCpu<XLEN>::host_write_mem_(uint64_t addr, uint64_t size) {
+        char buf[RiscvCpuTlb::PAGE_SIZE];
+        uint64_t written = 0;
+        while (written < size) {
+            size_t chunk = std::min<uint64_t>(size - written, sizeof(buf));
+            if (!host_access_(addr + written, chunk, reinterpret_cast<uint8_t *>(buf), false)) {
+                break;
+            }
+            host_write_(buf, chunk);
+            written += chunk;
+        }
+        return written;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::host_exit_(int64_t code) {
+        exited_ = true;
+        exit_code_ = code;
+        SIM_LOG_INFO(1, cobj_, 0, "Program exited with code %lld", static_cast<long long>(code));
+        batch_exit_ = true;
+        if (quit_on_exit_) {
+            SIM_quit(static_cast<int>(code));
+        } else {
+            SIM_break_simulation("Program exited");
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::htif_tohost_() {
+        uint64_t cmd = 0;
+        if (!host_access_(tohost_addr_, sizeof(cmd), reinterpret_cast<uint8_t *>(&cmd), false) || cmd == 0) {
+            return;
+        }
+        // the command is consumed, the target may post the next one
+        uint64_t zero = 0;
+        host_access_(tohost_addr_, sizeof(zero), reinterpret_cast<uint8_t *>(&zero), true);
+        uint8_t device = static_cast<uint8_t>(cmd >> htif_t::DEVICE_SHIFT);
+        uint8_t command = static_cast<uint8_t>(cmd >> htif_t::CMD_SHIFT);
+        uint64_t payload = cmd & htif_t::PAYLOAD_MASK;
+        uint64_t response;
+        switch (device) {
+            case htif_t::DEV_SYSCALL: {
+                if (payload & 1) {
+                    host_exit_(static_cast<int64_t>(payload >> 1));
+                    return;
+                }
+                uint64_t magic[htif_t::MAGIC_MEM_SIZE];
+                if (!host_access_(payload, sizeof(magic), reinterpret_cast<uint8_t *>(magic), false)) {
+                    return;
+                }
+                if (magic[0] == htif_t::SYS_EXIT) {
+                    host_exit_(static_cast<int64_t>(magic[1]));
+                    return;
+                }
+                if (magic[0] == htif_t::SYS_WRITE) {
+                    // magic[1] - file descriptor (stdout/stderr), [2] - buffer, [3] - length
+                    if (magic[1] != htif_t::STDOUT_FD && magic[1] != htif_t::STDERR_FD) {
+                        magic[0] = static_cast<uint64_t>(-9); // -EBADF
+                    } else {
+                        // a partial write returns the number of bytes written
+                        uint64_t written = host_write_mem_(magic[2], magic[3]);
+                        if (written == 0 && magic[3] != 0) {
+                            magic[0] = static_cast<uint64_t>(-14); // -EFAULT
+                        } else {
+                            magic[0] = written;
+                        }
+                    }
+                } else {
+                    SIM_LOG_UNIMPLEMENTED(
+                        1, cobj_, 0, "HTIF syscall: %llu", static_cast<unsigned long long>(magic[0])
+                    );
+                    magic[0] = static_cast<uint64_t>(-38); // -ENOSYS
+                }
+                host_access_(payload, sizeof(magic[0]), reinterpret_cast<uint8_t *>(magic), true);
+                response = 1;
+                break;
+            }
+            case htif_t::DEV_CONSOLE:
+                if (command != htif_t::CMD_PUTCHAR) {
+                    SIM_LOG_UNIMPLEMENTED(1, cobj_, 0, "HTIF console command: %u", command);
+                    return;
+                }
+                {
+                    char c = static_cast<char>(payload);
+                    host_write_(&c, 1);
+                }
+                response = cmd & ~htif_t::PAYLOAD_MASK;
+                break;
+            default:
+                SIM_LOG_UNIMPLEMENTED(1, cobj_, 0, "HTIF device: %u", device);
+                return;
+        }
+        if (fromhost_addr_ != 0) {
+            host_access_(fromhost_addr_, sizeof(response), reinterpret_cast<uint8_t *>(&response), true);
+        }
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::semihosting_call_() {
+        uint32_t entry = 0;
+        uint32_t exit = 0;
+        if (pc_ < INSTR_SIZE
+            || !host_access_(pc_ - INSTR_SIZE, INSTR_SIZE, reinterpret_cast<uint8_t *>(&entry), false)
+            || !host_access_(pc_ + INSTR_SIZE, INSTR_SIZE, reinterpret_cast<uint8_t *>(&exit), false)
+            || entry != semihosting_t::ENTRY_INSTR || exit != semihosting_t::EXIT_INSTR) {
+            return false;
+        }
+        reg_t op = regs_[10];   // a0
+        reg_t arg = regs_[11];  // a1
+        reg_t args[3] = {};
+        auto read_args = [&](unsigned num) {
+            return host_access_(arg, num * sizeof(reg_t), reinterpret_cast<uint8_t *>(args), false);
+        };
+        auto exit_code = [](reg_t reason, reg_t subcode) -> int64_t {
+            return (reason == semihosting_t::ADP_STOPPED_APPLICATION_EXIT) ? static_cast<sreg_t>(subcode) : 1;
+        };
+        reg_t result = 0;
+        switch (op) {
+            case semihosting_t::SYS_OPEN: {
+                // only the console (":tt") is supported, mode 0-3 stdin, 4-7 stdout, 8-11 stderr
+                std::string name(3, '\0');
+                if (!read_args(3) || args[2] != 3
+                    || !host_access_(args[0], name.size(), reinterpret_cast<uint8_t *>(name.data()), false)
+                    || name != ":tt") {
+                    result = static_cast<reg_t>(-1);
+                } else {
+                    result = args[1] / 4 + 1;
+                }
+                break;
+            }
+            case semihosting_t::SYS_WRITEC: {
+                char c;
+                if (host_access_(arg, 1, reinterpret_cast<uint8_t *>(&c), false)) {
+                    host_write_(&c, 1);
+                }
+                break;
+            }
+            case semihosting_t::SYS_WRITE0: {
+                // the string is written in bounded chunks, it ends at the first unmapped byte
+                std::string str;
+                char c;
+                for (reg_t addr = arg; host_access_(addr, 1, reinterpret_cast<uint8_t *>(&c), false) && c != '\0'; ++addr) {
+                    str.push_back(c);
+                    if (str.size() == RiscvCpuTlb::PAGE_SIZE) {
+                        host_write_(str.data(), str.size());
+                        str.clear();
+                    }
+                }
+                host_write_(str.data(), str.size());
+                break;
+            }
+            case semihosting_t::SYS_WRITE: {
+                // handle, buffer, length, returns the number of bytes not written
+                if (!read_args(3)) {
+                    result = static_cast<reg_t>(-1);
+                } else if (args[0] != semihosting_t::STDOUT_HANDLE && args[0] != semihosting_t::STDERR_HANDLE) {
+                    result = args[2];
+                } else {
+                    result = args[2] - static_cast<reg_t>(host_write_mem_(args[1], args[2]));
+                }
+                break;
+            }
+            case semihosting_t::SYS_CLOCK:
+                // centiseconds of the simulated time
+                result = freq_hz_ ? static_cast<reg_t>(current_cycle_ * 100 / freq_hz_) : 0;
+                break;
+            case semihosting_t::SYS_EXIT:
+                // RV32 passes the reason in a1, RV64 the address of the (reason, subcode) block
+                if constexpr (XLEN == RV32) {
+                    host_exit_(exit_code(arg, 0));
+                } else if (read_args(2)) {
+                    host_exit_(exit_code(args[0], args[1]));
+                }
+                break;
+            case semihosting_t::SYS_EXIT_EXTENDED:
+                if (read_args(2)) {
+                    host_exit_(exit_code(args[0], args[1]));
+                }
+                break;
+            default:
+                SIM_LOG_UNIMPLEMENTED(
+                    1, cobj_, 0, "Semihosting operation: 0x%llx", static_cast<unsigned long long>(op)
+                );
+                result = static_cast<reg_t>(-1);
+                break;
+        }
+        regs_[10] = result;
+        // the exit marker is executed as a regular NOP
+        pc_ += INSTR_SIZE;
+        return true;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,317 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-instrumentation.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuInstrumentation::~RiscvCpuInstrumentation() {
+        for (instrumentation_hooks_t *hooks : hooks_) {
+            delete hooks;
+        }
+        for (instrumentation_hooks_t *hooks : released_) {
+            delete hooks;
+        }
+    }
+
+    cpu_cb_handle_t *RiscvCpuInstrumentation::add(conf_object_t *connection, instrumentation_callback_t callback) {
+        auto [it, inserted] = connections_.try_emplace(connection, instrumentation_connection_t{connection, true, false});
+        // a connection removed by a running callback is taken back into use
+        it->second.removed = false;
+        callback.connection = &it->second;
+        callback.enabled = true;
+        callback.removed = false;
+        callbacks_.push_back(callback);
+        update_();
+        return reinterpret_cast<cpu_cb_handle_t *>(&callbacks_.back());
+    }
+
+    bool RiscvCpuInstrumentation::remove(cpu_cb_handle_t *handle) {
+        for (instrumentation_callback_t &callback : callbacks_) {
+            if (reinterpret_cast<const cpu_cb_handle_t *>(&callback) == handle && !callback.removed) {
+                callback.enabled = false;
+                callback.removed = true;
+                update_();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RiscvCpuInstrumentation::enable(cpu_cb_handle_t *handle, bool enabled) {
+        for (instrumentation_callback_t &callback : callbacks_) {
+            if (reinterpret_cast<const cpu_cb_handle_t *>(&callback) == handle && !callback.removed) {
+                callback.enabled = enabled;
+                update_();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RiscvCpuInstrumentation::remove_connection(conf_object_t *connection) {
+        auto it = connections_.find(connection);
+        if (it != connections_.end()) {
+            it->second.enabled = false;
+            it->second.removed = true;
+            update_();
+        }
+    }
+
+    void RiscvCpuInstrumentation::enable_connection(conf_object_t *connection, bool enabled) {
+        auto it = connections_.find(connection);
+        if (it != connections_.end() && !it->second.removed) {
+            it->second.enabled = enabled;
+            update_();
+        }
+    }
+
+    void RiscvCpuInstrumentation::update_() {
+        if (dispatching_ != 0) {
+            // a running callback may be in a table, the tables are rebuilt afterwards
+            dirty_ = true;
+            return;
+        }
+        dirty_ = false;
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            instrumentation_connection_t *connection = &it->second;
+            if (!connection->removed) {
+                ++it;
+                continue;
+            }
+            callbacks_.remove_if([connection](const instrumentation_callback_t &callback) {
+                return callback.connection == connection;
+            });
+            // the hooks objects stay until the predecoded instructions referencing them are
+            // released, the emptied ones don't count as active
+            for (instrumentation_hooks_t *hooks : hooks_) {
+                for (auto &kind : hooks->hooks) {
+                    for (const auto &hook : kind) {
+                        if (hook.connection == connection && hook.free_cb != nullptr) {
+                            hook.free_cb(connection->obj, hooks->cpu, hook.data);
+                        }
+                    }
+                    kind.erase(std::remove_if(kind.begin(), kind.end(),
+                        [connection](const auto &hook) { return hook.connection == connection; }), kind.end());
+                }
+                hooks->counters.erase(std::remove_if(hooks->counters.begin(), hooks->counters.end(),
+                    [connection](const auto &counter) { return counter.connection == connection; }),
+                    hooks->counters.end());
+            }
+            it = connections_.erase(it);
+        }
+        callbacks_.remove_if([](const instrumentation_callback_t &callback) { return callback.removed; });
+        for (auto &table : tables_) {
+            table.clear();
+        }
+        for (const instrumentation_callback_t &callback : callbacks_) {
+            if (callback.enabled && callback.connection->enabled) {
+                tables_[callback.kind].push_back(&callback);
+            }
+        }
+        update_active_();
+    }
+
+    void RiscvCpuInstrumentation::update_active_() {
+        active_ = std::any_of(tables_.begin(), tables_.end(), [](const auto &table) { return !table.empty(); }) ||
+            std::any_of(hooks_.begin(), hooks_.end(), [](const auto *hooks) { return !hooks->empty(); });
+    }
+
+    void RiscvCpuInstrumentation::instruction(uint8_t kind, conf_object_t *cpu, instrumentation_instr_t *instr) {
+        begin_dispatch_();
+        for (const instrumentation_callback_t *callback : tables_[kind]) {
+            if (callback->enabled) {
+                callback->func.instruction(callback->connection->obj, cpu,
+                    reinterpret_cast<instruction_handle_t *>(instr), callback->data);
+            }
+        }
+        end_dispatch_();
+    }
+
+    void RiscvCpuInstrumentation::memory(uint8_t kind, conf_object_t *cpu, instrumentation_access_t *access) {
+        begin_dispatch_();
+        for (const instrumentation_callback_t *callback : tables_[kind]) {
+            if (callback->enabled) {
+                callback->func.memory(callback->connection->obj, cpu,
+                    reinterpret_cast<memory_handle_t *>(access), callback->data);
+            }
+        }
+        end_dispatch_();
+    }
+
+    void RiscvCpuInstrumentation::exception(conf_object_t *cpu, instrumentation_exception_t *exception) {
+        begin_dispatch_();
+        for (const instrumentation_callback_t *callback : tables_[InstrumentationKind::EXCEPTION_BEFORE]) {
+            if (callback->enabled &&
+                (callback->exception == CPU_Exception_All || callback->exception == exception->number)) {
+                callback->func.exception(callback->connection->obj, cpu,
+                    reinterpret_cast<exception_handle_t *>(exception), callback->data);
+            }
+        }
+        end_dispatch_();
+    }
+
+    instrumentation_hooks_t *RiscvCpuInstrumentation::cache_instruction(conf_object_t *cpu, instrumentation_instr_t *instr) {
+        auto *hooks = new instrumentation_hooks_t();
+        hooks->cpu = cpu;
+        begin_dispatch_();
+        for (const instrumentation_callback_t *callback : tables_[InstrumentationKind::CACHED_INSTRUCTION]) {
+            if (!callback->enabled) {
+                continue;
+            }
+            // the callback registers the hooks through the cpu_cached_instruction interface,
+            // the hooks object is its cached_instruction_handle_t
+            hooks->connection = callback->connection;
+            callback->func.cached(callback->connection->obj, cpu,
+                reinterpret_cast<cached_instruction_handle_t *>(hooks),
+                reinterpret_cast<instruction_handle_t *>(instr), callback->data);
+        }
+        if (hooks->empty()) {
+            delete hooks;
+            hooks = nullptr;
+        } else {
+            hooks_.insert(hooks);
+            active_ = true;
+        }
+        end_dispatch_();
+        return hooks;
+    }
+
+    void RiscvCpuInstrumentation::release(instrumentation_hooks_t *hooks) {
+        hooks_.erase(hooks);
+        if (dispatching_ != 0) {
+            // a running callback may be one of the hooks, they are freed afterwards
+            released_.push_back(hooks);
+        } else {
+            free_(hooks);
+        }
+        update_active_();
+    }
+
+    void RiscvCpuInstrumentation::free_(instrumentation_hooks_t *hooks) {
+        for (const auto &kind : hooks->hooks) {
+            for (const auto &hook : kind) {
+                if (hook.free_cb != nullptr) {
+                    hook.free_cb(hook.connection->obj, hooks->cpu, hook.data);
+                }
+            }
+        }
+        delete hooks;
+    }
+
+    void RiscvCpuInstrumentation::run_instruction_hooks(const instrumentation_hooks_t &hooks, uint8_t kind,
+        instrumentation_instr_t *instr) {
+        begin_dispatch_();
+        for (const auto &hook : hooks.hooks[kind]) {
+            if (hook.connection->enabled) {
+                hook.func.instruction(hook.connection->obj, hooks.cpu,
+                    reinterpret_cast<instruction_handle_t *>(instr), hook.data);
+            }
+        }
+        end_dispatch_();
+    }
+
+    void RiscvCpuInstrumentation::run_memory_hooks(const instrumentation_hooks_t &hooks, uint8_t kind,
+        instrumentation_access_t *access) {
+        begin_dispatch_();
+        for (const auto &hook : hooks.hooks[kind]) {
+            if (hook.connection->enabled) {
+                hook.func.memory(hook.connection->obj, hooks.cpu,
+                    reinterpret_cast<memory_handle_t *>(access), hook.data);
+            }
+        }
+        end_dispatch_();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::instrument_before_(reg_t pc, const predecoded_instr_t &entry, reg_t addr, reg_t store_val) {
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        using kind_t = instrumentation_kind_t;
+        instr_handle_ = {pc, entry.instr};
+        access_handle_ = {addr, 1U << (entry.dec_instr.func3 & 0b11), 0, {}};
+        // entry.hooks is read before every use, a callback can release them (predecode flush)
+        if (entry.hooks != nullptr) {
+            for (const auto &counter : entry.hooks->counters) {
+                if (!counter.connection->enabled) {
+                    continue;
+                }
+                if (counter.atomic) {
+                    __atomic_fetch_add(counter.value, 1, __ATOMIC_RELAXED);
+                } else {
+                    (*counter.value)++;
+                }
+            }
+            instrumentation_.run_instruction_hooks(*entry.hooks, kind_t::INSTRUCTION_BEFORE, &instr_handle_);
+        }
+        instrumentation_.instruction(kind_t::INSTRUCTION_BEFORE, cobj_, &instr_handle_);
+        if (entry.dec_instr.opcode == operation_code_t::LOAD) {
+            if (entry.hooks != nullptr) {
+                instrumentation_.run_memory_hooks(*entry.hooks, kind_t::READ_BEFORE, &access_handle_);
+            }
+            instrumentation_.memory(kind_t::READ_BEFORE, cobj_, &access_handle_);
+        } else if (entry.dec_instr.opcode == operation_code_t::STORE) {
+            // the stored bytes are known before the store, little-endian
+            access_handle_.bytes_size = access_handle_.size;
+            for (unsigned i = 0; i < access_handle_.size; ++i) {
+                access_handle_.bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(store_val) >> (8 * i));
+            }
+            if (entry.hooks != nullptr) {
+                instrumentation_.run_memory_hooks(*entry.hooks, kind_t::WRITE_BEFORE, &access_handle_);
+            }
+            instrumentation_.memory(kind_t::WRITE_BEFORE, cobj_, &access_handle_);
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::instrument_after_(const predecoded_instr_t &entry) {
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        using kind_t = instrumentation_kind_t;
+        if (entry.dec_instr.opcode == operation_code_t::LOAD) {
+            // the loaded bytes are read back from the memory, they aren't known for devices
+            const uint8_t *host = data_tlb_->lookup(RiscvCpuTlb::READ, access_handle_.addr, access_handle_.size);
+            if (host == nullptr) {
+                host = get_page_host_(access_handle_.addr & RiscvCpuTlb::PAGE_MASK, RiscvCpuTlb::READ);
+                host = (host != nullptr) ? host + (access_handle_.addr & ~RiscvCpuTlb::PAGE_MASK) : nullptr;
+            }
+            if (host != nullptr) {
+                access_handle_.bytes_size = access_handle_.size;
+                std::memcpy(access_handle_.bytes, host, access_handle_.size);
+            }
+            if (entry.hooks != nullptr) {
+                instrumentation_.run_memory_hooks(*entry.hooks, kind_t::READ_AFTER, &access_handle_);
+            }
+            instrumentation_.memory(kind_t::READ_AFTER, cobj_, &access_handle_);
+        } else if (entry.dec_instr.opcode == operation_code_t::STORE) {
+            if (entry.hooks != nullptr) {
+                instrumentation_.run_memory_hooks(*entry.hooks, kind_t::WRITE_AFTER, &access_handle_);
+            }
+            instrumentation_.memory(kind_t::WRITE_AFTER, cobj_, &access_handle_);
+        }
+        if (entry.hooks != nullptr) {
+            instrumentation_.run_instruction_hooks(*entry.hooks, kind_t::INSTRUCTION_AFTER, &instr_handle_);
+        }
+        instrumentation_.instruction(kind_t::INSTRUCTION_AFTER, cobj_, &instr_handle_);
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,108 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu-conf.hpp"
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-memprof.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuMemProfile::RiscvCpuMemProfile() : period_(0), interval_(MEM_PROFILE_INTERVAL) {}
+
+    void RiscvCpuMemProfile::configure(uint64_t period, uint64_t interval) {
+        period_ = period;
+        interval_ = interval;
+        clear();
+    }
+
+    void RiscvCpuMemProfile::sample(bool write, uint64_t addr, uint64_t step) {
+        auto [it, inserted] = pages_.try_emplace(addr >> PAGE_WIDTH, PageStats{0, 0, step, step, ~0ULL});
+        PageStats &page = it->second;
+        if (write) {
+            page.writes++;
+        } else {
+            page.reads++;
+        }
+        page.last_touch = step;
+        if (interval_ != 0 && page.last_interval != step / interval_) {
+            page.last_interval = step / interval_;
+            if (working_set_.size() <= page.last_interval) {
+                working_set_.resize(page.last_interval + 1, 0);
+            }
+            working_set_[page.last_interval]++;
+        }
+    }
+
+    void RiscvCpuMemProfile::clear() {
+        pages_.clear();
+        working_set_.clear();
+    }
+
+    std::vector<mem_page_t> RiscvCpuMemProfile::get_pages() const {
+        std::vector<mem_page_t> pages;
+        pages.reserve(pages_.size());
+        for (const auto &[page, stats] : pages_) {
+            pages.push_back(mem_page_t{page << PAGE_WIDTH, stats.reads, stats.writes,
+                stats.first_touch, stats.last_touch});
+        }
+        std::sort(pages.begin(), pages.end(),
+            [](const mem_page_t &a, const mem_page_t &b) { return a.addr < b.addr; });
+        return pages;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::sample_access_(bool write, reg_t addr) {
+        mem_countdown_ = mem_profile_.get_countdown();
+        mem_profile_.sample(write, addr, current_step_);
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::mem_heatmap_as_attr() const {
+        std::vector<mem_page_t> pages = mem_profile_.get_pages();
+        attr_value_t pages_attr = SIM_alloc_attr_list(static_cast<unsigned>(pages.size()));
+        for (size_t i = 0; i < pages.size(); ++i) {
+            SIM_attr_list_set_item(
+                &pages_attr, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    5,
+                    SIM_make_attr_uint64(pages[i].addr),
+                    SIM_make_attr_uint64(pages[i].reads),
+                    SIM_make_attr_uint64(pages[i].writes),
+                    SIM_make_attr_uint64(pages[i].first_touch),
+                    SIM_make_attr_uint64(pages[i].last_touch)
+                )
+            );
+        }
+        return pages_attr;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::mem_working_set_as_attr() const {
+        const std::vector<uint64_t> &working_set = mem_profile_.get_working_set();
+        attr_value_t intervals = SIM_alloc_attr_list(static_cast<unsigned>(working_set.size()));
+        for (size_t i = 0; i < working_set.size(); ++i) {
+            SIM_attr_list_set_item(&intervals, static_cast<unsigned>(i), SIM_make_attr_uint64(working_set[i]));
+        }
+        return intervals;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,71 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu-decode.hpp"
+#include "riscv-cpu-disasm.hpp"
+#include "riscv-cpu-mix.hpp"
+
+namespace kz::riscv::core {
+    uint32_t RiscvCpuInstrMix::get_key_(const dec_instr_t &dec_instr, const custom_instr_t *custom) {
+        if (custom != nullptr) {
+            // [20] custom, the bound patterns may use all func3/func7 bits
+            return (1u << 20) | (static_cast<uint32_t>(dec_instr.opcode) << 15)
+                | (static_cast<uint32_t>(dec_instr.func3) << 12) | static_cast<uint32_t>(dec_instr.func7);
+        }
+        return RiscvCpuDecoder::get_op_key(dec_instr);
+    }
+
+    uint32_t RiscvCpuInstrMix::resolve(const dec_instr_t &dec_instr, const custom_instr_t *custom) {
+        uint32_t key = get_key_(dec_instr, custom);
+        auto it = ids_.find(key);
+        if (it != ids_.end()) {
+            if (custom != nullptr) {
+                // the pattern may have been bound to another instruction meanwhile
+                counters_[it->second].mnemonic = custom->name;
+            }
+            return it->second;
+        }
+        std::string mnemonic = custom != nullptr ? custom->name : RiscvCpuDisasm::get_op_name(dec_instr);
+        uint32_t id = static_cast<uint32_t>(counters_.size());
+        counters_.push_back(mix_counter_t{mnemonic, dec_instr.type, 0});
+        ids_.emplace(key, id);
+        return id;
+    }
+
+    void RiscvCpuInstrMix::clear() {
+        for (auto &counter : counters_) {
+            counter.executions = 0;
+        }
+    }
+
+    std::vector<mix_counter_t> RiscvCpuInstrMix::get_sorted() const {
+        std::vector<mix_counter_t> counters;
+        for (const auto &counter : counters_) {
+            if (counter.executions != 0) {
+                counters.push_back(counter);
+            }
+        }
+        std::stable_sort(counters.begin(), counters.end(), [](const mix_counter_t &a, const mix_counter_t &b) {
+            return a.executions > b.executions;
+        });
+        return counters;
+    }
+} /* ! kz::riscv::core ! */
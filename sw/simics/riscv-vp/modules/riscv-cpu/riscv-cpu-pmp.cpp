@@ -0,0 +1,110 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu-pmp.hpp"
+#include "riscv-cpu-priv.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuPmp::RiscvCpuPmp() {
+        reset();
+    }
+
+    void RiscvCpuPmp::reset() {
+        cfg_.fill(0);
+        addr_.fill(0);
+    }
+
+    bool RiscvCpuPmp::set_cfg(unsigned idx, uint8_t cfg) {
+        if (cfg_[idx] & L) {
+            return false;
+        }
+        // R=0, W=1 is a reserved combination
+        if ((cfg & (R | W)) == W) {
+            cfg &= ~W;
+        }
+        // bits [6:5] are reserved
+        cfg &= (L | A_MASK | RWX);
+        if (cfg_[idx] == cfg) {
+            return false;
+        }
+        cfg_[idx] = cfg;
+        return true;
+    }
+
+    bool RiscvCpuPmp::set_addr(unsigned idx, uint64_t addr) {
+        if (cfg_[idx] & L) {
+            return false;
+        }
+        if (idx + 1 < ENTRIES_NUM
+            && (cfg_[idx + 1] & L)
+            && ((cfg_[idx + 1] & A_MASK) >> A_SHIFT) == A_TOR) {
+            return false;
+        }
+        if (addr_[idx] == addr) {
+            return false;
+        }
+        addr_[idx] = addr;
+        return true;
+    }
+
+    bool RiscvCpuPmp::get_range_(unsigned idx, uint64_t *lo, uint64_t *hi) const {
+        switch ((cfg_[idx] & A_MASK) >> A_SHIFT) {
+            case A_TOR:
+                *lo = (idx == 0) ? 0 : (addr_[idx - 1] << 2);
+                *hi = addr_[idx] << 2;
+                return true;
+            case A_NA4:
+                *lo = addr_[idx] << 2;
+                *hi = *lo + 4;
+                return true;
+            case A_NAPOT: {
+                // the number of trailing ones encodes the size: 2^(ones + 3) bytes
+                uint64_t ones = addr_[idx] ^ (addr_[idx] + 1);
+                *lo = (addr_[idx] & ~ones) << 2;
+                *hi = *lo + ((ones + 1) << 2);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    uint8_t RiscvCpuPmp::get_perms(uint64_t start, uint64_t size, uint8_t priv, bool *uniform) const {
+        uint64_t end = start + size;
+        *uniform = true;
+        for (unsigned idx = 0; idx < ENTRIES_NUM; ++idx) {
+            uint64_t lo, hi;
+            if (!get_range_(idx, &lo, &hi) || end <= lo || start >= hi) {
+                continue;
+            }
+            // the entry with the lowest number matching any byte decides, it has to match all of them
+            if (start < lo || end > hi) {
+                *uniform = false;
+                return 0;
+            }
+            // M-mode accesses are checked against locked entries only
+            if (priv == privilege_t::M && !(cfg_[idx] & L)) {
+                return RWX;
+            }
+            return cfg_[idx] & RWX;
+        }
+        // no matching entry, M-mode access succeeds, S-mode and U-mode access fails
+        return (priv == privilege_t::M) ? RWX : 0;
+    }
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,65 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu-predecode.hpp"
+#include "riscv-cpu-instrumentation.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuPredecode::RiscvCpuPredecode(RiscvCpuInstrumentation *instrumentation)
+    : instrumentation_(instrumentation) {
+        for (auto &entry : entries_) {
+            entry.hooks = nullptr;
+        }
+        flush();
+    }
+
+    void RiscvCpuPredecode::release_hooks_(predecoded_instr_t *entry) {
+        if (entry->hooks != nullptr) {
+            instrumentation_->release(entry->hooks);
+            entry->hooks = nullptr;
+        }
+    }
+
+    predecoded_instr_t *RiscvCpuPredecode::fill(uint64_t pc) {
+        predecoded_instr_t *entry = &entries_[index_(pc)];
+        release_hooks_(entry);
+        entry->pc = pc;
+        entry->valid = true;
+        entry->custom = nullptr;
+        return entry;
+    }
+
+    void RiscvCpuPredecode::flush() {
+        for (auto &entry : entries_) {
+            entry.valid = false;
+            release_hooks_(&entry);
+        }
+    }
+
+    void RiscvCpuPredecode::flush_range(uint64_t start, uint64_t size) {
+        for (auto &entry : entries_) {
+            // the two lowest bits of the tag hold the privilege level
+            uint64_t pc = entry.pc & ~0b11ULL;
+            if (entry.valid && pc >= start && pc - start < size) {
+                entry.valid = false;
+                release_hooks_(&entry);
+            }
+        }
+    }
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,618 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <simics/cc-api.h>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-conf.hpp"
+#include "riscv-cpu-priv.hpp"
+
+namespace kz::riscv::core {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set_priv_(uint8_t priv) {
+        if (priv != priv_) {
+            SIM_LOG_INFO(3, cobj_, 0, "Privilege level change: %u -> %u", priv_, priv);
+        }
+        priv_ = priv;
+        update_data_priv_();
+        // interrupt enables depend on the privilege level
+        batch_exit_ = true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::update_data_priv_() {
+        // loads and stores of M-mode use the privilege level from mstatus.MPP if MPRV is set
+        if (priv_ == privilege_t::M && (mstatus_ & mstatus_t::MPRV)) {
+            data_priv_ = static_cast<uint8_t>((mstatus_ & mstatus_t::MPP) >> mstatus_t::MPP_SHIFT);
+        } else {
+            data_priv_ = priv_;
+        }
+        data_tlb_ = &tlb_[data_priv_];
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::take_trap_(reg_t cause, reg_t tval, bool to_s_mode) {
+        // interrupts use the vectored mode (tvec[1:0] = 1) if enabled
+        constexpr reg_t INTERRUPT = static_cast<reg_t>(1) << (XLEN - 1);
+        reg_t vector = (cause & INTERRUPT) ? (cause & ~INTERRUPT) * INSTR_SIZE : 0;
+        trap_count_++;
+        if (instrumentation_.has(instrumentation_kind_t::EXCEPTION_BEFORE)) {
+            instrumentation_exception_t exception = {
+                (cause & INTERRUPT) ? RiscvCpuInstrumentation::INTERRUPT_BASE + static_cast<int>(cause & ~INTERRUPT)
+                    : static_cast<int>(cause),
+                pc_
+            };
+            instrumentation_.exception(cobj_, &exception);
+        }
+        if (to_s_mode) {
+            scause_ = cause;
+            sepc_ = pc_;
+            stval_ = tval;
+            reg_t status = mstatus_ & ~(mstatus_t::SPP | mstatus_t::SPIE | mstatus_t::SIE);
+            if (priv_ == privilege_t::S) {
+                status |= mstatus_t::SPP;
+            }
+            if (mstatus_ & mstatus_t::SIE) {
+                status |= mstatus_t::SPIE;
+            }
+            mstatus_ = status;
+            pc_ = (stvec_ & ~static_cast<reg_t>(0b11)) + ((stvec_ & 1) ? vector : 0);
+            set_priv_(privilege_t::S);
+        } else {
+            mcause_ = cause;
+            mepc_ = pc_;
+            mtval_ = tval;
+            reg_t status = mstatus_ & ~(mstatus_t::MPP | mstatus_t::MPIE | mstatus_t::MIE);
+            status |= static_cast<reg_t>(priv_) << mstatus_t::MPP_SHIFT;
+            if (mstatus_ & mstatus_t::MIE) {
+                status |= mstatus_t::MPIE;
+            }
+            mstatus_ = status;
+            pc_ = (mtvec_ & ~static_cast<reg_t>(0b11)) + ((mtvec_ & 1) ? vector : 0);
+            set_priv_(privilege_t::M);
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::raise_exception_(uint8_t cause, reg_t tval) {
+        SIM_LOG_INFO(
+            2, cobj_, 0,
+            "Exception: cause='%u', pc='0x%llx', tval='0x%llx', priv='%u'",
+            cause, static_cast<unsigned long long>(pc_), static_cast<unsigned long long>(tval), priv_
+        );
+        // exceptions raised in M-mode are never delegated
+        take_trap_(cause, tval, priv_ <= privilege_t::S && ((medeleg_ >> cause) & 1));
+        // the trapped instruction isn't retired, like in the run loop, so it takes no step
+        // (instret) but the cycle of the trap
+        inc_cycles_(1);
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::check_interrupts_() {
+        reg_t pending = mip_ & mie_;
+        if (pending == 0) {
+            return;
+        }
+        // M-mode interrupts are enabled in the lower levels or if mstatus.MIE is set, the ones
+        // delegated to S-mode in U-mode or if mstatus.SIE is set in S-mode (never in M-mode)
+        reg_t enabled = 0;
+        if (priv_ < privilege_t::M || (mstatus_ & mstatus_t::MIE)) {
+            enabled = pending & ~mideleg_;
+        }
+        if (enabled == 0 && (priv_ < privilege_t::S || (priv_ == privilege_t::S && (mstatus_ & mstatus_t::SIE)))) {
+            enabled = pending & mideleg_;
+        }
+        if (enabled == 0) {
+            return;
+        }
+        // MEI, MSI, MTI, SEI, SSI, STI
+        static constexpr uint8_t priority[] = { 11, 3, 7, 9, 1, 5 };
+        for (uint8_t irq : priority) {
+            if ((enabled >> irq) & 1) {
+                SIM_LOG_INFO(
+                    2, cobj_, 0,
+                    "Interrupt: irq='%u', pc='0x%llx', priv='%u'",
+                    irq, static_cast<unsigned long long>(pc_), priv_
+                );
+                constexpr reg_t INTERRUPT = static_cast<reg_t>(1) << (XLEN - 1);
+                take_trap_(INTERRUPT | irq, 0, (mideleg_ >> irq) & 1);
+                return;
+            }
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set_irq_(int irq, bool level) {
+        reg_t mask = static_cast<reg_t>(1) << irq;
+        if (!(mask & interrupt_t::ALL_MASK)) {
+            SIM_LOG_ERROR(cobj_, 0, "Signal on unsupported interrupt port: %d", irq);
+            return;
+        }
+        SIM_LOG_INFO(3, cobj_, 0, "Interrupt %d %s", irq, level ? "raised" : "lowered");
+        mip_ = level ? (mip_ | mask) : (mip_ & ~mask);
+        // the interrupt is taken after the current instruction
+        batch_exit_ = true;
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::csr_read_(uint16_t csr, reg_t *value, bool inquiry) {
+        // CSR address bits [9:8] encode the lowest privilege level allowed to access it
+        if (!inquiry && ((csr >> 8) & 0b11) > priv_) {
+            return false;
+        }
+        switch (csr) {
+            case csr_addr_t::MSTATUS:
+                *value = mstatus_;
+                if constexpr (XLEN == RV64) {
+                    *value |= mstatus_t::UXL_SXL_64;
+                }
+                return true;
+            case csr_addr_t::SSTATUS:
+                *value = mstatus_ & mstatus_t::SSTATUS_MASK;
+                if constexpr (XLEN == RV64) {
+                    *value |= (mstatus_t::UXL_SXL_64 & (0b11ULL << 32));
+                }
+                return true;
+            case csr_addr_t::MISA:
+                // I base ISA with S-mode and U-mode
+                *value = traits_t::MISA_MXL | (1U << ('I' - 'A')) | (1U << ('S' - 'A')) | (1U << ('U' - 'A'));
+                return true;
+            case csr_addr_t::MEDELEG: *value = medeleg_; return true;
+            case csr_addr_t::MIDELEG: *value = mideleg_; return true;
+            case csr_addr_t::MIE: *value = mie_; return true;
+            case csr_addr_t::MIP: *value = mip_; return true;
+            case csr_addr_t::SIE: *value = mie_ & mideleg_; return true;
+            case csr_addr_t::SIP: *value = mip_ & mideleg_; return true;
+            case csr_addr_t::MTVEC: *value = mtvec_; return true;
+            case csr_addr_t::MCOUNTEREN: *value = mcounteren_; return true;
+            case csr_addr_t::MSCRATCH: *value = mscratch_; return true;
+            case csr_addr_t::MEPC: *value = mepc_; return true;
+            case csr_addr_t::MCAUSE: *value = mcause_; return true;
+            case csr_addr_t::MTVAL: *value = mtval_; return true;
+            case csr_addr_t::STVEC: *value = stvec_; return true;
+            case csr_addr_t::SCOUNTEREN: *value = scounteren_; return true;
+            case csr_addr_t::SSCRATCH: *value = sscratch_; return true;
+            case csr_addr_t::SEPC: *value = sepc_; return true;
+            case csr_addr_t::SCAUSE: *value = scause_; return true;
+            case csr_addr_t::STVAL: *value = stval_; return true;
+            case csr_addr_t::SATP:
+                if (!inquiry && priv_ == privilege_t::S && (mstatus_ & mstatus_t::TVM)) {
+                    return false;
+                }
+                *value = satp_;
+                return true;
+            case csr_addr_t::MVENDORID:
+            case csr_addr_t::MARCHID:
+            case csr_addr_t::MIMPID:
+            case csr_addr_t::MHARTID:
+                *value = 0;
+                return true;
+            case csr_addr_t::MCYCLE: *value = static_cast<reg_t>(current_cycle_); return true;
+            case csr_addr_t::MINSTRET: *value = static_cast<reg_t>(current_step_); return true;
+            case csr_addr_t::CYCLE:
+            case csr_addr_t::INSTRET:
+            case csr_addr_t::CYCLEH:
+            case csr_addr_t::INSTRETH: {
+                // access of the lower privilege levels is enabled by mcounteren/scounteren
+                unsigned bit = csr & 0x1F;
+                if (!inquiry && priv_ < privilege_t::M && !((mcounteren_ >> bit) & 1)) {
+                    return false;
+                }
+                if (!inquiry && priv_ < privilege_t::S && !((scounteren_ >> bit) & 1)) {
+                    return false;
+                }
+                if (csr == csr_addr_t::CYCLEH || csr == csr_addr_t::INSTRETH) {
+                    if constexpr (XLEN == RV32) {
+                        uint64_t counter = (csr == csr_addr_t::CYCLEH) ? current_cycle_ : current_step_;
+                        *value = static_cast<reg_t>(counter >> 32);
+                        return true;
+                    }
+                    return false;
+                }
+                *value = static_cast<reg_t>((csr == csr_addr_t::CYCLE) ? current_cycle_ : current_step_);
+                return true;
+            }
+            default:
+                break;
+        }
+        if constexpr (XLEN == RV32) {
+            // RV32 only, upper halves of the 64-bit machine registers
+            switch (csr) {
+                case csr_addr_t::MSTATUSH: *value = 0; return true;
+                case csr_addr_t::MCYCLEH: *value = static_cast<reg_t>(current_cycle_ >> 32); return true;
+                case csr_addr_t::MINSTRETH: *value = static_cast<reg_t>(current_step_ >> 32); return true;
+                default: break;
+            }
+        }
+        if (csr >= csr_addr_t::PMPCFG0 && csr <= csr_addr_t::PMPCFG15) {
+            // RV32 packs 4 entries into pmpcfg0..3, RV64 packs 8 into the even pmpcfg0/2 only
+            unsigned reg = csr - csr_addr_t::PMPCFG0;
+            unsigned per_reg = XLEN / 8;
+            if ((XLEN == RV64 && (reg & 1)) || reg * 4 >= RiscvCpuPmp::ENTRIES_NUM) {
+                return false;
+            }
+            reg_t cfg = 0;
+            for (unsigned i = 0; i < per_reg; ++i) {
+                cfg |= static_cast<reg_t>(pmp_.get_cfg(reg * 4 + i)) << (i * 8);
+            }
+            *value = cfg;
+            return true;
+        }
+        if (csr >= csr_addr_t::PMPADDR0 && csr <= csr_addr_t::PMPADDR15) {
+            *value = static_cast<reg_t>(pmp_.get_addr(csr - csr_addr_t::PMPADDR0));
+            return true;
+        }
+        return false;
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::csr_write_(uint16_t csr, reg_t value, bool inquiry) {
+        if (!inquiry) {
+            if (((csr >> 8) & 0b11) > priv_) {
+                return false;
+            }
+            // CSR address bits [11:10] set to 0b11 mark read-only registers
+            if ((csr >> 10) == 0b11) {
+                return false;
+            }
+        }
+        switch (csr) {
+            case csr_addr_t::MSTATUS: {
+                reg_t status = static_cast<reg_t>(value & mstatus_t::MSTATUS_MASK);
+                // MPP = 0b10 is a reserved encoding, legalize it to U-mode
+                if (((status & mstatus_t::MPP) >> mstatus_t::MPP_SHIFT) == 0b10) {
+                    status &= ~static_cast<reg_t>(mstatus_t::MPP);
+                }
+                mstatus_ = status;
+                update_data_priv_();
+                return true;
+            }
+            case csr_addr_t::SSTATUS:
+                mstatus_ = (mstatus_ & ~static_cast<reg_t>(mstatus_t::SSTATUS_MASK))
+                    | static_cast<reg_t>(value & mstatus_t::SSTATUS_MASK);
+                return true;
+            case csr_addr_t::MISA:
+                // read-only, the writes are ignored
+                return true;
+            case csr_addr_t::MEDELEG: medeleg_ = value & trap_cause_t::DELEG_MASK; return true;
+            case csr_addr_t::MIDELEG: mideleg_ = value & interrupt_t::S_MASK; return true;
+            case csr_addr_t::MIE: mie_ = value & interrupt_t::ALL_MASK; return true;
+            case csr_addr_t::MIP:
+                // only the S-mode bits are writable, M-mode ones are driven by the devices
+                mip_ = (mip_ & ~static_cast<reg_t>(interrupt_t::S_MASK)) | (value & interrupt_t::S_MASK);
+                return true;
+            case csr_addr_t::SIE:
+                mie_ = (mie_ & ~mideleg_) | (value & mideleg_);
+                return true;
+            case csr_addr_t::SIP:
+                // only the software interrupt is writable from S-mode
+                mip_ = (mip_ & ~(mideleg_ & interrupt_t::SSIP)) | (value & mideleg_ & interrupt_t::SSIP);
+                return true;
+            // only direct (0b00) and vectored (0b01) modes are legal
+            case csr_addr_t::MTVEC: mtvec_ = value & ~static_cast<reg_t>(0b10); return true;
+            case csr_addr_t::STVEC: stvec_ = value & ~static_cast<reg_t>(0b10); return true;
+            case csr_addr_t::MCOUNTEREN: mcounteren_ = value & 0b111; return true;
+            case csr_addr_t::SCOUNTEREN: scounteren_ = value & 0b111; return true;
+            case csr_addr_t::MSCRATCH: mscratch_ = value; return true;
+            case csr_addr_t::SSCRATCH: sscratch_ = value; return true;
+            // IALIGN = 32, the two lowest bits are always zero
+            case csr_addr_t::MEPC: mepc_ = value & ~static_cast<reg_t>(0b11); return true;
+            case csr_addr_t::SEPC: sepc_ = value & ~static_cast<reg_t>(0b11); return true;
+            case csr_addr_t::MCAUSE: mcause_ = value; return true;
+            case csr_addr_t::SCAUSE: scause_ = value; return true;
+            case csr_addr_t::MTVAL: mtval_ = value; return true;
+            case csr_addr_t::STVAL: stval_ = value; return true;
+            case csr_addr_t::SATP: {
+                if (!inquiry && priv_ == privilege_t::S && (mstatus_ & mstatus_t::TVM)) {
+                    return false;
+                }
+                // there is no MMU, only the Bare mode is supported, other modes are ignored
+                reg_t mode = (XLEN == RV32) ? (value >> 31) : (value >> 60);
+                if (mode == 0) {
+                    satp_ = value;
+                }
+                return true;
+            }
+            case csr_addr_t::MCYCLE:
+            case csr_addr_t::MINSTRET:
+                // counters are derived from the simulated time, the writes are ignored
+                return true;
+            default:
+                break;
+        }
+        if constexpr (XLEN == RV32) {
+            switch (csr) {
+                case csr_addr_t::MSTATUSH:
+                case csr_addr_t::MCYCLEH:
+                case csr_addr_t::MINSTRETH:
+                    return true;
+                default:
+                    break;
+            }
+        }
+        if (csr >= csr_addr_t::PMPCFG0 && csr <= csr_addr_t::PMPCFG15) {
+            unsigned reg = csr - csr_addr_t::PMPCFG0;
+            unsigned per_reg = XLEN / 8;
+            if ((XLEN == RV64 && (reg & 1)) || reg * 4 >= RiscvCpuPmp::ENTRIES_NUM) {
+                return false;
+            }
+            bool changed = false;
+            for (unsigned i = 0; i < per_reg; ++i) {
+                changed |= pmp_.set_cfg(reg * 4 + i, static_cast<uint8_t>(value >> (i * 8)));
+            }
+            if (changed) {
+                // cached permissions are not valid anymore
+                flush_caches_();
+            }
+            return true;
+        }
+        if (csr >= csr_addr_t::PMPADDR0 && csr <= csr_addr_t::PMPADDR15) {
+            if (pmp_.set_addr(csr - csr_addr_t::PMPADDR0, value & traits_t::PMPADDR_MASK)) {
+                flush_caches_();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::execute_system_(const dec_instr_t &dec_instr) {
+        uint32_t func3 = static_cast<uint32_t>(dec_instr.func3);
+        uint32_t func12 = static_cast<uint32_t>(static_cast<int32_t>(dec_instr.imm)) & 0xFFF;
+        if (func3 == 0b000) {
+            // privileged instructions, rd and rs1 are zero
+            if (static_cast<uint8_t>(dec_instr.func7) == 0b0001001) {
+                // SFENCE.VMA, there is no address translation, flush the page caches
+                if (priv_ < privilege_t::S || (priv_ == privilege_t::S && (mstatus_ & mstatus_t::TVM))) {
+                    raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                    return;
+                }
+                for (auto &tlb : tlb_) {
+                    tlb.flush();
+                }
+                pc_ += INSTR_SIZE;
+                inc_cycles_(1);
+                inc_steps_(1);
+                return;
+            }
+            switch (func12) {
+                case 0x000: // ECALL
+                    raise_exception_(trap_cause_t::ECALL_U + priv_, 0);
+                    return;
+                case 0x001: // EBREAK
+                    if (semihosting_ && semihosting_call_()) {
+                        inc_cycles_(1);
+                        inc_steps_(1);
+                        return;
+                    }
+                    raise_exception_(trap_cause_t::BREAKPOINT, pc_);
+                    return;
+                case 0x302: { // MRET
+                    if (priv_ < privilege_t::M) {
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                        return;
+                    }
+                    uint8_t mpp = static_cast<uint8_t>((mstatus_ & mstatus_t::MPP) >> mstatus_t::MPP_SHIFT);
+                    reg_t status = mstatus_ & ~(mstatus_t::MPP | mstatus_t::MIE);
+                    if (mstatus_ & mstatus_t::MPIE) {
+                        status |= mstatus_t::MIE;
+                    }
+                    status |= mstatus_t::MPIE;
+                    if (mpp != privilege_t::M) {
+                        status &= ~static_cast<reg_t>(mstatus_t::MPRV);
+                    }
+                    mstatus_ = status;
+                    pc_ = mepc_;
+                    set_priv_(mpp);
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                    return;
+                }
+                case 0x102: { // SRET
+                    if (priv_ < privilege_t::S || (priv_ == privilege_t::S && (mstatus_ & mstatus_t::TSR))) {
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                        return;
+                    }
+                    uint8_t spp = (mstatus_ & mstatus_t::SPP) ? privilege_t::S : privilege_t::U;
+                    reg_t status = mstatus_ & ~(mstatus_t::SPP | mstatus_t::SIE | mstatus_t::MPRV);
+                    if (mstatus_ & mstatus_t::SPIE) {
+                        status |= mstatus_t::SIE;
+                    }
+                    status |= mstatus_t::SPIE;
+                    mstatus_ = status;
+                    pc_ = sepc_;
+                    set_priv_(spp);
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                    return;
+                }
+                case 0x105: // WFI
+                    if (priv_ < privilege_t::M && (mstatus_ & mstatus_t::TW)) {
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                        return;
+                    }
+                    pc_ += INSTR_SIZE;
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                    // interrupts are delivered by events only, so the hart sleeps until the
+                    // next one instead of spinning in the idle loop
+                    if ((mip_ & mie_) == 0 && !cycle_queue_.is_empty() && cycle_queue_.get_delta() > 0) {
+                        stall_cycles_ = cycle_queue_.get_delta();
+                        batch_exit_ = true;
+                    }
+                    return;
+                default:
+                    SIM_LOG_INFO(2, cobj_, 0, "Illegal SYSTEM instruction: func12='0x%03x'", func12);
+                    raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                    return;
+            }
+        }
+        // Zicsr, CSRRW(I), CSRRS(I), CSRRC(I)
+        uint16_t csr = static_cast<uint16_t>(func12);
+        uint32_t rd = static_cast<uint32_t>(dec_instr.rd);
+        uint32_t rs1 = static_cast<uint32_t>(dec_instr.rs1);
+        // the immediate variants (func3[2] set) use the rs1 field as 5-bit zero-extended value
+        reg_t src = (func3 & 0b100) ? static_cast<reg_t>(rs1) : regs_[rs1];
+        bool is_swap = (func3 & 0b11) == 0b01;
+        // CSRRW doesn't read the CSR if rd = x0, CSRRS/CSRRC don't write it if rs1 = x0
+        bool do_read = !is_swap || rd != 0;
+        bool do_write = is_swap || rs1 != 0;
+        reg_t old_val = 0;
+        if (do_read && !csr_read_(csr, &old_val)) {
+            SIM_LOG_INFO(2, cobj_, 0, "Illegal CSR read: csr='0x%03x', priv='%u'", csr, priv_);
+            raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+            return;
+        }
+        if (do_write) {
+            reg_t new_val;
+            switch (func3 & 0b11) {
+                case 0b01: new_val = src; break; // CSRRW
+                case 0b10: new_val = old_val | src; break; // CSRRS
+                case 0b11: new_val = old_val & ~src; break; // CSRRC
+                default:
+                    raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                    return;
+            }
+            if (!csr_write_(csr, new_val)) {
+                SIM_LOG_INFO(2, cobj_, 0, "Illegal CSR write: csr='0x%03x', priv='%u'", csr, priv_);
+                raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                return;
+            }
+            // the write may enable a pending interrupt, it's checked at the end of the batch
+            batch_exit_ = true;
+        }
+        if (do_read && rd != 0) { // x0 is hardwired to zero
+            regs_[rd] = old_val;
+        }
+        pc_ += INSTR_SIZE;
+        inc_cycles_(1);
+        inc_steps_(1);
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::execute_misc_mem_(const dec_instr_t &dec_instr) {
+        switch (static_cast<uint32_t>(dec_instr.func3)) {
+            case 0b000: // FENCE
+                // single hart with in-order memory accesses, nothing to order
+                break;
+            case 0b001: // FENCE.I
+                // instructions could be modified through the device accesses (not visible to
+                // the store path), so the predecoded instructions are dropped
+                predecode_cache_.flush();
+                break;
+            default:
+                SIM_LOG_INFO(2, cobj_, 0, "Illegal MISC_MEM func3: 0x%x", static_cast<uint32_t>(dec_instr.func3));
+                raise_exception_(trap_cause_t::ILLEGAL_INSTR, 0);
+                return;
+        }
+        pc_ += INSTR_SIZE;
+        inc_cycles_(1);
+        inc_steps_(1);
+    }
+
+    template<unsigned XLEN>
+    const std::vector<typename RiscvCpu<XLEN>::CsrState> &RiscvCpu<XLEN>::get_csr_state_() {
+        static const std::vector<CsrState> state = {
+            {csr_addr_t::MSTATUS, &RiscvCpu::mstatus_},
+            {csr_addr_t::MEDELEG, &RiscvCpu::medeleg_},
+            {csr_addr_t::MIDELEG, &RiscvCpu::mideleg_},
+            {csr_addr_t::MIE, &RiscvCpu::mie_},
+            {csr_addr_t::MIP, &RiscvCpu::mip_},
+            {csr_addr_t::MTVEC, &RiscvCpu::mtvec_},
+            {csr_addr_t::MCOUNTEREN, &RiscvCpu::mcounteren_},
+            {csr_addr_t::MSCRATCH, &RiscvCpu::mscratch_},
+            {csr_addr_t::MEPC, &RiscvCpu::mepc_},
+            {csr_addr_t::MCAUSE, &RiscvCpu::mcause_},
+            {csr_addr_t::MTVAL, &RiscvCpu::mtval_},
+            {csr_addr_t::STVEC, &RiscvCpu::stvec_},
+            {csr_addr_t::SCOUNTEREN, &RiscvCpu::scounteren_},
+            {csr_addr_t::SSCRATCH, &RiscvCpu::sscratch_},
+            {csr_addr_t::SEPC, &RiscvCpu::sepc_},
+            {csr_addr_t::SCAUSE, &RiscvCpu::scause_},
+            {csr_addr_t::STVAL, &RiscvCpu::stval_},
+            {csr_addr_t::SATP, &RiscvCpu::satp_},
+        };
+        return state;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::csrs_as_attr() const {
+        const std::vector<CsrState> &state = get_csr_state_();
+        attr_value_t csrs = SIM_alloc_attr_list(static_cast<unsigned>(state.size()));
+        for (size_t i = 0; i < state.size(); ++i) {
+            SIM_attr_list_set_item(
+                &csrs, static_cast<unsigned>(i),
+                SIM_make_attr_list(2, SIM_make_attr_uint64(state[i].csr), SIM_make_attr_uint64(this->*state[i].value))
+            );
+        }
+        return csrs;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_csrs_from_attr(attr_value_t *val) {
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t item = SIM_attr_list_item(*val, i);
+            uint64_t csr = SIM_attr_integer(SIM_attr_list_item(item, 0));
+            const std::vector<CsrState> &state = get_csr_state_();
+            auto it = std::find_if(state.begin(), state.end(), [csr](const CsrState &entry) {
+                return entry.csr == csr;
+            });
+            if (it == state.end()) {
+                return Sim_Set_Illegal_Value;
+            }
+            this->*it->value = static_cast<reg_t>(SIM_attr_integer(SIM_attr_list_item(item, 1)));
+        }
+        // mstatus.MPRV selects the data privilege level, mip/mie may enable an interrupt
+        update_data_priv_();
+        batch_exit_ = true;
+        return Sim_Set_Ok;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::pmp_as_attr() const {
+        attr_value_t entries = SIM_alloc_attr_list(RiscvCpuPmp::ENTRIES_NUM);
+        for (unsigned i = 0; i < RiscvCpuPmp::ENTRIES_NUM; ++i) {
+            SIM_attr_list_set_item(
+                &entries, i,
+                SIM_make_attr_list(2, SIM_make_attr_uint64(pmp_.get_cfg(i)), SIM_make_attr_uint64(pmp_.get_addr(i)))
+            );
+        }
+        return entries;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_pmp_from_attr(attr_value_t *val) {
+        // the addresses go first, so neither the locked entries nor the locked TOR tops
+        // reject the rest of the restored state
+        pmp_.reset();
+        for (unsigned i = 0; i < RiscvCpuPmp::ENTRIES_NUM; ++i) {
+            pmp_.set_addr(i, SIM_attr_integer(SIM_attr_list_item(SIM_attr_list_item(*val, i), 1)));
+        }
+        for (unsigned i = 0; i < RiscvCpuPmp::ENTRIES_NUM; ++i) {
+            pmp_.set_cfg(i, static_cast<uint8_t>(SIM_attr_integer(SIM_attr_list_item(SIM_attr_list_item(*val, i), 0))));
+        }
+        flush_caches_();
+        return Sim_Set_Ok;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-profile.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuProfiler::RiscvCpuProfiler() {
+        clear();
+    }
+
+    profile_entry_t *RiscvCpuProfiler::insert_(uint64_t pc) {
+        // keep the load factor below 3/4, so the probe sequences stay short
+        if ((used_ + 1) * 4 > entries_.size() * 3) {
+            std::vector<profile_entry_t> old(entries_.size() * 2, profile_entry_t{EMPTY_PC, 0, 0, 0});
+            old.swap(entries_);
+            for (const auto &entry : old) {
+                if (entry.pc != EMPTY_PC) {
+                    *find_(entry.pc) = entry;
+                }
+            }
+        }
+        profile_entry_t *entry = find_(pc);
+        *entry = profile_entry_t{pc, 0, 0, 0};
+        used_++;
+        return entry;
+    }
+
+    void RiscvCpuProfiler::merge(const profile_entry_t &block) {
+        profile_entry_t *entry = find_(block.pc);
+        if (entry->pc == EMPTY_PC) {
+            entry = insert_(block.pc);
+        }
+        entry->executions += block.executions;
+        entry->instructions += block.instructions;
+        entry->length = std::max(entry->length, block.length);
+    }
+
+    void RiscvCpuProfiler::clear() {
+        entries_.assign(1ULL << INITIAL_WIDTH, profile_entry_t{EMPTY_PC, 0, 0, 0});
+        used_ = 0;
+    }
+
+    std::vector<profile_entry_t> RiscvCpuProfiler::get_sorted() const {
+        std::vector<profile_entry_t> blocks;
+        blocks.reserve(used_);
+        for (const auto &entry : entries_) {
+            if (entry.pc != EMPTY_PC) {
+                blocks.push_back(entry);
+            }
+        }
+        std::sort(blocks.begin(), blocks.end(), [](const profile_entry_t &a, const profile_entry_t &b) {
+            return a.instructions != b.instructions ? a.instructions > b.instructions : a.pc < b.pc;
+        });
+        return blocks;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::update_instrumentation_() {
+        tracking_blocks_ = profiling_ || bbv_collecting_;
+        instrumentation_active_ = instrumentation_.is_active();
+        instrumented_ = tracking_blocks_ || callgraph_tracking_ || mix_counting_ || tracing_ ||
+            mode_ != sim_mode_t::Functional || instrumentation_active_;
+        // the run loop picks the variant at the beginning of the next batch
+        batch_exit_ = true;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::profile_as_attr() const {
+        std::vector<profile_entry_t> blocks = profiler_.get_sorted();
+        attr_value_t result = SIM_alloc_attr_list(static_cast<unsigned>(blocks.size()));
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            SIM_attr_list_set_item(
+                &result, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    4,
+                    SIM_make_attr_uint64(blocks[i].pc),
+                    SIM_make_attr_uint64(blocks[i].executions),
+                    SIM_make_attr_uint64(blocks[i].instructions),
+                    SIM_make_attr_uint64(blocks[i].length)
+                )
+            );
+        }
+        return result;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_profile_from_attr(attr_value_t *val) {
+        profiler_.clear();
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t block = SIM_attr_list_item(*val, i);
+            profile_entry_t entry;
+            entry.pc = SIM_attr_integer(SIM_attr_list_item(block, 0));
+            entry.executions = SIM_attr_integer(SIM_attr_list_item(block, 1));
+            entry.instructions = SIM_attr_integer(SIM_attr_list_item(block, 2));
+            entry.length = static_cast<uint32_t>(SIM_attr_integer(SIM_attr_list_item(block, 3)));
+            if (entry.pc & (INSTR_SIZE - 1)) {
+                return Sim_Set_Illegal_Value;
+            }
+            profiler_.merge(entry);
+        }
+        block_len_ = 0;
+        return Sim_Set_Ok;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::instr_mix_as_attr() const {
+        static constexpr const char *formats[] = {"other", "R", "I", "S", "B", "U", "J", "other"};
+        std::vector<mix_counter_t> counters = instr_mix_.get_sorted();
+        attr_value_t result = SIM_alloc_attr_list(static_cast<unsigned>(counters.size()));
+        for (size_t i = 0; i < counters.size(); ++i) {
+            SIM_attr_list_set_item(
+                &result, static_cast<unsigned>(i),
+                SIM_make_attr_list(
+                    3,
+                    SIM_make_attr_string(counters[i].mnemonic.c_str()),
+                    SIM_make_attr_string(formats[static_cast<unsigned>(counters[i].type)]),
+                    SIM_make_attr_uint64(counters[i].executions)
+                )
+            );
+        }
+        return result;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -92,8 +92,11 @@ namespace kz::riscv::core {
     }
 
     void EventQueue::post(simtime_t when, event_class_t* evclass, conf_object_t* obj, lang_void* param) {
-        // slot can be used for ordering if needed, here set to 0
-        events_.emplace_back(when, 0, evclass, obj, param);
+        // the queue is kept ordered by delta, so the front event is always the next one due,
+        // events due at the same time are handled in the posting order (slot is set to 0)
+        auto it = std::upper_bound(events_.begin(), events_.end(), when,
+            [](simtime_t delta, const Event& e) { return delta < e.delta; });
+        events_.emplace(it, when, 0, evclass, obj, param);
     }
 
     void EventQueue::rescale_time(uint64 old_freq, uint64 new_freq) {
@@ -0,0 +1,309 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-timing.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuTiming::RiscvCpuTiming() {
+        window_open_ = false;
+        window_steps_ = 0;
+        window_cycles_ = 0;
+        set_stats(0, 0, 0);
+    }
+
+    const char *RiscvCpuTiming::get_mode_name(sim_mode_t mode) {
+        switch (mode) {
+            case sim_mode_t::Warmup:
+                return "warmup";
+            case sim_mode_t::Timing:
+                return "timing";
+            default:
+                return "functional";
+        }
+    }
+
+    bool RiscvCpuTiming::get_mode(const std::string &name, sim_mode_t *mode) {
+        for (sim_mode_t candidate : {sim_mode_t::Functional, sim_mode_t::Warmup, sim_mode_t::Timing}) {
+            if (name == get_mode_name(candidate)) {
+                *mode = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RiscvCpuTiming::pop_due(uint64_t step, sim_mode_t *mode) {
+        if (schedule_.empty() || schedule_.begin()->first > step) {
+            return false;
+        }
+        *mode = schedule_.begin()->second;
+        schedule_.erase(schedule_.begin());
+        return true;
+    }
+
+    void RiscvCpuTiming::begin_window(uint64_t steps, uint64_t cycles) {
+        window_open_ = true;
+        window_steps_ = steps;
+        window_cycles_ = cycles;
+    }
+
+    void RiscvCpuTiming::end_window(uint64_t steps, uint64_t cycles) {
+        if (!window_open_) {
+            return;
+        }
+        window_open_ = false;
+        windows_++;
+        instructions_ += steps - window_steps_;
+        cycles_ += cycles - window_cycles_;
+    }
+
+    void RiscvCpuTiming::get_stats(uint64_t steps, uint64_t cycles, uint64_t *windows,
+        uint64_t *instructions, uint64_t *window_cycles) const {
+        *windows = windows_;
+        *instructions = instructions_;
+        *window_cycles = cycles_;
+        if (window_open_) {
+            *windows += 1;
+            *instructions += steps - window_steps_;
+            *window_cycles += cycles - window_cycles_;
+        }
+    }
+
+    void RiscvCpuTiming::set_stats(uint64_t windows, uint64_t instructions, uint64_t cycles) {
+        windows_ = windows;
+        instructions_ = instructions;
+        cycles_ = cycles;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::set_mode_(sim_mode_t mode) {
+        if (mode == mode_) {
+            return;
+        }
+        uint64_t cycles = current_cycle_ + stall_cycles_;
+        if (mode_ == sim_mode_t::Timing) {
+            timing_.end_window(current_step_, cycles);
+        }
+        SIM_LOG_INFO(
+            2, cobj_, 0, "Switching from %s to %s mode at step %llu",
+            RiscvCpuTiming::get_mode_name(mode_), RiscvCpuTiming::get_mode_name(mode),
+            static_cast<unsigned long long>(current_step_)
+        );
+        mode_ = mode;
+        if (mode_ == sim_mode_t::Timing) {
+            timing_.begin_window(current_step_, cycles);
+        }
+        update_instrumentation_();
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::apply_mode_schedule_() {
+        sim_mode_t mode;
+        while (timing_.pop_due(current_step_, &mode)) {
+            set_mode_(mode);
+        }
+    }
+
+    template<unsigned XLEN>
+    uint64 RiscvCpu<XLEN>::mode_magic_handler_(
+        lang_void *user_data,
+        conf_object_t *cpu,
+        uint32 instr,
+        uint64 rs1_val,
+        uint64 rs2_val) {
+        // the shift amount selects the mode, see is_mode_magic_
+        static constexpr sim_mode_t MODES[] = {sim_mode_t::Functional, sim_mode_t::Warmup, sim_mode_t::Timing};
+        simics::from_obj<RiscvCpu>(cpu)->set_mode_(MODES[((instr >> 20) & 0x1F) - 1]);
+        return 0;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::timing_instr_(reg_t pc, const predecoded_instr_t *entry, bool retired, reg_t addr) {
+        // the timing models account the executed instruction here, the warm-up mode only
+        // trains them, the timing mode charges the extra cycles
+        if (entry == nullptr) {
+            return;
+        }
+        cycles_t extra = 0;
+        if (icache_.is_attached()) {
+            extra += icache_.access(pc, false) * icache_miss_penalty_;
+        }
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        if (retired && dcache_.is_attached() && (entry->dec_instr.opcode == operation_code_t::LOAD ||
+            entry->dec_instr.opcode == operation_code_t::STORE)) {
+            // the caches are indexed with the effective address, it's the physical one unless
+            // the address translation is enabled
+            bool is_write = entry->dec_instr.opcode == operation_code_t::STORE;
+            extra += dcache_.access(addr, is_write) * dcache_miss_penalty_;
+        }
+        if (retired && entry->ends_block && bpred_.is_attached()) {
+            const dec_instr_t &dec_instr = entry->dec_instr;
+            bool miss = false;
+            if (dec_instr.opcode == operation_code_t::BRANCH) {
+                // the decoder keeps B-type offsets in halfwords
+                reg_t target = pc + (static_cast<reg_t>(static_cast<sreg_t>(dec_instr.imm)) << 1);
+                miss = bpred_.branch(pc, target, pc_ != static_cast<reg_t>(pc + INSTR_SIZE));
+            } else if (dec_instr.opcode == operation_code_t::JAL || dec_instr.opcode == operation_code_t::JALR) {
+                // the call graph uses the same call/return predicates
+                bool indirect = dec_instr.opcode == operation_code_t::JALR;
+                miss = bpred_.jump(pc, pc_, indirect, RiscvCpuDecoder::is_call(dec_instr),
+                    RiscvCpuDecoder::is_return(dec_instr));
+            }
+            if (miss) {
+                extra += bpred_penalty_;
+            }
+        }
+        if (mode_ != sim_mode_t::Timing) {
+            return;
+        }
+        if (retired) {
+            // the latencies were resolved at predecode time, the execution took one cycle
+            bool taken = pc_ != static_cast<reg_t>(pc + INSTR_SIZE);
+            extra += (taken ? entry->taken_cycles : entry->cycles) - 1;
+        }
+        charge_cycles_(extra);
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::charge_cycles_(cycles_t extra) {
+        if (extra == 0) {
+            return;
+        }
+        simtime_t delta = cycle_queue_.get_delta();
+        if (delta >= 0 && delta <= extra) {
+            // a cycle event is due within the stall, the run loop consumes it up to the event
+            stall_cycles_ += extra;
+            batch_exit_ = true;
+        } else {
+            inc_cycles_(static_cast<int>(extra));
+            limit_batch_();
+        }
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::mode_schedule_as_attr() const {
+        const auto &schedule = timing_.get_schedule();
+        attr_value_t result = SIM_alloc_attr_list(static_cast<unsigned>(schedule.size()));
+        unsigned i = 0;
+        for (const auto &[step, mode] : schedule) {
+            SIM_attr_list_set_item(
+                &result, i++,
+                SIM_make_attr_list(
+                    2,
+                    SIM_make_attr_uint64(step),
+                    SIM_make_attr_string(RiscvCpuTiming::get_mode_name(mode))
+                )
+            );
+        }
+        return result;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_mode_schedule_from_attr(attr_value_t *val) {
+        RiscvCpuTiming timing;
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t item = SIM_attr_list_item(*val, i);
+            sim_mode_t mode;
+            if (!RiscvCpuTiming::get_mode(SIM_attr_string(SIM_attr_list_item(item, 1)), &mode)) {
+                return Sim_Set_Illegal_Value;
+            }
+            timing.schedule(SIM_attr_integer(SIM_attr_list_item(item, 0)), mode);
+        }
+        timing_.clear_schedule();
+        for (const auto &[step, mode] : timing.get_schedule()) {
+            timing_.schedule(step, mode);
+        }
+        // the batch size depends on the next switch
+        batch_exit_ = true;
+        return Sim_Set_Ok;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::timing_stats_as_attr() const {
+        uint64_t windows, instructions, cycles;
+        timing_.get_stats(current_step_, current_cycle_ + stall_cycles_, &windows, &instructions, &cycles);
+        return SIM_make_attr_list(
+            3,
+            SIM_make_attr_uint64(windows),
+            SIM_make_attr_uint64(instructions),
+            SIM_make_attr_uint64(cycles)
+        );
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_timing_stats_from_attr(attr_value_t *val) {
+        if (SIM_attr_list_size(*val) == 0) {
+            timing_.set_stats(0, 0, 0);
+        } else {
+            uint64_t windows = SIM_attr_integer(SIM_attr_list_item(*val, 0));
+            // the saved values include the window open at the time, it continues from now
+            if (timing_.is_window_open() && windows != 0) {
+                windows--;
+            }
+            timing_.set_stats(
+                windows,
+                SIM_attr_integer(SIM_attr_list_item(*val, 1)),
+                SIM_attr_integer(SIM_attr_list_item(*val, 2))
+            );
+        }
+        if (timing_.is_window_open()) {
+            timing_.begin_window(current_step_, current_cycle_ + stall_cycles_);
+        }
+        return Sim_Set_Ok;
+    }
+
+    template<unsigned XLEN>
+    attr_value_t RiscvCpu<XLEN>::cost_model_as_attr() const {
+        attr_value_t result = SIM_alloc_attr_list(cost_class_t::NUM);
+        for (uint8_t cls = 0; cls < cost_class_t::NUM; ++cls) {
+            SIM_attr_list_set_item(
+                &result, cls,
+                SIM_make_attr_list(
+                    2,
+                    SIM_make_attr_string(RiscvCpuCostModel::get_class_name(cls)),
+                    SIM_make_attr_uint64(cost_model_.get_latency(cls))
+                )
+            );
+        }
+        return result;
+    }
+
+    template<unsigned XLEN>
+    set_error_t RiscvCpu<XLEN>::set_cost_model_from_attr(attr_value_t *val) {
+        RiscvCpuCostModel cost_model = cost_model_;
+        for (unsigned i = 0; i < SIM_attr_list_size(*val); ++i) {
+            attr_value_t item = SIM_attr_list_item(*val, i);
+            uint8_t cls;
+            int64 cycles = SIM_attr_integer(SIM_attr_list_item(item, 1));
+            if (!RiscvCpuCostModel::get_class(SIM_attr_string(SIM_attr_list_item(item, 0)), &cls) ||
+                cycles < 1 || cycles > UINT16_MAX) {
+                return Sim_Set_Illegal_Value;
+            }
+            cost_model.set_latency(cls, static_cast<uint16_t>(cycles));
+        }
+        cost_model_ = cost_model;
+        // the latencies are resolved when the instructions are predecoded
+        predecode_cache_.flush();
+        return Sim_Set_Ok;
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
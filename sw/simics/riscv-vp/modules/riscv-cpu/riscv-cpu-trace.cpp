@@ -0,0 +1,196 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstring>
+#ifdef RISCV_CPU_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "riscv-cpu.hpp"
+#include "riscv-cpu-trace.hpp"
+
+namespace kz::riscv::core {
+    RiscvCpuTracer::RiscvCpuTracer():
+        head_(0), tail_(0), stop_(false), write_error_(false), file_(nullptr), compress_(false),
+        next_pc_(0), last_addr_(0), records_(0) {
+        for (auto &chunk : ring_) {
+            chunk.size = 0;
+            chunk.records = 0;
+        }
+    }
+
+    RiscvCpuTracer::~RiscvCpuTracer() {
+        close();
+    }
+
+    bool RiscvCpuTracer::open(const std::string &path, unsigned xlen, bool compress) {
+        close();
+#ifndef RISCV_CPU_HAVE_ZLIB
+        if (compress) {
+            return false;
+        }
+#endif
+        file_ = fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        uint8_t header[16] = {'R', 'V', 'T', 'R', 'A', 'C', 'E', 0};
+        header[8] = static_cast<uint8_t>(VERSION);
+        header[9] = static_cast<uint8_t>(VERSION >> 8);
+        header[10] = static_cast<uint8_t>(xlen);
+        header[11] = static_cast<uint8_t>(xlen >> 8);
+        header[12] = compress ? FLAG_COMPRESSED : 0;
+        fwrite(header, sizeof(header), 1, file_);
+        compress_ = compress;
+        for (auto &chunk : ring_) {
+            chunk.data.resize(CHUNK_SIZE);
+        }
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        stop_.store(false, std::memory_order_relaxed);
+        write_error_.store(false, std::memory_order_relaxed);
+        records_ = 0;
+        start_chunk_();
+        writer_ = std::thread(&RiscvCpuTracer::write_chunks_, this);
+        return true;
+    }
+
+    bool RiscvCpuTracer::close() {
+        if (file_ == nullptr) {
+            return true;
+        }
+        flush();
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+        bool ok = !write_error_.load(std::memory_order_relaxed) && fclose(file_) == 0;
+        file_ = nullptr;
+        // the buffers are released, a trace file can take a while to be opened again
+        for (auto &chunk : ring_) {
+            std::vector<uint8_t>().swap(chunk.data);
+        }
+        std::vector<uint8_t>().swap(compressed_);
+        return ok;
+    }
+
+    void RiscvCpuTracer::start_chunk_() {
+        Chunk &chunk = ring_[head_.load(std::memory_order_relaxed) % RING_SLOTS];
+        chunk.size = 0;
+        chunk.records = 0;
+        next_pc_ = 0;
+        last_addr_ = 0;
+    }
+
+    void RiscvCpuTracer::flush() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (file_ == nullptr || ring_[head % RING_SLOTS].records == 0) {
+            return;
+        }
+        head_.store(head + 1, std::memory_order_release);
+        // wait for the writer if the whole ring is pending, the trace can't lose records
+        while (head + 1 - tail_.load(std::memory_order_acquire) >= RING_SLOTS) {
+            std::this_thread::yield();
+        }
+        start_chunk_();
+    }
+
+    void RiscvCpuTracer::write_chunks_() {
+        for (;;) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                // the producer publishes the last chunk before it sets stop_
+                if (stop_.load(std::memory_order_acquire) && tail == head_.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            if (!write_chunk_(ring_[tail % RING_SLOTS])) {
+                write_error_.store(true, std::memory_order_relaxed);
+            }
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+        fflush(file_);
+    }
+
+    bool RiscvCpuTracer::write_chunk_(const Chunk &chunk) {
+        const uint8_t *data = chunk.data.data();
+        size_t size = chunk.size;
+#ifdef RISCV_CPU_HAVE_ZLIB
+        if (compress_) {
+            uLongf stored = compressBound(static_cast<uLong>(chunk.size));
+            compressed_.resize(stored);
+            if (compress2(compressed_.data(), &stored, data, static_cast<uLong>(size), Z_BEST_SPEED) != Z_OK) {
+                return false;
+            }
+            data = compressed_.data();
+            size = stored;
+        }
+#endif
+        uint32_t header[4] = {
+            CHUNK_MAGIC,
+            static_cast<uint32_t>(size),
+            static_cast<uint32_t>(chunk.size),
+            chunk.records
+        };
+        uint8_t bytes[sizeof(header)];
+        for (size_t i = 0; i < sizeof(bytes); ++i) {
+            bytes[i] = static_cast<uint8_t>(header[i / 4] >> (8 * (i % 4)));
+        }
+        return fwrite(bytes, sizeof(bytes), 1, file_) == 1 && fwrite(data, size, 1, file_) == 1;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::trace_instr_(reg_t pc, uint8_t priv, const predecoded_instr_t &entry, reg_t addr, reg_t store_val) {
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        const dec_instr_t &dec_instr = entry.dec_instr;
+        trace_record_t rec;
+        rec.pc = pc;
+        rec.instr = entry.instr;
+        rec.priv = priv;
+        rec.flags = 0;
+        switch (dec_instr.opcode) {
+            case operation_code_t::STORE: {
+                rec.flags = RiscvCpuTracer::REC_MEM | RiscvCpuTracer::REC_STORE;
+                rec.addr = addr;
+                unsigned bits = 8u << dec_instr.func3;
+                rec.store_val = bits < 64 ? (store_val & ((1ULL << bits) - 1)) : store_val;
+                break;
+            }
+            case operation_code_t::BRANCH:
+            case operation_code_t::MISC_MEM:
+                break;
+            case operation_code_t::LOAD:
+                rec.flags = RiscvCpuTracer::REC_MEM;
+                rec.addr = addr;
+                [[fallthrough]];
+            default:
+                if (dec_instr.rd != 0) {
+                    rec.flags |= RiscvCpuTracer::REC_RD;
+                    rec.rd = dec_instr.rd;
+                    rec.rd_val = regs_[dec_instr.rd];
+                }
+                break;
+        }
+        tracer_.record(rec);
+    }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
+} /* ! kz::riscv::core ! */
@@ -26,10 +26,10 @@ namespace kz::riscv::types {
             case 0b000: return I_TYPE; // LOAD
             case 0b001: return OTHER_TYPE; // LOAD_FP
             case 0b010: return OTHER_TYPE; // CUSTOM_0
-            case 0b011: return OTHER_TYPE; // MISC_MEM
+            case 0b011: return I_TYPE; // MISC_MEM
             case 0b100: return I_TYPE; // OP_IMM
             case 0b101: return U_TYPE; // AUIPC
-            case 0b110: return OTHER_TYPE; // OP_IMM_32
+            case 0b110: return I_TYPE; // OP_IMM_32
             case 0b111: return OTHER_TYPE; // RV_48_0
         }
         return UNDEF_TYPE;
@@ -43,7 +43,7 @@ namespace kz::riscv::types {
             case 0b011: return OTHER_TYPE; // AMO
             case 0b100: return R_TYPE; // OP
             case 0b101: return U_TYPE; // LUI
-            case 0b110: return OTHER_TYPE; // OP_32
+            case 0b110: return R_TYPE; // OP_32
             case 0b111: return OTHER_TYPE; // RV_64
         }
         return UNDEF_TYPE;
@@ -69,7 +69,7 @@ namespace kz::riscv::types {
             case 0b001: return I_TYPE; // JALR
             case 0b010: return OTHER_TYPE; // RSVD_1
             case 0b011: return J_TYPE; // JAL
-            case 0b100: return OTHER_TYPE; // SYSTEM
+            case 0b100: return I_TYPE; // SYSTEM
             case 0b101: return OTHER_TYPE; // RSVD_2
             case 0b110: return OTHER_TYPE; // CUSTOM_3_RV128
             case 0b111: return OTHER_TYPE; // RV_80
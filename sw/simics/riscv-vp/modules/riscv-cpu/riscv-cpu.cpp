@@ -18,6 +18,7 @@
  */
 
 #include <iostream>
+#include <string>
 
 #include <simics/cc-api.h>
 #include <simics/base/clock.h>
@@ -27,20 +28,82 @@
 #include "riscv-cpu.hpp"
 #include "riscv-cpu-decode.hpp"
 #include "riscv-cpu-conf.hpp"
+#include "riscv-clint.hpp"
+#include "riscv-uart.hpp"
+#include "riscv-popcount.hpp"
 
 
 namespace kz::riscv::core {
-    RiscvCpu::RiscvCpu(simics::ConfObjectRef conf_obj)
-    : simics::ConfObject(conf_obj), step_queue_("step-queue"), cycle_queue_("cycle-queue") {
+    template<unsigned XLEN>
+    RiscvCpu<XLEN>::RiscvCpu(simics::ConfObjectRef conf_obj)
+    : simics::ConfObject(conf_obj), step_queue_("step-queue"), cycle_queue_("cycle-queue"),
+      predecode_cache_(&instrumentation_) {
         cobj_ = obj().object();
         // general registers
         regs_.fill(0);
+        pc_ = RESET_ADDR;
+        // privilege level, the hart starts in M-mode
+        priv_ = privilege_t::M;
+        data_priv_ = privilege_t::M;
+        data_tlb_ = &tlb_[privilege_t::M];
         // control and status registers
         mstatus_ = 0;
+        medeleg_ = 0;
+        mideleg_ = 0;
+        mie_ = 0;
+        mip_ = 0;
+        mtvec_ = 0;
+        mcounteren_ = 0;
+        mscratch_ = 0;
         mepc_ = 0;
         mcause_ = 0;
-        mtvec_ = 0;
-        pc_ = 0;
+        mtval_ = 0;
+        stvec_ = 0;
+        scounteren_ = 0;
+        sscratch_ = 0;
+        sepc_ = 0;
+        scause_ = 0;
+        stval_ = 0;
+        satp_ = 0;
+        // host interface
+        tohost_addr_ = 0;
+        fromhost_addr_ = 0;
+        semihosting_ = false;
+        quit_on_exit_ = false;
+        exited_ = false;
+        exit_code_ = 0;
+        // breakpoints
+        break_step_ = -1;
+        break_pc_ = 0;
+        breakpoint_hap_ = -1;
+        last_watch_hit_ = watchpoint_hit_t{watchpoint_hit_t::NO_HIT, 0, 0, 0, 0, 0};
+        gdb_running_ = false;
+        gdb_watch_step_ = 0;
+        gdb_watch_handle_ = watchpoint_hit_t::NO_HIT;
+        gdb_stopped_hap_ = -1;
+        // instrumentation
+        profiling_ = false;
+        bbv_interval_ = BBV_INTERVAL;
+        bbv_collecting_ = false;
+        tracking_blocks_ = false;
+        block_pc_ = 0;
+        block_len_ = 0;
+        host_profiling_ = false;
+        mem_countdown_ = mem_profile_.get_countdown();
+        coverage_enabled_ = false;
+        callgraph_tracking_ = false;
+        mix_counting_ = false;
+        tracing_ = false;
+        trace_compression_ = false;
+        trap_count_ = 0;
+        mode_ = sim_mode_t::Functional;
+        mode_magic_ = false;
+        mode_magic_instr_ = custom_instr_t{"mode_magic", 0, 0, 0, 1, mode_magic_handler_, nullptr};
+        icache_miss_penalty_ = CACHE_MISS_PENALTY;
+        dcache_miss_penalty_ = CACHE_MISS_PENALTY;
+        bpred_penalty_ = BRANCH_MISPREDICT_PENALTY;
+        instrumented_ = false;
+        instrumentation_active_ = false;
         // direct memory interface
         subsystem_ = 0;
         // state
@@ -51,153 +114,494 @@ namespace kz::riscv::core {
         current_cycle_ = 0;
         current_step_ = 0;
         time_offset_.val = {};
+        batch_exit_ = false;
+        batch_left_ = 0;
         // configuration
         freq_hz_ = 1000;  // Default frequency: 1 kHz
         VT_set_object_clock(conf_obj, conf_obj);
     }
 
-    RiscvCpu::~RiscvCpu() {}
+    template<unsigned XLEN>
+    RiscvCpu<XLEN>::~RiscvCpu() {
+        if (breakpoint_hap_ >= 0) {
+            SIM_hap_delete_callback_id("Core_Breakpoint_Change", breakpoint_hap_);
+        }
+        close_gdb_();
+    }
 
-    direct_memory_lookup_t RiscvCpu::get_mem_handler_(physical_address_t addr, unsigned size) {
-        direct_memory_lookup_t dml = phys_mem_.iface().lookup(cobj_, addr, size, Sim_Access_Read);
+    template<unsigned XLEN>
+    direct_memory_lookup_t RiscvCpu<XLEN>::get_mem_handler_(
+        physical_address_t addr,
+        unsigned size,
+        access_t access) {
+        direct_memory_lookup_t dml = phys_mem_.iface().lookup(cobj_, addr, size, access);
         SIM_LOG_INFO(
-            1, cobj_, 0,
-            "direct memory lookup: target='%s', offs='%llu', access='%d'",
-            SIM_object_name(dml.target), dml.offs, dml.access
+            4, cobj_, 0,
+            "direct memory lookup: addr='0x%llx', target='%s', offs='%llu', access='%d'",
+            addr, dml.target ? SIM_object_name(dml.target) : "", dml.offs, dml.access
         );
         return dml;
     }
 
-    uint8 *RiscvCpu::read_mem_(addr_t offset, unsigned size) {
+    template<unsigned XLEN>
+    uint8 *RiscvCpu<XLEN>::read_mem_(physical_address_t addr, unsigned size) {
+        direct_memory_lookup_t dml = get_mem_handler_(addr, size, Sim_Access_Read);
+        if (dml.target == nullptr) {
+            return nullptr;
+        }
         simics::Connect<simics::iface::DirectMemoryInterface> dm_iface;
         // set proper memory target for direct memory access interface
-        dm_iface.set(mem_handler_.target);
+        dm_iface.set(dml.target);
         // The get_handle method is used by a memory user (cpu) to create or retrieve a handle to the
         // memory region starting at offset - "offs" with size - "size", it's unique for requestor
         // representec by "cobj" reference and subsystem id.
-        direct_memory_handle_t mem_handler = dm_iface.iface().get_handle(cobj_, subsystem_, offset, size);
+        direct_memory_handle_t mem_handler = dm_iface.iface().get_handle(cobj_, subsystem_, dml.offs, size);
         direct_memory_t dm = dm_iface.iface().request(mem_handler, Sim_Access_Read, Sim_Access_Write);
         return dm.data;
     }
 
-    uint32_t RiscvCpu::read_reg_(int reg) {
+    template<unsigned XLEN>
+    uint8_t *RiscvCpu<XLEN>::get_page_host_(uint64_t page, unsigned access) {
+        // stores request exclusive write access too, instruction fetches are plain reads
+        access_t permission = (access == RiscvCpuTlb::WRITE)
+            ? static_cast<access_t>(Sim_Access_Read | Sim_Access_Write)
+            : Sim_Access_Read;
+        direct_memory_lookup_t dml = get_mem_handler_(page, RiscvCpuTlb::PAGE_SIZE, permission);
+        if (dml.target == nullptr || (dml.access & permission) != permission) {
+            // not a plain memory (e.g., a device register bank)
+            return nullptr;
+        }
+        simics::Connect<simics::iface::DirectMemoryInterface> dm_iface;
+        dm_iface.set(dml.target);
+        direct_memory_handle_t handle = dm_iface.iface().get_handle(
+            cobj_, subsystem_, dml.offs, RiscvCpuTlb::PAGE_SIZE
+        );
+        direct_memory_t dm = dm_iface.iface().request(handle, permission, Sim_Access_Write);
+        return dm.data;
+    }
+
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::access_slow_(unsigned access, reg_t addr, unsigned size, uint8_t *data) {
+        static constexpr uint8_t misaligned_cause[RiscvCpuTlb::ACCESS_NUM] = {
+            trap_cause_t::LOAD_MISALIGNED, trap_cause_t::STORE_MISALIGNED, trap_cause_t::INSTR_MISALIGNED
+        };
+        static constexpr uint8_t fault_cause[RiscvCpuTlb::ACCESS_NUM] = {
+            trap_cause_t::LOAD_ACCESS_FAULT, trap_cause_t::STORE_ACCESS_FAULT, trap_cause_t::INSTR_ACCESS_FAULT
+        };
+        static constexpr uint8_t pmp_perm[RiscvCpuTlb::ACCESS_NUM] = {
+            RiscvCpuPmp::R, RiscvCpuPmp::W, RiscvCpuPmp::X
+        };
+        // misaligned accesses are not supported, so an access never crosses a page boundary
+        if ((addr & (size - 1)) != 0) {
+            raise_exception_(misaligned_cause[access], addr);
+            return false;
+        }
+        uint8_t priv = (access == RiscvCpuTlb::EXEC) ? priv_ : data_priv_;
+        uint64_t page = static_cast<uint64_t>(addr) & RiscvCpuTlb::PAGE_MASK;
+        // the page can be cached only if the permission applies to all of its bytes
+        bool uniform;
+        bool cacheable = true;
+        uint8_t perms = pmp_.get_perms(page, RiscvCpuTlb::PAGE_SIZE, priv, &uniform);
+        if (!uniform) {
+            cacheable = false;
+            perms = pmp_.get_perms(addr, size, priv, &uniform);
+        }
+        if (!(perms & pmp_perm[access])) {
+            SIM_LOG_INFO(
+                3, cobj_, 0,
+                "PMP denied access: addr='0x%llx', size='%u', access='%u', priv='%u'",
+                static_cast<unsigned long long>(addr), size, access, priv
+            );
+            raise_exception_(fault_cause[access], addr);
+            return false;
+        }
+        // stores to pages with predecoded instructions are never cached, so they can be
+        // invalidated below (self-modifying code)
+        bool is_code = (access == RiscvCpuTlb::WRITE) && (code_pages_.count(page) != 0);
+        bool is_watched = false;
+        if (!watched_pages_.empty()) {
+            auto it = watched_pages_.find(page);
+            is_watched = (it != watched_pages_.end()) && (it->second & (1U << access));
+        }
+        // the execution breakpoints are flagged in the predecoded instructions instead
+        bool is_break = (access != RiscvCpuTlb::EXEC) && (breakpoints_.get_page_mask(page) & (1U << access));
+        bool is_watchpoint = (watchpoints_.get_page_mask(page) & (1U << access)) != 0;
+        // the instructions are predecoded whatever page they are fetched from (uncached or a
+        // device), so the stores to it have to take this path and invalidate them
+        if (access == RiscvCpuTlb::EXEC && code_pages_.insert(page).second) {
+            for (auto &tlb : tlb_) {
+                tlb.flush_page(RiscvCpuTlb::WRITE, page);
+            }
+        }
+        uint8_t *host = get_page_host_(page, access);
+        if (host != nullptr) {
+            if (cacheable && !is_code && !is_watched && !is_break && !is_watchpoint) {
+                tlb_[priv].fill(access, page, host);
+            }
+            uint8_t *ptr = host + (addr & ~RiscvCpuTlb::PAGE_MASK);
+            if (access == RiscvCpuTlb::WRITE) {
+                std::memcpy(ptr, data, size);
+            } else {
+                std::memcpy(data, ptr, size);
+            }
+        } else {
+            // memory mapped device, issue a transaction
+            transaction_flags_t flags = 0;
+            if (access == RiscvCpuTlb::WRITE) {
+                flags = Sim_Transaction_Write;
+            } else if (access == RiscvCpuTlb::EXEC) {
+                flags = Sim_Transaction_Fetch;
+            }
+            atom_t atoms[] = {
+                ATOM_data(data),
+                ATOM_size(size),
+                ATOM_flags(flags),
+                ATOM_initiator(cobj_),
+                ATOM_LIST_END
+            };
+            transaction_t t = {};
+            t.atoms = atoms;
+            exception_type_t ex = SIM_issue_transaction(phys_mem_.obj().object(), &t, addr);
+            if (ex != Sim_PE_No_Exception) {
+                SIM_LOG_INFO(
+                    2, cobj_, 0,
+                    "Memory transaction failed: addr='0x%llx', size='%u', access='%u'",
+                    static_cast<unsigned long long>(addr), size, access
+                );
+                raise_exception_(fault_cause[access], addr);
+                return false;
+            }
+        }
+        if (is_code) {
+            predecode_cache_.flush_range(page, RiscvCpuTlb::PAGE_SIZE);
+        }
+        if (is_watched) {
+            watch_hit_(access, addr, size);
+        }
+        // the transactions pass the breakpoints of the memory space on their own
+        if (is_break && host != nullptr) {
+            break_access_(access, addr, size, data);
+        }
+        if (is_watchpoint) {
+            watch_access_(access, addr, size);
+        }
+        return true;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::flush_caches_() {
+        predecode_cache_.flush();
+        code_pages_.clear();
+        for (auto &tlb : tlb_) {
+            tlb.flush();
+        }
+    }
+
+    template<unsigned XLEN>
+    typename RiscvCpu<XLEN>::reg_t RiscvCpu<XLEN>::read_reg_(int reg) {
         if (reg < 0 || reg >= RV32I_GP_REG_NUM) {
             throw std::out_of_range("Invalid register number");
         }
         return regs_[reg];
     }
 
-    void RiscvCpu::write_reg_(int reg, uint32_t value) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::write_reg_(int reg, reg_t value) {
         if (reg < 0 || reg >= RV32I_GP_REG_NUM) {
             throw std::out_of_range("Invalid register number");
         }
         regs_[reg] = value;
+        regs_[0] = 0; // x0 is hardwired to zero, cheaper than checking rd
     }
 
-    kz::riscv::types::instr_t RiscvCpu::fetch_(addr_t address) {
-        SIM_LOG_INFO(4, cobj_, 0, "Fetching instruction from address 0x%08x", static_cast<unsigned int>(address));
-        uint8 *data = read_mem_(address, INSTR_SIZE);
-        instr_t instr = 0;
-        // Little-endian
-        for (int i = 0; i < INSTR_SIZE; ++i) {
-            instr |= static_cast<instr_t>(data[i]) << (i * 8);
+    template<unsigned XLEN>
+    bool RiscvCpu<XLEN>::fetch_(reg_t address, instr_t *instr) {
+        SIM_LOG_INFO(4, cobj_, 0, "Fetching instruction from address 0x%08llx", static_cast<unsigned long long>(address));
+        uint32_t data;
+        const uint8_t *host = tlb_[priv_].lookup(RiscvCpuTlb::EXEC, address, INSTR_SIZE);
+        if (host != nullptr) {
+            std::memcpy(&data, host, INSTR_SIZE);
+        } else if (!access_slow_(RiscvCpuTlb::EXEC, address, INSTR_SIZE, reinterpret_cast<uint8_t *>(&data))) {
+            return false;
         }
+        // Little-endian
+        *instr = static_cast<instr_t>(data);
         SIM_LOG_INFO(
             4, cobj_, 0,
-            "Fetched instruction 0x%08x from address 0x%08x",
-            instr, static_cast<unsigned int>(address)
+            "Fetched instruction 0x%08x from address 0x%08llx",
+            *instr, static_cast<unsigned long long>(address)
         );
-        return instr;
+        return true;
     }
 
-    kz::riscv::types::dec_instr_t RiscvCpu::decode_(instr_t instr) {
+    template<unsigned XLEN>
+    kz::riscv::types::dec_instr_t RiscvCpu<XLEN>::decode_(instr_t instr) {
         SIM_LOG_INFO(4, cobj_, 0, "Decoding instruction 0x%08x", instr);
         dec_instr_t dec_instr;
         RiscvCpuDecoder::decode(instr, &dec_instr);
         return dec_instr;
     }
 
-    void RiscvCpu::execute_(dec_instr_t dec_instr) {
+    template<unsigned XLEN>
+    predecoded_instr_t *RiscvCpu<XLEN>::predecode_(uint64_t pc) {
+        // The privilege level is a part of the tag (instructions are 4-byte aligned, so the two
+        // lowest bits are free), the fetch permission was checked for the level on fill, so
+        // a privilege change doesn't need to flush the cache.
+        if (pc & (INSTR_SIZE - 1)) {
+            // the tag below relies on the alignment
+            raise_exception_(trap_cause_t::INSTR_MISALIGNED, pc);
+            return nullptr;
+        }
+        uint64_t tag = pc | priv_;
+        predecoded_instr_t *entry = predecode_cache_.lookup(tag);
+        if (entry != nullptr) {
+            return entry;
+        }
+        // cache miss, fetch and decode the instruction and resolve everything what doesn't
+        // depend on the CPU state, so it's not repeated on every execution
+        instr_t instr;
+        if (!fetch_(pc, &instr)) {
+            return nullptr;
+        }
+        if (coverage_enabled_) {
+            coverage_.mark(pc);
+        }
+        // the fill releases the callbacks of the evicted instruction
+        entry = predecode_cache_.fill(tag);
+        entry->instr = instr;
+        if (instrumentation_.has(instrumentation_kind_t::CACHED_INSTRUCTION)) {
+            instrumentation_instr_t cached = {pc, instr};
+            entry->hooks = instrumentation_.cache_instruction(cobj_, &cached);
+        }
+        if (instrumentation_.is_active() != instrumentation_active_) {
+            update_instrumentation_();
+        }
+        entry->breakpoint = (breakpoints_.get_page_mask(pc) & (1U << RiscvCpuTlb::EXEC)) != 0;
+        entry->dec_instr = decode_(entry->instr);
+        entry->custom = custom_instrs_.resolve(entry->dec_instr);
+        if (mode_magic_ && is_mode_magic_(instr)) {
+            entry->custom = &mode_magic_instr_;
+        }
+        cost_model_.resolve(entry->dec_instr, entry->custom, &entry->cycles, &entry->taken_cycles);
+        entry->mix_id = instr_mix_.resolve(entry->dec_instr, entry->custom);
+        // the basic block (profiling) ends with a control transfer, traps are detected at run time
+        using operation_code_t = kz::riscv::types::operation_code_t;
+        entry->ends_block = (entry->dec_instr.opcode == operation_code_t::BRANCH ||
+            entry->dec_instr.opcode == operation_code_t::JAL ||
+            entry->dec_instr.opcode == operation_code_t::JALR ||
+            entry->dec_instr.opcode == operation_code_t::SYSTEM);
+        return entry;
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::execute_custom_(const predecoded_instr_t &entry) {
+        const custom_instr_t *custom = entry.custom;
+        SIM_LOG_INFO(2, cobj_, 0, "Executing custom instruction '%s'", custom->name.c_str());
+        reg_t rs1_val = read_reg_(entry.dec_instr.rs1);
+        reg_t rs2_val = read_reg_(entry.dec_instr.rs2);
+        uint64_t rd_val = custom->handler(custom->user_data, cobj_, entry.instr, rs1_val, rs2_val);
+        if (entry.dec_instr.rd != 0) { // x0 is hardwired to zero
+            write_reg_(entry.dec_instr.rd, static_cast<reg_t>(rd_val));
+        }
+        pc_ += INSTR_SIZE;
+        inc_cycles_(custom->latency);
+        inc_steps_(1);
+        if (custom->latency > 1) {
+            limit_batch_();
+        }
+    }
+
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::execute_(dec_instr_t dec_instr, instr_t instr) {
         using operation_code_t = kz::riscv::types::operation_code_t;
         //cycles_t stall_cycles = 0; // for IDLE operation
         // cycles_t cycles_left = 0; // for IDLE operation
-        uint32_t rs1_val = read_reg_(dec_instr.rs1);
-        uint32_t rs2_val = read_reg_(dec_instr.rs2);
+        reg_t rs1_val = read_reg_(dec_instr.rs1);
+        reg_t rs2_val = read_reg_(dec_instr.rs2);
         int imm12 = ((int)dec_instr.imm) << 12; // for U_TYPE
         switch(dec_instr.opcode) {
-            case operation_code_t::LOAD:
+            case operation_code_t::LOAD: {
                 // Load instructions (e.g., LB, LH, LW, LBU, LHU)
-                // Implement load logic here
                 SIM_LOG_INFO(2, cobj_, 0, "Executing LOAD instruction");
-                pc_ += INSTR_SIZE;
-                inc_cycles_(1);
-                inc_steps_(1);
+                reg_t addr = rs1_val + static_cast<sreg_t>(dec_instr.imm);
+                bool done = false;
+                switch(dec_instr.func3) {
+                    case 0b000: { // LB
+                        int8_t value;
+                        if ((done = load_(addr, &value))) {
+                            write_reg_(dec_instr.rd, static_cast<sreg_t>(value));
+                        }
+                        break;
+                    }
+                    case 0b001: { // LH
+                        int16_t value;
+                        if ((done = load_(addr, &value))) {
+                            write_reg_(dec_instr.rd, static_cast<sreg_t>(value));
+                        }
+                        break;
+                    }
+                    case 0b010: { // LW
+                        int32_t value;
+                        if ((done = load_(addr, &value))) {
+                            write_reg_(dec_instr.rd, static_cast<sreg_t>(value));
+                        }
+                        break;
+                    }
+                    case 0b100: { // LBU
+                        uint8_t value;
+                        if ((done = load_(addr, &value))) {
+                            write_reg_(dec_instr.rd, value);
+                        }
+                        break;
+                    }
+                    case 0b101: { // LHU
+                        uint16_t value;
+                        if ((done = load_(addr, &value))) {
+                            write_reg_(dec_instr.rd, value);
+                        }
+                        break;
+                    }
+                    case 0b110: // LWU, RV64I only
+                        if constexpr (XLEN == RV64) {
+                            uint32_t value;
+                            if ((done = load_(addr, &value))) {
+                                write_reg_(dec_instr.rd, value);
+                            }
+                            break;
+                        }
+                        [[fallthrough]];
+                    case 0b011: // LD, RV64I only
+                        if constexpr (XLEN == RV64) {
+                            uint64_t value;
+                            if ((done = load_(addr, &value))) {
+                                write_reg_(dec_instr.rd, value);
+                            }
+                            break;
+                        }
+                        [[fallthrough]];
+                    default:
+                        SIM_LOG_INFO(
+                            2, cobj_, 0,
+                            "Unsupported LOAD func3: 0x%08x",
+                            static_cast<uint32_t>(dec_instr.func3)
+                        );
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                        return;
+                }
+                if (done) { // otherwise the trap has been already taken
+                    pc_ += INSTR_SIZE;
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                }
                 break;
-            case operation_code_t::STORE:
+            }
+            case operation_code_t::STORE: {
                 // Store instructions (e.g., SB, SH, SW)
-                // Implement store logic here
                 SIM_LOG_INFO(2, cobj_, 0, "Executing STORE instruction");
-                pc_ += INSTR_SIZE;
-                inc_cycles_(1);
-                inc_steps_(1);
+                reg_t addr = rs1_val + static_cast<sreg_t>(dec_instr.imm);
+                bool done = false;
+                switch(dec_instr.func3) {
+                    case 0b000: // SB
+                        done = store_(addr, static_cast<uint8_t>(rs2_val));
+                        break;
+                    case 0b001: // SH
+                        done = store_(addr, static_cast<uint16_t>(rs2_val));
+                        break;
+                    case 0b010: // SW
+                        done = store_(addr, static_cast<uint32_t>(rs2_val));
+                        break;
+                    case 0b011: // SD, RV64I only
+                        if constexpr (XLEN == RV64) {
+                            done = store_(addr, static_cast<uint64_t>(rs2_val));
+                            break;
+                        }
+                        [[fallthrough]];
+                    default:
+                        SIM_LOG_INFO(
+                            2, cobj_, 0,
+                            "Unsupported STORE func3: 0x%08x",
+                            static_cast<uint32_t>(dec_instr.func3)
+                        );
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                        return;
+                }
+                if (done) { // otherwise the trap has been already taken
+                    pc_ += INSTR_SIZE;
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                }
+                break;
+            }
+            case operation_code_t::MISC_MEM:
+                // Memory ordering instructions (FENCE, FENCE.I)
+                SIM_LOG_INFO(2, cobj_, 0, "Executing MISC_MEM instruction");
+                execute_misc_mem_(dec_instr);
+                break;
+            case operation_code_t::SYSTEM:
+                // Environment calls, trap returns and CSR access instructions
+                SIM_LOG_INFO(2, cobj_, 0, "Executing SYSTEM instruction");
+                execute_system_(dec_instr);
                 break;
             case operation_code_t::OP_IMM:
                 SIM_LOG_INFO(2, cobj_, 0, "Executing OP_IMM instruction");
                 // Immediate arithmetic instructions (e.g., ADDI, SLTI, ANDI)
                 switch(dec_instr.func3) {
                     case 0b000: // ADDI
-                        write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) + static_cast<int32_t>(dec_instr.imm));
+                        write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) + static_cast<sreg_t>(dec_instr.imm));
                         break;
                     case 0b010: // SLTI
-                        write_reg_(dec_instr.rd, (static_cast<int32_t>(rs1_val) < static_cast<int32_t>(dec_instr.imm)) ? 1 : 0);
+                        write_reg_(dec_instr.rd, (static_cast<sreg_t>(rs1_val) < static_cast<sreg_t>(dec_instr.imm)) ? 1 : 0);
                         break;
                     case 0b011: // SLTIU
-                        write_reg_(dec_instr.rd, (rs1_val < static_cast<uint32_t>(dec_instr.imm)) ? 1 : 0);
+                        write_reg_(dec_instr.rd, (rs1_val < static_cast<reg_t>(static_cast<sreg_t>(dec_instr.imm))) ? 1 : 0);
                         break;
                     case 0b100: // XORI
-                        write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) ^ static_cast<int32_t>(dec_instr.imm));
+                        write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) ^ static_cast<sreg_t>(dec_instr.imm));
                         break;
                     case 0b110: // ORI
-                        write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) | static_cast<int32_t>(dec_instr.imm));
+                        write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) | static_cast<sreg_t>(dec_instr.imm));
                         break;
                     case 0b111: // ANDI
-                        write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) & static_cast<int32_t>(dec_instr.imm));
+                        write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) & static_cast<sreg_t>(dec_instr.imm));
                         break;
                     case 0b001: // SLLI
-                        if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                        if ((static_cast<uint8_t>(dec_instr.func7) & traits_t::SHIFT_FUNC7_MASK) != 0b0000000) {
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SLLI func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SLLI func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
-                        write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) << (static_cast<int32_t>(dec_instr.imm) & 0b11111));
+                        write_reg_(dec_instr.rd, rs1_val << (static_cast<sreg_t>(dec_instr.imm) & traits_t::SHAMT_MASK));
                         break;
                     case 0b101: // SRLI and SRAI
-                        if (dec_instr.func7 == 0b0000000) {
+                        if ((static_cast<uint8_t>(dec_instr.func7) & traits_t::SHIFT_FUNC7_MASK) == 0b0000000) {
                             // SRLI
-                            write_reg_(dec_instr.rd, static_cast<uint32_t>(rs1_val) >> (static_cast<int32_t>(dec_instr.imm) & 0b11111));
-                        } else if (dec_instr.func7 == 0b0100000) {
+                            write_reg_(dec_instr.rd, rs1_val >> (static_cast<sreg_t>(dec_instr.imm) & traits_t::SHAMT_MASK));
+                        } else if ((static_cast<uint8_t>(dec_instr.func7) & traits_t::SHIFT_FUNC7_MASK) == 0b0100000) {
                             // SRAI
-                            write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) >> (static_cast<int32_t>(dec_instr.imm) & 0b11111));
+                            write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) >> (static_cast<sreg_t>(dec_instr.imm) & traits_t::SHAMT_MASK));
                         } else {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SRLI/SRAI func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SRLI/SRAI func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         break;
                     // Handle other immediate operations here
                     default:
-                        SIM_LOG_ERROR(
-                            cobj_, 0,
+                        SIM_LOG_INFO(
+                            2, cobj_, 0,
                             "Unsupported OP_IMM func3: 0x%08x",
                             static_cast<uint32_t>(dec_instr.func3)
                         );
-                        throw std::runtime_error("Unsupported OP_IMM func3");
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                        return;
                 }
                 pc_ += INSTR_SIZE;
                 inc_cycles_(1);
@@ -215,107 +619,116 @@ namespace kz::riscv::core {
                             // SUB
                             write_reg_(dec_instr.rd, rs1_val - rs2_val);
                         } else {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid ADD/SUB func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid ADD/SUB func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         break;
                     case 0b001: // SLL
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SLL func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SLL func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
-                        write_reg_(dec_instr.rd, rs1_val << (rs2_val & 0b11111));
+                        write_reg_(dec_instr.rd, rs1_val << (rs2_val & traits_t::SHAMT_MASK));
                         break;
                     case 0b010: // SLT
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SLT func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SLT func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
-                        write_reg_(dec_instr.rd, (rs1_val < rs2_val) ? 1 : 0);
+                        write_reg_(dec_instr.rd, (static_cast<sreg_t>(rs1_val) < static_cast<sreg_t>(rs2_val)) ? 1 : 0);
                         break;
                     case 0b011: // SLTU
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SLTU func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SLTU func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         write_reg_(
                             dec_instr.rd,
-                            (static_cast<uint32_t>(rs1_val) < static_cast<uint32_t>(rs2_val)) ? 1 : 0
+                            (rs1_val < rs2_val) ? 1 : 0
                         );
                         break;
                     case 0b100: // XOR
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid XOR func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid XOR func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         write_reg_(dec_instr.rd, (rs1_val ^ rs2_val));
                         break;
                     case 0b101: // SRL and SRA
                         if (dec_instr.func7 == 0b0000000) {
                             // SRL
-                            write_reg_(dec_instr.rd, static_cast<uint32_t>(rs1_val) >> (rs2_val & 0b11111));
+                            write_reg_(dec_instr.rd, rs1_val >> (rs2_val & traits_t::SHAMT_MASK));
                         } else if (dec_instr.func7 == 0b0100000) {
                             // SRA
-                            write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val) >> (rs2_val & 0b11111));
+                            write_reg_(dec_instr.rd, static_cast<sreg_t>(rs1_val) >> (rs2_val & traits_t::SHAMT_MASK));
                         } else {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid SRL/SRA func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid SRL/SRA func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         break;
                     case 0b110: // OR
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid OR func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid OR func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
-                        break;
                         write_reg_(dec_instr.rd, (rs1_val | rs2_val));
+                        break;
                     case 0b111: // AND
                         if (dec_instr.func7 != 0b0000000) {
-                            SIM_LOG_ERROR(
-                                cobj_, 0,
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
                                 "Invalid AND func7: 0x%08x",
                                 static_cast<uint32_t>(dec_instr.func7)
                             );
-                            throw std::runtime_error("Invalid AND func7");
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
                         }
                         write_reg_(dec_instr.rd, (rs1_val & rs2_val));
                         break;
                     // Handle other register-register operations here
                     default:
-                        SIM_LOG_ERROR(
-                            cobj_, 0,
+                        SIM_LOG_INFO(
+                            2, cobj_, 0,
                             "Unsupported OP func3: 0x%08x",
                             static_cast<uint32_t>(dec_instr.func3)
                         );
-                        throw std::runtime_error("Unsupported OP func3");
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                        return;
                     }
                 pc_ += INSTR_SIZE;
                 inc_cycles_(1);
@@ -341,7 +754,8 @@ namespace kz::riscv::core {
                 // Jump and Link
                 SIM_LOG_INFO(2, cobj_, 0, "Executing JAL instruction");
                 write_reg_(dec_instr.rd, pc_ + INSTR_SIZE);
-                pc_ += (int32_t)dec_instr.imm;
+                // the decoder keeps J-type offsets in halfwords
+                pc_ += static_cast<reg_t>(static_cast<sreg_t>(dec_instr.imm)) << 1;
                 inc_cycles_(1);
                 inc_steps_(1);
                 break;
@@ -349,17 +763,19 @@ namespace kz::riscv::core {
                 // Jump and Link Register
                 SIM_LOG_INFO(2, cobj_, 0, "Executing JALR instruction");
                 write_reg_(dec_instr.rd, pc_ + INSTR_SIZE);
-                pc_ = (rs1_val + (int32_t)dec_instr.imm) & 0xFFFFFFFE;
+                pc_ = (rs1_val + (int32_t)dec_instr.imm) & ~static_cast<reg_t>(1);
                 inc_cycles_(1);
                 inc_steps_(1);
                 break;
-            case operation_code_t::BRANCH:
+            case operation_code_t::BRANCH: {
                 // Branch instructions (e.g., BEQ, BNE, BLT, BGE, BLTU, BGEU)
                 SIM_LOG_INFO(2, cobj_, 0, "Executing BRANCH instruction");
+                // the decoder keeps B-type offsets in halfwords
+                reg_t offset = static_cast<reg_t>(static_cast<sreg_t>(dec_instr.imm)) << 1;
                 switch(dec_instr.func3) {
                     case 0b000: // BEQ
                         if (rs1_val == rs2_val) {
-                            pc_ += (int32_t)dec_instr.imm;
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -368,7 +784,7 @@ namespace kz::riscv::core {
                         break;
                     case 0b001: // BNE
                         if (rs1_val != rs2_val) {
-                            pc_ += (int32_t)dec_instr.imm;
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -376,8 +792,8 @@ namespace kz::riscv::core {
                         inc_steps_(1);
                         break;
                     case 0b100: // BLT
-                        if (static_cast<int32_t>(rs1_val) < static_cast<int32_t>(rs2_val)) {
-                            pc_ += (int32_t)dec_instr.imm;
+                        if (static_cast<sreg_t>(rs1_val) < static_cast<sreg_t>(rs2_val)) {
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -385,8 +801,8 @@ namespace kz::riscv::core {
                         inc_steps_(1);
                         break;
                     case 0b101: // BGE
-                        if (static_cast<int32_t>(rs1_val) >= static_cast<int32_t>(rs2_val)) {
-                            pc_ += (int32_t)dec_instr.imm;
+                        if (static_cast<sreg_t>(rs1_val) >= static_cast<sreg_t>(rs2_val)) {
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -394,8 +810,8 @@ namespace kz::riscv::core {
                         inc_steps_(1);
                         break;
                     case 0b110: // BLTU
-                        if (static_cast<uint32_t>(rs1_val) < static_cast<uint32_t>(rs2_val)) {
-                            pc_ += (int32_t)dec_instr.imm;
+                        if (rs1_val < rs2_val) {
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -403,8 +819,8 @@ namespace kz::riscv::core {
                         inc_steps_(1);
                         break;
                     case 0b111: // BGEU
-                        if (static_cast<uint32_t>(rs1_val) >= static_cast<uint32_t>(rs2_val)) {
-                            pc_ += (int32_t)dec_instr.imm;
+                        if (rs1_val >= rs2_val) {
+                            pc_ += offset;
                         } else {
                             pc_ += INSTR_SIZE;
                         }
@@ -412,25 +828,155 @@ namespace kz::riscv::core {
                         inc_steps_(1);
                         break;
                     default:
-                        SIM_LOG_ERROR(
-                            cobj_, 0,
+                        SIM_LOG_INFO(
+                            2, cobj_, 0,
                             "Unsupported BRANCH func3: 0x%08x",
                             static_cast<uint32_t>(dec_instr.func3)
                         );
-                        throw std::runtime_error("Unsupported BRANCH func3");
+                        raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                        return;
                 }
                 break;
+            }
+            case operation_code_t::OP_IMM_32:
+                // RV64I only, 32-bit immediate arithmetic instructions (e.g., ADDIW, SLLIW),
+                // the 32-bit result is sign-extended to XLEN. RV32I falls through to the default.
+                if constexpr (XLEN == RV64) {
+                    SIM_LOG_INFO(2, cobj_, 0, "Executing OP_IMM_32 instruction");
+                    uint32_t rs1_val_32 = static_cast<uint32_t>(rs1_val);
+                    switch(dec_instr.func3) {
+                        case 0b000: // ADDIW
+                            write_reg_(
+                                dec_instr.rd,
+                                static_cast<int32_t>(rs1_val_32 + static_cast<uint32_t>(dec_instr.imm))
+                            );
+                            break;
+                        case 0b001: // SLLIW
+                            if (dec_instr.func7 != 0b0000000) {
+                                SIM_LOG_INFO(
+                                    2, cobj_, 0,
+                                    "Invalid SLLIW func7: 0x%08x",
+                                    static_cast<uint32_t>(dec_instr.func7)
+                                );
+                                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                                return;
+                            }
+                            write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 << (static_cast<int32_t>(dec_instr.imm) & 0b11111)));
+                            break;
+                        case 0b101: // SRLIW and SRAIW
+                            if (dec_instr.func7 == 0b0000000) {
+                                // SRLIW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 >> (static_cast<int32_t>(dec_instr.imm) & 0b11111)));
+                            } else if (dec_instr.func7 == 0b0100000) {
+                                // SRAIW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32) >> (static_cast<int32_t>(dec_instr.imm) & 0b11111));
+                            } else {
+                                SIM_LOG_INFO(
+                                    2, cobj_, 0,
+                                    "Invalid SRLIW/SRAIW func7: 0x%08x",
+                                    static_cast<uint32_t>(dec_instr.func7)
+                                );
+                                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                                return;
+                            }
+                            break;
+                        default:
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
+                                "Unsupported OP_IMM_32 func3: 0x%08x",
+                                static_cast<uint32_t>(dec_instr.func3)
+                            );
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
+                    }
+                    pc_ += INSTR_SIZE;
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                    break;
+                }
+                [[fallthrough]];
+            case operation_code_t::OP_32:
+                // RV64I only, 32-bit register-register arithmetic instructions (e.g., ADDW, SRAW),
+                // the 32-bit result is sign-extended to XLEN. RV32I falls through to the default.
+                if constexpr (XLEN == RV64) {
+                    SIM_LOG_INFO(2, cobj_, 0, "Executing OP_32 instruction");
+                    uint32_t rs1_val_32 = static_cast<uint32_t>(rs1_val);
+                    uint32_t rs2_val_32 = static_cast<uint32_t>(rs2_val);
+                    switch(dec_instr.func3) {
+                        case 0b000: // ADDW and SUBW
+                            if (dec_instr.func7 == 0b0000000) {
+                                // ADDW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 + rs2_val_32));
+                            } else if (dec_instr.func7 == 0b0100000) {
+                                // SUBW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 - rs2_val_32));
+                            } else {
+                                SIM_LOG_INFO(
+                                    2, cobj_, 0,
+                                    "Invalid ADDW/SUBW func7: 0x%08x",
+                                    static_cast<uint32_t>(dec_instr.func7)
+                                );
+                                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                                return;
+                            }
+                            break;
+                        case 0b001: // SLLW
+                            if (dec_instr.func7 != 0b0000000) {
+                                SIM_LOG_INFO(
+                                    2, cobj_, 0,
+                                    "Invalid SLLW func7: 0x%08x",
+                                    static_cast<uint32_t>(dec_instr.func7)
+                                );
+                                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                                return;
+                            }
+                            write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 << (rs2_val_32 & 0b11111)));
+                            break;
+                        case 0b101: // SRLW and SRAW
+                            if (dec_instr.func7 == 0b0000000) {
+                                // SRLW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32 >> (rs2_val_32 & 0b11111)));
+                            } else if (dec_instr.func7 == 0b0100000) {
+                                // SRAW
+                                write_reg_(dec_instr.rd, static_cast<int32_t>(rs1_val_32) >> (rs2_val_32 & 0b11111));
+                            } else {
+                                SIM_LOG_INFO(
+                                    2, cobj_, 0,
+                                    "Invalid SRLW/SRAW func7: 0x%08x",
+                                    static_cast<uint32_t>(dec_instr.func7)
+                                );
+                                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                                return;
+                            }
+                            break;
+                        default:
+                            SIM_LOG_INFO(
+                                2, cobj_, 0,
+                                "Unsupported OP_32 func3: 0x%08x",
+                                static_cast<uint32_t>(dec_instr.func3)
+                            );
+                            raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                            return;
+                    }
+                    pc_ += INSTR_SIZE;
+                    inc_cycles_(1);
+                    inc_steps_(1);
+                    break;
+                }
+                [[fallthrough]];
             default:
-                SIM_LOG_ERROR(
-                    cobj_, 0,
+                SIM_LOG_INFO(
+                    2, cobj_, 0,
                     "Unsupported opcode: 0x%08x",
                     static_cast<uint32_t>(dec_instr.opcode)
                 );
-                throw std::runtime_error("Unsupported opcode");
+                raise_exception_(trap_cause_t::ILLEGAL_INSTR, instr);
+                return;
         }
     }
 
-    void RiscvCpu::handle_events_(event_queue_t *queue) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::handle_events_(event_queue_t *queue) {
         while (!queue->is_empty()
             && queue->get_delta() == 0
             && state_ != execute_state_t::Stopped) {
@@ -441,7 +987,8 @@ namespace kz::riscv::core {
         }
     }
 
-    void RiscvCpu::inc_cycles_(int cycles) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::inc_cycles_(int cycles) {
         if (cycles < 0) {
             throw std::invalid_argument("Cycles to increment must be non-negative");
         }
@@ -451,7 +998,8 @@ namespace kz::riscv::core {
         }
     }
 
-    void RiscvCpu::inc_steps_(int steps) {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::inc_steps_(int steps) {
         if (steps < 0) {
             throw std::invalid_argument("Steps to increment must be non-negative");
         }
@@ -461,7 +1009,8 @@ namespace kz::riscv::core {
         }
     }
 
-    void RiscvCpu::frequency_port::subscribe(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::frequency_port::subscribe(
         conf_object_t *obj,
         const char *listener_port) {
         // It's a placeholder for implementation of frequency change subscription on CPU port
@@ -471,7 +1020,8 @@ namespace kz::riscv::core {
         //RiscvCpu *cpu = parent();
     }
 
-    void RiscvCpu::frequency_port::unsubscribe(
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::frequency_port::unsubscribe(
         conf_object_t *obj,
         const char *listener_port) {
         // It's a placeholder for implementation of frequency change unsubscription on CPU port
@@ -481,14 +1031,47 @@ namespace kz::riscv::core {
         //RiscvCpu *cpu = parent();
     }
 
-    void RiscvCpu::finalize() {
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::finalize() {
     }
 
-    void RiscvCpu::objects_finalized() {
-        mem_handler_ = get_mem_handler_(RESET_ADDR, RAM_SIZE);
+    template<unsigned XLEN>
+    void RiscvCpu<XLEN>::objects_finalized() {
+        // the breakpoints are set on the physical memory space, which doesn't see the direct
+        // memory accesses, they are checked by the CPU
+        breakpoint_hap_ = SIM_hap_add_callback(
+            "Core_Breakpoint_Change", reinterpret_cast<obj_hap_func_t>(breakpoint_change_c), this
+        );
+        update_breakpoints_();
     }
+
+    template class RiscvCpu<RV32>;
+    template class RiscvCpu<RV64>;
 } /* ! kz::riscv::core ! */
 
+// register_cpu_class() registers the CPU class of the given width (XLEN) together with its
+// port classes, the port class name has to be unique across the module
+template<unsigned XLEN>
+static void register_cpu_class(
+    const char *name,
+    const char *freq_port_name,
+    const char *irq_port_name,
+    const char *short_desc,
+    const char *desc) {
+    using cpu_t = kz::riscv::core::RiscvCpu<XLEN>;
+    auto cls = simics::make_class<cpu_t>(name, short_desc, desc);
+    auto cpu_frequency_port = simics::make_class<typename cpu_t::frequency_port>(
+        freq_port_name,
+        "Broadcasts changes in CPU frequency.",
+        "Broadcasts changes in CPU frequency.");
+    cls->add(cpu_frequency_port, "port.cpu_frequency");
+    auto cpu_irq_port = simics::make_class<typename cpu_t::irq_port>(
+        irq_port_name,
+        "Interrupt line of the CPU.",
+        "Interrupt line of the CPU, the index of the port is the bit number of the mip register.");
+    cls->add(cpu_irq_port, "port.irq[" + std::to_string(kz::riscv::core::IRQ_PORTS_NUM) + "]");
+}
+
 // init_local() is called once when the device module is loaded into Simics
 // It is responsible to initialize device, and register the device class in module
 // The function is declared 'extern "C"' to prevent C++ name mangling
@@ -496,8 +1079,10 @@ namespace kz::riscv::core {
 // that may be thrown during device registration
 extern "C"
 void init_local() try {
-    auto cls = simics::make_class<kz::riscv::core::RiscvCpu>(
+    register_cpu_class<kz::riscv::core::RV32>(
         "riscv_cpu",
+        "cpu_frequency",
+        "cpu_irq",
         "RV32I CPU model, single core, 32-bit, in-order, non-pipelined, no hyperthreading.",
         "This is a basic implementation of a RISC-V RV32I CPU model. It supports a subset of "
         "the RISC-V instruction set architecture (ISA) and is intended for educational and "
@@ -509,11 +1094,42 @@ void init_local() try {
         "include all features of a full-fledged RISC-V CPU implementation. For more advanced "
         "features and optimizations, please refer to more comprehensive RISC-V CPU models or "
         "implementations.");
-    auto cpu_frequency_port = simics::make_class<kz::riscv::core::RiscvCpu::frequency_port>(
-        "cpu_frequency",
-        "Broadcasts changes in CPU frequency.",
-        "Broadcasts changes in CPU frequency.");
-    cls->add(cpu_frequency_port, "port.cpu_frequency");
+    register_cpu_class<kz::riscv::core::RV64>(
+        "riscv64_cpu",
+        "cpu64_frequency",
+        "cpu64_irq",
+        "RV64I CPU model, single core, 64-bit, in-order, non-pipelined, no hyperthreading.",
+        "This is the 64-bit variant of the RISC-V CPU model, built from the same sources as the "
+        "RV32I \"riscv_cpu\" class. General purpose registers, the program counter and control and "
+        "status registers are 64-bit wide, the shift amount is extended to 6 bits and the RV64I "
+        "OP-IMM-32 and OP-32 instructions (ADDIW, SLLIW, SRLIW, SRAIW, ADDW, SUBW, SLLW, SRLW, "
+        "SRAW) are supported. All other functionalities and limitations are the same as for the "
+        "RV32I model.");
+    simics::make_class<kz::riscv::devices::RiscvClint>(
+        "riscv_clint",
+        "Core-local interruptor, machine timer and software interrupts.",
+        "CLINT compatible timer and software interrupt device of a single hart. The mtime "
+        "register is derived from the clock cycle counter and a single cycle event is posted "
+        "for the next mtimecmp match, so the device is never polled. MTIP and MSIP are driven "
+        "through the signal interface of the mtip_target and msip_target objects, typically "
+        "cpu.port.irq[7] and cpu.port.irq[3]. Registers: msip (0x0000), mtimecmp (0x4000) and "
+        "mtime (0xBFF8).");
+    simics::make_class<kz::riscv::devices::RiscvUart>(
+        "riscv_uart",
+        "SiFive compatible UART with the host side buffering.",
+        "UART with the SiFive register layout: txdata (0x00), rxdata (0x04), txctrl (0x08), "
+        "rxctrl (0x0C), ie (0x10), ip (0x14) and div (0x18). The transmitted characters are "
+        "buffered on the host side and written to the Simics console (or tx_file) on newline, "
+        "when the buffer is full or when the simulation stops, the transmit FIFO is never full. "
+        "The received characters are read on demand from rx_file (\"-\" for stdin) or injected "
+        "with the rx_input attribute.");
+    simics::make_class<kz::riscv::devices::RiscvPopcount>(
+        "riscv_popcount",
+        "Example custom instruction, population count in the CUSTOM_0 opcode.",
+        "Reference companion device of the riscv_custom_instr interface. It binds \"popc rd, rs1\" "
+        "(CUSTOM_0 opcode, func3 and func7 equal to 0) to the CPU set in the cpu attribute, the "
+        "instruction writes the number of set bits of rs1 to rd and costs latency cycles. The "
+        "executions attribute counts the calls of the host-native handler.");
 } catch(const std::exception& e) {
     std::cerr << e.what() << std::endl;
 }
@@ -0,0 +1,119 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <bitset>
+
+#include <simics/cc-api.h>
+
+#include "riscv-popcount.hpp"
+
+namespace kz::riscv::devices {
+    RiscvPopcount::RiscvPopcount(simics::ConfObjectRef conf_obj) : simics::ConfObject(conf_obj) {
+        cobj_ = obj().object();
+        cpu_ = nullptr;
+        latency_ = 1;
+        executions_ = 0;
+        bound_ = false;
+    }
+
+    RiscvPopcount::~RiscvPopcount() {
+        unbind_();
+    }
+
+    void RiscvPopcount::objects_finalized() {
+        if (cpu_ != nullptr) {
+            bind_();
+        }
+    }
+
+    bool RiscvPopcount::bind_() {
+        unbind_();
+        const riscv_custom_instr_interface_t *iface = SIM_C_GET_INTERFACE(cpu_, riscv_custom_instr);
+        if (iface == nullptr) {
+            SIM_LOG_ERROR(cobj_, 0, "The CPU doesn't implement the riscv_custom_instr interface");
+            return false;
+        }
+        if (iface->bind(cpu_, "popc", OPCODE, FUNC3, FUNC7, latency_, execute_c, this) != 0) {
+            return false;
+        }
+        bound_ = true;
+        return true;
+    }
+
+    void RiscvPopcount::unbind_() {
+        if (!bound_) {
+            return;
+        }
+        SIM_C_GET_INTERFACE(cpu_, riscv_custom_instr)->unbind(cpu_, OPCODE, FUNC3, FUNC7);
+        bound_ = false;
+    }
+
+    uint64 RiscvPopcount::execute_c(lang_void *user_data, conf_object_t *cpu, uint32 instr, uint64 rs1_val, uint64 rs2_val) {
+        auto *popcount = static_cast<RiscvPopcount *>(user_data);
+        ++popcount->executions_;
+        return std::bitset<64>(rs1_val).count();
+    }
+
+    void RiscvPopcount::init_class(simics::ConfClass *cls) {
+        cls->add(
+            simics::Attribute(
+                "cpu", "o|n", "CPU the instruction is bound to.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_object(simics::from_obj<RiscvPopcount>(obj)->cpu_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *popcount = simics::from_obj<RiscvPopcount>(obj);
+                    conf_object_t *cpu = SIM_attr_is_nil(*val) ? nullptr : SIM_attr_object(*val);
+                    if (cpu != nullptr && SIM_C_GET_INTERFACE(cpu, riscv_custom_instr) == nullptr) {
+                        return Sim_Set_Interface_Not_Found;
+                    }
+                    popcount->unbind_();
+                    popcount->cpu_ = cpu;
+                    if (cpu != nullptr && SIM_object_is_configured(obj) && !popcount->bind_()) {
+                        return Sim_Set_Illegal_Value;
+                    }
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "latency", "i", "Cycles charged per execution of the instruction (default 1).",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvPopcount>(obj)->latency_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *popcount = simics::from_obj<RiscvPopcount>(obj);
+                    popcount->latency_ = static_cast<unsigned>(SIM_attr_integer(*val));
+                    // the latency is resolved at predecode time, binding again flushes the cache
+                    if (popcount->bound_ && !popcount->bind_()) {
+                        return Sim_Set_Illegal_Value;
+                    }
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "executions", "i", "Number of the executed instructions.",
+                ATTR_CLS_VAR(RiscvPopcount, executions_)
+            )
+        );
+    }
+} /* ! kz::riscv::devices ! */
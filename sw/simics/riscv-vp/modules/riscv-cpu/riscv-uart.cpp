@@ -0,0 +1,409 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <simics/cc-api.h>
+
+#include "riscv-uart.hpp"
+
+namespace kz::riscv::devices {
+    event_class_t *RiscvUart::rx_poll_event_ = nullptr;
+
+    RiscvUart::RiscvUart(simics::ConfObjectRef conf_obj) : simics::ConfObject(conf_obj) {
+        cobj_ = obj().object();
+        txctrl_ = 0;
+        rxctrl_ = 0;
+        ie_ = 0;
+        div_ = 0;
+        irq_ = false;
+        tx_file_ = nullptr;
+        rx_file_ = nullptr;
+        tx_count_ = 0;
+        rx_count_ = 0;
+        rx_poll_cycles_ = RX_POLL_CYCLES;
+        stopped_hap_ = -1;
+        tx_buffer_.reserve(TX_BUFFER_SIZE);
+    }
+
+    RiscvUart::~RiscvUart() {
+        if (stopped_hap_ >= 0) {
+            SIM_hap_delete_callback_id("Core_Simulation_Stopped", stopped_hap_);
+        }
+        flush_tx_();
+        if (tx_file_ != nullptr) {
+            std::fclose(tx_file_);
+        }
+        if (rx_file_ != nullptr && rx_file_ != stdin) {
+            std::fclose(rx_file_);
+        }
+    }
+
+    void RiscvUart::objects_finalized() {
+        // partial lines are printed when the simulation stops
+        stopped_hap_ = SIM_hap_add_callback(
+            "Core_Simulation_Stopped", reinterpret_cast<obj_hap_func_t>(simulation_stopped_c), this
+        );
+        // the event is not checkpointed, post it again for the restored state
+        post_rx_poll_();
+        update_irq_();
+    }
+
+    void RiscvUart::simulation_stopped_c(lang_void *data, conf_object_t *obj, int64 exception, char *error) {
+        static_cast<RiscvUart *>(data)->flush_tx_();
+    }
+
+    void RiscvUart::transmit_(uint8_t c) {
+        tx_buffer_.push_back(static_cast<char>(c));
+        ++tx_count_;
+        if (c == '\n' || tx_buffer_.size() >= TX_BUFFER_SIZE) {
+            flush_tx_();
+        }
+    }
+
+    void RiscvUart::flush_tx_() {
+        if (tx_buffer_.empty()) {
+            return;
+        }
+        if (tx_file_ != nullptr) {
+            std::fwrite(tx_buffer_.data(), 1, tx_buffer_.size(), tx_file_);
+            std::fflush(tx_file_);
+        } else {
+            SIM_write(tx_buffer_.data(), static_cast<int>(tx_buffer_.size()));
+        }
+        tx_buffer_.clear();
+    }
+
+    void RiscvUart::fill_rx_() {
+        if (rx_file_ == nullptr) {
+            return;
+        }
+        while (rx_fifo_.size() < RX_FIFO_SIZE) {
+            int c;
+            if (rx_file_ == stdin) {
+#ifndef _WIN32
+                // the simulation must not block on the user input
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                uint8_t byte;
+                if (poll(&pfd, 1, 0) <= 0 || read(STDIN_FILENO, &byte, 1) != 1) {
+                    return;
+                }
+                c = byte;
+#else
+                return;
+#endif
+            } else {
+                c = std::fgetc(rx_file_);
+                if (c == EOF) {
+                    return;
+                }
+            }
+            rx_fifo_.push_back(static_cast<uint8_t>(c));
+        }
+    }
+
+    void RiscvUart::post_rx_poll_() {
+        conf_object_t *clock = SIM_object_clock(cobj_);
+        if (clock == nullptr || !SIM_object_is_configured(cobj_)) {
+            // objects_finalized() will do it
+            return;
+        }
+        SIM_event_cancel_time(clock, rx_poll_event_, cobj_, nullptr, nullptr);
+        if (rx_file_ != nullptr && rx_poll_cycles_ != 0) {
+            SIM_event_post_cycle(clock, rx_poll_event_, cobj_, static_cast<cycles_t>(rx_poll_cycles_), nullptr);
+        }
+    }
+
+    void RiscvUart::rx_poll_event_c(conf_object_t *obj, lang_void *data) {
+        RiscvUart *uart = simics::from_obj<RiscvUart>(obj);
+        // the guest waiting for the RX watermark interrupt never reads rxdata on its own
+        uart->fill_rx_();
+        uart->update_irq_();
+        uart->post_rx_poll_();
+    }
+
+    uint32_t RiscvUart::get_ip_() const {
+        uint32_t ip = 0;
+        // the transmit FIFO is always empty, so it's below any non-zero watermark
+        if (((txctrl_ & CTRL_CNT_MASK) >> CTRL_CNT_SHIFT) > 0) {
+            ip |= TXWM;
+        }
+        if (rx_fifo_.size() > ((rxctrl_ & CTRL_CNT_MASK) >> CTRL_CNT_SHIFT)) {
+            ip |= RXWM;
+        }
+        return ip;
+    }
+
+    void RiscvUart::update_irq_() {
+        bool level = (ie_ & get_ip_()) != 0;
+        if (level == irq_) {
+            return;
+        }
+        irq_ = level;
+        if (irq_target_.obj()) {
+            if (irq_) {
+                irq_target_.iface().signal_raise();
+            } else {
+                irq_target_.iface().signal_lower();
+            }
+        }
+    }
+
+    bool RiscvUart::open_tx_file_(const std::string &name) {
+        flush_tx_();
+        if (tx_file_ != nullptr) {
+            std::fclose(tx_file_);
+            tx_file_ = nullptr;
+        }
+        tx_file_name_ = name;
+        if (name.empty()) {
+            return true;
+        }
+        tx_file_ = std::fopen(name.c_str(), "ab");
+        if (tx_file_ == nullptr) {
+            SIM_LOG_ERROR(cobj_, 0, "Can't open the output file: %s", name.c_str());
+            tx_file_name_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool RiscvUart::open_rx_file_(const std::string &name) {
+        if (rx_file_ != nullptr && rx_file_ != stdin) {
+            std::fclose(rx_file_);
+        }
+        rx_file_ = nullptr;
+        rx_file_name_ = name;
+        if (name.empty()) {
+            post_rx_poll_();
+            return true;
+        }
+        if (name == "-") {
+#ifdef _WIN32
+            SIM_LOG_UNIMPLEMENTED(1, cobj_, 0, "Reading from stdin is not supported on Windows");
+#endif
+            rx_file_ = stdin;
+            post_rx_poll_();
+            return true;
+        }
+        rx_file_ = std::fopen(name.c_str(), "rb");
+        if (rx_file_ == nullptr) {
+            SIM_LOG_ERROR(cobj_, 0, "Can't open the input file: %s", name.c_str());
+            rx_file_name_.clear();
+            post_rx_poll_();
+            return false;
+        }
+        post_rx_poll_();
+        return true;
+    }
+
+    exception_type_t RiscvUart::issue(transaction_t *t, uint64 addr) {
+        if (SIM_transaction_size(t) != 4 || (addr & 3) != 0) {
+            SIM_LOG_SPEC_VIOLATION(
+                1, cobj_, 0,
+                "Unsupported access: offset='0x%llx', size='%u'",
+                static_cast<unsigned long long>(addr), SIM_transaction_size(t)
+            );
+            return Sim_PE_IO_Not_Taken;
+        }
+        if (SIM_transaction_is_write(t)) {
+            uint32_t value = static_cast<uint32_t>(SIM_get_transaction_value_le(t));
+            switch (addr) {
+                case TXDATA_OFFSET:
+                    if (txctrl_ & CTRL_EN) {
+                        transmit_(static_cast<uint8_t>(value));
+                    }
+                    return Sim_PE_No_Exception;
+                case RXDATA_OFFSET:
+                    // read-only
+                    return Sim_PE_No_Exception;
+                case TXCTRL_OFFSET:
+                    txctrl_ = value & (CTRL_EN | CTRL_CNT_MASK);
+                    break;
+                case RXCTRL_OFFSET:
+                    rxctrl_ = value & (CTRL_EN | CTRL_CNT_MASK);
+                    break;
+                case IE_OFFSET:
+                    ie_ = value & (TXWM | RXWM);
+                    break;
+                case IP_OFFSET:
+                    // read-only
+                    return Sim_PE_No_Exception;
+                case DIV_OFFSET:
+                    div_ = value & 0xFFFF;
+                    return Sim_PE_No_Exception;
+                default:
+                    SIM_LOG_SPEC_VIOLATION(1, cobj_, 0, "Write to unmapped register: offset='0x%llx'", addr);
+                    return Sim_PE_IO_Not_Taken;
+            }
+            update_irq_();
+            return Sim_PE_No_Exception;
+        }
+        uint32_t value;
+        switch (addr) {
+            case TXDATA_OFFSET:
+                // the transmit FIFO is never full
+                value = 0;
+                break;
+            case RXDATA_OFFSET:
+                if (rx_fifo_.empty() && !SIM_transaction_is_inquiry(t)) {
+                    fill_rx_();
+                }
+                if (rx_fifo_.empty() || !(rxctrl_ & CTRL_EN)) {
+                    value = FIFO_FLAG;
+                } else if (SIM_transaction_is_inquiry(t)) {
+                    value = rx_fifo_.front();
+                } else {
+                    value = rx_fifo_.front();
+                    rx_fifo_.pop_front();
+                    ++rx_count_;
+                    update_irq_();
+                }
+                break;
+            case TXCTRL_OFFSET: value = txctrl_; break;
+            case RXCTRL_OFFSET: value = rxctrl_; break;
+            case IE_OFFSET: value = ie_; break;
+            case IP_OFFSET: value = get_ip_(); break;
+            case DIV_OFFSET: value = div_; break;
+            default:
+                SIM_LOG_SPEC_VIOLATION(1, cobj_, 0, "Read from unmapped register: offset='0x%llx'", addr);
+                return Sim_PE_IO_Not_Taken;
+        }
+        SIM_set_transaction_value_le(t, value);
+        return Sim_PE_No_Exception;
+    }
+
+    void RiscvUart::init_class(simics::ConfClass *cls) {
+        cls->add(simics::iface::TransactionInterface::Info());
+        // the event is reposted while the input file is open, so it's not saved in checkpoints
+        rx_poll_event_ = SIM_register_event(
+            "rx_poll", *cls, Sim_EC_Notsaved, rx_poll_event_c, nullptr, nullptr, nullptr, nullptr
+        );
+        cls->add(
+            simics::Attribute(
+                "txctrl", "i", "Transmit control register.",
+                ATTR_CLS_VAR(RiscvUart, txctrl_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "rxctrl", "i", "Receive control register.",
+                ATTR_CLS_VAR(RiscvUart, rxctrl_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "ie", "i", "Interrupt enable register.",
+                ATTR_CLS_VAR(RiscvUart, ie_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "div", "i", "Baud rate divisor register (no timing effect).",
+                ATTR_CLS_VAR(RiscvUart, div_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "tx_count", "i", "Number of transmitted characters.",
+                ATTR_CLS_VAR(RiscvUart, tx_count_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "rx_count", "i", "Number of received characters.",
+                ATTR_CLS_VAR(RiscvUart, rx_count_)
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "tx_file", "s|n",
+                "Output file the transmitted characters are appended to, the Simics console if"
+                " not set.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    return uart->tx_file_name_.empty()
+                        ? SIM_make_attr_nil() : SIM_make_attr_string(uart->tx_file_name_.c_str());
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    std::string name = SIM_attr_is_nil(*val) ? "" : SIM_attr_string(*val);
+                    return uart->open_tx_file_(name) ? Sim_Set_Ok : Sim_Set_Illegal_Value;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "rx_file", "s|n", "Input file the received characters are read from, \"-\" for stdin.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    return uart->rx_file_name_.empty()
+                        ? SIM_make_attr_nil() : SIM_make_attr_string(uart->rx_file_name_.c_str());
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    std::string name = SIM_attr_is_nil(*val) ? "" : SIM_attr_string(*val);
+                    return uart->open_rx_file_(name) ? Sim_Set_Ok : Sim_Set_Illegal_Value;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "rx_poll_interval", "i",
+                "Number of cycles between polls of the input file (or stdin), 0 disables polling"
+                " and the input is read on rxdata reads only.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    return SIM_make_attr_uint64(simics::from_obj<RiscvUart>(obj)->rx_poll_cycles_);
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    uart->rx_poll_cycles_ = SIM_attr_integer(*val);
+                    uart->post_rx_poll_();
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "rx_input", "s", "Characters to be received, appended to the receive FIFO.",
+                [](conf_object_t *obj) -> attr_value_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    return SIM_make_attr_string(std::string(uart->rx_fifo_.begin(), uart->rx_fifo_.end()).c_str());
+                },
+                [](conf_object_t *obj, attr_value_t *val) -> set_error_t {
+                    auto *uart = simics::from_obj<RiscvUart>(obj);
+                    for (const char *c = SIM_attr_string(*val); *c != '\0'; ++c) {
+                        uart->rx_fifo_.push_back(static_cast<uint8_t>(*c));
+                    }
+                    uart->update_irq_();
+                    return Sim_Set_Ok;
+                }
+            )
+        );
+        cls->add(
+            simics::Attribute(
+                "irq_target", "o|n", "Target of the interrupt line (e.g. cpu.port.irq[11]).",
+                ATTR_CLS_VAR(RiscvUart, irq_target_)
+            )
+        );
+    }
+} /* ! kz::riscv::devices ! */
@@ -0,0 +1,99 @@
+# Copyright © 2025 Karol Zmijewski
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this
+# software and associated documentation files (the “Software”), to deal in the Software
+# without restriction, including without limitation the rights to use, copy, modify, merge,
+# publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+# to whom the Software is furnished to do so, subject to the following conditions:
+# The above copyright notice and this permission notice shall be included in all copies or
+# substantial portions of the Software.
+# THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+#
+# INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+# PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+# FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+# ELF32/ELF64 reader shared by the module commands (module_load.py), the tools
+# (sw/simics/riscv-vp/tools) and the benchmark driver (tests/bench), it depends on the
+# standard library only so the tools run without Simics
+
+import struct
+
+SHT_SYMTAB = 2
+SHF_EXECINSTR = 0x4
+PT_LOAD = 1
+PF_X = 0x1
+STT_FUNC = 2
+SHN_UNDEF = 0
+
+class ElfError(ValueError):
+    pass
+
+class Elf:
+    """
+    Sections, executable segments and symbols of an ELF file of either width and byte order.
+    """
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ElfError(f"{path}: not an ELF file")
+        self.path = path
+        self.is64 = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+        if self.is64:
+            (phoff, shoff) = struct.unpack_from(endian + "QQ", data, 0x20)
+            (phentsize, phnum, shentsize, shnum) = struct.unpack_from(endian + "HHHH", data, 0x36)
+        else:
+            (phoff, shoff) = struct.unpack_from(endian + "II", data, 0x1c)
+            (phentsize, phnum, shentsize, shnum) = struct.unpack_from(endian + "HHHH", data, 0x2a)
+        # (type, flags, address, file offset, size, link, entry size)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size, link, _, _, entsize) = struct.unpack_from(
+                endian + ("IIQQQQIIQQ" if self.is64 else "IIIIIIIIII"), data, shoff + i * shentsize)
+            self.sections.append((sh_type, flags, addr, offset, size, link, entsize))
+        # (type, flags, virtual address, memory size)
+        self.segments = []
+        for i in range(phnum):
+            if self.is64:
+                (p_type, flags, _, vaddr, _, _, memsz, _) = struct.unpack_from(
+                    endian + "IIQQQQQQ", data, phoff + i * phentsize)
+            else:
+                (p_type, _, vaddr, _, _, memsz, flags, _) = struct.unpack_from(
+                    endian + "IIIIIIII", data, phoff + i * phentsize)
+            self.segments.append((p_type, flags, vaddr, memsz))
+        # (name, value, size, type, section index)
+        self.symbols = []
+        for (sh_type, _, _, offset, size, link, entsize) in self.sections:
+            if sh_type != SHT_SYMTAB or not entsize:
+                continue
+            strtab = self.sections[link][3]
+            for pos in range(offset, offset + size, entsize):
+                if self.is64:
+                    (name, info, _, shndx, value, sym_size) = struct.unpack_from(endian + "IBBHQQ", data, pos)
+                else:
+                    (name, value, sym_size, info, _, shndx) = struct.unpack_from(endian + "IIIBBH", data, pos)
+                end = data.index(b"\0", strtab + name)
+                self.symbols.append((data[strtab + name:end].decode(), value, sym_size, info & 0xf, shndx))
+
+    def functions(self, offset = 0):
+        """Return the defined function symbols as a sorted list of (address, size, name)."""
+        return sorted((value + offset, size, name) for (name, value, size, sym_type, shndx) in self.symbols
+                      if sym_type == STT_FUNC and shndx != SHN_UNDEF)
+
+    def addresses(self, names):
+        """Return {name: address} of the named symbols found in the file."""
+        return {name: value for (name, value, _, _, _) in self.symbols if name in names}
+
+    def code_segments(self, offset = 0):
+        """Return the [(start, end)] ranges of the executable loadable segments."""
+        return [(vaddr + offset, vaddr + offset + memsz) for (p_type, flags, vaddr, memsz) in self.segments
+                if p_type == PT_LOAD and flags & PF_X]
+
+    def code_sections(self):
+        """Return the [(start, end)] ranges of the non-empty executable sections."""
+        return [(addr, addr + size) for (_, flags, addr, _, size, _, _) in self.sections
+                if flags & SHF_EXECINSTR and size]
@@ -15,6 +15,8 @@
 # OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 # DEALINGS IN THE SOFTWARE.
 
+import importlib.util
+import os
 import simics
 
 def create_riscv_cpu(name = None):
@@ -24,3 +26,174 @@ def create_riscv_cpu(name = None):
     riscv_cpu = simics.pre_conf_object(name, "riscv_cpu")
     simics.SIM_add_configuration([riscv_cpu], None)
     return simics.SIM_get_object(riscv_cpu.name)
+
+def create_riscv64_cpu(name = None):
+    """
+    Create a new riscv64_cpu object
+    """
+    riscv64_cpu = simics.pre_conf_object(name, "riscv64_cpu")
+    simics.SIM_add_configuration([riscv64_cpu], None)
+    return simics.SIM_get_object(riscv64_cpu.name)
+
+def create_riscv_clint(name = None, cpu = None):
+    """
+    Create a new riscv_clint object, driving the timer and software interrupts of the cpu
+    """
+    riscv_clint = simics.pre_conf_object(name, "riscv_clint")
+    if cpu:
+        riscv_clint.queue = cpu
+        riscv_clint.mtip_target = cpu.port.irq[7]
+        riscv_clint.msip_target = cpu.port.irq[3]
+    simics.SIM_add_configuration([riscv_clint], None)
+    return simics.SIM_get_object(riscv_clint.name)
+
+def create_riscv_uart(name = None, cpu = None):
+    """
+    Create a new riscv_uart object, connected to the external interrupt line of the cpu
+    """
+    riscv_uart = simics.pre_conf_object(name, "riscv_uart")
+    if cpu:
+        riscv_uart.queue = cpu
+        riscv_uart.irq_target = cpu.port.irq[11]
+    simics.SIM_add_configuration([riscv_uart], None)
+    return simics.SIM_get_object(riscv_uart.name)
+
+def create_riscv_popcount(name = None, cpu = None, latency = 1):
+    """
+    Create a new riscv_popcount object, binding the popc custom instruction to the cpu
+    """
+    riscv_popcount = simics.pre_conf_object(name, "riscv_popcount", latency = latency)
+    if cpu:
+        riscv_popcount.cpu = cpu
+    simics.SIM_add_configuration([riscv_popcount], None)
+    return simics.SIM_get_object(riscv_popcount.name)
+
+# tools directory of the riscv-vp project
+TOOLS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "..", "tools")
+
+def load_tool(name):
+    """
+    Import the script of the riscv-vp tools directory (e.g. "riscv-trace") as a module
+    """
+    path = os.path.join(TOOLS_DIR, name + ".py")
+    spec = importlib.util.spec_from_file_location(name.replace("-", "_"), path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+RAM_BASE = 0x10000000
+
+def create_machine(name, cpu_class = "riscv_cpu", ram_size = 0x10000):
+    """
+    Create a cpu of the given class with ram_size bytes of RAM mapped at RAM_BASE (the reset
+    address), the cpu is the clock of its own cell. Devices can be added to cpu.phys_mem.map.
+    """
+    cell = simics.pre_conf_object(name + "_cell", "cell")
+    image = simics.pre_conf_object(name + "_image", "image", size = ram_size)
+    ram = simics.pre_conf_object(name + "_ram", "ram", image = image)
+    mem = simics.pre_conf_object(name + "_mem", "memory-space")
+    cpu = simics.pre_conf_object(name, cpu_class, phys_mem = mem, cell = cell)
+    cpu.queue = cpu
+    mem.map = [[RAM_BASE, ram, 0, 0, ram_size]]
+    simics.SIM_add_configuration([cell, image, ram, mem, cpu], None)
+    return simics.SIM_get_object(name)
+
+def load(cpu, address, words):
+    """
+    Write the instruction (or data) words to the physical memory of the cpu
+    """
+    data = b"".join((w & 0xFFFFFFFF).to_bytes(4, "little") for w in words)
+    cpu.phys_mem.iface.memory_space.write(None, address, tuple(data), True)
+
+def read_mem(cpu, address, size):
+    """
+    Read size bytes of the physical memory of the cpu
+    """
+    return bytes(cpu.phys_mem.iface.memory_space.read(None, address, size, True))
+
+def read_reg(cpu, name):
+    """
+    Read the register given by its number (general purpose) or name (pc, priv, CSRs)
+    """
+    regs = cpu.iface.int_register
+    return regs.read(regs.get_number(f"x{name}" if isinstance(name, int) else name))
+
+def write_reg(cpu, name, value):
+    """
+    Write the register given by its number (general purpose) or name (pc, priv, CSRs)
+    """
+    regs = cpu.iface.int_register
+    regs.write(regs.get_number(f"x{name}" if isinstance(name, int) else name), value)
+
+def run(cpu, steps):
+    """
+    Run the cpu for the given number of steps, unless the simulation is stopped earlier
+    """
+    simics.SIM_run_command("pselect " + cpu.name)
+    simics.SIM_continue(steps)
+
+# A minimal RV32I/RV64I assembler for the test programs, every function returns the
+# instruction word, li returns a list of them. Registers are given by their numbers.
+ZERO, RA, SP, GP, TP, T0, T1, T2, S0, S1 = range(10)
+A0, A1, A2, A3, A4, A5, A6, A7 = range(10, 18)
+S2, S3, S4, S5, S6, S7, S8, S9, S10, S11 = range(18, 28)
+T3, T4, T5, T6 = range(28, 32)
+
+CSR_MSTATUS = 0x300
+CSR_MIE = 0x304
+CSR_MTVEC = 0x305
+CSR_MSCRATCH = 0x340
+CSR_MEPC = 0x341
+CSR_MCAUSE = 0x342
+CSR_MTVAL = 0x343
+CSR_PMPCFG0 = 0x3A0
+CSR_PMPADDR0 = 0x3B0
+CSR_MCYCLE = 0xB00
+CSR_CYCLE = 0xC00
+CSR_INSTRET = 0xC02
+
+def r_type(opcode, rd, func3, rs1, rs2, func7):
+    return (func7 << 25) | (rs2 << 20) | (rs1 << 15) | (func3 << 12) | (rd << 7) | opcode
+
+def i_type(opcode, rd, func3, rs1, imm):
+    return ((imm & 0xFFF) << 20) | (rs1 << 15) | (func3 << 12) | (rd << 7) | opcode
+
+def s_type(opcode, func3, rs1, rs2, imm):
+    return (((imm >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (func3 << 12) | ((imm & 0x1F) << 7) | opcode
+
+def b_type(func3, rs1, rs2, offset):
+    return ((((offset >> 12) & 1) << 31) | (((offset >> 5) & 0x3F) << 25) | (rs2 << 20) | (rs1 << 15)
+            | (func3 << 12) | (((offset >> 1) & 0xF) << 8) | (((offset >> 11) & 1) << 7) | 0x63)
+
+def addi(rd, rs1, imm): return i_type(0x13, rd, 0, rs1, imm)
+def slli(rd, rs1, shamt): return i_type(0x13, rd, 1, rs1, shamt)
+def srai(rd, rs1, shamt): return i_type(0x13, rd, 5, rs1, 0x400 | shamt)
+def add(rd, rs1, rs2): return r_type(0x33, rd, 0, rs1, rs2, 0)
+def sub(rd, rs1, rs2): return r_type(0x33, rd, 0, rs1, rs2, 0x20)
+def lui(rd, imm): return ((imm & 0xFFFFF) << 12) | (rd << 7) | 0x37
+def lb(rd, rs1, imm): return i_type(0x03, rd, 0, rs1, imm)
+def lw(rd, rs1, imm): return i_type(0x03, rd, 2, rs1, imm)
+def sb(rs2, rs1, imm): return s_type(0x23, 0, rs1, rs2, imm)
+def sw(rs2, rs1, imm): return s_type(0x23, 2, rs1, rs2, imm)
+def beq(rs1, rs2, offset): return b_type(0, rs1, rs2, offset)
+def bne(rs1, rs2, offset): return b_type(1, rs1, rs2, offset)
+def blt(rs1, rs2, offset): return b_type(4, rs1, rs2, offset)
+def jalr(rd, rs1, imm): return i_type(0x67, rd, 0, rs1, imm)
+def jal(rd, offset):
+    return ((((offset >> 20) & 1) << 31) | (((offset >> 1) & 0x3FF) << 21) | (((offset >> 11) & 1) << 20)
+            | (((offset >> 12) & 0xFF) << 12) | (rd << 7) | 0x6F)
+def csrrw(rd, csr, rs1): return i_type(0x73, rd, 1, rs1, csr)
+def csrrs(rd, csr, rs1): return i_type(0x73, rd, 2, rs1, csr)
+def csrr(rd, csr): return csrrs(rd, csr, ZERO)
+def csrw(csr, rs1): return csrrw(ZERO, csr, rs1)
+def ecall(): return 0x00000073
+def ebreak(): return 0x00100073
+def mret(): return 0x30200073
+def custom_0(rd, rs1, rs2, func3 = 0, func7 = 0): return r_type(0x0B, rd, func3, rs1, rs2, func7)
+
+def li(rd, value):
+    """
+    Load a 32-bit (sign extended) constant, lui + addi
+    """
+    lo = ((value & 0xFFF) ^ 0x800) - 0x800
+    return [lui(rd, ((value - lo) >> 12) & 0xFFFFF), addi(rd, rd, lo)]
@@ -22,8 +22,12 @@ import riscv_cpu_common
 
 info_status.check_for_info_status(["riscv-cpu"])
 dev = riscv_cpu_common.create_riscv_cpu()
+dev64 = riscv_cpu_common.create_riscv64_cpu()
+clint = riscv_cpu_common.create_riscv_clint(cpu = dev)
+uart = riscv_cpu_common.create_riscv_uart(cpu = dev)
+popc = riscv_cpu_common.create_riscv_popcount(cpu = dev)
 
-for obj in [dev]:
+for obj in [dev, dev64, clint, uart, popc]:
     for cmd in ["info", "status"]:
         try:
             simics.SIM_run_command(obj.name + "." + cmd)
@@ -0,0 +1,93 @@
+# Copyright © 2025 Karol Zmijewski
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this
+# software and associated documentation files (the “Software”), to deal in the Software
+# without restriction, including without limitation the rights to use, copy, modify, merge,
+# publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+# to whom the Software is furnished to do so, subject to the following conditions:
+# The above copyright notice and this permission notice shall be included in all copies or
+# substantial portions of the Software.
+# THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+#
+# INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+# PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+# FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+import os
+import tempfile
+import simics
+import stest
+import riscv_cpu_common
+
+asm = riscv_cpu_common
+
+# the SimPoint driver (tools/simics-simpoint.py) writes a checkpoint at the start of every
+# interval and measures it in another Simics, the restored CPU has to resume the same
+# execution: the registers, the CSRs (mtvec of the trap below) and the locked PMP entry
+simics_simpoint = riscv_cpu_common.load_tool("simics-simpoint")
+handler = asm.RAM_BASE + 0x100
+setup = [
+    *asm.li(asm.T0, handler),
+    asm.csrw(asm.CSR_MTVEC, asm.T0),
+    *asm.li(asm.T1, 0x5a5a),
+    asm.csrw(asm.CSR_MSCRATCH, asm.T1),
+    *asm.li(asm.T0, 0x20000000 >> 2),               # TOR, [0, 0x20000000)
+    asm.csrw(asm.CSR_PMPADDR0, asm.T0),
+    asm.addi(asm.T0, asm.ZERO, 0x8f),               # L | TOR | RWX
+    asm.csrw(asm.CSR_PMPCFG0, asm.T0),
+    asm.addi(asm.T1, asm.ZERO, 20),
+]
+loop = [
+    asm.addi(asm.A0, asm.A0, 1),
+    asm.addi(asm.T1, asm.T1, -1),
+    asm.bne(asm.T1, asm.ZERO, -8),
+    asm.ecall(),
+    asm.jal(asm.ZERO, 0),
+]
+ecall = asm.RAM_BASE + 4 * (len(setup) + 3)
+timing = {"cost_preset": "fde_ip", "icache": None, "dcache": [4096, 2, 64, "lru", True], "branch_predictor": None}
+job = {"warmup": 3, "interval": 12, "timing": timing}
+
+def create_machine():
+    cpu = riscv_cpu_common.create_machine("ckpt_cpu")
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, setup + loop)
+    riscv_cpu_common.load(cpu, handler, [asm.csrr(asm.S1, asm.CSR_MCAUSE), asm.jal(asm.ZERO, 0)])
+    return cpu
+
+def state(cpu):
+    return (cpu.gprs, cpu.csrs, cpu.pmp, cpu.pc, cpu.priv, cpu.steps, cpu.cycles)
+
+def resume(cpu):
+    """Measure the interval with the timing models of the study, then run to the trap."""
+    result = simics_simpoint.measure(cpu, job)
+    stest.expect_equal(cpu.mode, "functional")
+    riscv_cpu_common.run(cpu, 60)
+    return (result, cpu.steps, riscv_cpu_common.read_reg(cpu, asm.A0), riscv_cpu_common.read_reg(cpu, asm.S1),
+            riscv_cpu_common.read_reg(cpu, "mepc"), cpu.pc)
+
+cpu = create_machine()
+simics.SIM_run_command("pselect " + cpu.name)
+path = os.path.join(tempfile.mkdtemp(), "interval.ckpt")
+checkpoint_step = len(setup) + 4 * 3                  # 4 iterations of the loop
+result = simics_simpoint.snapshot(cpu, {"checkpoints": [[checkpoint_step, path]]})
+stest.expect_equal(result, {"checkpoints": [path]})
+saved = state(cpu)
+stest.expect_equal(cpu.steps, checkpoint_step)
+stest.expect_equal(cpu.gprs[asm.A0], 4)
+stest.expect_equal(cpu.gprs[asm.T1], 16)
+stest.expect_equal(dict(cpu.csrs)[asm.CSR_MTVEC], handler)
+stest.expect_equal(dict(cpu.csrs)[asm.CSR_MSCRATCH], 0x5a5a)
+stest.expect_equal(cpu.pmp[0], [0x8f, 0x20000000 >> 2])
+reference = resume(cpu)
+stest.expect_equal(reference, ({"instructions": 12, "cycles": 12 * 6}, checkpoint_step + 3 + 12 + 60,
+                               20, 11, ecall, handler + 4))
+
+# the interval starts again from the checkpoint
+simics.SIM_delete_objects([cpu, cpu.phys_mem, cpu.phys_mem.map[0][1], cpu.phys_mem.map[0][1].image, cpu.cell])
+simics.SIM_read_configuration(path)
+cpu = simics.SIM_get_object("ckpt_cpu")
+stest.expect_equal(state(cpu), saved)
+simics.SIM_run_command("pselect " + cpu.name)
+stest.expect_equal(resume(cpu), reference)
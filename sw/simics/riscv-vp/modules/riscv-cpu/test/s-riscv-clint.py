@@ -0,0 +1,120 @@
+# Copyright © 2025 Karol Zmijewski
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this
+# software and associated documentation files (the “Software”), to deal in the Software
+# without restriction, including without limitation the rights to use, copy, modify, merge,
+# publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+# to whom the Software is furnished to do so, subject to the following conditions:
+# The above copyright notice and this permission notice shall be included in all copies or
+# substantial portions of the Software.
+# THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+#
+# INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+# PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+# FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+import simics
+import stest
+import riscv_cpu_common
+
+MIP_MSIP = 1 << 3
+MIP_MTIP = 1 << 7
+
+cpu = riscv_cpu_common.create_riscv_cpu()
+clint = riscv_cpu_common.create_riscv_clint(cpu = cpu)
+mip = cpu.iface.int_register.get_number("mip")
+
+def read_mip():
+    return cpu.iface.int_register.read(mip)
+
+def access(offset, size, value = None):
+    if value is None:
+        t = simics.transaction_t(read = True, size = size)
+    else:
+        t = simics.transaction_t(write = True, size = size, value_le = value)
+    stest.expect_equal(clint.iface.transaction.issue(t, offset), simics.Sim_PE_No_Exception)
+    return t.value_le
+
+# no timer interrupt after reset
+stest.expect_equal(clint.mtimecmp, 0xFFFFFFFFFFFFFFFF)
+stest.expect_equal(read_mip() & MIP_MTIP, 0)
+
+# mtimecmp <= mtime raises MTIP immediately, a future match lowers it
+clint.mtimecmp = 0
+stest.expect_equal(read_mip() & MIP_MTIP, MIP_MTIP)
+clint.mtimecmp = clint.mtime + 100
+stest.expect_equal(read_mip() & MIP_MTIP, 0)
+
+# 32-bit halves of mtimecmp
+access(0x4000, 4, 0x89abcdef)
+access(0x4004, 4, 0x01234567)
+stest.expect_equal(clint.mtimecmp, 0x0123456789abcdef)
+stest.expect_equal(access(0x4000, 8), 0x0123456789abcdef)
+
+# mtime is derived from the clock, the time does not advance here
+access(0xBFF8, 8, 0x1000)
+stest.expect_equal(access(0xBFF8, 8), 0x1000)
+stest.expect_equal(clint.mtime, 0x1000)
+
+# msip drives MSIP
+access(0x0, 4, 1)
+stest.expect_equal(read_mip() & MIP_MSIP, MIP_MSIP)
+access(0x0, 4, 0)
+stest.expect_equal(read_mip() & MIP_MSIP, 0)
+
+# the cycle events are handled in the order they are due, not in the order they were posted,
+# the later posted timer due earlier raises its line (MSIP here) first
+ev_cpu = riscv_cpu_common.create_machine("ev_cpu")
+riscv_cpu_common.load(ev_cpu, riscv_cpu_common.RAM_BASE, [riscv_cpu_common.jal(riscv_cpu_common.ZERO, 0)])
+late = riscv_cpu_common.create_riscv_clint("late_clint", cpu = ev_cpu)
+early = riscv_cpu_common.create_riscv_clint("early_clint", cpu = ev_cpu)
+early.msip_target = None
+early.mtip_target = ev_cpu.port.irq[3]
+late.mtimecmp = 1000
+early.mtimecmp = 100
+riscv_cpu_common.run(ev_cpu, 90)
+stest.expect_equal(riscv_cpu_common.read_reg(ev_cpu, "mip") & (MIP_MSIP | MIP_MTIP), 0)
+riscv_cpu_common.run(ev_cpu, 20)
+stest.expect_equal(riscv_cpu_common.read_reg(ev_cpu, "mip") & (MIP_MSIP | MIP_MTIP), MIP_MSIP)
+riscv_cpu_common.run(ev_cpu, 1000)
+stest.expect_equal(riscv_cpu_common.read_reg(ev_cpu, "mip") & (MIP_MSIP | MIP_MTIP), MIP_MSIP | MIP_MTIP)
+
+# the restored mtime_offset is the one of the saved cycles_per_tick, mtime doesn't move when
+# the attributes are set like from a checkpoint (before the object is configured)
+saved = riscv_cpu_common.create_riscv_clint("saved_clint", cpu = ev_cpu)
+saved.cycles_per_tick = 4
+saved.mtime = 0x5000
+restored = simics.pre_conf_object("restored_clint", "riscv_clint")
+restored.queue = ev_cpu
+restored.mtime_offset = saved.mtime_offset
+restored.cycles_per_tick = saved.cycles_per_tick
+restored.mtimecmp = saved.mtimecmp
+simics.SIM_add_configuration([restored], None)
+restored = simics.SIM_get_object("restored_clint")
+stest.expect_equal(restored.cycles_per_tick, 4)
+stest.expect_equal(restored.mtime_offset, saved.mtime_offset)
+stest.expect_equal(restored.mtime, 0x5000)
+
+# the instructions taking more than a cycle shorten the batch, so the timer interrupt isn't
+# overshot when the popc latency is 30 cycles, the handler records mcycle
+asm = riscv_cpu_common
+lat_cpu = asm.create_machine("lat_cpu")
+asm.load(lat_cpu, asm.RAM_BASE, [
+    *asm.li(asm.T0, asm.RAM_BASE + 0x100),
+    asm.csrw(asm.CSR_MTVEC, asm.T0),
+    asm.addi(asm.T0, asm.ZERO, MIP_MTIP),
+    asm.csrw(asm.CSR_MIE, asm.T0),
+    asm.addi(asm.T0, asm.ZERO, 1 << 3),             # mstatus.MIE
+    asm.csrw(asm.CSR_MSTATUS, asm.T0),
+    asm.custom_0(asm.A0, asm.A1, asm.ZERO),         # popc a0, a1
+    asm.jal(asm.ZERO, -4),
+])
+asm.load(lat_cpu, asm.RAM_BASE + 0x100, [asm.csrr(asm.S1, asm.CSR_MCYCLE), asm.jal(asm.ZERO, 0)])
+asm.create_riscv_popcount(cpu = lat_cpu, latency = 30)
+lat_clint = asm.create_riscv_clint("lat_clint", cpu = lat_cpu)
+lat_clint.mtimecmp = 100
+asm.run(lat_cpu, 1000)
+stest.expect_equal(asm.read_reg(lat_cpu, "mcause"), (1 << 31) | 7)
+stest.expect_true(100 <= asm.read_reg(lat_cpu, asm.S1) <= 100 + 30 + 1)
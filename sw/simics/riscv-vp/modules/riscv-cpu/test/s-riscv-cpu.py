@@ -15,11 +15,807 @@
 # OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 # DEALINGS IN THE SOFTWARE.
 
+import os
+import re
+import socket
+import subprocess
+import tempfile
+import time
 import dev_util
+import simics
 import conf
 import stest
 import riscv_cpu_common
 
 dev = riscv_cpu_common.create_riscv_cpu()
+dev64 = riscv_cpu_common.create_riscv64_cpu()
+asm = riscv_cpu_common
+
+# both variants are built from the same sources, only the register width differs
+stest.expect_equal(dev.xlen, 32)
+stest.expect_equal(dev64.xlen, 64)
+
+# the hart starts in M-mode at the reset address
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.priv, 3)
+    stest.expect_equal(cpu.pc, 0x10000000)
+
+# the host interface is disabled by default, tohost has to be 8-byte aligned
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.tohost, 0)
+    stest.expect_equal(cpu.semihosting, False)
+    stest.expect_equal(cpu.exit_code, None)
+    cpu.tohost = 0x10001000
+    stest.expect_equal(cpu.tohost, 0x10001000)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.tohost = 0x10001004
+    cpu.tohost = 0
+
+# the profiler is disabled by default, a block ends with a control transfer instruction,
+# the profile ([pc, executions, instructions, length], the hottest first) can be restored
+# and cleared
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.profiling, False)
+    stest.expect_equal(cpu.profile, [])
+loop_program = [
+    asm.addi(asm.T0, asm.ZERO, 5),
+    asm.addi(asm.A0, asm.A0, 1),
+    asm.addi(asm.T0, asm.T0, -1),
+    asm.bne(asm.T0, asm.ZERO, -8),
+    asm.jal(asm.ZERO, 0),
+]
+profile_cpu = riscv_cpu_common.create_machine("profile_cpu")
+riscv_cpu_common.load(profile_cpu, asm.RAM_BASE, loop_program)
+profile_cpu.profiling = True
+riscv_cpu_common.run(profile_cpu, 1 + 5 * 3 + 3)
+profile = [[asm.RAM_BASE + 0x04, 4, 12, 3], [asm.RAM_BASE, 1, 4, 4], [asm.RAM_BASE + 0x10, 3, 3, 1]]
+stest.expect_equal(profile_cpu.profile, profile)
+profile_cpu.profile = []
+stest.expect_equal(profile_cpu.profile, [])
+profile_cpu.profile = profile
+stest.expect_equal(profile_cpu.profile, profile)
+
+# the instruction mix is disabled by default, only clearing it is allowed, the operations are
+# counted with their formats, the most frequent first
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.mix_counting, False)
+    stest.expect_equal(cpu.instruction_mix, [])
+    cpu.instruction_mix = []
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.instruction_mix = [["addi", "I", 1]]
+for cls in ("riscv_cpu", "riscv64_cpu"):
+    cpu = riscv_cpu_common.create_machine("mix_" + cls, cls)
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, loop_program)
+    cpu.mix_counting = True
+    riscv_cpu_common.run(cpu, 1 + 5 * 3 + 3)
+    stest.expect_equal(cpu.instruction_mix, [["addi", "I", 11], ["bne", "B", 5], ["jal", "J", 3]])
+    cpu.instruction_mix = []
+    riscv_cpu_common.run(cpu, 2)
+    stest.expect_equal(cpu.instruction_mix, [["jal", "J", 2]])
+
+# the trace is disabled by default, a record per retired instruction holds the written register,
+# the accessed address and the stored value, tools/riscv-trace.py decodes it
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.trace_file, None)
+    stest.expect_equal(cpu.trace_compression, False)
+    stest.expect_equal(cpu.trace_records, 0)
+riscv_trace = riscv_cpu_common.load_tool("riscv-trace")
+traces = {}
+for cls in ("riscv_cpu", "riscv64_cpu"):
+    cpu = riscv_cpu_common.create_machine("trace_" + cls, cls)
+    program = [
+        *asm.li(asm.T1, asm.RAM_BASE + 0x800),
+        asm.addi(asm.T0, asm.ZERO, 42),
+        asm.sw(asm.T0, asm.T1, 0),
+        asm.lw(asm.A0, asm.T1, 0),
+        asm.jal(asm.ZERO, 0),
+    ]
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, program)
+    trace = os.path.join(tempfile.mkdtemp(), "trace.bin")
+    cpu.trace_file = trace
+    riscv_cpu_common.run(cpu, 7)
+    stest.expect_equal(cpu.trace_records, 7)
+    cpu.trace_file = None
+    with open(trace, "rb") as f:
+        data = f.read()
+    stest.expect_equal(riscv_trace.read_header(data), (cpu.xlen, 0))
+    records = list(riscv_trace.iter_records(data))
+    data_addr = asm.RAM_BASE + 0x800
+    stest.expect_equal(records, [
+        (asm.RAM_BASE + 0x00, 3, program[0], asm.T1, data_addr + 0x800, None, None),
+        (asm.RAM_BASE + 0x04, 3, program[1], asm.T1, data_addr, None, None),
+        (asm.RAM_BASE + 0x08, 3, program[2], asm.T0, 42, None, None),
+        (asm.RAM_BASE + 0x0c, 3, program[3], None, None, data_addr, 42),
+        (asm.RAM_BASE + 0x10, 3, program[4], asm.A0, 42, data_addr, None),
+        (asm.RAM_BASE + 0x14, 3, program[5], None, None, None, None),
+        (asm.RAM_BASE + 0x14, 3, program[5], None, None, None, None),
+    ])
+    traces[cpu.xlen] = trace
+
+# the host build of the trace analyzer reports the instruction mix, the hot PCs and the reuse
+# distance of the memory accesses
+analyzer_dir = os.path.join(riscv_cpu_common.TOOLS_DIR, "trace-analyzer")
+subprocess.run(["make", "-s", "-C", analyzer_dir], check = True)
+report = subprocess.run([os.path.join(analyzer_dir, "riscv-trace-analyzer"), "-j", "2", traces[32]],
+                        capture_output = True, text = True, check = True).stdout
+stest.expect_true(report.startswith("Instructions: 7 in 1 chunks (RV32)"))
+for line in (r"jal \(J\)\s+2\s", r"sw \(S\)\s+1\s", r"0x0000000010000014\s+2\s+\S+\s+j zero, 0x10000014",
+             r"Memory accesses: 2, lines of 64 bytes, first accesses 1 "):
+    stest.expect_true(re.search(line, report) is not None, line)
+
+# BBV collection is disabled by default, the interval has to be positive, the blocks get ids in
+# the order of their first execution
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.bbv_file, None)
+    stest.expect_equal(cpu.bbv_interval, 10000000)
+    stest.expect_equal(cpu.bbv_intervals, 0)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.bbv_interval = 0
+bbv_cpu = riscv_cpu_common.create_machine("bbv_cpu")
+riscv_cpu_common.load(bbv_cpu, asm.RAM_BASE, loop_program)
+bbv = os.path.join(tempfile.mkdtemp(), "bbv.bb")
+bbv_cpu.bbv_interval = 6
+bbv_cpu.bbv_file = bbv
+riscv_cpu_common.run(bbv_cpu, 1 + 5 * 3 + 3)
+stest.expect_equal(bbv_cpu.bbv_intervals, 3)
+bbv_cpu.bbv_file = None
+# an interval ends with the block which reaches its length, the blocks are weighted by length
+with open(bbv) as f:
+    stest.expect_equal(f.read(), "T:1:4 :2:3 \nT:2:6 \nT:2:3 :3:3 \n")
+
+# the functional mode is the default, nothing is scheduled
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.mode, "functional")
+    stest.expect_equal(cpu.mode_schedule, [])
+    stest.expect_equal(cpu.mode_magic, False)
+    stest.expect_equal(cpu.timing_stats, [0, 0, 0])
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.mode = "detailed"
+    cpu.mode_schedule = [[2000, "timing"], [1000, "warmup"]]
+    stest.expect_equal(cpu.mode_schedule, [[1000, "warmup"], [2000, "timing"]])
+    cpu.mode_schedule = []
+# the "srai zero, zero, N" markers switch the modes, the loads cost 8 cycles in the timing
+# window only
+mode_cpu = riscv_cpu_common.create_machine("mode_cpu")
+riscv_cpu_common.load(mode_cpu, asm.RAM_BASE, [
+    *asm.li(asm.T1, asm.RAM_BASE + 0x800),
+    asm.srai(asm.ZERO, asm.ZERO, 3),                # timing
+    asm.lw(asm.A0, asm.T1, 0),
+    asm.lw(asm.A1, asm.T1, 0),
+    asm.lw(asm.A2, asm.T1, 0),
+    asm.addi(asm.A3, asm.ZERO, 1),
+    asm.srai(asm.ZERO, asm.ZERO, 1),                # functional
+    asm.lw(asm.A4, asm.T1, 0),
+    asm.jal(asm.ZERO, 0),
+])
+mode_cpu.mode_magic = True
+mode_cpu.cost_model = [["load", 8]]
+riscv_cpu_common.run(mode_cpu, 2 + 1 + 4 + 1 + 1 + 2)
+stest.expect_equal(mode_cpu.mode, "functional")
+stest.expect_equal(mode_cpu.timing_stats, [1, 1 + 4, 1 + 4 + 3 * 7])
+stest.expect_equal(mode_cpu.cycles, 11 + 3 * 7)
+
+# one cycle per instruction is the default cost model, the presets replace the whole table
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.cost_preset, "default")
+    stest.expect_equal(dict(cpu.cost_model)["load"], 1)
+    cpu.cost_preset = "fde_ip"
+    stest.expect_equal(set(c for (_, c) in cpu.cost_model), {6})
+    cpu.cost_model = [["load", 8]]
+    stest.expect_equal(cpu.cost_preset, "custom")
+    stest.expect_equal(dict(cpu.cost_model)["load"], 8)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.cost_model = [["fpu", 4]]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.cost_preset = "o3"
+    cpu.cost_preset = "default"
+# the latencies of the classes are charged in the timing mode only, the functional mode keeps
+# one cycle per instruction
+for (mode, cycles) in (("timing", 11 + 4 * 3 + 1 * 2 + 3 * 3), ("functional", 1 + 5 * 3 + 3)):
+    cpu = riscv_cpu_common.create_machine("cost_" + mode)
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, loop_program)
+    cpu.cost_model = [["branch_taken", 3], ["branch_not_taken", 2]]
+    cpu.mode = mode
+    riscv_cpu_common.run(cpu, 1 + 5 * 3 + 3)
+    stest.expect_equal(cpu.cycles, cycles)
+
+# the caches are detached by default, the geometry has to be a power of two
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.icache, None)
+    stest.expect_equal(cpu.dcache, None)
+    stest.expect_equal(cpu.dcache_miss_penalty, 20)
+    cpu.dcache = [32768, 8, 64, "plru", True]
+    stest.expect_equal(cpu.dcache, [32768, 8, 64, "plru", True])
+    stest.expect_equal(cpu.dcache_stats, [0, 0, 0, 0, 0])
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.icache = [24576, 3, 64, "lru", False]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.icache = [16384, 4, 32, "fifo", False]
+    # a rejected geometry or policy keeps the attached cache
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.dcache = [32768, 16, 4096, "lru", True]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.dcache = [4096, 2, 64, "mru", True]
+    stest.expect_equal(cpu.dcache, [32768, 8, 64, "plru", True])
+    cpu.dcache = None
+# a direct mapped write-back cache: the load of the second line of set 0 evicts the dirty first
+# one, the line transfers are charged in the timing mode only
+for (mode, cycles) in (("warmup", 8), ("timing", 8 + (1 + 2 + 1) * 20)):
+    cpu = riscv_cpu_common.create_machine("dcache_" + mode)
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, [
+        *asm.li(asm.T1, asm.RAM_BASE + 0x800),
+        asm.lw(asm.A0, asm.T1, 0),                  # read miss
+        asm.sw(asm.A0, asm.T1, 4),                  # write hit, the line is dirty
+        asm.lw(asm.A1, asm.T1, 0x80),               # read miss, write back
+        asm.lw(asm.A2, asm.T1, 0x40),               # read miss in set 1
+        asm.lw(asm.A3, asm.T1, 0x84),               # read hit
+        asm.jal(asm.ZERO, 0),
+    ])
+    cpu.dcache = [128, 1, 64, "lru", True]
+    cpu.mode = mode
+    riscv_cpu_common.run(cpu, 2 + 5 + 1)
+    stest.expect_equal(cpu.dcache_stats, [4, 3, 1, 0, 1])
+    stest.expect_equal(cpu.cycles, cycles)
+
+# no branch predictor is attached by default
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.branch_predictor, None)
+    stest.expect_equal(cpu.branch_mispredict_penalty, 3)
+    cpu.branch_predictor = ["gshare", 4096, 12, 256, 8]
+    stest.expect_equal(cpu.branch_predictor, ["gshare", 4096, 12, 256, 8])
+    stest.expect_equal(cpu.branch_stats, [0, 0, 0, 0, 0, 0])
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.branch_predictor = ["tage", 4096, 12, 256, 8]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.branch_predictor = ["bimodal", 1000, 0, 0, 0]
+    stest.expect_equal(cpu.branch_predictor, ["gshare", 4096, 12, 256, 8])
+    cpu.branch_predictor = None
+# "jalr zero, 4(ra)" skips an instruction after the call site, it isn't a return (the same
+# predicate as the call graph), so it doesn't pop the RAS, the BTB predicts it instead
+bpred_cpu = riscv_cpu_common.create_machine("bpred_cpu")
+riscv_cpu_common.load(bpred_cpu, asm.RAM_BASE, [
+    asm.addi(asm.T0, asm.ZERO, 4),
+    asm.jal(asm.RA, 0x40 - 0x04),                   # call f
+    asm.addi(asm.A0, asm.A0, 100),                  # skipped by f
+    asm.jal(asm.RA, 0x50 - 0x0c),                   # call g
+    asm.addi(asm.T0, asm.T0, -1),
+    asm.bne(asm.T0, asm.ZERO, 0x04 - 0x14),
+    asm.jal(asm.ZERO, 0),
+])
+riscv_cpu_common.load(bpred_cpu, asm.RAM_BASE + 0x40, [
+    asm.addi(asm.A1, asm.A1, 1),                    # f
+    asm.jalr(asm.ZERO, asm.RA, 4),
+])
+riscv_cpu_common.load(bpred_cpu, asm.RAM_BASE + 0x50, [
+    asm.jalr(asm.ZERO, asm.RA, 0),                  # g
+])
+bpred_cpu.branch_predictor = ["btfn", 1024, 0, 256, 8]
+bpred_cpu.mode = "warmup"
+riscv_cpu_common.run(bpred_cpu, 1 + 4 * 7 + 1)
+stest.expect_equal(riscv_cpu_common.read_reg(bpred_cpu, asm.A0), 0)
+stest.expect_equal(riscv_cpu_common.read_reg(bpred_cpu, asm.A1), 4)
+# the first taken branch misses the BTB, the last one isn't taken; the first execution of
+# every jump misses the BTB, the returns of g are predicted by the RAS
+stest.expect_equal(bpred_cpu.branch_stats, [4, 2, 4 * 4 + 1, 3 + 1, 4, 0])
+
+# the call graph is empty until the tracking starts, it can only be cleared
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.callgraph_tracking, False)
+    stest.expect_equal(cpu.callgraph, [[], []])
+    cpu.callgraph_tracking = True
+    stest.expect_equal(len(cpu.callgraph[0]), 1)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.callgraph = [[[0, 1, 1]], []]
+    cpu.callgraph = []
+    cpu.callgraph_tracking = False
+
+# nested calls: main calls f and g, f calls g through JALR and JAL from two call sites; the
+# call instruction is charged to the caller and the return to the callee, the functions are
+# exclusive and the calls inclusive, one cycle per instruction in the functional mode
+callgraph_cpu = riscv_cpu_common.create_machine("callgraph_cpu")
+riscv_cpu_common.load(callgraph_cpu, asm.RAM_BASE, [
+    asm.jal(asm.RA, 0x20 - 0x00),                   # main: call f
+    asm.jal(asm.RA, 0x40 - 0x04),                   # call g
+    asm.jal(asm.ZERO, 0),
+])
+riscv_cpu_common.load(callgraph_cpu, asm.RAM_BASE + 0x20, [
+    asm.addi(asm.S0, asm.RA, 0),                    # f
+    asm.lui(asm.T1, asm.RAM_BASE >> 12),
+    asm.jalr(asm.RA, asm.T1, 0x40),                 # call g
+    asm.jal(asm.RA, 0x40 - 0x2c),                   # call g
+    asm.addi(asm.RA, asm.S0, 0),
+    asm.jalr(asm.ZERO, asm.RA, 0),
+])
+riscv_cpu_common.load(callgraph_cpu, asm.RAM_BASE + 0x40, [
+    asm.addi(asm.A1, asm.A1, 1),                    # g
+    asm.jalr(asm.ZERO, asm.RA, 0),
+])
+callgraph_cpu.callgraph_tracking = True
+riscv_cpu_common.run(callgraph_cpu, 1 + 10 + 3 + 2)
+stest.expect_equal(riscv_cpu_common.read_reg(callgraph_cpu, asm.A1), 3)
+main, f, g = asm.RAM_BASE, asm.RAM_BASE + 0x20, asm.RAM_BASE + 0x40
+functions, calls = callgraph_cpu.callgraph
+stest.expect_equal(functions, [[main, 4, 4], [f, 6, 6], [g, 6, 6]])
+stest.expect_equal(sorted(calls), [
+    [main, main, f, 1, 10, 10],
+    [main, main + 0x04, g, 1, 2, 2],
+    [f, f + 0x08, g, 1, 2, 2],
+    [f, f + 0x0c, g, 1, 2, 2],
+])
+callgraph_cpu.callgraph_tracking = False
+
+# the coverage map holds a 128-byte bitmap per 4 KiB page
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.coverage, False)
+    stest.expect_equal(cpu.coverage_map, [])
+    cpu.coverage_map = [[0x1000, tuple([1] + [0] * 127)]]
+    stest.expect_equal(cpu.coverage_map, [[0x1000, tuple([1] + [0] * 127)]])
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.coverage_map = [[0x1004, tuple([0] * 128)]]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.coverage_map = [[0x1000, tuple([0] * 64)]]
+    cpu.coverage_map = []
+
+# an executed instruction sets its bit, the code which is never reached stays clear; without
+# an ELF file save-coverage puts the runs in an "[unknown]" module based at the first one
+riscv_coverage = riscv_cpu_common.load_tool("riscv-coverage")
+coverage_cpu = riscv_cpu_common.create_machine("coverage_cpu")
+riscv_cpu_common.load(coverage_cpu, asm.RAM_BASE, loop_program + [asm.addi(asm.A1, asm.A1, 1)])
+coverage_cpu.coverage = True
+riscv_cpu_common.run(coverage_cpu, 1 + 5 * 3 + 3)
+stest.expect_equal(coverage_cpu.coverage_map, [[asm.RAM_BASE, tuple([0x1f] + [0] * 127)]])
+drcov = os.path.join(tempfile.mkdtemp(), "coverage.drcov")
+simics.SIM_run_command(f'{coverage_cpu.name}.save-coverage "{drcov}"')
+stest.expect_equal(riscv_coverage.read_drcov(drcov),
+                   {riscv_coverage.UNKNOWN_MODULE: (asm.RAM_BASE, {0, 4, 8, 12, 16})})
+
+# the memory profile is disabled by default, the heatmap can only be cleared
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.mem_sampling, 0)
+    stest.expect_equal(cpu.mem_interval, 1000000)
+    stest.expect_equal(cpu.mem_heatmap, [])
+    stest.expect_equal(cpu.mem_working_set, [])
+    cpu.mem_sampling = 16
+    stest.expect_equal(cpu.mem_sampling, 16)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.mem_sampling = -1
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.mem_heatmap = [[0x1000, 1, 1, 0, 0]]
+    cpu.mem_sampling = 0
+
+# the sampled accesses are counted per page with the steps of their first and last touch,
+# every Nth access is sampled and a working set interval counts the distinct pages once
+for cls in ("riscv_cpu", "riscv64_cpu"):
+    cpu = riscv_cpu_common.create_machine("memprof_" + cls, cls)
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, [
+        asm.lui(asm.A1, (asm.RAM_BASE + 0x2000) >> 12),
+        asm.sw(asm.A0, asm.A1, 0),
+        asm.lw(asm.A2, asm.A1, 4),
+        asm.sw(asm.A0, asm.A1, -4),
+        asm.lw(asm.A2, asm.A1, 8),
+        asm.jal(asm.ZERO, -20),
+    ])
+    cpu.mem_interval = 3
+    cpu.mem_sampling = 1
+    riscv_cpu_common.run(cpu, 6)
+    stest.expect_equal(cpu.mem_heatmap, [[asm.RAM_BASE + 0x1000, 0, 1, 3, 3],
+                                         [asm.RAM_BASE + 0x2000, 2, 1, 1, 4]])
+    stest.expect_equal(cpu.mem_working_set, [1, 2])
+    cpu.mem_sampling = 2
+    riscv_cpu_common.run(cpu, 6)
+    stest.expect_equal(cpu.mem_heatmap, [[asm.RAM_BASE + 0x2000, 2, 0, 8, 10]])
+    stest.expect_equal(cpu.mem_working_set, [0, 0, 1, 1])
+
+# the host profile has a row per tier, it can only be cleared
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.host_profiling, False)
+    stest.expect_equal([tier for (tier, *_) in cpu.host_profile], ["plain", "instrumented", "events"])
+    cpu.host_profile = []
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.host_profile = [["plain", 0, 0, 0, 0, 0, 0]]
+
+# the guest instructions of a run are accounted to the tier of their batches, the task clock
+# is always opened; the hosts which don't allow perf_event_open refuse the profiling
+hostprof_cpu = riscv_cpu_common.create_machine("hostprof_cpu")
+riscv_cpu_common.load(hostprof_cpu, asm.RAM_BASE, loop_program)
+stest.untrap_log("error", hostprof_cpu)
+try:
+    hostprof_cpu.host_profiling = True
+except simics.SimExc_IllegalValue:
+    print("perf_event_open is not available, the host profile is not checked")
+stest.trap_log("error", hostprof_cpu)
+if hostprof_cpu.host_profiling:
+    riscv_cpu_common.run(hostprof_cpu, 1 + 5 * 3 + 3)
+    hostprof_cpu.mix_counting = True
+    riscv_cpu_common.run(hostprof_cpu, 2)
+    stest.expect_true("task-clock" in hostprof_cpu.host_counters)
+    profile = {tier: (guest, task_clock) for (tier, guest, task_clock, *_) in hostprof_cpu.host_profile}
+    stest.expect_equal(profile["plain"][0], 1 + 5 * 3 + 3)
+    stest.expect_equal(profile["instrumented"][0], 2)
+    stest.expect_equal(profile["events"][0], 0)
+    stest.expect_true(profile["plain"][1] > 0)
+    hostprof_cpu.host_profile = []
+    stest.expect_equal([row[1:] for row in hostprof_cpu.host_profile], [[0] * 6] * 3)
+    hostprof_cpu.host_profiling = False
+
+# the instrumentation API is provided through the standard Simics interfaces
+for cpu in (dev, dev64):
+    for iface in ("cpu_instrumentation_subscribe", "cpu_cached_instruction",
+                  "cpu_instruction_query", "cpu_memory_query", "cpu_exception_query"):
+        stest.expect_true(hasattr(cpu.iface, iface))
+
+# the hooks of the cached instructions run until their connection is removed, also from
+# within a hook, and the instructions are offered again to a new subscription
+instr_cpu = riscv_cpu_common.create_machine("instr_cpu")
+riscv_cpu_common.load(instr_cpu, asm.RAM_BASE, loop_program)
+instr_conn = simics.SIM_create_object("memory-space", "instr_conn", [])
+subscribe = instr_cpu.iface.cpu_instrumentation_subscribe
+executed = []
+def before_instruction(conn, cpu, handle, limit):
+    executed.append(cpu.iface.cpu_instruction_query.logical_address(cpu, handle))
+    if len(executed) == limit:
+        cpu.iface.cpu_instrumentation_subscribe.remove_connection_callbacks(cpu, conn)
+def cached_instruction(conn, cpu, ci_handle, handle, limit):
+    cpu.iface.cpu_cached_instruction.register_instruction_before_cb(
+        cpu, ci_handle, before_instruction, limit, None)
+subscribe.register_cached_instruction_cb(instr_conn, cached_instruction, 0)
+riscv_cpu_common.run(instr_cpu, 6)
+stest.expect_equal(executed, [asm.RAM_BASE + offset for offset in (0, 4, 8, 12, 4, 8)])
+subscribe.remove_connection_callbacks(instr_cpu, instr_conn)
+riscv_cpu_common.run(instr_cpu, 6)
+stest.expect_equal(len(executed), 6)
+executed.clear()
+subscribe.register_cached_instruction_cb(instr_conn, cached_instruction, 3)
+riscv_cpu_common.run(instr_cpu, 6)
+stest.expect_equal(executed, [asm.RAM_BASE + offset for offset in (12, 4, 8)])
+stest.expect_equal(instr_cpu.pc, asm.RAM_BASE + 16)
+
+# the breakpoints of the physical memory space are copied to the CPU when they change
+bp_cpu = riscv_cpu_common.create_riscv_cpu("bp_cpu")
+bp_cpu.phys_mem = simics.SIM_create_object("memory-space", "bp_mem", [])
+stest.expect_equal(bp_cpu.breakpoints, [])
+bp = simics.SIM_breakpoint(bp_cpu.phys_mem, simics.Sim_Break_Physical, simics.Sim_Access_Execute,
+                           0x10000000, 4, simics.Sim_Breakpoint_Simulation)
+stest.expect_equal([(access, start, end) for (_, access, start, end) in bp_cpu.breakpoints],
+                   [(4, 0x10000000, 0x10000003)])
+simics.SIM_delete_breakpoint(bp)
+stest.expect_equal(bp_cpu.breakpoints, [])
+
+# an execution breakpoint stops the CPU before the instruction, a read or write one after the
+# access; a deleted CPU isn't notified of the breakpoint changes any more
+bp_run_cpu = riscv_cpu_common.create_machine("bp_run_cpu")
+riscv_cpu_common.load(bp_run_cpu, asm.RAM_BASE, [
+    asm.lui(asm.A1, (asm.RAM_BASE + 0x1000) >> 12),
+    asm.lw(asm.A2, asm.A1, 0),
+    asm.addi(asm.A3, asm.A3, 1),
+    asm.sw(asm.A3, asm.A1, 4),
+    asm.addi(asm.A4, asm.A4, 1),
+    asm.jal(asm.ZERO, 0),
+])
+riscv_cpu_common.load(bp_run_cpu, asm.RAM_BASE + 0x1000, [0x1234])
+mem_name = bp_run_cpu.phys_mem.name
+bp_ids = [simics.SIM_run_command(f"bp.memory.break {mem_name} {asm.RAM_BASE + 0x1000:#x} 4 -r"),
+          simics.SIM_run_command(f"bp.memory.break {mem_name} {asm.RAM_BASE + 0x1004:#x} 4 -w"),
+          simics.SIM_run_command(f"bp.memory.break {mem_name} {asm.RAM_BASE + 0x10:#x} 4 -x")]
+riscv_cpu_common.run(bp_run_cpu, 100)
+stest.expect_equal(bp_run_cpu.pc, asm.RAM_BASE + 0x08)
+stest.expect_equal(riscv_cpu_common.read_reg(bp_run_cpu, asm.A2), 0x1234)
+riscv_cpu_common.run(bp_run_cpu, 100)
+stest.expect_equal(bp_run_cpu.pc, asm.RAM_BASE + 0x10)
+stest.expect_equal(riscv_cpu_common.read_mem(bp_run_cpu, asm.RAM_BASE + 0x1004, 4), (1).to_bytes(4, "little"))
+riscv_cpu_common.run(bp_run_cpu, 100)
+stest.expect_equal(bp_run_cpu.pc, asm.RAM_BASE + 0x10)
+stest.expect_equal(riscv_cpu_common.read_reg(bp_run_cpu, asm.A4), 0)
+riscv_cpu_common.run(bp_run_cpu, 100)
+stest.expect_equal(bp_run_cpu.pc, asm.RAM_BASE + 0x14)
+stest.expect_equal(riscv_cpu_common.read_reg(bp_run_cpu, asm.A4), 1)
+for bp_id in bp_ids:
+    simics.SIM_run_command(f"bp.delete {bp_id}")
+stest.expect_equal(bp_run_cpu.breakpoints, [])
+simics.SIM_delete_objects([bp_run_cpu, bp_run_cpu.cell, bp_run_cpu.phys_mem] +
+                          [simics.SIM_get_object("bp_run_cpu_" + part) for part in ("ram", "image")])
+bp = simics.SIM_breakpoint(bp_cpu.phys_mem, simics.Sim_Break_Physical, simics.Sim_Access_Execute,
+                           0x10000000, 4, simics.Sim_Breakpoint_Simulation)
+simics.SIM_delete_breakpoint(bp)
+
+# the watchpoints are byte ranges with a read/write mask, nothing is hit until the cpu runs
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.watchpoints, [])
+    stest.expect_equal(cpu.watchpoint_hit, None)
+    cpu.watchpoints = [[0x10002000, 8, 2], [0x10002ffe, 4, 3]]
+    stest.expect_equal(cpu.watchpoints, [[0x10002000, 8, 2], [0x10002ffe, 4, 3]])
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.watchpoints = [[0x10002000, 0, 2]]
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.watchpoints = [[0x10002000, 4, 4]]
+    cpu.watchpoints = []
+
+# a watched store stops the CPU after it's done, the hit reports the address of the store;
+# the load of the unwatched word of the same page passes
+watch_cpu = riscv_cpu_common.create_machine("watch_cpu")
+riscv_cpu_common.load(watch_cpu, asm.RAM_BASE, [
+    asm.lui(asm.A1, (asm.RAM_BASE + 0x1000) >> 12),
+    asm.lw(asm.A2, asm.A1, 0),
+    asm.addi(asm.A3, asm.A3, 1),
+    asm.sw(asm.A3, asm.A1, 4),
+    asm.addi(asm.A4, asm.A4, 1),
+    asm.jal(asm.ZERO, 0),
+])
+watch_cpu.watchpoints = [[asm.RAM_BASE + 0x1004, 4, 2]]
+riscv_cpu_common.run(watch_cpu, 100)
+stest.expect_equal(watch_cpu.watchpoint_hit, [0, asm.RAM_BASE + 0x0c, asm.RAM_BASE + 0x1004, 4, 2])
+stest.expect_equal(watch_cpu.pc, asm.RAM_BASE + 0x10)
+stest.expect_equal(riscv_cpu_common.read_mem(watch_cpu, asm.RAM_BASE + 0x1004, 4), (1).to_bytes(4, "little"))
+riscv_cpu_common.run(watch_cpu, 100)
+stest.expect_equal(watch_cpu.pc, asm.RAM_BASE + 0x14)
+stest.expect_equal(riscv_cpu_common.read_reg(watch_cpu, asm.A4), 1)
+
+# the GDB stub is disabled by default, it listens on the local host when the port is set
+for cpu in (dev, dev64):
+    stest.expect_equal(cpu.gdb_port, 0)
+    with stest.expect_exception_mgr(simics.SimExc_IllegalValue):
+        cpu.gdb_port = 0x10000
+
+def gdb_packets(client, payloads, tail = b""):
+    """Send the packets at once, followed by the raw tail bytes, and return the payloads of
+    their replies, the Simics socket callbacks are run while waiting."""
+    client.sendall(b"".join(b"$%s#%02x" % (payload, sum(payload) & 0xff) for payload in payloads) + tail)
+    data = b""
+    deadline = time.monotonic() + 10
+    while len(replies := re.findall(rb"\$([^#]*)#[0-9a-f]{2}", data)) < len(payloads):
+        if time.monotonic() > deadline:
+            stest.fail(f"no reply to {payloads}")
+        simics.SIM_process_pending_work()
+        try:
+            data += client.recv(0x10000)
+        except BlockingIOError:
+            time.sleep(0.01)
+    client.sendall(b"+" * len(replies))
+    return replies
+
+def gdb_packet(client, payload):
+    """Send the packet and return the payload of the reply."""
+    return gdb_packets(client, [payload])[0]
+
+# a session on a free port: the registers, the memory, and a breakpoint the continue stops on,
+# the stop is replied after the simulation is started outside of the socket callback
+gdb_cpu = riscv_cpu_common.create_machine("gdb_cpu")
+riscv_cpu_common.load(gdb_cpu, asm.RAM_BASE, loop_program)
+riscv_cpu_common.write_reg(gdb_cpu, asm.A0, 0x1234)
+with socket.socket() as probe:
+    probe.bind(("127.0.0.1", 0))
+    port = probe.getsockname()[1]
+gdb_cpu.gdb_port = port
+stest.expect_equal(gdb_cpu.gdb_port, port)
+with socket.create_connection(("127.0.0.1", port)) as client:
+    client.setblocking(False)
+    regs = bytes.fromhex(gdb_packet(client, b"g").decode())
+    stest.expect_equal(len(regs), 33 * 4)
+    stest.expect_equal(regs[asm.A0 * 4:asm.A0 * 4 + 4], (0x1234).to_bytes(4, "little"))
+    stest.expect_equal(regs[32 * 4:], asm.RAM_BASE.to_bytes(4, "little"))
+    stest.expect_equal(gdb_packet(client, b"m%x,8" % asm.RAM_BASE),
+                       riscv_cpu_common.read_mem(gdb_cpu, asm.RAM_BASE, 8).hex().encode())
+    stest.expect_equal(gdb_packet(client, b"M%x,4,00" % asm.RAM_BASE), b"E01")
+    stest.expect_equal(gdb_packet(client, b"Z0,%x,4" % (asm.RAM_BASE + 8)), b"OK")
+    stest.expect_equal(gdb_packet(client, b"c"), b"S05")
+    stest.expect_equal(gdb_cpu.pc, asm.RAM_BASE + 8)
+    stest.expect_equal(gdb_packet(client, b"z0,%x,4" % (asm.RAM_BASE + 8)), b"OK")
+    stest.expect_equal(gdb_packet(client, b"s"), b"S05")
+    stest.expect_equal(gdb_cpu.pc, asm.RAM_BASE + 12)
+    # the packets sent with a resume are handled after its stop reply, an interrupt sent with
+    # the continue stops the target as well
+    stop, regs = gdb_packets(client, [b"s", b"g"])
+    stest.expect_equal(stop, b"S05")
+    stest.expect_equal(bytes.fromhex(regs.decode())[32 * 4:], (asm.RAM_BASE + 4).to_bytes(4, "little"))
+    stest.expect_equal(gdb_packets(client, [b"c"], b"\x03"), [b"S05"])
+    stest.expect_equal(gdb_packet(client, b"D"), b"OK")
+gdb_cpu.gdb_port = 0
+stest.expect_equal(gdb_cpu.gdb_port, 0)
+
+# the popc example accelerator is bound through the riscv_custom_instr interface, the binding is
+# resolved when the instruction is predecoded (every change of the bindings flushes the cache)
+# and it survives the predecode flushes
+custom_cpu = riscv_cpu_common.create_machine("custom_cpu")
+riscv_cpu_common.load(custom_cpu, asm.RAM_BASE, [
+    *asm.li(asm.A1, 0xf0f0),
+    asm.custom_0(asm.A0, asm.A1, asm.ZERO),     # popc a0, a1
+    asm.addi(asm.A2, asm.A2, 1),
+    asm.jal(asm.ZERO, -8),
+])
+popc = riscv_cpu_common.create_riscv_popcount("popc", cpu = custom_cpu, latency = 4)
+stest.expect_equal(custom_cpu.custom_instructions, [["popc", 2, 0, 0, 4]])
+riscv_cpu_common.run(custom_cpu, 2 + 3 * 2)
+stest.expect_equal(riscv_cpu_common.read_reg(custom_cpu, asm.A0), 8)
+stest.expect_equal(riscv_cpu_common.read_reg(custom_cpu, asm.A2), 2)
+stest.expect_equal(popc.executions, 2)
+stest.expect_equal(custom_cpu.cycles, 2 + 2 * (4 + 1 + 1))
+# the new latency is bound again, so it applies to the already predecoded instruction
+popc.latency = 10
+stest.expect_equal(custom_cpu.custom_instructions, [["popc", 2, 0, 0, 10]])
+cycles = custom_cpu.cycles
+riscv_cpu_common.run(custom_cpu, 3)
+stest.expect_equal(custom_cpu.cycles - cycles, 10 + 1 + 1)
+custom_cpu.mode_magic = False   # flushes the predecode cache
+riscv_cpu_common.run(custom_cpu, 3)
+stest.expect_equal(popc.executions, 4)
+stest.expect_equal(riscv_cpu_common.read_reg(custom_cpu, asm.A0), 8)
+stest.expect_equal(riscv_cpu_common.read_reg(custom_cpu, asm.A2), 4)
+simics.SIM_delete_object(popc)
+stest.expect_equal(custom_cpu.custom_instructions, [])
+
+# a U-mode program calls M-mode with ECALL, a load outside of the PMP region, a misaligned load
+# and a reserved encoding trap too, the handler skips the trapped instruction and returns with
+# MRET; the trapped instruction takes no step, so the run stops after the first handler one
+for cls in ("riscv_cpu", "riscv64_cpu"):
+    cpu = riscv_cpu_common.create_machine("priv_" + cls, cls)
+    handler = asm.RAM_BASE + 0x100
+    illegal = asm.r_type(0x33, asm.A3, 0, asm.A3, asm.A3, 0x7f)   # reserved OP func7
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, [
+        *asm.li(asm.T0, handler),
+        asm.csrw(asm.CSR_MTVEC, asm.T0),
+        *asm.li(asm.T0, 0x20000000 >> 2),           # TOR, [0, 0x20000000)
+        asm.csrw(asm.CSR_PMPADDR0, asm.T0),
+        asm.addi(asm.T0, asm.ZERO, 0x0f),           # TOR | RWX
+        asm.csrw(asm.CSR_PMPCFG0, asm.T0),
+        *asm.li(asm.T0, asm.RAM_BASE + 0x40),
+        asm.csrw(asm.CSR_MEPC, asm.T0),
+        asm.mret(),                                 # mstatus.MPP is U after reset
+    ])
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x40, [
+        asm.addi(asm.A0, asm.ZERO, 7),
+        asm.ecall(),
+        *asm.li(asm.A1, 0x20000000),
+        asm.lw(asm.A2, asm.A1, 0),
+        *asm.li(asm.A1, asm.RAM_BASE + 0x202),
+        asm.lw(asm.A2, asm.A1, 0),
+        illegal,
+        asm.jal(asm.ZERO, 0),
+    ])
+    riscv_cpu_common.load(cpu, handler, [
+        asm.csrr(asm.S1, asm.CSR_MCAUSE),
+        asm.csrr(asm.S2, asm.CSR_MTVAL),
+        asm.csrr(asm.T0, asm.CSR_MEPC),
+        asm.addi(asm.T0, asm.T0, 4),
+        asm.csrw(asm.CSR_MEPC, asm.T0),
+        asm.mret(),
+    ])
+    riscv_cpu_common.run(cpu, 12)
+    stest.expect_equal(cpu.priv, 0)
+    stest.expect_equal(cpu.pc, asm.RAM_BASE + 0x40)
+    for (steps, cause, tval, epc) in ((2, 8, 0, 0x44),
+                                      (3, 5, 0x20000000, 0x50),
+                                      (3, 4, asm.RAM_BASE + 0x202, 0x5c),
+                                      (1, 2, illegal, 0x60)):
+        riscv_cpu_common.run(cpu, steps)
+        stest.expect_equal(cpu.priv, 3)
+        stest.expect_equal(cpu.pc, handler + 4)
+        stest.expect_equal(riscv_cpu_common.read_reg(cpu, "mcause"), cause)
+        stest.expect_equal(riscv_cpu_common.read_reg(cpu, "mtval"), tval)
+        stest.expect_equal(riscv_cpu_common.read_reg(cpu, "mepc"), asm.RAM_BASE + epc)
+        riscv_cpu_common.run(cpu, 5)
+        stest.expect_equal(cpu.priv, 0)
+        stest.expect_equal(cpu.pc, asm.RAM_BASE + epc + 4)
+        stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S1), cause)
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.A0), 7)
+
+# a PMP entry covering a part of the page keeps it out of the page caches, the stores to such
+# a code page still invalidate the predecoded instructions
+smc_cpu = riscv_cpu_common.create_machine("smc_cpu")
+riscv_cpu_common.load(smc_cpu, asm.RAM_BASE, [
+    *asm.li(asm.T0, (asm.RAM_BASE + 0x800) >> 2),
+    asm.csrw(asm.CSR_PMPADDR0, asm.T0),
+    asm.addi(asm.T0, asm.ZERO, 0x17),               # NA4 | RWX
+    asm.csrw(asm.CSR_PMPCFG0, asm.T0),
+    *asm.li(asm.T1, asm.addi(asm.A0, asm.ZERO, 2)),
+    *asm.li(asm.T2, asm.RAM_BASE + 0x40),
+    asm.jal(asm.RA, 0x40 - 0x24),
+    asm.sw(asm.T1, asm.T2, 0),
+    asm.jal(asm.RA, 0x40 - 0x2c),
+    asm.jal(asm.ZERO, 0),
+])
+riscv_cpu_common.load(smc_cpu, asm.RAM_BASE + 0x40, [
+    asm.addi(asm.A0, asm.ZERO, 1),
+    asm.jalr(asm.ZERO, asm.RA, 0),
+])
+riscv_cpu_common.run(smc_cpu, 12)
+stest.expect_equal(riscv_cpu_common.read_reg(smc_cpu, asm.A0), 1)
+riscv_cpu_common.run(smc_cpu, 4)
+stest.expect_equal(riscv_cpu_common.read_reg(smc_cpu, asm.A0), 2)
+stest.expect_equal(smc_cpu.pc, asm.RAM_BASE + 0x30)
+
+# the targets of the branches and jumps are disassembled as absolute addresses
+stest.expect_equal(dev.iface.processor_info_v2.disassemble(0x1000000c, asm.bne(asm.A0, asm.ZERO, -12).to_bytes(4, "little"), -1),
+                   (4, "bne a0, zero, 0x10000000"))
+
+# the HTIF write syscall copies the buffer in bounded chunks and accepts stdout/stderr only,
+# the exit command stops the simulation with the exit code
+for cls in ("riscv_cpu", "riscv64_cpu"):
+    cpu = riscv_cpu_common.create_machine("htif_" + cls, cls)
+    cpu.tohost = asm.RAM_BASE + 0x1000
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x800, [64, 0, 1, 0, asm.RAM_BASE + 0x900, 0, 3, 0])
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x840, [64, 0, 7, 0, asm.RAM_BASE + 0x900, 0, 3, 0])
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x880, [64, 0, 1, 0, 0x30000000, 0, 0, 1 << 8])
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x900, [int.from_bytes(b"ok\n\0", "little")])
+    program = [*asm.li(asm.T0, asm.RAM_BASE + 0x1000)]
+    for (magic, reg) in ((0x800, asm.S0), (0x840, asm.S1), (0x880, asm.A0)):
+        program += [
+            *asm.li(asm.T1, asm.RAM_BASE + magic),
+            asm.sw(asm.T1, asm.T0, 0),
+            asm.sw(asm.ZERO, asm.T0, 4),
+            asm.lw(reg, asm.T1, 0),
+        ]
+    program += [
+        asm.addi(asm.T1, asm.ZERO, (5 << 1) | 1),
+        asm.sw(asm.T1, asm.T0, 0),
+        asm.sw(asm.ZERO, asm.T0, 4),
+        asm.jal(asm.ZERO, 0),
+    ]
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, program)
+    riscv_cpu_common.run(cpu, 100)
+    stest.expect_equal(cpu.exit_code, 5)
+    stest.expect_equal(cpu.pc, asm.RAM_BASE + 4 * (len(program) - 1))
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S0), 3)
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S1) & 0xFFFFFFFF, 0xFFFFFFF7)  # -EBADF
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.A0) & 0xFFFFFFFF, 0xFFFFFFF2)  # -EFAULT
+
+# semihosting calls: SYS_WRITE to an unknown handle writes nothing, SYS_WRITE to stdout (handle
+# of ":tt" opened for writing), SYS_WRITE0 and SYS_EXIT_EXTENDED with the exit code
+for (cls, xlen) in (("riscv_cpu", 4), ("riscv64_cpu", 8)):
+    cpu = riscv_cpu_common.create_machine("semihosting_" + cls, cls)
+    cpu.semihosting = True
+    def block(*args):
+        return [(v >> shift) & 0xFFFFFFFF for v in args for shift in range(0, xlen * 8, 32)]
+    text = asm.RAM_BASE + 0x900
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x800, block(9, text, 3))
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x840, block(2, text, 3))
+    riscv_cpu_common.load(cpu, asm.RAM_BASE + 0x880, block(0x20026, 7))
+    riscv_cpu_common.load(cpu, text, [int.from_bytes(b"ok\n\0", "little")])
+    program = []
+    for (op, arg, reg) in ((0x05, asm.RAM_BASE + 0x800, asm.S0),
+                           (0x05, asm.RAM_BASE + 0x840, asm.S1),
+                           (0x04, text, asm.S2),
+                           (0x20, asm.RAM_BASE + 0x880, asm.S3)):
+        program += [
+            asm.addi(asm.A0, asm.ZERO, op),
+            *asm.li(asm.A1, arg),
+            asm.slli(asm.ZERO, asm.ZERO, 0x1f),
+            asm.ebreak(),
+            asm.srai(asm.ZERO, asm.ZERO, 7),
+            asm.addi(reg, asm.A0, 0),
+        ]
+    riscv_cpu_common.load(cpu, asm.RAM_BASE, program)
+    riscv_cpu_common.run(cpu, 100)
+    stest.expect_equal(cpu.exit_code, 7)
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S0), 3)
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S1), 0)
+    stest.expect_equal(riscv_cpu_common.read_reg(cpu, asm.S2), 0)
+
+# the benchmark harness measures its kernel with rdinstret/rdcycle and reports through HTIF,
+# bench.py computes the CPI from the steps and cycles of the whole run
+bench_cpu = riscv_cpu_common.create_machine("bench_cpu")
+bench_cpu.tohost = asm.RAM_BASE + 0x1000
+riscv_cpu_common.load(bench_cpu, asm.RAM_BASE, [
+    *asm.li(asm.T2, asm.RAM_BASE + 0x1000),
+    asm.addi(asm.T0, asm.ZERO, 10),
+    asm.csrr(asm.S0, asm.CSR_INSTRET),
+    asm.csrr(asm.S2, asm.CSR_CYCLE),
+    asm.addi(asm.T0, asm.T0, -1),
+    asm.bne(asm.T0, asm.ZERO, -4),
+    asm.csrr(asm.S1, asm.CSR_INSTRET),
+    asm.csrr(asm.S3, asm.CSR_CYCLE),
+    asm.sub(asm.T1, asm.S1, asm.S0),
+    asm.slli(asm.T1, asm.T1, 1),
+    asm.addi(asm.T1, asm.T1, 1),
+    asm.sw(asm.T1, asm.T2, 0),
+    asm.sw(asm.ZERO, asm.T2, 4),
+    asm.jal(asm.ZERO, 0),
+])
+steps = bench_cpu.steps
+cycles = bench_cpu.cycles
+riscv_cpu_common.run(bench_cpu, 1000)
+stest.expect_equal(bench_cpu.exit_code, 2 + 2 * 10)
+stest.expect_equal(riscv_cpu_common.read_reg(bench_cpu, asm.S3) - riscv_cpu_common.read_reg(bench_cpu, asm.S2), 2 + 2 * 10)
+stest.expect_equal(bench_cpu.steps - steps, 2 + 1 + 2 + 2 * 10 + 2 + 3 + 2)
+stest.expect_equal(bench_cpu.cycles - cycles, bench_cpu.steps - steps)
 
 # TEST PLACEHOLDER - add tests here
@@ -0,0 +1,81 @@
+# Copyright © 2025 Karol Zmijewski
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this
+# software and associated documentation files (the “Software”), to deal in the Software
+# without restriction, including without limitation the rights to use, copy, modify, merge,
+# publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+# to whom the Software is furnished to do so, subject to the following conditions:
+# The above copyright notice and this permission notice shall be included in all copies or
+# substantial portions of the Software.
+# THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+#
+# INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+# PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+# FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+import os
+import tempfile
+import simics
+import stest
+import riscv_cpu_common
+
+IE_RXWM = 1 << 1
+MIP_MEIP = 1 << 11
+
+cpu = riscv_cpu_common.create_riscv_cpu()
+uart = riscv_cpu_common.create_riscv_uart(cpu = cpu)
+mip = cpu.iface.int_register.get_number("mip")
+
+def access(offset, value = None):
+    if value is None:
+        t = simics.transaction_t(read = True, size = 4)
+    else:
+        t = simics.transaction_t(write = True, size = 4, value_le = value)
+    stest.expect_equal(uart.iface.transaction.issue(t, offset), simics.Sim_PE_No_Exception)
+    return t.value_le
+
+# transmitted characters are buffered until the end of line
+out = os.path.join(tempfile.mkdtemp(), "uart.out")
+uart.tx_file = out
+access(0x08, 1)
+for c in "hello":
+    access(0x00, ord(c))
+stest.expect_equal(open(out).read(), "")
+access(0x00, ord("\n"))
+stest.expect_equal(open(out).read(), "hello\n")
+stest.expect_equal(uart.tx_count, 6)
+uart.tx_file = None
+
+# empty receive FIFO
+access(0x0C, 1)
+stest.expect_equal(access(0x04) >> 31, 1)
+
+# received characters raise the watermark interrupt
+access(0x10, IE_RXWM)
+uart.rx_input = "ok"
+stest.expect_equal(cpu.iface.int_register.read(mip) & MIP_MEIP, MIP_MEIP)
+stest.expect_equal(access(0x04), ord("o"))
+stest.expect_equal(access(0x04), ord("k"))
+stest.expect_equal(access(0x04) >> 31, 1)
+stest.expect_equal(cpu.iface.int_register.read(mip) & MIP_MEIP, 0)
+stest.expect_equal(uart.rx_count, 2)
+
+# the input file is polled from a cycle event, the guest doesn't have to read rxdata
+rx = os.path.join(tempfile.mkdtemp(), "uart.in")
+with open(rx, "w") as f:
+    f.write("hi")
+machine = riscv_cpu_common.create_machine("uart_machine")
+riscv_cpu_common.load(machine, riscv_cpu_common.RAM_BASE, [riscv_cpu_common.jal(riscv_cpu_common.ZERO, 0)])
+polled = riscv_cpu_common.create_riscv_uart("polled_uart", cpu = machine)
+polled.rx_poll_interval = 100
+polled.rxctrl = 1
+polled.ie = IE_RXWM
+polled.rx_file = rx
+riscv_cpu_common.run(machine, 50)
+stest.expect_equal(riscv_cpu_common.read_reg(machine, "mip") & MIP_MEIP, 0)
+riscv_cpu_common.run(machine, 100)
+stest.expect_equal(riscv_cpu_common.read_reg(machine, "mip") & MIP_MEIP, MIP_MEIP)
+stest.expect_equal(polled.rx_input, "hi")
+stest.expect_equal(polled.rx_count, 0)
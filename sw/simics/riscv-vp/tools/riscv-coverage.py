@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+Tools for the drcov coverage files written by the riscv_cpu save-coverage command.
+
+Usage: riscv-coverage.py merge <drcov>... -o merged.drcov
+    Merge the coverage of many runs, an instruction is covered if any run executed it.
+Usage: riscv-coverage.py lcov --elf app.elf [--addr2line <tool>] <drcov>... -o app.info
+    Convert the coverage of the ELF file to the lcov tracefile (genhtml), the source lines
+    are resolved from the DWARF line info with addr2line, the hit count of a line is the
+    number of runs which executed it.
+"""
+import argparse
+import os
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+                                "modules", "riscv-cpu"))
+import riscv_elf
+
+BLOCK = struct.Struct("<IHH")
+UNKNOWN_MODULE = "[unknown]"
+
+class CoverageError(Exception):
+    pass
+
+def read_drcov(path):
+    """
+    Return {module path: (base, {executed instruction offsets})} of a drcov file, the files
+    of DynamoRIO are accepted as well.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    pos = 0
+    def line():
+        nonlocal pos
+        end = data.index(b"\n", pos)
+        text = data[pos:end].decode().rstrip("\r")
+        pos = end + 1
+        return text
+    if not line().startswith("DRCOV VERSION: 2"):
+        raise CoverageError("not a drcov version 2 file")
+    header = line()
+    while not header.startswith("Module Table:"):
+        header = line()
+    count = int(header.rsplit("count", 1)[1])
+    columns = [name.strip() for name in line().split(":", 1)[1].split(",")]
+    base_column = columns.index("base" if "base" in columns else "start")
+    path_column = columns.index("path")
+    modules = []
+    for _ in range(count):
+        fields = [field.strip() for field in line().split(",", len(columns) - 1)]
+        modules.append((int(fields[base_column], 16), fields[path_column]))
+    header = line()
+    if not header.startswith("BB Table:"):
+        raise CoverageError("missing BB table")
+    blocks = int(header.split()[2])
+    coverage = {}
+    for (start, size, module) in BLOCK.iter_unpack(data[pos:pos + blocks * BLOCK.size]):
+        (base, module_path) = modules[module]
+        offsets = coverage.setdefault(module_path, (base, set()))[1]
+        offsets.update(range(start, start + size, 4))
+    return coverage
+
+def merge_coverage(runs):
+    """Return the union of the coverage of the runs, see read_drcov."""
+    merged = {}
+    for coverage in runs:
+        for (module_path, (base, offsets)) in coverage.items():
+            merged.setdefault(module_path, (base, set()))[1].update(offsets)
+    return merged
+
+def write_drcov(path, coverage):
+    modules = sorted(coverage.items(), key = lambda module: module[1][0])
+    header = ["DRCOV VERSION: 2", "DRCOV FLAVOR: riscv-cpu",
+              f"Module Table: version 2, count {len(modules)}",
+              "Columns: id, base, end, entry, checksum, timestamp, path"]
+    blocks = []
+    for (i, (module_path, (base, offsets))) in enumerate(modules):
+        end = base + max(offsets, default = 0) + 4
+        header.append(f"{i}, {base:#x}, {end:#x}, 0x0, 0x0, 0x0, {module_path}")
+        start = None
+        for offset in sorted(offsets):
+            # the runs of instructions are split to fit the 16-bit size of a block
+            if start is None or offset != last + 4 or offset - start >= 0xfffc:
+                if start is not None:
+                    blocks.append(BLOCK.pack(start, last + 4 - start, i))
+                start = offset
+            last = offset
+        if start is not None:
+            blocks.append(BLOCK.pack(start, last + 4 - start, i))
+    header.append(f"BB Table: {len(blocks)} bbs")
+    with open(path, "wb") as f:
+        f.write(("\n".join(header) + "\n").encode())
+        f.write(b"".join(blocks))
+
+def elf_code(path):
+    """
+    Return (link address of the first executable segment, [(start, end)] of the executable
+    sections) of an ELF32/ELF64 file.
+    """
+    try:
+        elf = riscv_elf.Elf(path)
+    except riscv_elf.ElfError as e:
+        raise CoverageError(str(e))
+    bases = [start for (start, _) in elf.code_segments()]
+    if not bases:
+        raise CoverageError(f"{path}: no executable segment")
+    return (min(bases), elf.code_sections())
+
+def source_lines(elf, addresses, addr2line):
+    """Return the (file, line) of every address, None if it has no line info."""
+    text = "".join(f"{address:#x}\n" for address in addresses)
+    result = subprocess.run([addr2line, "-e", elf], input = text, capture_output = True,
+                            text = True, check = True)
+    lines = []
+    for location in result.stdout.splitlines():
+        (path, _, number) = location.split(" ")[0].rpartition(":")
+        lines.append((path, int(number)) if path != "??" and number.isdigit() and number != "0" else None)
+    if len(lines) != len(addresses):
+        raise CoverageError(f"unexpected output of {addr2line}")
+    return lines
+
+def find_module(coverage, elf):
+    name = os.path.basename(elf)
+    for (module_path, module) in coverage.items():
+        if os.path.basename(module_path) == name:
+            return module
+    known = [module for (module_path, module) in coverage.items() if module_path != UNKNOWN_MODULE]
+    return known[0] if len(known) == 1 else None
+
+def merge(args):
+    write_drcov(args.output, merge_coverage(read_drcov(path) for path in args.drcov))
+
+def lcov(args):
+    (link_base, sections) = elf_code(args.elf)
+    addresses = [address for (start, end) in sections for address in range(start & ~3, end, 4)]
+    lines = source_lines(args.elf, addresses, args.addr2line)
+    hits = {}
+    for location in lines:
+        if location is not None:
+            hits.setdefault(location[0], {}).setdefault(location[1], 0)
+    for path in args.drcov:
+        module = find_module(read_drcov(path), args.elf)
+        if module is None:
+            raise CoverageError(f"{path}: no module of {args.elf}")
+        executed = {link_base + offset for offset in module[1]}
+        # a line counts once per run, however many of its instructions were executed
+        covered = {location for (address, location) in zip(addresses, lines)
+                   if location is not None and address in executed}
+        for (source, number) in covered:
+            hits[source][number] += 1
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        out.write("TN:\n")
+        for source in sorted(hits):
+            out.write(f"SF:{source}\n")
+            for (number, count) in sorted(hits[source].items()):
+                out.write(f"DA:{number},{count}\n")
+            out.write(f"LH:{sum(1 for count in hits[source].values() if count)}\n")
+            out.write(f"LF:{len(hits[source])}\n")
+            out.write("end_of_record\n")
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+def main():
+    parser = argparse.ArgumentParser(description = "riscv_cpu coverage tools")
+    commands = parser.add_subparsers(dest = "command", required = True)
+    p = commands.add_parser("merge", help = "merge the coverage of many runs")
+    p.add_argument("drcov", nargs = "+", help = "the drcov files")
+    p.add_argument("-o", "--output", required = True, help = "the merged drcov file")
+    p.set_defaults(func = merge)
+    p = commands.add_parser("lcov", help = "convert the coverage to the lcov tracefile")
+    p.add_argument("drcov", nargs = "+", help = "the drcov files")
+    p.add_argument("--elf", required = True, help = "the program with the DWARF line info")
+    p.add_argument("--addr2line", default = "riscv32-unknown-elf-addr2line",
+                   help = "addr2line of the RISC-V toolchain")
+    p.add_argument("-o", "--output", help = "output file, stdout by default")
+    p.set_defaults(func = lcov)
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except (CoverageError, OSError, subprocess.CalledProcessError) as e:
+        sys.exit(f"riscv-coverage: {e}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Estimate the CPI of a workload from its SimPoint intervals simulated in parallel.
+
+Usage: riscv-simpoint.py --simics <project>/simics --simpoints app.simpoints
+           --weights app.weights [--interval 10000000] [--warmup 1000000] [-j N]
+           [--cost-preset fde_ip] [--icache 32768,8,64,plru,false]
+           [--dcache 32768,8,64,plru,true] [--branch-predictor gshare,4096,12,512,16] <elf>
+
+A single functional pass writes a checkpoint at the start of the warm-up window of every
+chosen interval, then the intervals are simulated in the timing mode by independent Simics
+processes (up to N at once) and their CPI is merged with the SimPoint weights.
+"""
+import argparse
+import concurrent.futures
+import json
+import os
+import subprocess
+import sys
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+TARGET_SCRIPT = os.path.join(os.path.dirname(TOOLS_DIR), "riscv-vp.simics")
+PROBE_SCRIPT = os.path.join(TOOLS_DIR, "simics-simpoint.py")
+RESULT_TAG = "SIMPOINT-RESULT "
+
+sys.path.insert(0, os.path.join(os.path.dirname(TOOLS_DIR), "modules", "riscv-cpu"))
+import riscv_elf
+
+def read_simpoints(simpoints, weights):
+    """
+    Return [(interval, weight)] of the SimPoint .simpoints and .weights files, both have
+    "<value> <cluster>" lines.
+    """
+    def read(path, convert):
+        with open(path) as f:
+            return {int(cluster): convert(value) for (value, cluster) in map(str.split, f) if value}
+    intervals = read(simpoints, int)
+    weights = read(weights, float)
+    return sorted((intervals[cluster], weights[cluster]) for cluster in intervals)
+
+def timing_value(value):
+    """
+    Convert the comma separated cache or branch predictor value of the command line (the
+    format of the riscv-vp.simics parameters) to the attribute value, None if empty.
+    """
+    if not value:
+        return None
+    return [int(v) if v.isdigit() else (v == "true") if v in ("true", "false") else v for v in value.split(",")]
+
+def run_simics(args, commands, job, job_file):
+    with open(job_file, "w") as f:
+        json.dump(job, f)
+    cmd = [args.simics, "-batch-mode"]
+    for command in commands + [f'$simpoint_job = "{job_file}"', f'run-python-file "{PROBE_SCRIPT}"']:
+        cmd += ["-e", command.replace("\\", "/")]
+    proc = subprocess.run(cmd, capture_output = True, text = True, timeout = args.timeout)
+    for line in proc.stdout.splitlines():
+        if line.startswith(RESULT_TAG):
+            return json.loads(line[len(RESULT_TAG):])
+    sys.stderr.write(proc.stdout + proc.stderr)
+    raise RuntimeError(f"{job_file}: Simics didn't report the result (exit code {proc.returncode})")
+
+def main():
+    parser = argparse.ArgumentParser(description = __doc__.strip().splitlines()[0])
+    parser.add_argument("--simics", required = True, help = "Simics launcher of the project with the riscv-cpu module")
+    parser.add_argument("--simpoints", required = True, help = "SimPoint .simpoints file")
+    parser.add_argument("--weights", required = True, help = "SimPoint .weights file")
+    parser.add_argument("--interval", type = int, default = 10000000, help = "length of the BBV intervals in instructions")
+    parser.add_argument("--warmup", type = int, default = 1000000, help = "warm-up window before every interval in instructions")
+    parser.add_argument("-j", "--jobs", type = int, default = os.cpu_count(), help = "number of the parallel simulations")
+    parser.add_argument("--workdir", default = "simpoint", help = "directory of the checkpoints and job files")
+    parser.add_argument("--output", default = "simpoint.json", help = "JSON report file")
+    parser.add_argument("--timeout", type = int, default = 3600, help = "timeout of a single simulation in seconds")
+    parser.add_argument("--cost-preset", default = "default", help = "latency table preset of the timing mode")
+    parser.add_argument("--icache", default = "", help = "instruction cache: size,ways,line,replacement,write-back")
+    parser.add_argument("--dcache", default = "", help = "data cache: size,ways,line,replacement,write-back")
+    parser.add_argument("--branch-predictor", default = "", help = "branch predictor: predictor,PHT,history,BTB,RAS")
+    parser.add_argument("elf", help = "workload ELF file")
+    args = parser.parse_args()
+
+    symbols = riscv_elf.Elf(args.elf).addresses(("tohost", "fromhost"))
+    target = [
+        f'$elf_file = "{os.path.abspath(args.elf)}"',
+        "$load_offset = 0",
+        f"$tohost = {symbols.get('tohost', 0):#x}",
+        f"$fromhost = {symbols.get('fromhost', 0):#x}",
+        f'$cost_preset = "{args.cost_preset}"',
+        f'$icache = "{args.icache}"',
+        f'$dcache = "{args.dcache}"',
+        f'$branch_predictor = "{args.branch_predictor}"',
+        f'run-command-file "{TARGET_SCRIPT}"',
+    ]
+    timing = {
+        "cost_preset": args.cost_preset,
+        "icache": timing_value(args.icache),
+        "dcache": timing_value(args.dcache),
+        "branch_predictor": timing_value(args.branch_predictor),
+    }
+    os.makedirs(args.workdir, exist_ok = True)
+    workdir = os.path.abspath(args.workdir)
+    points = read_simpoints(args.simpoints, args.weights)
+
+    # functional pass, the checkpoints are written in the order of the intervals
+    starts = {}
+    for (interval, _) in points:
+        starts[interval] = max(interval * args.interval - args.warmup, 0)
+    checkpoints = [[starts[i], os.path.join(workdir, f"interval-{i}.ckpt")] for i in sorted(starts)]
+    snapshot = run_simics(args, target, {"action": "snapshot", "checkpoints": checkpoints},
+        os.path.join(workdir, "snapshot.json"))
+    print(f"functional pass: {len(snapshot['checkpoints'])} checkpoints in {snapshot['host_seconds']:.1f} s")
+
+    # timing pass, every interval is simulated from its checkpoint by a separate process
+    def measure(point):
+        (interval, weight) = point
+        path = os.path.join(workdir, f"interval-{interval}.ckpt")
+        job = {
+            "action": "measure",
+            "warmup": interval * args.interval - starts[interval],
+            "interval": args.interval,
+            "timing": timing,
+        }
+        result = run_simics(args, [f'read-configuration "{path}"'], job,
+            os.path.join(workdir, f"interval-{interval}.json"))
+        result.update({"interval": interval, "weight": weight})
+        result["cpi"] = result["cycles"] / result["instructions"] if result["instructions"] else None
+        return result
+    written = set(snapshot["checkpoints"])
+    points = [p for p in points if os.path.join(workdir, f"interval-{p[0]}.ckpt") in written]
+    with concurrent.futures.ThreadPoolExecutor(max_workers = max(args.jobs, 1)) as pool:
+        results = list(pool.map(measure, points))
+    for result in results:
+        print(f"interval {result['interval']:8} weight={result['weight']:.4f} "
+              f"instr={result['instructions']} cpi={result['cpi'] or 0:.3f}")
+
+    # the weights of the intervals which weren't reached are left out
+    measured = [r for r in results if r["cpi"] is not None]
+    total_weight = sum(r["weight"] for r in measured)
+    cpi = sum(r["weight"] * r["cpi"] for r in measured) / total_weight if total_weight else None
+    report = {
+        "elf": args.elf,
+        "interval": args.interval,
+        "warmup": args.warmup,
+        "timing": timing,
+        "results": results,
+        "summary": {
+            "intervals": len(measured),
+            "weight": total_weight,
+            "cpi": cpi,
+            "host_seconds": snapshot["host_seconds"] + sum(r["host_seconds"] for r in results),
+        },
+    }
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent = 2)
+    print(f"weighted CPI: {cpi or 0:.4f} ({len(measured)} intervals, weight {total_weight:.4f})")
+    return 0 if measured else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Tools for the binary instruction traces written by the riscv_cpu trace_file attribute.
+
+Usage: riscv-trace.py decode <trace> [-o commits.log]
+    Render the Spike compatible commit log (spike --log-commits) of the trace.
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+FILE_MAGIC = b"RVTRACE\0"
+FILE_HEADER = struct.Struct("<8sHHI")
+CHUNK_MAGIC = 0x43545652
+CHUNK_HEADER = struct.Struct("<IIII")
+FLAG_COMPRESSED = 1
+
+REC_PC = 0x01
+REC_RD = 0x02
+REC_MEM = 0x04
+REC_STORE = 0x08
+REC_PRIV_SHIFT = 4
+
+STORE_OPCODE = 0b0100011
+
+class TraceError(Exception):
+    pass
+
+def read_header(data):
+    """Return (xlen, flags) of the trace in the buffer."""
+    if len(data) < FILE_HEADER.size:
+        raise TraceError("truncated file header")
+    (magic, version, xlen, flags) = FILE_HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC or version != 1:
+        raise TraceError("not a riscv_cpu trace file")
+    return (xlen, flags)
+
+def iter_chunks(data):
+    """Yield (offset, stored size, raw size, records) of every chunk, the chunk data starts
+    at the offset. A truncated chunk at the end (trace still being written) is skipped."""
+    offset = FILE_HEADER.size
+    while offset + CHUNK_HEADER.size <= len(data):
+        (magic, stored, raw, records) = CHUNK_HEADER.unpack_from(data, offset)
+        if magic != CHUNK_MAGIC:
+            raise TraceError(f"bad chunk magic at offset {offset:#x}")
+        offset += CHUNK_HEADER.size
+        if offset + stored > len(data):
+            break
+        yield (offset, stored, raw, records)
+        offset += stored
+
+def chunk_data(data, flags, offset, stored):
+    raw = data[offset:offset + stored]
+    return zlib.decompress(raw) if flags & FLAG_COMPRESSED else bytes(raw)
+
+def _varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if byte < 0x80:
+            return (value, pos)
+        shift += 7
+
+def _unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+def decode_chunk(buf, xlen):
+    """Yield (pc, priv, instr, rd, rd_val, addr, store_val) of every record of the chunk,
+    the optional fields are None if not present."""
+    mask = (1 << xlen) - 1
+    next_pc = 0
+    last_addr = 0
+    pos = 0
+    end = len(buf)
+    while pos < end:
+        header = buf[pos]
+        pos += 1
+        pc = next_pc
+        if header & REC_PC:
+            (delta, pos) = _varint(buf, pos)
+            pc = (next_pc + _unzigzag(delta)) & 0xffffffffffffffff
+        instr = int.from_bytes(buf[pos:pos + 4], "little")
+        pos += 4
+        rd = rd_val = addr = store_val = None
+        if header & REC_RD:
+            rd = buf[pos]
+            (rd_val, pos) = _varint(buf, pos + 1)
+        if header & REC_MEM:
+            (delta, pos) = _varint(buf, pos)
+            addr = (last_addr + _unzigzag(delta)) & 0xffffffffffffffff
+            last_addr = addr
+        if header & REC_STORE:
+            (store_val, pos) = _varint(buf, pos)
+        next_pc = pc + 4
+        yield (pc & mask, (header >> REC_PRIV_SHIFT) & 3, instr, rd, rd_val, addr, store_val)
+
+def iter_records(data):
+    (xlen, flags) = read_header(data)
+    for (offset, stored, _, _) in iter_chunks(data):
+        yield from decode_chunk(chunk_data(data, flags, offset, stored), xlen)
+
+def format_commit(xlen, record):
+    """Format the record the way Spike logs a committed instruction."""
+    (pc, priv, instr, rd, rd_val, addr, store_val) = record
+    digits = xlen // 4
+    line = f"core   0: {priv} 0x{pc:0{digits}x} (0x{instr:08x})"
+    if rd is not None:
+        line += f" x{rd:<2d} 0x{rd_val:0{digits}x}"
+    if addr is not None:
+        line += f" mem 0x{addr:0{digits}x}"
+        if store_val is not None and (instr & 0x7f) == STORE_OPCODE:
+            size = 1 << ((instr >> 12) & 0b11)
+            line += f" 0x{store_val:0{2 * size}x}"
+    return line
+
+def decode(args):
+    with open(args.trace, "rb") as f:
+        data = f.read()
+    (xlen, _) = read_header(data)
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        for record in iter_records(data):
+            out.write(format_commit(xlen, record) + "\n")
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+def main():
+    parser = argparse.ArgumentParser(description = "riscv_cpu binary trace tools")
+    commands = parser.add_subparsers(dest = "command", required = True)
+    p = commands.add_parser("decode", help = "render the Spike commit log of the trace")
+    p.add_argument("trace", help = "the trace file")
+    p.add_argument("-o", "--output", help = "output file, stdout by default")
+    p.set_defaults(func = decode)
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except TraceError as e:
+        sys.exit(f"{args.trace}: {e}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+# Executed inside Simics by riscv-simpoint.py (run-python-file), the job file named by the
+# $simpoint_job variable selects the action:
+#   snapshot - run the workload functionally and write a checkpoint at every given step,
+#   measure  - set the timing models up, warm them up and measure a single interval in the
+#              timing mode,
+# the outcome is printed as a single JSON line.
+import json
+import time
+import conf
+import simics
+
+# timing model attributes of the measure job, the caches and the branch predictor are
+# attribute values, None detaches them
+TIMING_ATTRS = ("cost_preset", "icache", "dcache", "branch_predictor")
+
+def snapshot(cpu, job):
+    cpu.mode = "functional"
+    written = []
+    for (step, path) in job["checkpoints"]:
+        if step > cpu.steps:
+            simics.SIM_continue(step - cpu.steps)
+        if cpu.exit_code is not None or cpu.steps < step:
+            # the workload has exited before the interval
+            break
+        simics.SIM_write_configuration_to_file(path, 0)
+        written.append(path)
+    return {"checkpoints": written}
+
+def measure(cpu, job):
+    # the checkpoint holds the configuration of the functional pass, the timing models of the
+    # study replace it, setting a cache geometry starts it cold
+    for (name, value) in job.get("timing", {}).items():
+        if name in TIMING_ATTRS:
+            setattr(cpu, name, value)
+    # the warm-up window precedes the measured interval, the statistics cover the latter only
+    cpu.timing_stats = []
+    cpu.mode_schedule = [[cpu.steps + job["warmup"], "timing"]]
+    cpu.mode = "warmup" if job["warmup"] else "timing"
+    simics.SIM_continue(job["warmup"] + job["interval"])
+    cpu.mode = "functional"
+    (windows, instructions, cycles) = cpu.timing_stats
+    return {"instructions": instructions, "cycles": cycles}
+
+if __name__ == "__main__":
+    from cli import simenv
+    with open(simenv.simpoint_job) as f:
+        job = json.load(f)
+    start = time.perf_counter()
+    action = snapshot if job["action"] == "snapshot" else measure
+    result = action(conf.rcpu, job)
+    result["host_seconds"] = time.perf_counter() - start
+    print("SIMPOINT-RESULT " + json.dumps(result), flush = True)
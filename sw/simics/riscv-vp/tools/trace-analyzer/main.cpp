@@ -0,0 +1,74 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "trace-reader.hpp"
+#include "trace-analyzer.hpp"
+
+using namespace kz::riscv::tools;
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s [-j threads] [-l line_bytes] [-n top] <trace>\n"
+        "Analyze the binary instruction trace of riscv_cpu: instruction mix, hot PCs,\n"
+        "conditional branch outcomes and memory reuse distance.\n"
+        "  -j  number of threads, all host cores by default\n"
+        "  -l  line size in bytes for the reuse distance, power of 2, 64 by default\n"
+        "  -n  number of entries of the top lists, 20 by default\n", name);
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = std::thread::hardware_concurrency();
+    unsigned line_bytes = 64;
+    unsigned top = 20;
+    int opt;
+    while ((opt = getopt(argc, argv, "j:l:n:h")) != -1) {
+        switch (opt) {
+            case 'j': threads = static_cast<unsigned>(strtoul(optarg, nullptr, 0)); break;
+            case 'l': line_bytes = static_cast<unsigned>(strtoul(optarg, nullptr, 0)); break;
+            case 'n': top = static_cast<unsigned>(strtoul(optarg, nullptr, 0)); break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind + 1 != argc || line_bytes == 0 || (line_bytes & (line_bytes - 1)) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    unsigned line_shift = 0;
+    while ((1u << line_shift) < line_bytes) {
+        line_shift++;
+    }
+    TraceFile trace;
+    std::string error;
+    if (!trace.open(argv[optind], &error)) {
+        fprintf(stderr, "%s: %s\n", argv[optind], error.c_str());
+        return 1;
+    }
+    TraceAnalyzer analyzer(trace, line_shift);
+    if (!analyzer.run(threads > 0 ? threads : 1)) {
+        fprintf(stderr, "%s: corrupted chunks were skipped\n", argv[optind]);
+    }
+    analyzer.report(stdout, top);
+    return 0;
+}
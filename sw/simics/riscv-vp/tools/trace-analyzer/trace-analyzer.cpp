@@ -0,0 +1,373 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "riscv-cpu-types.hpp"
+#include "riscv-cpu-decode.hpp"
+#include "riscv-cpu-disasm.hpp"
+#include "trace-analyzer.hpp"
+
+namespace kz::riscv::tools {
+    using tracer_t = kz::riscv::core::RiscvCpuTracer;
+    using decoder_t = kz::riscv::core::RiscvCpuDecoder;
+    using disasm_t = kz::riscv::core::RiscvCpuDisasm;
+    using dec_instr_t = kz::riscv::types::dec_instr_t;
+
+    static constexpr uint32_t BRANCH_OPCODE = 0b1100011;
+    static constexpr size_t INITIAL_MARKS = 1 << 16;
+
+    TraceStats::TraceStats(): instructions(0), mem_accesses(0), cold_accesses(0) {
+        reuse.fill(0);
+    }
+
+    void TraceStats::add_reuse(uint64_t distance) {
+        unsigned bucket = 0;
+        while (distance != 0 && bucket < REUSE_BUCKETS - 1) {
+            distance >>= 1;
+            bucket++;
+        }
+        reuse[bucket]++;
+    }
+
+    void TraceStats::merge(const TraceStats &other) {
+        instructions += other.instructions;
+        mem_accesses += other.mem_accesses;
+        cold_accesses += other.cold_accesses;
+        for (const auto &[word, executions] : other.instr_words) {
+            instr_words[word] += executions;
+        }
+        for (const auto &[pc, stats] : other.pcs) {
+            pc_stats_t &merged = pcs[pc];
+            merged.executions += stats.executions;
+            merged.instr = stats.instr;
+        }
+        for (const auto &[pc, stats] : other.branches) {
+            branch_stats_t &merged = branches[pc];
+            merged.taken += stats.taken;
+            merged.not_taken += stats.not_taken;
+        }
+        for (unsigned i = 0; i < REUSE_BUCKETS; ++i) {
+            reuse[i] += other.reuse[i];
+        }
+    }
+
+    TraceAnalyzer::TraceAnalyzer(const TraceFile &trace, unsigned line_shift):
+        trace_(trace), line_shift_(line_shift), next_chunk_(0), merged_chunks_(0), valid_(true),
+        pending_branch_(false), pending_branch_pc_(0), marks_(INITIAL_MARKS), now_(0) {}
+
+    bool TraceAnalyzer::run(unsigned threads) {
+        const auto &chunks = trace_.get_chunks();
+        std::vector<trace_stats_t> thread_stats(threads);
+        std::vector<std::thread> pool;
+        for (unsigned i = 0; i < threads; ++i) {
+            pool.emplace_back(&TraceAnalyzer::worker_, this, &thread_stats[i]);
+        }
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            std::unique_ptr<chunk_summary_t> summary;
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                cond_.wait(guard, [&] { return pending_.count(i) != 0; });
+                summary = std::move(pending_[i]);
+                pending_.erase(i);
+            }
+            merge_summary_(*summary);
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                merged_chunks_++;
+            }
+            cond_.notify_all();
+        }
+        for (auto &thread : pool) {
+            thread.join();
+        }
+        for (const auto &stats : thread_stats) {
+            stats_.merge(stats);
+        }
+        return valid_;
+    }
+
+    void TraceAnalyzer::worker_(trace_stats_t *stats) {
+        const auto &chunks = trace_.get_chunks();
+        std::vector<uint8_t> buf;
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                cond_.wait(guard, [&] {
+                    return next_chunk_ >= chunks.size() || next_chunk_ < merged_chunks_ + MERGE_WINDOW;
+                });
+                if (next_chunk_ >= chunks.size()) {
+                    return;
+                }
+                index = next_chunk_++;
+            }
+            auto summary = std::make_unique<chunk_summary_t>();
+            analyze_chunk_(chunks[index], &buf, stats, summary.get());
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                pending_.emplace(index, std::move(summary));
+            }
+            cond_.notify_all();
+        }
+    }
+
+    void TraceAnalyzer::analyze_chunk_(const trace_chunk_t &chunk, std::vector<uint8_t> *buf,
+        trace_stats_t *stats, chunk_summary_t *summary) const {
+        summary->valid = false;
+        summary->empty = true;
+        summary->ends_with_branch = false;
+        const uint8_t *data = trace_.read_chunk(chunk, buf);
+        if (data == nullptr) {
+            return;
+        }
+        TraceRecordDecoder decoder(data, chunk.raw_size, trace_.get_xlen());
+        // reuse distances of the accesses with the previous access in the chunk, the times
+        // are the indices of the memory accesses
+        AccessMarks marks(chunk.records);
+        std::unordered_map<uint64_t, size_t> line_times;
+        size_t time = 0;
+        uint32_t records = 0;
+        bool branch = false;
+        uint64_t branch_pc = 0;
+        trace_record_t rec;
+        while (decoder.next(&rec)) {
+            if (records++ == 0) {
+                summary->first_pc = rec.pc;
+            }
+            // the outcome of a branch is known from the next instruction
+            if (branch) {
+                branch_stats_t &outcome = stats->branches[branch_pc];
+                if (rec.pc != branch_pc + 4) {
+                    outcome.taken++;
+                } else {
+                    outcome.not_taken++;
+                }
+            }
+            stats->instructions++;
+            stats->instr_words[rec.instr]++;
+            pc_stats_t &pc = stats->pcs[rec.pc];
+            pc.executions++;
+            pc.instr = rec.instr;
+            if (rec.flags & tracer_t::REC_MEM) {
+                stats->mem_accesses++;
+                uint64_t line = rec.addr >> line_shift_;
+                time++;
+                auto [it, inserted] = line_times.try_emplace(line, time);
+                if (inserted) {
+                    summary->first_lines.push_back(line);
+                } else {
+                    stats->add_reuse(marks.prefix(time - 1) - marks.prefix(it->second));
+                    marks.add(it->second, -1);
+                    it->second = time;
+                }
+                marks.add(time, 1);
+            }
+            branch = (rec.instr & 0x7f) == BRANCH_OPCODE;
+            branch_pc = rec.pc;
+        }
+        summary->valid = (records == chunk.records);
+        summary->empty = (records == 0);
+        summary->ends_with_branch = branch;
+        summary->last_pc = branch_pc;
+        std::vector<std::pair<size_t, uint64_t>> order;
+        order.reserve(line_times.size());
+        for (const auto &[line, last] : line_times) {
+            order.emplace_back(last, line);
+        }
+        std::sort(order.begin(), order.end());
+        summary->last_lines.reserve(order.size());
+        for (const auto &entry : order) {
+            summary->last_lines.push_back(entry.second);
+        }
+    }
+
+    void TraceAnalyzer::mark_line_(uint64_t line) {
+        if (now_ == marks_.size()) {
+            // out of times, renumber the marks, only the order of the last accesses matters
+            std::vector<std::pair<size_t, uint64_t>> order;
+            order.reserve(line_times_.size());
+            for (const auto &[marked, time] : line_times_) {
+                order.emplace_back(time, marked);
+            }
+            std::sort(order.begin(), order.end());
+            marks_ = AccessMarks(std::max(order.size() * 2, INITIAL_MARKS));
+            now_ = 0;
+            for (const auto &entry : order) {
+                line_times_[entry.second] = ++now_;
+                marks_.add(now_, 1);
+            }
+        }
+        auto [it, inserted] = line_times_.try_emplace(line, 0);
+        if (!inserted) {
+            marks_.add(it->second, -1);
+        }
+        it->second = ++now_;
+        marks_.add(now_, 1);
+    }
+
+    void TraceAnalyzer::merge_summary_(const chunk_summary_t &summary) {
+        if (!summary.valid) {
+            valid_ = false;
+        }
+        if (summary.empty) {
+            return;
+        }
+        if (pending_branch_) {
+            branch_stats_t &outcome = stats_.branches[pending_branch_pc_];
+            if (summary.first_pc != pending_branch_pc_ + 4) {
+                outcome.taken++;
+            } else {
+                outcome.not_taken++;
+            }
+        }
+        pending_branch_ = summary.ends_with_branch;
+        pending_branch_pc_ = summary.last_pc;
+        // the first accesses of the chunk continue the global history, the lines accessed
+        // before in the chunk are already marked, so they are counted as well
+        for (uint64_t line : summary.first_lines) {
+            auto it = line_times_.find(line);
+            if (it != line_times_.end()) {
+                stats_.add_reuse(marks_.prefix(now_) - marks_.prefix(it->second));
+            } else {
+                stats_.cold_accesses++;
+            }
+            mark_line_(line);
+        }
+        // and the order of the last accesses is the one of the end of the chunk
+        for (uint64_t line : summary.last_lines) {
+            mark_line_(line);
+        }
+    }
+
+    static const char *get_format(const dec_instr_t &dec_instr) {
+        static constexpr const char *formats[] = {"other", "R", "I", "S", "B", "U", "J", "other"};
+        return formats[static_cast<unsigned>(dec_instr.type)];
+    }
+
+    static double percent(uint64_t part, uint64_t total) {
+        return total != 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+    }
+
+    void TraceAnalyzer::report(FILE *out, unsigned top) const {
+        uint64_t total = stats_.instructions;
+        fprintf(out, "Instructions: %llu in %zu chunks (RV%u)\n",
+            static_cast<unsigned long long>(total), trace_.get_chunks().size(), trace_.get_xlen());
+
+        // instruction mix, the distinct instruction words are decoded once
+        std::map<uint32_t, std::pair<dec_instr_t, uint64_t>> ops;
+        for (const auto &[word, executions] : stats_.instr_words) {
+            dec_instr_t dec_instr;
+            decoder_t::decode(word, &dec_instr);
+            auto &op = ops.try_emplace(decoder_t::get_op_key(dec_instr), dec_instr, 0).first->second;
+            op.second += executions;
+        }
+        std::vector<std::pair<uint64_t, std::string>> mix;
+        std::map<std::string, uint64_t> formats;
+        for (const auto &[key, op] : ops) {
+            mix.emplace_back(op.second, disasm_t::get_op_name(op.first) + " (" + get_format(op.first) + ")");
+            formats[get_format(op.first)] += op.second;
+        }
+        std::sort(mix.begin(), mix.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+        fprintf(out, "\nInstruction mix:\n");
+        for (size_t i = 0; i < mix.size() && i < top; ++i) {
+            fprintf(out, "  %-24s %16llu %7.2f%%\n", mix[i].second.c_str(),
+                static_cast<unsigned long long>(mix[i].first), percent(mix[i].first, total));
+        }
+        fprintf(out, "\nInstruction formats:\n");
+        for (const char *format : {"R", "I", "S", "B", "U", "J", "other"}) {
+            auto it = formats.find(format);
+            if (it != formats.end()) {
+                fprintf(out, "  %-24s %16llu %7.2f%%\n", format,
+                    static_cast<unsigned long long>(it->second), percent(it->second, total));
+            }
+        }
+
+        // the hottest instructions
+        std::vector<std::pair<uint64_t, const pc_stats_t *>> pcs;
+        pcs.reserve(stats_.pcs.size());
+        for (const auto &[pc, stats] : stats_.pcs) {
+            pcs.emplace_back(pc, &stats);
+        }
+        size_t hot = std::min<size_t>(top, pcs.size());
+        std::partial_sort(pcs.begin(), pcs.begin() + hot, pcs.end(), [](const auto &a, const auto &b) {
+            return a.second->executions != b.second->executions ?
+                a.second->executions > b.second->executions : a.first < b.first;
+        });
+        fprintf(out, "\nHot instructions (%zu distinct PCs):\n", pcs.size());
+        for (size_t i = 0; i < hot; ++i) {
+            dec_instr_t dec_instr;
+            decoder_t::decode(pcs[i].second->instr, &dec_instr);
+            fprintf(out, "  0x%016llx %16llu %7.2f%%  %s\n", static_cast<unsigned long long>(pcs[i].first),
+                static_cast<unsigned long long>(pcs[i].second->executions),
+                percent(pcs[i].second->executions, total),
+                disasm_t::disasm(pcs[i].first, dec_instr).c_str());
+        }
+
+        // conditional branches
+        uint64_t taken = 0;
+        uint64_t not_taken = 0;
+        std::vector<std::pair<uint64_t, const branch_stats_t *>> branches;
+        for (const auto &[pc, stats] : stats_.branches) {
+            taken += stats.taken;
+            not_taken += stats.not_taken;
+            branches.emplace_back(pc, &stats);
+        }
+        fprintf(out, "\nConditional branches: %llu, taken %llu (%.2f%%), not taken %llu (%.2f%%)\n",
+            static_cast<unsigned long long>(taken + not_taken),
+            static_cast<unsigned long long>(taken), percent(taken, taken + not_taken),
+            static_cast<unsigned long long>(not_taken), percent(not_taken, taken + not_taken));
+        size_t shown = std::min<size_t>(top, branches.size());
+        std::partial_sort(branches.begin(), branches.begin() + shown, branches.end(), [](const auto &a, const auto &b) {
+            uint64_t a_total = a.second->taken + a.second->not_taken;
+            uint64_t b_total = b.second->taken + b.second->not_taken;
+            return a_total != b_total ? a_total > b_total : a.first < b.first;
+        });
+        for (size_t i = 0; i < shown; ++i) {
+            uint64_t executions = branches[i].second->taken + branches[i].second->not_taken;
+            fprintf(out, "  0x%016llx %16llu taken %7.2f%%\n", static_cast<unsigned long long>(branches[i].first),
+                static_cast<unsigned long long>(executions), percent(branches[i].second->taken, executions));
+        }
+
+        // reuse distance, the number of distinct lines accessed since the previous access
+        fprintf(out, "\nMemory accesses: %llu, lines of %u bytes, first accesses %llu (%.2f%%)\n",
+            static_cast<unsigned long long>(stats_.mem_accesses), 1u << line_shift_,
+            static_cast<unsigned long long>(stats_.cold_accesses), percent(stats_.cold_accesses, stats_.mem_accesses));
+        fprintf(out, "Reuse distance:\n");
+        uint64_t cumulative = 0;
+        for (unsigned i = 0; i < trace_stats_t::REUSE_BUCKETS; ++i) {
+            if (stats_.reuse[i] == 0) {
+                continue;
+            }
+            cumulative += stats_.reuse[i];
+            uint64_t low = i == 0 ? 0 : 1ULL << (i - 1);
+            uint64_t high = i == 0 ? 0 : (1ULL << i) - 1;
+            std::string range = low == high ? std::to_string(low) : std::to_string(low) + "-" + std::to_string(high);
+            if (i == trace_stats_t::REUSE_BUCKETS - 1) {
+                range = std::to_string(low) + "+";
+            }
+            fprintf(out, "  %-24s %16llu %7.2f%% %7.2f%%\n", range.c_str(),
+                static_cast<unsigned long long>(stats_.reuse[i]),
+                percent(stats_.reuse[i], stats_.mem_accesses), percent(cumulative, stats_.mem_accesses));
+        }
+    }
+} /* ! kz::riscv::tools ! */
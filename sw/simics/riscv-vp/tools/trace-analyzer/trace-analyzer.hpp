@@ -0,0 +1,170 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "trace-reader.hpp"
+
+namespace kz::riscv::tools {
+    class BranchStats {
+    public:
+        uint64_t taken;
+        uint64_t not_taken;
+    };
+    using branch_stats_t = BranchStats;
+
+    class PcStats {
+    public:
+        uint64_t executions;
+        uint32_t instr;
+    };
+    using pc_stats_t = PcStats;
+
+    /**
+     * Results which don't depend on the order the chunks are analyzed in, every thread
+     * collects its own ones, they are merged at the end.
+     */
+    class TraceStats {
+    public:
+        // reuse distance buckets: 0, 1, 2-3, 4-7, ..., 2^30 and more
+        static constexpr unsigned REUSE_BUCKETS = 32;
+
+        TraceStats();
+        void merge(const TraceStats &other);
+        void add_reuse(uint64_t distance);
+
+        uint64_t instructions;
+        uint64_t mem_accesses;
+        uint64_t cold_accesses;                                 // first accesses to a line
+        std::unordered_map<uint32_t, uint64_t> instr_words;     // raw instruction word -> executions
+        std::unordered_map<uint64_t, pc_stats_t> pcs;
+        std::unordered_map<uint64_t, branch_stats_t> branches;  // conditional branches
+        std::array<uint64_t, REUSE_BUCKETS> reuse;
+    };
+    using trace_stats_t = TraceStats;
+
+    /**
+     * Results of a chunk, which have to be merged in the trace order: the accesses to the
+     * lines not accessed before in the chunk (their reuse distance depends on the previous
+     * chunks) and the branch at the end of the chunk (its outcome depends on the next one).
+     */
+    class ChunkSummary {
+    public:
+        bool valid;                         // false if the chunk is corrupted
+        bool empty;
+        uint64_t first_pc;
+        bool ends_with_branch;
+        uint64_t last_pc;
+        std::vector<uint64_t> first_lines;  // lines in the order of their first access
+        std::vector<uint64_t> last_lines;   // the same lines in the order of their last access
+    };
+    using chunk_summary_t = ChunkSummary;
+
+    /**
+     * Fenwick tree of the access marks, a line has a single mark at the time of its last
+     * access, so the number of marks after the previous access to a line is the number of
+     * distinct lines accessed since then (the reuse distance).
+     */
+    class AccessMarks {
+    public:
+        explicit AccessMarks(size_t size = 0) : tree_(size + 1, 0) {}
+        size_t size() const { return tree_.size() - 1; }
+        void add(size_t time, int delta) {
+            for (size_t i = time; i < tree_.size(); i += i & (~i + 1)) {
+                tree_[i] += delta;
+            }
+        }
+        // number of marks at the times [1, time]
+        uint64_t prefix(size_t time) const {
+            uint64_t sum = 0;
+            for (size_t i = time; i > 0; i -= i & (~i + 1)) {
+                sum += tree_[i];
+            }
+            return sum;
+        }
+    private:
+        std::vector<int64_t> tree_;
+    };
+
+    /**
+     * Parallel analysis of a trace: instruction mix, executions per PC, conditional branch
+     * outcomes and reuse distance of the memory lines. The chunks are analyzed by a pool of
+     * threads, the chunk summaries are merged in the trace order by the calling thread, while
+     * the threads work on the next chunks.
+     */
+    class TraceAnalyzer {
+    public:
+        // the threads can get this many chunks ahead of the merge, it limits the memory used
+        // by the pending summaries
+        static constexpr size_t MERGE_WINDOW = 256;
+
+        /**
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param trace [M][In] The opened trace file.
+         * @param line_shift [M][In] log2 of the line size used for the reuse distance.
+         */
+        TraceAnalyzer(const TraceFile &trace, unsigned line_shift);
+        /**
+         * Analyze the whole trace.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param threads [M][In] Number of the worker threads.
+         * @return false if a chunk is corrupted.
+         */
+        bool run(unsigned threads);
+        /**
+         * Print the report of the analysis.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param out [M][In] Output stream.
+         * @param top [M][In] Number of the entries of the top lists.
+         */
+        void report(FILE *out, unsigned top) const;
+    private:
+        void worker_(trace_stats_t *stats);
+        void analyze_chunk_(const trace_chunk_t &chunk, std::vector<uint8_t> *buf,
+            trace_stats_t *stats, chunk_summary_t *summary) const;
+        void merge_summary_(const chunk_summary_t &summary);
+        void mark_line_(uint64_t line);
+        const TraceFile &trace_;
+        unsigned line_shift_;
+        // work distribution and the ordered merge
+        std::mutex lock_;
+        std::condition_variable cond_;
+        size_t next_chunk_;
+        size_t merged_chunks_;
+        std::map<size_t, std::unique_ptr<chunk_summary_t>> pending_;
+        // state of the merge
+        bool valid_;
+        trace_stats_t stats_;
+        bool pending_branch_;
+        uint64_t pending_branch_pc_;
+        std::unordered_map<uint64_t, size_t> line_times_;
+        AccessMarks marks_;
+        size_t now_;
+    };
+} /* ! kz::riscv::tools ! */
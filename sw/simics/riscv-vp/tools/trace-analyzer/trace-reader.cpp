@@ -0,0 +1,172 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "trace-reader.hpp"
+
+namespace kz::riscv::tools {
+    using tracer_t = kz::riscv::core::RiscvCpuTracer;
+
+    static uint32_t get_u32(const uint8_t *p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    TraceFile::TraceFile(): map_(nullptr), size_(0), xlen_(0), compressed_(false) {}
+
+    TraceFile::~TraceFile() {
+        close_();
+    }
+
+    void TraceFile::close_() {
+        if (map_ != nullptr) {
+            munmap(map_, size_);
+            map_ = nullptr;
+        }
+        chunks_.clear();
+    }
+
+    bool TraceFile::open(const std::string &path, std::string *error) {
+        close_();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            *error = strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 16) {
+            *error = "not a trace file";
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void *map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            *error = strerror(errno);
+            return false;
+        }
+        map_ = static_cast<uint8_t *>(map);
+        // the threads take the chunks in the file order, so the reads are mostly sequential
+        madvise(map_, size_, MADV_SEQUENTIAL);
+        uint16_t version = map_[8] | (map_[9] << 8);
+        if (memcmp(map_, "RVTRACE", 8) != 0 || version != tracer_t::VERSION) {
+            *error = "not a trace file";
+            close_();
+            return false;
+        }
+        xlen_ = map_[10] | (map_[11] << 8);
+        compressed_ = (get_u32(map_ + 12) & tracer_t::FLAG_COMPRESSED) != 0;
+        size_t offset = 16;
+        while (offset + 16 <= size_) {
+            const uint8_t *header = map_ + offset;
+            if (get_u32(header) != tracer_t::CHUNK_MAGIC) {
+                *error = "corrupted chunk at offset " + std::to_string(offset);
+                close_();
+                return false;
+            }
+            trace_chunk_t chunk{header + 16, get_u32(header + 4), get_u32(header + 8), get_u32(header + 12)};
+            offset += 16;
+            if (offset + chunk.stored_size > size_) {
+                break; // the trace is still being written
+            }
+            chunks_.push_back(chunk);
+            offset += chunk.stored_size;
+        }
+        return true;
+    }
+
+    const uint8_t *TraceFile::read_chunk(const trace_chunk_t &chunk, std::vector<uint8_t> *buf) const {
+        if (!compressed_) {
+            return chunk.data;
+        }
+        buf->resize(chunk.raw_size);
+        uLongf size = chunk.raw_size;
+        if (uncompress(buf->data(), &size, chunk.data, chunk.stored_size) != Z_OK || size != chunk.raw_size) {
+            return nullptr;
+        }
+        return buf->data();
+    }
+
+    TraceRecordDecoder::TraceRecordDecoder(const uint8_t *data, size_t size, unsigned xlen):
+        pos_(data), end_(data + size), pc_mask_(xlen < 64 ? (1ULL << xlen) - 1 : ~0ULL),
+        next_pc_(0), last_addr_(0) {}
+
+    bool TraceRecordDecoder::get_varint_(uint64_t *value) {
+        uint64_t result = 0;
+        for (unsigned shift = 0; pos_ < end_ && shift < 64; shift += 7) {
+            uint8_t byte = *pos_++;
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TraceRecordDecoder::next(trace_record_t *rec) {
+        if (pos_ >= end_) {
+            return false;
+        }
+        uint8_t header = *pos_++;
+        rec->flags = header & (tracer_t::REC_RD | tracer_t::REC_MEM | tracer_t::REC_STORE);
+        rec->priv = (header >> tracer_t::REC_PRIV_SHIFT) & 3;
+        rec->pc = next_pc_;
+        uint64_t value;
+        if (header & tracer_t::REC_PC) {
+            if (!get_varint_(&value)) {
+                return false;
+            }
+            rec->pc = next_pc_ + unzigzag_(value);
+        }
+        rec->pc &= pc_mask_;
+        if (end_ - pos_ < 4) {
+            return false;
+        }
+        rec->instr = get_u32(pos_);
+        pos_ += 4;
+        if (header & tracer_t::REC_RD) {
+            if (pos_ >= end_) {
+                return false;
+            }
+            rec->rd = *pos_++;
+            if (!get_varint_(&rec->rd_val)) {
+                return false;
+            }
+        }
+        if (header & tracer_t::REC_MEM) {
+            if (!get_varint_(&value)) {
+                return false;
+            }
+            last_addr_ += unzigzag_(value);
+            rec->addr = last_addr_;
+        }
+        if ((header & tracer_t::REC_STORE) && !get_varint_(&rec->store_val)) {
+            return false;
+        }
+        next_pc_ = rec->pc + 4;
+        return true;
+    }
+} /* ! kz::riscv::tools ! */
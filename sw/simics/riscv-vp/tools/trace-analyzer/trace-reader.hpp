@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2025 Karol Zmijewski
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "riscv-cpu-trace.hpp"
+
+namespace kz::riscv::tools {
+    using trace_record_t = kz::riscv::core::trace_record_t;
+
+    class TraceChunk {
+    public:
+        const uint8_t *data;    // chunk data in the mapped file
+        uint32_t stored_size;   // size of the data in the file
+        uint32_t raw_size;      // size of the decompressed records
+        uint32_t records;
+    };
+    using trace_chunk_t = TraceChunk;
+
+    /**
+     * Read-only memory mapped trace file (see RiscvCpuTracer for the format). The chunk
+     * headers are the sync points of the file, every chunk can be decoded on its own, so
+     * the chunks can be processed in parallel.
+     */
+    class TraceFile {
+    public:
+        TraceFile();
+        ~TraceFile();
+        TraceFile(const TraceFile &) = delete;
+        TraceFile &operator=(const TraceFile &) = delete;
+        /**
+         * Map the file and index its chunks, a truncated chunk at the end is ignored.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param path [M][In] The trace file.
+         * @param error [M][Out] Reason of the failure.
+         * @return false if the file can't be mapped or it isn't a trace file.
+         */
+        bool open(const std::string &path, std::string *error);
+        unsigned get_xlen() const { return xlen_; }
+        bool is_compressed() const { return compressed_; }
+        const std::vector<trace_chunk_t> &get_chunks() const { return chunks_; }
+        /**
+         * Get the records of the chunk, compressed chunks are decompressed into the buffer.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param chunk [M][In] The chunk.
+         * @param buf [M][In/Out] Buffer for the decompressed records.
+         * @return pointer to chunk.raw_size bytes of records, nullptr if the chunk is corrupted.
+         */
+        const uint8_t *read_chunk(const trace_chunk_t &chunk, std::vector<uint8_t> *buf) const;
+    private:
+        void close_();
+        uint8_t *map_;
+        size_t size_;
+        unsigned xlen_;
+        bool compressed_;
+        std::vector<trace_chunk_t> chunks_;
+    };
+
+    /**
+     * Decoder of the records of a single chunk.
+     */
+    class TraceRecordDecoder {
+    public:
+        TraceRecordDecoder(const uint8_t *data, size_t size, unsigned xlen);
+        /**
+         * Decode the next record.
+         * M/O - Mandatory/Optional, In/Out - Input/Output.
+         * @param rec [M][Out] The decoded record.
+         * @return false at the end of the chunk or if the record is truncated.
+         */
+        bool next(trace_record_t *rec);
+    private:
+        bool get_varint_(uint64_t *value);
+        static uint64_t unzigzag_(uint64_t value) { return (value >> 1) ^ (~(value & 1) + 1); }
+        const uint8_t *pos_;
+        const uint8_t *end_;
+        uint64_t pc_mask_;
+        uint64_t next_pc_;
+        uint64_t last_addr_;
+    };
+} /* ! kz::riscv::tools ! */
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Run the benchmark workloads on the Simics model (riscv-vp target) and write a JSON report
+with the guest instruction and cycle counts, CPI and the host speed in MIPS of every workload.
+
+Usage: bench.py --simics <project>/simics [--output results.json] [--timeout 600] <elf>...
+"""
+import argparse
+import datetime
+import json
+import math
+import os
+import platform
+import re
+import subprocess
+import sys
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(os.path.dirname(BENCH_DIR))
+TARGET_SCRIPT = os.path.join(REPO_DIR, "sw", "simics", "riscv-vp", "riscv-vp.simics")
+PROBE_SCRIPT = os.path.join(BENCH_DIR, "simics-bench.py")
+RESULT_TAG = "BENCH-RESULT "
+# report line printed by bench_check() in common/bench.c
+REPORT_RE = re.compile(r"^(\S+): checksum=(0x[0-9a-f]+) instret=(\d+) cycles=(\d+) (PASS|FAIL)$", re.M)
+
+sys.path.insert(0, os.path.join(REPO_DIR, "sw", "simics", "riscv-vp", "modules", "riscv-cpu"))
+import riscv_elf
+
+def run_simics(simics, elf, timeout):
+    symbols = riscv_elf.Elf(elf).addresses(("tohost", "fromhost"))
+    if "tohost" not in symbols:
+        raise ValueError(f"{elf}: no tohost symbol, the workload can't report its exit")
+    commands = [
+        f'$elf_file = "{os.path.abspath(elf)}"',
+        "$load_offset = 0",
+        f"$tohost = {symbols['tohost']:#x}",
+        f"$fromhost = {symbols.get('fromhost', 0):#x}",
+        f'run-command-file "{TARGET_SCRIPT}"',
+        f'run-python-file "{PROBE_SCRIPT}"',
+    ]
+    args = [simics, "-batch-mode"]
+    for command in commands:
+        args += ["-e", command.replace("\\", "/")]
+    proc = subprocess.run(args, capture_output = True, text = True, timeout = timeout)
+    result = None
+    for line in proc.stdout.splitlines():
+        if line.startswith(RESULT_TAG):
+            result = json.loads(line[len(RESULT_TAG):])
+    if result is None:
+        sys.stderr.write(proc.stdout + proc.stderr)
+        raise RuntimeError(f"{elf}: Simics didn't report the result (exit code {proc.returncode})")
+    report = REPORT_RE.search(proc.stdout)
+    if report:
+        result["checksum"] = report.group(2)
+        result["kernel_instructions"] = int(report.group(3))
+        result["kernel_cycles"] = int(report.group(4))
+    return result
+
+def main():
+    parser = argparse.ArgumentParser(description = __doc__.strip().splitlines()[0])
+    parser.add_argument("--simics", required = True, help = "Simics launcher of the project with the riscv-cpu module")
+    parser.add_argument("--output", default = "results.json", help = "JSON report file")
+    parser.add_argument("--timeout", type = int, default = 600, help = "timeout of a single workload in seconds")
+    parser.add_argument("elfs", nargs = "+", help = "workload ELF files")
+    args = parser.parse_args()
+
+    results = []
+    for elf in args.elfs:
+        name = os.path.splitext(os.path.basename(elf))[0]
+        result = run_simics(args.simics, elf, args.timeout)
+        instructions = result["instructions"]
+        seconds = result["host_seconds"]
+        result.update({
+            "name": name,
+            "elf": elf,
+            "passed": result["exit_code"] == 0,
+            "cpi": result["cycles"] / instructions if instructions else None,
+            "mips": instructions / seconds / 1e6 if seconds > 0 else None,
+        })
+        results.append(result)
+        print(f"{name:12} {'PASS' if result['passed'] else 'FAIL'} "
+              f"instr={instructions} cpi={result['cpi'] or 0:.3f} mips={result['mips'] or 0:.2f}")
+
+    mips = [r["mips"] for r in results if r["mips"]]
+    report = {
+        "target": "simics",
+        "date": datetime.datetime.now().isoformat(timespec = "seconds"),
+        "host": {
+            "system": platform.system(),
+            "machine": platform.machine(),
+            "processor": platform.processor(),
+        },
+        "results": results,
+        "summary": {
+            "passed": sum(r["passed"] for r in results),
+            "failed": sum(not r["passed"] for r in results),
+            "geomean_mips": math.exp(sum(map(math.log, mips)) / len(mips)) if mips else None,
+        },
+    }
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent = 2)
+    return 0 if report["summary"]["failed"] == 0 else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
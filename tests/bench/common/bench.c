@@ -0,0 +1,164 @@
+#include "bench.h"
+
+#ifdef BENCH_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void bench_puts(const char *str) { fputs(str, stdout); }
+void bench_put_dec(uint64_t value) { printf("%llu", (unsigned long long)value); }
+void bench_put_hex(uint32_t value) { printf("0x%08x", value); }
+void bench_exit(int code) { exit(code); }
+void bench_start(void) {}
+void bench_stop(void) {}
+
+static uint64_t counter_cycles = 0;
+static uint64_t counter_instret = 0;
+#else
+/* HTIF locations, placed in their own page by bench.lds */
+volatile uint64_t tohost __attribute__((section(".tohost"), aligned(64)));
+volatile uint64_t fromhost __attribute__((section(".tohost"), aligned(64)));
+
+#define HTIF_SYS_WRITE 64
+
+static void htif_write_tohost(uint64_t cmd) {
+    /* the host takes the command when the upper word is written, so it goes last */
+    volatile uint32_t *word = (volatile uint32_t *)&tohost;
+    word[0] = (uint32_t)cmd;
+    word[1] = (uint32_t)(cmd >> 32);
+}
+
+static uint64_t htif_syscall(uint64_t num, uint64_t arg0, uint64_t arg1, uint64_t arg2) {
+    static volatile uint64_t magic_mem[8] __attribute__((aligned(64)));
+    magic_mem[0] = num;
+    magic_mem[1] = arg0;
+    magic_mem[2] = arg1;
+    magic_mem[3] = arg2;
+    __sync_synchronize();
+    htif_write_tohost((uintptr_t)magic_mem);
+    while (fromhost == 0) {
+    }
+    fromhost = 0;
+    __sync_synchronize();
+    return magic_mem[0];
+}
+
+void bench_puts(const char *str) {
+    size_t len = 0;
+    while (str[len] != '\0') {
+        len++;
+    }
+    htif_syscall(HTIF_SYS_WRITE, 1, (uintptr_t)str, len);
+}
+
+void bench_put_dec(uint64_t value) {
+    char buf[21];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    do {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    bench_puts(p);
+}
+
+void bench_put_hex(uint32_t value) {
+    char buf[11] = "0x";
+    for (int i = 0; i < 8; i++) {
+        buf[2 + i] = "0123456789abcdef"[(value >> (28 - 4 * i)) & 0xF];
+    }
+    buf[10] = '\0';
+    bench_puts(buf);
+}
+
+void bench_exit(int code) {
+    htif_write_tohost(((uint64_t)code << 1) | 1);
+    for (;;) {
+    }
+}
+
+static uint64_t read_cycle(void) {
+    uint32_t hi, lo, hi2;
+    do {
+        __asm__ volatile("rdcycleh %0" : "=r"(hi));
+        __asm__ volatile("rdcycle %0" : "=r"(lo));
+        __asm__ volatile("rdcycleh %0" : "=r"(hi2));
+    } while (hi != hi2);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static uint64_t read_instret(void) {
+    uint32_t hi, lo, hi2;
+    do {
+        __asm__ volatile("rdinstreth %0" : "=r"(hi));
+        __asm__ volatile("rdinstret %0" : "=r"(lo));
+        __asm__ volatile("rdinstreth %0" : "=r"(hi2));
+    } while (hi != hi2);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static uint64_t counter_cycles;
+static uint64_t counter_instret;
+
+void bench_start(void) {
+    counter_cycles = read_cycle();
+    counter_instret = read_instret();
+}
+
+void bench_stop(void) {
+    counter_cycles = read_cycle() - counter_cycles;
+    counter_instret = read_instret() - counter_instret;
+}
+
+void *memcpy(void *dst, const void *src, size_t size) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    while (size--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+void *memset(void *dst, int value, size_t size) {
+    uint8_t *d = dst;
+    while (size--) {
+        *d++ = (uint8_t)value;
+    }
+    return dst;
+}
+#endif /* !BENCH_HOST! */
+
+int bench_check(const char *name, uint32_t checksum, uint32_t expected) {
+    int passed = (checksum == expected);
+    bench_puts(name);
+    bench_puts(": checksum=");
+    bench_put_hex(checksum);
+    bench_puts(" instret=");
+    bench_put_dec(counter_instret);
+    bench_puts(" cycles=");
+    bench_put_dec(counter_cycles);
+    bench_puts(passed ? " PASS\n" : " FAIL\n");
+    return passed ? 0 : 1;
+}
+
+uint16_t bench_crc16(uint32_t value, uint16_t crc) {
+    for (int i = 0; i < 32; i++) {
+        uint16_t bit = (uint16_t)((value ^ crc) & 1);
+        value >>= 1;
+        crc >>= 1;
+        if (bit) {
+            crc ^= 0xA001;
+        }
+    }
+    return crc;
+}
+
+uint32_t bench_rand(uint32_t *state) {
+    /* xorshift32 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
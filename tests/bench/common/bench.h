@@ -0,0 +1,40 @@
+/*
+ * Common harness of the benchmark workloads. Every workload is a freestanding RV32I program
+ * linked with bench.lds and crt.S, it runs its kernel between bench_start() and bench_stop(),
+ * compares the checksum of the results with the expected value and returns the exit code
+ * from main(), which is reported to the host through HTIF tohost (Spike, Simics riscv-vp).
+ * Building with -DBENCH_HOST gives a native program with the same output, used to verify the
+ * expected checksums. The number of kernel repetitions (ITERATIONS) has a default in every
+ * workload and can be overridden with -DITERATIONS=N, the expected checksum depends on it.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void bench_puts(const char *str);
+void bench_put_dec(uint64_t value);
+void bench_put_hex(uint32_t value);
+void bench_exit(int code) __attribute__((noreturn));
+
+/* read the cycle and instret counters before and after the measured kernel */
+void bench_start(void);
+void bench_stop(void);
+
+/*
+ * Print the report line of the workload: name, checksum and the counters of the measured part.
+ * Returns the exit code: 0 if the checksum is equal to the expected one, 1 otherwise.
+ */
+int bench_check(const char *name, uint32_t checksum, uint32_t expected);
+
+/* CRC-16 used by the CoreMark-style kernels to fold their results into a checksum */
+uint16_t bench_crc16(uint32_t value, uint16_t crc);
+
+/* deterministic pseudo-random numbers, the same sequence on every target */
+uint32_t bench_rand(uint32_t *state);
+
+void *memcpy(void *dst, const void *src, size_t size);
+void *memset(void *dst, int value, size_t size);
+
+#endif /* !BENCH_H! */
@@ -0,0 +1,221 @@
+/*
+ * Dhrystone-like integer workload: record assignments through pointers, string copy and
+ * compare, enumerations, one and two dimensional arrays and short procedure calls.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 20000
+#endif
+
+#define EXPECTED 0x00006e0d
+
+typedef enum { IDENT_1, IDENT_2, IDENT_3, IDENT_4, IDENT_5 } ident_t;
+
+typedef struct record {
+    struct record *ptr_comp;
+    ident_t discr;
+    ident_t enum_comp;
+    int int_comp;
+    char str_comp[31];
+} record_t;
+
+static record_t glob_rec;
+static record_t next_glob_rec;
+static record_t *ptr_glob;
+static int int_glob;
+static int bool_glob;
+static char char_1_glob;
+static char char_2_glob;
+static int arr_1_glob[50];
+static int arr_2_glob[50][50];
+
+static void str_copy(char *dst, const char *src) {
+    while ((*dst++ = *src++) != '\0') {
+    }
+}
+
+static int str_compare(const char *str_1, const char *str_2) {
+    while (*str_1 != '\0' && *str_1 == *str_2) {
+        str_1++;
+        str_2++;
+    }
+    return (unsigned char)*str_1 - (unsigned char)*str_2;
+}
+
+static __attribute__((noinline)) ident_t func_1(char ch_1, char ch_2) {
+    char ch_loc_1 = ch_1;
+    char ch_loc_2 = ch_loc_1;
+    if (ch_loc_2 != ch_2) {
+        return IDENT_1;
+    }
+    char_1_glob = ch_loc_1;
+    return IDENT_2;
+}
+
+static __attribute__((noinline)) int func_2(const char *str_1, const char *str_2) {
+    int int_loc = 2;
+    char ch_loc = 'A';
+    while (int_loc <= 2) {
+        if (func_1(str_1[int_loc], str_2[int_loc + 1]) == IDENT_1) {
+            ch_loc = 'A';
+            int_loc += 1;
+        }
+    }
+    if (ch_loc >= 'W' && ch_loc < 'Z') {
+        int_loc = 7;
+    }
+    if (ch_loc == 'R') {
+        return 1;
+    }
+    if (str_compare(str_1, str_2) > 0) {
+        int_loc += 7;
+        int_glob = int_loc;
+        return 1;
+    }
+    return 0;
+}
+
+static __attribute__((noinline)) int func_3(ident_t enum_par) {
+    return enum_par == IDENT_3;
+}
+
+static __attribute__((noinline)) void proc_6(ident_t enum_val, ident_t *enum_ref) {
+    *enum_ref = enum_val;
+    if (!func_3(enum_val)) {
+        *enum_ref = IDENT_4;
+    }
+    switch (enum_val) {
+        case IDENT_1: *enum_ref = IDENT_1; break;
+        case IDENT_2: *enum_ref = (int_glob > 100) ? IDENT_1 : IDENT_4; break;
+        case IDENT_3: *enum_ref = IDENT_2; break;
+        case IDENT_4: break;
+        case IDENT_5: *enum_ref = IDENT_3; break;
+    }
+}
+
+static __attribute__((noinline)) void proc_7(int int_1, int int_2, int *int_ref) {
+    *int_ref = int_2 + int_1 + 2;
+}
+
+static __attribute__((noinline)) void proc_8(int arr_1[50], int arr_2[50][50], int int_1, int int_2) {
+    int int_loc = int_1 + 5;
+    arr_1[int_loc] = int_2;
+    arr_1[int_loc + 1] = arr_1[int_loc];
+    arr_1[int_loc + 30] = int_loc;
+    for (int idx = int_loc; idx <= int_loc + 1; idx++) {
+        arr_2[int_loc][idx] = int_loc;
+    }
+    arr_2[int_loc][int_loc - 1] += 1;
+    arr_2[int_loc + 20][int_loc] = arr_1[int_loc];
+    int_glob = 5;
+}
+
+static __attribute__((noinline)) void proc_3(record_t **ptr_ref) {
+    if (ptr_glob != 0) {
+        *ptr_ref = ptr_glob->ptr_comp;
+    }
+    proc_7(10, int_glob, &ptr_glob->int_comp);
+}
+
+static __attribute__((noinline)) void proc_1(record_t *ptr_val) {
+    record_t *next = ptr_val->ptr_comp;
+    *ptr_val->ptr_comp = *ptr_glob;
+    ptr_val->int_comp = 5;
+    next->int_comp = ptr_val->int_comp;
+    next->ptr_comp = ptr_val->ptr_comp;
+    proc_3(&next->ptr_comp);
+    if (next->discr == IDENT_1) {
+        next->int_comp = 6;
+        proc_6(ptr_val->enum_comp, &next->enum_comp);
+        next->ptr_comp = ptr_glob->ptr_comp;
+        proc_7(next->int_comp, 10, &next->int_comp);
+    } else {
+        *ptr_val = *ptr_val->ptr_comp;
+    }
+}
+
+static __attribute__((noinline)) void proc_2(int *int_ref) {
+    int int_loc = *int_ref + 10;
+    ident_t enum_loc = IDENT_2;
+    for (;;) {
+        if (char_1_glob == 'A') {
+            int_loc -= 1;
+            *int_ref = int_loc - int_glob;
+            enum_loc = IDENT_1;
+        }
+        if (enum_loc == IDENT_1) {
+            break;
+        }
+    }
+}
+
+static __attribute__((noinline)) void proc_4(void) {
+    int bool_loc = (char_1_glob == 'A');
+    bool_glob = bool_loc | bool_glob;
+    char_2_glob = 'B';
+}
+
+static __attribute__((noinline)) void proc_5(void) {
+    char_1_glob = 'A';
+    bool_glob = 0;
+}
+
+int main(void) {
+    char str_1_loc[31];
+    char str_2_loc[31];
+    int int_1_loc = 0;
+    int int_2_loc = 0;
+    int int_3_loc = 0;
+    ident_t enum_loc = IDENT_1;
+    uint16_t crc = 0;
+
+    next_glob_rec.ptr_comp = 0;
+    glob_rec.ptr_comp = &next_glob_rec;
+    glob_rec.discr = IDENT_1;
+    glob_rec.enum_comp = IDENT_3;
+    glob_rec.int_comp = 40;
+    str_copy(glob_rec.str_comp, "DHRYSTONE PROGRAM, SOME STRING");
+    ptr_glob = &glob_rec;
+    str_copy(str_1_loc, "DHRYSTONE PROGRAM, 1'ST STRING");
+    arr_2_glob[8][7] = 10;
+
+    bench_start();
+    for (int run = 1; run <= ITERATIONS; run++) {
+        proc_5();
+        proc_4();
+        int_1_loc = 2;
+        int_2_loc = 3;
+        str_copy(str_2_loc, "DHRYSTONE PROGRAM, 2'ND STRING");
+        enum_loc = IDENT_2;
+        bool_glob = !func_2(str_1_loc, str_2_loc);
+        while (int_1_loc < int_2_loc) {
+            int_3_loc = 5 * int_1_loc - int_2_loc;
+            proc_7(int_1_loc, int_2_loc, &int_3_loc);
+            int_1_loc += 1;
+        }
+        proc_8(arr_1_glob, arr_2_glob, int_1_loc, int_3_loc);
+        proc_1(ptr_glob);
+        for (char ch_index = 'A'; ch_index <= char_2_glob; ch_index++) {
+            if (enum_loc == func_1(ch_index, 'C')) {
+                proc_6(IDENT_1, &enum_loc);
+                str_copy(str_2_loc, "DHRYSTONE PROGRAM, 3'RD STRING");
+                int_2_loc = run;
+                int_glob = run;
+            }
+        }
+        int_2_loc = int_2_loc * int_1_loc;
+        int_1_loc = int_2_loc / int_3_loc;
+        int_2_loc = 7 * (int_2_loc - int_3_loc) - int_1_loc;
+        proc_2(&int_1_loc);
+        crc = bench_crc16((uint32_t)(int_1_loc + int_2_loc + int_3_loc + enum_loc), crc);
+    }
+    bench_stop();
+
+    crc = bench_crc16((uint32_t)int_glob, crc);
+    crc = bench_crc16((uint32_t)bool_glob, crc);
+    crc = bench_crc16((uint32_t)arr_2_glob[8][7], crc);
+    crc = bench_crc16((uint32_t)ptr_glob->int_comp, crc);
+    crc = bench_crc16((uint32_t)str_compare(str_2_loc, "DHRYSTONE PROGRAM, 2'ND STRING"), crc);
+    return bench_check("dhrystone", crc, EXPECTED);
+}
@@ -0,0 +1,75 @@
+/*
+ * Floating point kernel: dot product, polynomial evaluation (Horner) and Newton-Raphson
+ * square root in double precision. RV32I has no FPU, so every operation is a libgcc soft-float
+ * call, all of them are exactly rounded, so the result is bit exact on every target.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 20
+#endif
+
+#define EXPECTED 0x00008235
+
+#define VECT_SIZE 64
+
+static double vect_a[VECT_SIZE];
+static double vect_b[VECT_SIZE];
+static const double coeffs[] = { 1.0, -0.5, 0.25, -0.125, 0.0625, -0.03125, 0.015625 };
+
+static double dot(const double *a, const double *b, int size) {
+    double sum = 0.0;
+    for (int i = 0; i < size; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static double horner(double x) {
+    double result = 0.0;
+    for (int i = (int)(sizeof(coeffs) / sizeof(coeffs[0])) - 1; i >= 0; i--) {
+        result = result * x + coeffs[i];
+    }
+    return result;
+}
+
+static double newton_sqrt(double x) {
+    double guess = (x > 1.0) ? x / 2.0 : 1.0;
+    for (int i = 0; i < 8; i++) {
+        guess = 0.5 * (guess + x / guess);
+    }
+    return guess;
+}
+
+static uint16_t crc_double(double value, uint16_t crc) {
+    union {
+        double d;
+        uint32_t w[2];
+    } bits = { .d = value };
+    crc = bench_crc16(bits.w[0], crc);
+    return bench_crc16(bits.w[1], crc);
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    uint32_t state = 0xF00DFACE;
+    for (int i = 0; i < VECT_SIZE; i++) {
+        vect_a[i] = (double)(int32_t)(bench_rand(&state) & 0xFFFF) / 256.0;
+        vect_b[i] = (double)(int32_t)(bench_rand(&state) & 0xFFFF) / 1024.0 - 32.0;
+    }
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        double sum = dot(vect_a, vect_b, VECT_SIZE);
+        crc = crc_double(sum, crc);
+        for (int j = 0; j < VECT_SIZE; j++) {
+            vect_b[j] = horner(vect_b[j] / 64.0) * 32.0;
+            vect_a[j] = newton_sqrt(vect_a[j] + (double)i);
+        }
+        crc = crc_double(vect_a[i % VECT_SIZE], crc);
+        crc = crc_double(vect_b[i % VECT_SIZE], crc);
+    }
+    bench_stop();
+
+    return bench_check("fp", crc, EXPECTED);
+}
@@ -0,0 +1,142 @@
+/*
+ * CoreMark-style linked list kernel: search, reverse and merge sort of a list of small
+ * records living in a static pool, the pointer chasing stresses loads and the data dependent
+ * branches.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 200
+#endif
+
+#define EXPECTED 0x00002419
+
+#define LIST_SIZE 128
+
+typedef struct list_node {
+    struct list_node *next;
+    int16_t data;
+    int16_t idx;
+} list_node_t;
+
+static list_node_t pool[LIST_SIZE];
+
+static list_node_t *list_init(uint32_t seed) {
+    uint32_t state = seed;
+    list_node_t *head = 0;
+    for (int i = LIST_SIZE - 1; i >= 0; i--) {
+        pool[i].data = (int16_t)(bench_rand(&state) & 0x7FFF);
+        pool[i].idx = (int16_t)i;
+        pool[i].next = head;
+        head = &pool[i];
+    }
+    return head;
+}
+
+static list_node_t *list_find(list_node_t *list, int16_t data) {
+    while (list != 0 && (list->data & 0xFF) != (data & 0xFF)) {
+        list = list->next;
+    }
+    return list;
+}
+
+static list_node_t *list_reverse(list_node_t *list) {
+    list_node_t *prev = 0;
+    while (list != 0) {
+        list_node_t *next = list->next;
+        list->next = prev;
+        prev = list;
+        list = next;
+    }
+    return prev;
+}
+
+static int cmp_data(const list_node_t *a, const list_node_t *b) {
+    return a->data - b->data;
+}
+
+static int cmp_idx(const list_node_t *a, const list_node_t *b) {
+    return a->idx - b->idx;
+}
+
+/* bottom-up merge sort, no recursion and no extra memory */
+static list_node_t *list_sort(list_node_t *list, int (*cmp)(const list_node_t *, const list_node_t *)) {
+    int insize = 1;
+    for (;;) {
+        list_node_t *p = list;
+        list_node_t *tail = 0;
+        int merges = 0;
+        list = 0;
+        while (p != 0) {
+            list_node_t *q = p;
+            int psize = 0;
+            merges++;
+            for (int i = 0; i < insize && q != 0; i++) {
+                psize++;
+                q = q->next;
+            }
+            int qsize = insize;
+            while (psize > 0 || (qsize > 0 && q != 0)) {
+                list_node_t *e;
+                if (psize == 0) {
+                    e = q;
+                    q = q->next;
+                    qsize--;
+                } else if (qsize == 0 || q == 0 || cmp(p, q) <= 0) {
+                    e = p;
+                    p = p->next;
+                    psize--;
+                } else {
+                    e = q;
+                    q = q->next;
+                    qsize--;
+                }
+                if (tail != 0) {
+                    tail->next = e;
+                } else {
+                    list = e;
+                }
+                tail = e;
+            }
+            p = q;
+        }
+        tail->next = 0;
+        if (merges <= 1) {
+            return list;
+        }
+        insize *= 2;
+    }
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    list_node_t *list = list_init(0x12345678);
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        int found = 0;
+        int missed = 0;
+        for (int j = 0; j < 16; j++) {
+            list_node_t *node = list_find(list, (int16_t)(i * 16 + j));
+            if (node != 0) {
+                found++;
+                crc = bench_crc16((uint32_t)node->idx, crc);
+            } else {
+                missed++;
+            }
+        }
+        list = list_reverse(list);
+        list = list_sort(list, cmp_data);
+        crc = bench_crc16((uint32_t)(list->data + list->next->data), crc);
+        /* modify a record, so the next sort has something to do */
+        list->data = (int16_t)((list->data ^ (i * 0x1F3)) & 0x7FFF);
+        list = list_sort(list, cmp_idx);
+        crc = bench_crc16((uint32_t)(found << 16 | missed), crc);
+    }
+    bench_stop();
+
+    for (list_node_t *node = list; node != 0; node = node->next) {
+        crc = bench_crc16((uint32_t)node->data, crc);
+    }
+    return bench_check("list", crc, EXPECTED);
+}
@@ -0,0 +1,100 @@
+/*
+ * CoreMark-style matrix kernel: constant add and multiply, matrix-vector and matrix-matrix
+ * products of 16-bit matrices with 32-bit accumulation. RV32I has no multiplier, so the
+ * products are computed by the libgcc helpers.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 20
+#endif
+
+#define EXPECTED 0x0000d950
+
+#define N 16
+
+static int16_t mat_a[N][N];
+static int16_t mat_b[N][N];
+static int32_t mat_c[N][N];
+static int32_t vec_c[N];
+
+static void matrix_init(uint32_t seed) {
+    uint32_t state = seed;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            mat_a[i][j] = (int16_t)((bench_rand(&state) & 0xFFF) - 0x800);
+            mat_b[i][j] = (int16_t)((bench_rand(&state) & 0xFFF) - 0x800);
+        }
+    }
+}
+
+static void matrix_add_const(int16_t mat[N][N], int16_t value) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            mat[i][j] = (int16_t)(mat[i][j] + value);
+        }
+    }
+}
+
+static void matrix_mul_const(int32_t res[N][N], int16_t mat[N][N], int16_t value) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            res[i][j] = (int32_t)mat[i][j] * value;
+        }
+    }
+}
+
+static void matrix_mul_vect(int32_t res[N], int16_t mat[N][N], int16_t vect[N]) {
+    for (int i = 0; i < N; i++) {
+        int32_t sum = 0;
+        for (int j = 0; j < N; j++) {
+            sum += (int32_t)mat[i][j] * vect[j];
+        }
+        res[i] = sum;
+    }
+}
+
+static void matrix_mul_matrix(int32_t res[N][N], int16_t mat_1[N][N], int16_t mat_2[N][N]) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            int32_t sum = 0;
+            for (int k = 0; k < N; k++) {
+                sum += (int32_t)mat_1[i][k] * mat_2[k][j];
+            }
+            res[i][j] = sum;
+        }
+    }
+}
+
+static uint16_t matrix_sum(int32_t res[N][N], uint16_t crc) {
+    int32_t sum = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            sum += res[i][j];
+        }
+    }
+    return bench_crc16((uint32_t)sum, crc);
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    matrix_init(0xCAFEBABE);
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        int16_t value = (int16_t)(i + 7);
+        matrix_add_const(mat_a, value);
+        matrix_mul_const(mat_c, mat_a, value);
+        crc = matrix_sum(mat_c, crc);
+        matrix_mul_vect(vec_c, mat_a, mat_b[i % N]);
+        for (int j = 0; j < N; j++) {
+            crc = bench_crc16((uint32_t)vec_c[j], crc);
+        }
+        matrix_mul_matrix(mat_c, mat_a, mat_b);
+        crc = matrix_sum(mat_c, crc);
+        matrix_add_const(mat_a, (int16_t)-value);
+    }
+    bench_stop();
+
+    return bench_check("matrix", crc, EXPECTED);
+}
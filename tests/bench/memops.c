@@ -0,0 +1,87 @@
+/*
+ * Block memory kernel: word-wise and byte-wise copy and fill of buffers with different sizes
+ * and alignments, the loop is dominated by loads and stores.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 100
+#endif
+
+#define EXPECTED 0x00000722
+
+#define BUF_SIZE 4096
+
+static uint8_t src_buf[BUF_SIZE] __attribute__((aligned(4)));
+static uint8_t dst_buf[BUF_SIZE] __attribute__((aligned(4)));
+
+static void copy_block(uint8_t *dst, const uint8_t *src, size_t size) {
+    /* words if both pointers share the alignment, bytes for the rest */
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) == 0) {
+        while (((uintptr_t)dst & 3) != 0 && size > 0) {
+            *dst++ = *src++;
+            size--;
+        }
+        uint32_t *dst_word = (uint32_t *)dst;
+        const uint32_t *src_word = (const uint32_t *)src;
+        for (; size >= 16; size -= 16) {
+            dst_word[0] = src_word[0];
+            dst_word[1] = src_word[1];
+            dst_word[2] = src_word[2];
+            dst_word[3] = src_word[3];
+            dst_word += 4;
+            src_word += 4;
+        }
+        for (; size >= 4; size -= 4) {
+            *dst_word++ = *src_word++;
+        }
+        dst = (uint8_t *)dst_word;
+        src = (const uint8_t *)src_word;
+    }
+    while (size-- > 0) {
+        *dst++ = *src++;
+    }
+}
+
+static void fill_block(uint8_t *dst, uint8_t value, size_t size) {
+    while (((uintptr_t)dst & 3) != 0 && size > 0) {
+        *dst++ = value;
+        size--;
+    }
+    uint32_t word = value * 0x01010101U;
+    uint32_t *dst_word = (uint32_t *)dst;
+    for (; size >= 4; size -= 4) {
+        *dst_word++ = word;
+    }
+    dst = (uint8_t *)dst_word;
+    while (size-- > 0) {
+        *dst++ = value;
+    }
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    uint32_t state = 0xA5A5A5A5;
+    for (int i = 0; i < BUF_SIZE; i += 4) {
+        uint32_t value = bench_rand(&state);
+        copy_block(&src_buf[i], (const uint8_t *)&value, 4);
+    }
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (unsigned offset = 0; offset < 4; offset++) {
+            size_t size = BUF_SIZE - 8 - offset * 16;
+            fill_block(&dst_buf[offset], (uint8_t)(i + offset), size);
+            crc = bench_crc16(dst_buf[offset + size / 2], crc);
+            copy_block(&dst_buf[offset], &src_buf[(offset * 3) & 3], size);
+            crc = bench_crc16(*(uint32_t *)&dst_buf[BUF_SIZE / 2], crc);
+        }
+        copy_block(src_buf, dst_buf, BUF_SIZE);
+    }
+    bench_stop();
+
+    for (int i = 0; i < BUF_SIZE; i += 4) {
+        crc = bench_crc16(*(uint32_t *)&dst_buf[i], crc);
+    }
+    return bench_check("memops", crc, EXPECTED);
+}
@@ -0,0 +1,19 @@
+# Executed inside Simics by bench.py (run-python-file) once the riscv-vp target is created:
+# runs the workload until it exits and prints the measured values as a single JSON line.
+import json
+import time
+import conf
+import simics
+
+cpu = conf.rcpu
+steps = cpu.steps
+cycles = cpu.cycles
+start = time.perf_counter()
+simics.SIM_continue(0)
+host_seconds = time.perf_counter() - start
+print("BENCH-RESULT " + json.dumps({
+    "exit_code": cpu.exit_code,
+    "instructions": cpu.steps - steps,
+    "cycles": cpu.cycles - cycles,
+    "host_seconds": host_seconds,
+}), flush = True)
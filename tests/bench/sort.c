@@ -0,0 +1,98 @@
+/*
+ * Branch-heavy sort kernel: quicksort with the median of three pivot and insertion sort of
+ * short ranges on pseudo-random data, the comparisons are unpredictable.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 20
+#endif
+
+#define EXPECTED 0x00009a6a
+
+#define ARRAY_SIZE 2048
+#define INSERTION_THRESHOLD 12
+
+static int32_t array[ARRAY_SIZE];
+
+static void insertion_sort(int32_t *data, int lo, int hi) {
+    for (int i = lo + 1; i <= hi; i++) {
+        int32_t value = data[i];
+        int j = i - 1;
+        while (j >= lo && data[j] > value) {
+            data[j + 1] = data[j];
+            j--;
+        }
+        data[j + 1] = value;
+    }
+}
+
+static void swap(int32_t *a, int32_t *b) {
+    int32_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void quick_sort(int32_t *data, int lo, int hi) {
+    while (hi - lo > INSERTION_THRESHOLD) {
+        int mid = lo + (hi - lo) / 2;
+        if (data[mid] < data[lo]) {
+            swap(&data[mid], &data[lo]);
+        }
+        if (data[hi] < data[lo]) {
+            swap(&data[hi], &data[lo]);
+        }
+        if (data[hi] < data[mid]) {
+            swap(&data[hi], &data[mid]);
+        }
+        int32_t pivot = data[mid];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (data[i] < pivot) {
+                i++;
+            }
+            while (data[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                swap(&data[i], &data[j]);
+                i++;
+                j--;
+            }
+        }
+        /* recurse into the smaller part, loop on the bigger one */
+        if (j - lo < hi - i) {
+            quick_sort(data, lo, j);
+            lo = i;
+        } else {
+            quick_sort(data, i, hi);
+            hi = j;
+        }
+    }
+    insertion_sort(data, lo, hi);
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    uint32_t state = 0x13579BDF;
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (int j = 0; j < ARRAY_SIZE; j++) {
+            array[j] = (int32_t)bench_rand(&state) >> (i & 7);
+        }
+        quick_sort(array, 0, ARRAY_SIZE - 1);
+        uint32_t unsorted = 0;
+        for (int j = 1; j < ARRAY_SIZE; j++) {
+            unsorted += (array[j - 1] > array[j]);
+        }
+        crc = bench_crc16(unsorted, crc);
+        crc = bench_crc16((uint32_t)array[0], crc);
+        crc = bench_crc16((uint32_t)array[ARRAY_SIZE / 2], crc);
+        crc = bench_crc16((uint32_t)array[ARRAY_SIZE - 1], crc);
+    }
+    bench_stop();
+
+    return bench_check("sort", crc, EXPECTED);
+}
@@ -0,0 +1,146 @@
+/*
+ * CoreMark-style state machine kernel: classify comma separated tokens of the input as
+ * integers, floats, scientific notation or invalid ones, one character at a time. Every
+ * iteration corrupts a few characters, so the branch pattern keeps changing.
+ */
+#include "bench.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 1000
+#endif
+
+#define EXPECTED 0x00009d69
+
+typedef enum {
+    STATE_START,
+    STATE_INVALID,
+    STATE_S1,
+    STATE_S2,
+    STATE_INT,
+    STATE_FLOAT,
+    STATE_EXPONENT,
+    STATE_SCIENTIFIC,
+    STATE_NUM
+} state_t;
+
+static const char input_template[] =
+    "5012,1234,-874,+122,35.54,-1.2e3,0.25,1e+5,--3,7.5e-2,abc,12e,"
+    "-.5,+0.0,3.14159,2.0E10,99999,-7,1.e4,x1,0x10,1234567,-0.0001,8e8,";
+
+static char input[sizeof(input_template)];
+
+static int is_digit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+static state_t next_state(state_t state, char ch, uint32_t *transitions) {
+    state_t next = state;
+    switch (state) {
+        case STATE_START:
+            if (is_digit(ch)) {
+                next = STATE_INT;
+            } else if (ch == '+' || ch == '-') {
+                next = STATE_S1;
+            } else if (ch == '.') {
+                next = STATE_FLOAT;
+            } else {
+                next = STATE_INVALID;
+            }
+            break;
+        case STATE_S1:
+            if (is_digit(ch)) {
+                next = STATE_INT;
+            } else if (ch == '.') {
+                next = STATE_FLOAT;
+            } else {
+                next = STATE_INVALID;
+            }
+            break;
+        case STATE_INT:
+            if (ch == '.') {
+                next = STATE_FLOAT;
+            } else if (!is_digit(ch)) {
+                next = STATE_INVALID;
+            }
+            break;
+        case STATE_FLOAT:
+            if (ch == 'e' || ch == 'E') {
+                next = STATE_S2;
+            } else if (!is_digit(ch)) {
+                next = STATE_INVALID;
+            }
+            break;
+        case STATE_S2:
+            if (ch == '+' || ch == '-') {
+                next = STATE_EXPONENT;
+            } else if (is_digit(ch)) {
+                next = STATE_SCIENTIFIC;
+            } else {
+                next = STATE_INVALID;
+            }
+            break;
+        case STATE_EXPONENT:
+            next = is_digit(ch) ? STATE_SCIENTIFIC : STATE_INVALID;
+            break;
+        case STATE_SCIENTIFIC:
+            if (!is_digit(ch)) {
+                next = STATE_INVALID;
+            }
+            break;
+        default:
+            break;
+    }
+    if (next != state) {
+        transitions[next]++;
+    }
+    return next;
+}
+
+static void scan(uint32_t final_counts[STATE_NUM], uint32_t transitions[STATE_NUM]) {
+    const char *p = input;
+    while (*p != '\0') {
+        state_t state = STATE_START;
+        while (*p != '\0' && *p != ',') {
+            state = next_state(state, *p, transitions);
+            if (state == STATE_INVALID) {
+                break;
+            }
+            p++;
+        }
+        final_counts[state]++;
+        while (*p != '\0' && *p != ',') {
+            p++;
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+}
+
+int main(void) {
+    uint16_t crc = 0;
+    uint32_t state = 0x5EED5EED;
+    for (unsigned i = 0; i < sizeof(input_template); i++) {
+        input[i] = input_template[i];
+    }
+
+    bench_start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        uint32_t final_counts[STATE_NUM] = { 0 };
+        uint32_t transitions[STATE_NUM] = { 0 };
+        scan(final_counts, transitions);
+        for (int s = 0; s < STATE_NUM; s++) {
+            crc = bench_crc16(final_counts[s] << 16 | transitions[s], crc);
+        }
+        /* corrupt (or restore) a few characters, the separators are kept */
+        for (int j = 0; j < 4; j++) {
+            uint32_t pos = bench_rand(&state) % (sizeof(input_template) - 1);
+            if (input[pos] != ',') {
+                input[pos] = (input[pos] == input_template[pos]) ? (char)('0' + (pos & 7)) : input_template[pos];
+            }
+        }
+    }
+    bench_stop();
+
+    return bench_check("state", crc, EXPECTED);
+}